@@ -0,0 +1,277 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Defines AudioFeatureCalculator.
+#include <math.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "Eigen/Core"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "audio/dsp/mfcc/mel_filterbank.h"
+#include "audio/dsp/mfcc/mfcc.h"
+#include "audio/dsp/spectrogram/spectrogram.h"
+#include "mediapipe/calculators/audio/audio_feature_calculator.pb.h"
+#include "mediapipe/calculators/audio/mfcc_mel_calculators.pb.h"
+#include "mediapipe/calculators/audio/spectrogram_calculator.pb.h"
+#include "mediapipe/calculators/audio/spectrogram_utils.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/matrix.h"
+#include "mediapipe/framework/formats/time_series_header.pb.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/time_series_util.h"
+
+namespace mediapipe {
+
+// MediaPipe Calculator computing Mel spectra or Mel Frequency Cepstral
+// Coefficients from a single channel waveform. It fuses the
+//   SpectrogramCalculator -> MelSpectrumCalculator or MfccCalculator
+// chain into a single calculator, whose output packets, header and timestamps
+// are identical to those of the chain with the same options.
+//
+// Each spectrogram frame goes through the filterbank as soon as it is
+// computed, in buffers reused across frames and packets, so that neither the
+// spectrogram packets nor their float to double conversions are materialized.
+//
+// Example config:
+// node {
+//   calculator: "AudioFeatureCalculator"
+//   input_stream: "audio_samples"
+//   output_stream: "mfcc_frames"
+//   options {
+//     [mediapipe.AudioFeatureCalculatorOptions.ext] {
+//       spectrogram_options {
+//         frame_duration_seconds: 0.025
+//         frame_overlap_seconds: 0.015
+//       }
+//       feature_type: MFCC
+//       mfcc_options {
+//         mel_spectrum_params { channel_count: 40 }
+//         mfcc_count: 13
+//       }
+//     }
+//   }
+// }
+class AudioFeatureCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Index(0).Set<Matrix>(
+        // Single channel input stream with TimeSeriesHeader.
+    );
+    cc->Outputs().Index(0).Set<Matrix>(
+        // Feature frames with TimeSeriesHeader, one column per frame.
+    );
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override;
+  absl::Status Process(CalculatorContext* cc) override;
+  // Performs zero-padding and processing of any remaining samples if
+  // pad_final_packet is set.
+  absl::Status Close(CalculatorContext* cc) override;
+
+ private:
+  // Computes the features of the frames completed by `samples` and outputs
+  // them in a single packet, if any.
+  absl::Status ProcessSamples(const Eigen::Ref<const Matrix>& samples,
+                              CalculatorContext* cc);
+
+  // Computes the output timestamps like SpectrogramCalculator.
+  spectrogram_utils::SpectrogramTimestamps output_timestamps_;
+  double input_sample_rate_;
+  bool pad_final_packet_;
+  int frame_duration_samples_;
+  int frame_step_samples_;
+  bool reset_sample_buffer_;
+  float input_scale_;
+  // SpectrogramCalculator applies its output scale in single precision.
+  float output_scale_;
+  int64_t cumulative_input_samples_ = 0;
+  int num_output_channels_;
+
+  audio_dsp::Spectrogram spectrogram_;
+  // Only one of them is set, depending on the feature type.
+  std::unique_ptr<audio_dsp::MelFilterbank> mel_filterbank_;
+  std::unique_ptr<audio_dsp::Mfcc> mfcc_;
+
+  // Buffers reused across packets.
+  std::vector<float> input_samples_;
+  std::vector<std::vector<float>> spectrogram_frames_;
+  std::vector<double> spectrum_;
+  std::vector<double> features_;
+};
+REGISTER_CALCULATOR(AudioFeatureCalculator);
+
+absl::Status AudioFeatureCalculator::Open(CalculatorContext* cc) {
+  const auto& options = cc->Options<AudioFeatureCalculatorOptions>();
+  const SpectrogramCalculatorOptions& spectrogram_options =
+      options.spectrogram_options();
+  RET_CHECK_EQ(spectrogram_options.output_type(),
+               SpectrogramCalculatorOptions::SQUARED_MAGNITUDE)
+      << "AudioFeatureCalculator requires SQUARED_MAGNITUDE spectrograms.";
+  RET_CHECK(!spectrogram_options.allow_multichannel_input())
+      << "AudioFeatureCalculator only supports single channel input.";
+  RET_CHECK(!spectrogram_options.use_batched_fft());
+  RET_CHECK_NE(spectrogram_options.output_layout(),
+               SpectrogramCalculatorOptions::SPECTROGRAM_CHANNELS_IN_ROWS);
+
+  TimeSeriesHeader input_header;
+  MP_RETURN_IF_ERROR(time_series_util::FillTimeSeriesHeaderIfValid(
+      cc->Inputs().Index(0).Header(), &input_header));
+  RET_CHECK_EQ(input_header.num_channels(), 1)
+      << "AudioFeatureCalculator only supports single channel input.";
+  input_sample_rate_ = input_header.sample_rate();
+
+  frame_duration_samples_ =
+      round(spectrogram_options.frame_duration_seconds() * input_sample_rate_);
+  frame_step_samples_ =
+      frame_duration_samples_ -
+      round(spectrogram_options.frame_overlap_seconds() * input_sample_rate_);
+  RET_CHECK_GT(frame_duration_samples_, 0);
+  RET_CHECK_GT(frame_step_samples_, 0);
+
+  output_timestamps_ = spectrogram_utils::SpectrogramTimestamps(
+      input_sample_rate_, frame_step_samples_,
+      spectrogram_options.use_local_timestamp());
+  pad_final_packet_ = spectrogram_options.pad_final_packet();
+  reset_sample_buffer_ = spectrogram_options.sample_buffer_mode() ==
+                         SpectrogramCalculatorOptions::RESET;
+  input_scale_ = spectrogram_options.input_scale();
+  output_scale_ = spectrogram_options.output_scale();
+
+  auto window_fun =
+      spectrogram_utils::MakeWindowFunction(spectrogram_options.window_type());
+  if (window_fun == nullptr) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid window type ", spectrogram_options.window_type()));
+  }
+  std::vector<double> window;
+  window_fun->GetPeriodicSamples(frame_duration_samples_, &window);
+  std::optional<int> fft_size;
+  if (spectrogram_options.fft_size() > 0) {
+    fft_size = spectrogram_options.fft_size();
+  }
+  RET_CHECK(spectrogram_.Initialize(window, frame_step_samples_, fft_size));
+  const int num_frequency_channels = spectrogram_.output_frequency_channels();
+
+  const MfccCalculatorOptions& mfcc_options = options.mfcc_options();
+  const MelSpectrumCalculatorOptions& mel_options =
+      mfcc_options.mel_spectrum_params();
+  mel_filterbank_.reset();
+  mfcc_.reset();
+  if (options.feature_type() == AudioFeatureCalculatorOptions::MFCC) {
+    mfcc_ = std::make_unique<audio_dsp::Mfcc>();
+    num_output_channels_ = mfcc_options.mfcc_count();
+    mfcc_->set_dct_coefficient_count(num_output_channels_);
+    mfcc_->set_upper_frequency_limit(mel_options.max_frequency_hertz());
+    mfcc_->set_lower_frequency_limit(mel_options.min_frequency_hertz());
+    mfcc_->set_filterbank_channel_count(mel_options.channel_count());
+    RET_CHECK(mfcc_->Initialize(num_frequency_channels, input_sample_rate_))
+        << "Mfcc::Initialize returned uninitialized";
+  } else {
+    mel_filterbank_ = std::make_unique<audio_dsp::MelFilterbank>();
+    num_output_channels_ = mel_options.channel_count();
+    RET_CHECK(mel_filterbank_->Initialize(
+        num_frequency_channels, input_sample_rate_, num_output_channels_,
+        mel_options.min_frequency_hertz(), mel_options.max_frequency_hertz()))
+        << "MelFilterbank::Initialize returned uninitialized";
+  }
+  spectrum_.resize(num_frequency_channels);
+  features_.resize(num_output_channels_);
+
+  auto output_header = std::make_unique<TimeSeriesHeader>(input_header);
+  output_header->set_audio_sample_rate(input_sample_rate_);
+  output_header->set_num_channels(num_output_channels_);
+  output_header->set_sample_rate(input_sample_rate_ / frame_step_samples_);
+  output_header->clear_packet_rate();
+  output_header->clear_num_samples();
+  cc->Outputs().Index(0).SetHeader(Adopt(output_header.release()));
+
+  if (output_timestamps_.use_local_timestamp()) {
+    cc->SetOffset(0);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status AudioFeatureCalculator::Process(CalculatorContext* cc) {
+  output_timestamps_.AddInput(cc->InputTimestamp());
+  const Matrix& input_stream = cc->Inputs().Index(0).Get<Matrix>();
+  RET_CHECK_EQ(input_stream.rows(), 1);
+  cumulative_input_samples_ += input_stream.cols();
+  return ProcessSamples(input_stream, cc);
+}
+
+absl::Status AudioFeatureCalculator::ProcessSamples(
+    const Eigen::Ref<const Matrix>& samples, CalculatorContext* cc) {
+  input_samples_.resize(samples.cols());
+  Eigen::Map<Matrix>(input_samples_.data(), 1, input_samples_.size()) =
+      samples * input_scale_;
+  if (reset_sample_buffer_) {
+    spectrogram_.ResetSampleBuffer();
+  }
+  if (!spectrogram_.ComputeSpectrogram(input_samples_, &spectrogram_frames_)) {
+    return absl::InternalError("Spectrogram returned failure");
+  }
+  const int num_frames = spectrogram_frames_.size();
+  if (num_frames == 0) {
+    return absl::OkStatus();
+  }
+
+  auto output = std::make_unique<Matrix>(num_output_channels_, num_frames);
+  for (int frame = 0; frame < num_frames; ++frame) {
+    // Rounds the spectrum to single precision as the spectrogram packets of
+    // the chained calculators do.
+    Eigen::Map<Eigen::VectorXd>(spectrum_.data(), spectrum_.size()) =
+        (output_scale_ *
+         Eigen::Map<const Eigen::VectorXf>(spectrogram_frames_[frame].data(),
+                                           spectrogram_frames_[frame].size()))
+            .cast<double>();
+    if (mfcc_ != nullptr) {
+      mfcc_->Compute(spectrum_, &features_);
+    } else {
+      mel_filterbank_->Compute(spectrum_, &features_);
+    }
+    RET_CHECK_EQ(features_.size(), num_output_channels_);
+    output->col(frame) =
+        Eigen::Map<const Eigen::VectorXd>(features_.data(), features_.size())
+            .cast<float>();
+  }
+  cc->Outputs().Index(0).Add(output.release(),
+                             output_timestamps_.Current(cc->InputTimestamp()));
+
+  output_timestamps_.AddCompletedFrames(num_frames);
+  if (!output_timestamps_.use_local_timestamp()) {
+    cc->Outputs().Index(0).SetNextTimestampBound(
+        output_timestamps_.Cumulative());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status AudioFeatureCalculator::Close(CalculatorContext* cc) {
+  if (cumulative_input_samples_ > 0 && pad_final_packet_) {
+    const int64_t required_padding_samples =
+        spectrogram_utils::FinalPaddingSamples(cumulative_input_samples_,
+                                               frame_duration_samples_,
+                                               frame_step_samples_);
+    return ProcessSamples(Matrix::Zero(1, required_padding_samples), cc);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace mediapipe
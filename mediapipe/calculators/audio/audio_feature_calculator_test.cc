@@ -0,0 +1,209 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Eigen/Core"
+#include "mediapipe/calculators/audio/audio_feature_calculator.pb.h"
+#include "mediapipe/calculators/audio/mfcc_mel_calculators.pb.h"
+#include "mediapipe/calculators/audio/spectrogram_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/matrix.h"
+#include "mediapipe/framework/formats/time_series_header.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr double kSampleRate = 16000.0;
+constexpr int64_t kInitialTimestamp = 4;
+
+CalculatorGraphConfig::Node MakeNode(const std::string& calculator) {
+  CalculatorGraphConfig::Node node;
+  node.set_calculator(calculator);
+  node.add_input_stream("input");
+  node.add_output_stream("output");
+  return node;
+}
+
+// Random waveform split into packets of `packet_sizes` samples.
+CalculatorRunner::StreamContents MakeWaveform(
+    const std::vector<int>& packet_sizes) {
+  CalculatorRunner::StreamContents waveform;
+  auto header = std::make_unique<TimeSeriesHeader>();
+  header->set_sample_rate(kSampleRate);
+  header->set_num_channels(1);
+  waveform.header = Adopt(header.release());
+  std::mt19937 rng(/*seed=*/7);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  int64_t num_samples = 0;
+  for (int packet_size : packet_sizes) {
+    auto samples = std::make_unique<Matrix>(1, packet_size);
+    for (int i = 0; i < packet_size; ++i) (*samples)(0, i) = distribution(rng);
+    waveform.packets.push_back(
+        Adopt(samples.release())
+            .At(Timestamp(kInitialTimestamp +
+                          num_samples * Timestamp::kTimestampUnitsPerSecond /
+                              kSampleRate)));
+    num_samples += packet_size;
+  }
+  return waveform;
+}
+
+CalculatorRunner::StreamContents Run(
+    const CalculatorGraphConfig::Node& node,
+    const CalculatorRunner::StreamContents& input) {
+  CalculatorRunner runner(node);
+  runner.MutableInputs()->Index(0) = input;
+  MP_EXPECT_OK(runner.Run());
+  return runner.Outputs().Index(0);
+}
+
+// Runs SpectrogramCalculator followed by MelSpectrumCalculator or
+// MfccCalculator, which AudioFeatureCalculator fuses.
+CalculatorRunner::StreamContents RunChainedCalculators(
+    const AudioFeatureCalculatorOptions& options,
+    const CalculatorRunner::StreamContents& waveform) {
+  CalculatorGraphConfig::Node spectrogram_node =
+      MakeNode("SpectrogramCalculator");
+  *spectrogram_node.mutable_options()->MutableExtension(
+      SpectrogramCalculatorOptions::ext) = options.spectrogram_options();
+  const CalculatorRunner::StreamContents spectrogram =
+      Run(spectrogram_node, waveform);
+
+  if (options.feature_type() == AudioFeatureCalculatorOptions::MFCC) {
+    CalculatorGraphConfig::Node mfcc_node = MakeNode("MfccCalculator");
+    *mfcc_node.mutable_options()->MutableExtension(
+        MfccCalculatorOptions::ext) = options.mfcc_options();
+    return Run(mfcc_node, spectrogram);
+  }
+  CalculatorGraphConfig::Node mel_node = MakeNode("MelSpectrumCalculator");
+  *mel_node.mutable_options()->MutableExtension(
+      MelSpectrumCalculatorOptions::ext) =
+      options.mfcc_options().mel_spectrum_params();
+  return Run(mel_node, spectrogram);
+}
+
+CalculatorRunner::StreamContents RunAudioFeatureCalculator(
+    const AudioFeatureCalculatorOptions& options,
+    const CalculatorRunner::StreamContents& waveform) {
+  CalculatorGraphConfig::Node node = MakeNode("AudioFeatureCalculator");
+  *node.mutable_options()->MutableExtension(
+      AudioFeatureCalculatorOptions::ext) = options;
+  return Run(node, waveform);
+}
+
+void ExpectSameFeatures(const CalculatorRunner::StreamContents& expected,
+                        const CalculatorRunner::StreamContents& actual) {
+  const auto& expected_header = expected.header.Get<TimeSeriesHeader>();
+  const auto& actual_header = actual.header.Get<TimeSeriesHeader>();
+  EXPECT_EQ(actual_header.SerializeAsString(),
+            expected_header.SerializeAsString());
+  ASSERT_EQ(actual.packets.size(), expected.packets.size());
+  ASSERT_FALSE(expected.packets.empty());
+  for (int i = 0; i < expected.packets.size(); ++i) {
+    EXPECT_EQ(actual.packets[i].Timestamp(), expected.packets[i].Timestamp());
+    const Matrix& expected_features = expected.packets[i].Get<Matrix>();
+    const Matrix& actual_features = actual.packets[i].Get<Matrix>();
+    ASSERT_EQ(actual_features.rows(), expected_features.rows());
+    ASSERT_EQ(actual_features.cols(), expected_features.cols());
+    // The fused calculator performs the same operations in the same
+    // precision as the chain, so the features are bitwise identical.
+    EXPECT_TRUE(actual_features == expected_features) << "packet " << i;
+  }
+}
+
+AudioFeatureCalculatorOptions MakeOptions(
+    AudioFeatureCalculatorOptions::FeatureType feature_type) {
+  AudioFeatureCalculatorOptions options;
+  options.set_feature_type(feature_type);
+  SpectrogramCalculatorOptions* spectrogram_options =
+      options.mutable_spectrogram_options();
+  spectrogram_options->set_frame_duration_seconds(0.025);
+  spectrogram_options->set_frame_overlap_seconds(0.015);
+  MfccCalculatorOptions* mfcc_options = options.mutable_mfcc_options();
+  mfcc_options->mutable_mel_spectrum_params()->set_channel_count(40);
+  mfcc_options->mutable_mel_spectrum_params()->set_max_frequency_hertz(7600.0);
+  mfcc_options->set_mfcc_count(13);
+  return options;
+}
+
+TEST(AudioFeatureCalculatorTest, MfccMatchesChainedCalculators) {
+  const AudioFeatureCalculatorOptions options =
+      MakeOptions(AudioFeatureCalculatorOptions::MFCC);
+  const CalculatorRunner::StreamContents waveform =
+      MakeWaveform({1600, 100, 37, 4000, 255});
+  ExpectSameFeatures(RunChainedCalculators(options, waveform),
+                     RunAudioFeatureCalculator(options, waveform));
+}
+
+TEST(AudioFeatureCalculatorTest, MelSpectrumMatchesChainedCalculators) {
+  const AudioFeatureCalculatorOptions options =
+      MakeOptions(AudioFeatureCalculatorOptions::MEL_SPECTRUM);
+  const CalculatorRunner::StreamContents waveform =
+      MakeWaveform({1600, 100, 37, 4000, 255});
+  ExpectSameFeatures(RunChainedCalculators(options, waveform),
+                     RunAudioFeatureCalculator(options, waveform));
+}
+
+TEST(AudioFeatureCalculatorTest, MatchesChainWithSpectrogramOptions) {
+  AudioFeatureCalculatorOptions options =
+      MakeOptions(AudioFeatureCalculatorOptions::MFCC);
+  SpectrogramCalculatorOptions* spectrogram_options =
+      options.mutable_spectrogram_options();
+  spectrogram_options->set_window_type(SpectrogramCalculatorOptions::HAMMING);
+  spectrogram_options->set_fft_size(1024);
+  spectrogram_options->set_input_scale(3.0);
+  spectrogram_options->set_output_scale(0.5);
+  spectrogram_options->set_use_local_timestamp(true);
+  const CalculatorRunner::StreamContents waveform =
+      MakeWaveform({1600, 100, 37, 4000, 255});
+  ExpectSameFeatures(RunChainedCalculators(options, waveform),
+                     RunAudioFeatureCalculator(options, waveform));
+}
+
+TEST(AudioFeatureCalculatorTest, MatchesChainWithResetSampleBuffer) {
+  AudioFeatureCalculatorOptions options =
+      MakeOptions(AudioFeatureCalculatorOptions::MEL_SPECTRUM);
+  options.mutable_spectrogram_options()->set_sample_buffer_mode(
+      SpectrogramCalculatorOptions::RESET);
+  options.mutable_spectrogram_options()->set_pad_final_packet(false);
+  const CalculatorRunner::StreamContents waveform =
+      MakeWaveform({1600, 800, 800, 1600});
+  ExpectSameFeatures(RunChainedCalculators(options, waveform),
+                     RunAudioFeatureCalculator(options, waveform));
+}
+
+TEST(AudioFeatureCalculatorTest, RejectsComplexSpectrogram) {
+  AudioFeatureCalculatorOptions options =
+      MakeOptions(AudioFeatureCalculatorOptions::MFCC);
+  options.mutable_spectrogram_options()->set_output_type(
+      SpectrogramCalculatorOptions::COMPLEX);
+  CalculatorGraphConfig::Node node = MakeNode("AudioFeatureCalculator");
+  *node.mutable_options()->MutableExtension(
+      AudioFeatureCalculatorOptions::ext) = options;
+  CalculatorRunner runner(node);
+  runner.MutableInputs()->Index(0) = MakeWaveform({1600});
+  EXPECT_FALSE(runner.Run().ok());
+}
+
+}  // namespace
+}  // namespace mediapipe
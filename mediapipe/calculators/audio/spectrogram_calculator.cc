@@ -15,30 +15,165 @@
 // Defines SpectrogramCalculator.
 #include <math.h>
 
+#include <algorithm>
+#include <complex>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <vector>
 
 #include "Eigen/Core"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "audio/dsp/spectrogram/spectrogram.h"
 #include "audio/dsp/window_functions.h"
 #include "mediapipe/calculators/audio/spectrogram_calculator.pb.h"
+#include "mediapipe/calculators/audio/spectrogram_utils.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/framework/port/logging.h"
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/framework/port/status_builder.h"
+#include "mediapipe/framework/port/threadpool.h"
 #include "mediapipe/util/time_series_util.h"
+#include "pffft.h"
 
 namespace mediapipe {
 
 namespace {
 constexpr char kFrameDurationTag[] = "FRAME_DURATION";
 constexpr char kFrameOverlapTag[] = "FRAME_OVERLAP";
+
+// Computes the spectrograms of all the channels of a time series with a single
+// real-FFT plan. The samples are framed like audio_dsp::Spectrogram does, from
+// a single buffer for all the channels. Frames of different channels can be
+// computed concurrently by distinct workers.
+class MultichannelSpectrogram {
+ public:
+  MultichannelSpectrogram() = default;
+  ~MultichannelSpectrogram() {
+    if (fft_setup_ != nullptr) {
+      pffft_destroy_setup(fft_setup_);
+    }
+  }
+
+  // MultichannelSpectrogram is neither copyable nor movable.
+  MultichannelSpectrogram(const MultichannelSpectrogram&) = delete;
+  MultichannelSpectrogram& operator=(const MultichannelSpectrogram&) = delete;
+
+  // Scaling the window by `input_scale` is the same as scaling the samples.
+  // `num_workers` is the number of workers that compute frames concurrently.
+  absl::Status Initialize(int num_channels, const std::vector<double>& window,
+                          int step_length, std::optional<int> fft_length,
+                          float input_scale, int num_workers) {
+    RET_CHECK(!window.empty());
+    window_length_ = window.size();
+    step_length_ = step_length;
+    RET_CHECK_GT(step_length_, 0);
+    RET_CHECK_LE(step_length_, window_length_)
+        << "use_batched_fft requires a non-negative frame overlap.";
+    fft_length_ = 1;
+    while (fft_length_ < window_length_) fft_length_ *= 2;
+    if (fft_length.has_value()) {
+      RET_CHECK_GE(*fft_length, window_length_);
+      fft_length_ = *fft_length;
+    }
+    fft_setup_ = pffft_new_setup(fft_length_, PFFFT_REAL);
+    if (fft_setup_ == nullptr) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported FFT size with use_batched_fft: ",
+                       fft_length_));
+    }
+    window_ = Eigen::Map<const Eigen::RowVectorXd>(window.data(),
+                                                   window_length_)
+                  .cast<float>() *
+              input_scale;
+    samples_.Reset(num_channels);
+    samples_.Reserve(2 * window_length_);
+    // The FFT input is zero-padded once and for all, as only its first
+    // window_length_ values are ever written.
+    worker_buffers_.assign(num_workers, AlignedBuffer(3 * fft_length_, 0.0f));
+    return absl::OkStatus();
+  }
+
+  int output_frequency_channels() const { return fft_length_ / 2 + 1; }
+
+  void ResetSampleBuffer() { samples_.Reset(samples_.num_channels()); }
+
+  void PushSamples(const Matrix& samples) { samples_.Push(samples); }
+
+  // Returns the number of complete frames in the sample buffer.
+  int num_frames() const {
+    const int num_samples = samples_.num_samples();
+    if (num_samples < window_length_) return 0;
+    return (num_samples - window_length_) / step_length_ + 1;
+  }
+
+  // Drops the samples that only belong to the first `count` frames.
+  void DropFrames(int count) { samples_.Drop(count * step_length_); }
+
+  // Computes the squared magnitude spectrum of `channel` in the `frame`-th
+  // buffered frame, using the buffers of `worker`.
+  void ComputeFrame(int channel, int frame, int worker, float* spectrum) {
+    const float* fft_output = Transform(channel, frame, worker);
+    const int num_pairs = fft_length_ / 2;
+    Eigen::Map<Eigen::RowVectorXf>(spectrum, num_pairs) =
+        Eigen::Map<const Eigen::Matrix2Xf>(fft_output, 2, num_pairs)
+            .colwise()
+            .squaredNorm();
+    // The first pair holds the real DC and Nyquist bins.
+    spectrum[0] = fft_output[0] * fft_output[0];
+    spectrum[num_pairs] = fft_output[1] * fft_output[1];
+  }
+
+  // Computes the complex spectrum of `channel` in the `frame`-th buffered
+  // frame, using the buffers of `worker`.
+  void ComputeFrame(int channel, int frame, int worker,
+                    std::complex<float>* spectrum) {
+    const float* fft_output = Transform(channel, frame, worker);
+    const int num_pairs = fft_length_ / 2;
+    spectrum[0] = std::complex<float>(fft_output[0], 0.0f);
+    spectrum[num_pairs] = std::complex<float>(fft_output[1], 0.0f);
+    // audio_dsp::Spectrogram outputs the conjugate of the forward DFT.
+    for (int i = 1; i < num_pairs; ++i) {
+      spectrum[i] =
+          std::complex<float>(fft_output[2 * i], -fft_output[2 * i + 1]);
+    }
+  }
+
+ private:
+  using AlignedBuffer = std::vector<float, Eigen::aligned_allocator<float>>;
+
+  // Returns the FFT of the windowed samples of `channel` in the `frame`-th
+  // buffered frame, ordered as [re(0), re(N/2), re(1), im(1), re(2), ...].
+  const float* Transform(int channel, int frame, int worker) {
+    // pffft only requires the buffers to be aligned, which holds for all three
+    // as the FFT size is a multiple of 32.
+    float* fft_input = worker_buffers_[worker].data();
+    float* fft_output = fft_input + fft_length_;
+    float* fft_work = fft_output + fft_length_;
+    Eigen::Map<Eigen::RowVectorXf>(fft_input, window_length_) =
+        samples_.Samples(frame * step_length_, window_length_)
+            .row(channel)
+            .cwiseProduct(window_);
+    pffft_transform_ordered(fft_setup_, fft_input, fft_output, fft_work,
+                            PFFFT_FORWARD);
+    return fft_output;
+  }
+
+  int window_length_ = 0;
+  int step_length_ = 0;
+  int fft_length_ = 0;
+  PFFFT_Setup* fft_setup_ = nullptr;
+  // The window, scaled by the input scale.
+  Eigen::RowVectorXf window_;
+  time_series_util::SampleBuffer samples_;
+  // The FFT input, output and work buffers of each worker.
+  std::vector<AlignedBuffer> worker_buffers_;
+};
 }  // namespace
 // MediaPipe Calculator for computing the "spectrogram" (short-time Fourier
 // transform squared-magnitude, by default) of a multichannel input
@@ -73,6 +208,11 @@ constexpr char kFrameOverlapTag[] = "FRAME_OVERLAP";
 // If output_layout is set to SPECTROGRAM_CHANNELS_IN_ROWS, the output will be a
 // matrix with each row being one channel of the spectrogram regardless of the
 // number of channels that need to be output.
+//
+// For microphone arrays, num_threads computes the channels in parallel, and
+// use_batched_fft frames all the channels in a single buffer and transforms
+// them with a single FFT plan, which saves the per channel copies and
+// allocations of audio_dsp::Spectrogram.
 class SpectrogramCalculator : public CalculatorBase {
  public:
   static absl::Status GetContract(CalculatorContract* cc) {
@@ -140,36 +280,6 @@ class SpectrogramCalculator : public CalculatorBase {
   absl::Status Close(CalculatorContext* cc) override;
 
  private:
-  Timestamp CurrentOutputTimestamp(CalculatorContext* cc) {
-    if (use_local_timestamp_) {
-      const Timestamp now = cc->InputTimestamp();
-      if (now == Timestamp::Done()) {
-        // During Close the timestamp is not available, send an estimate.
-        return last_local_output_timestamp_ +
-               round(last_completed_frames_ * frame_step_samples() *
-                     Timestamp::kTimestampUnitsPerSecond / input_sample_rate_);
-      }
-      last_local_output_timestamp_ = now;
-      return now;
-    }
-    return CumulativeOutputTimestamp();
-  }
-
-  Timestamp CumulativeOutputTimestamp() {
-    // Cumulative output timestamp is the *center* of the next frame to be
-    // emitted, hence delayed by half a window duration compared to relevant
-    // input timestamp.
-    return initial_input_timestamp_ +
-           round(cumulative_completed_frames_ * frame_step_samples() *
-                 Timestamp::kTimestampUnitsPerSecond / input_sample_rate_);
-  }
-
-  TimestampDiff TimeStampDurationForSamples(int64_t num_samples) {
-    return TimestampDiff(
-        round(num_samples * Timestamp::kTimestampUnitsPerSecond /
-              input_sample_rate_));
-  }
-
   int frame_step_samples() const {
     return frame_duration_samples_ - frame_overlap_samples_;
   }
@@ -188,10 +298,23 @@ class SpectrogramCalculator : public CalculatorBase {
       const OutputMatrixType postprocess_output_fn(const OutputMatrixType&),
       CalculatorContext* cc);
 
-  // Use the MediaPipe timestamp instead of the estimated one. Useful when the
+  // Computes the spectrogram frames of one channel of the input with its
+  // audio_dsp::Spectrogram object, before post-processing.
+  template <class OutputMatrixType>
+  absl::Status ComputeChannelSpectrogram(const Matrix& input_stream,
+                                         int channel,
+                                         OutputMatrixType* output_frames);
+
+  // Calls `fn(begin, end, worker)` on disjoint ranges of channels covering
+  // [0, num_channels), concurrently if num_threads is above 1. Concurrent
+  // calls get distinct workers in [0, num_threads).
+  void ParallelForChannels(int num_channels,
+                           absl::FunctionRef<void(int, int, int)> fn);
+
+  // Computes the output timestamps. With use_local_timestamp, uses the
+  // MediaPipe timestamp instead of the estimated one, which is useful when the
   // data is intermittent.
-  bool use_local_timestamp_;
-  Timestamp last_local_output_timestamp_;
+  spectrogram_utils::SpectrogramTimestamps output_timestamps_;
 
   double input_sample_rate_;
   bool pad_final_packet_;
@@ -199,12 +322,6 @@ class SpectrogramCalculator : public CalculatorBase {
   int frame_overlap_samples_;
   // How many samples we've been passed, used for checking input time stamps.
   int64_t cumulative_input_samples_;
-  // How many frames we've emitted, used for calculating output time stamps.
-  int64_t cumulative_completed_frames_;
-  // How many frames were emitted last, used for estimating the timestamp on
-  // Close when use_local_timestamp_ is true;
-  int64_t last_completed_frames_;
-  Timestamp initial_input_timestamp_;
   int num_input_channels_;
   // How many frequency bins we emit (=N_FFT/2 + 1).
   int num_output_channels_;
@@ -214,6 +331,12 @@ class SpectrogramCalculator : public CalculatorBase {
   bool allow_multichannel_input_;
   // Vector of Spectrogram objects, one for each channel.
   std::vector<std::unique_ptr<audio_dsp::Spectrogram>> spectrogram_generators_;
+  // Replaces spectrogram_generators_ if use_batched_fft is set.
+  std::unique_ptr<MultichannelSpectrogram> batched_spectrogram_;
+  // Number of threads computing the channels, including the calling one.
+  int num_threads_;
+  // Runs the channels that aren't computed by the calling thread.
+  std::unique_ptr<ThreadPool> thread_pool_;
   // Whether to reset the Spectrogram sample buffer on every call to Process.
   bool reset_sample_buffer_;
   // Fixed scale factor applied to input values.
@@ -232,23 +355,6 @@ REGISTER_CALCULATOR(SpectrogramCalculator);
 // Factor to convert ln(SQUARED_MAGNITUDE) to deciBels = 10.0/ln(10.0).
 const float SpectrogramCalculator::kLnSquaredMagnitudeToDb = 4.342944819032518;
 
-namespace {
-std::unique_ptr<audio_dsp::WindowFunction> MakeWindowFun(
-    const SpectrogramCalculatorOptions::WindowType window_type) {
-  switch (window_type) {
-    // The cosine window and square root of Hann are equivalent.
-    case SpectrogramCalculatorOptions::COSINE:
-    case SpectrogramCalculatorOptions::SQRT_HANN:
-      return std::make_unique<audio_dsp::CosineWindow>();
-    case SpectrogramCalculatorOptions::HANN:
-      return std::make_unique<audio_dsp::HannWindow>();
-    case SpectrogramCalculatorOptions::HAMMING:
-      return std::make_unique<audio_dsp::HammingWindow>();
-  }
-  return nullptr;
-}
-}  // namespace
-
 absl::Status SpectrogramCalculator::Open(CalculatorContext* cc) {
   SpectrogramCalculatorOptions spectrogram_options =
       cc->Options<SpectrogramCalculatorOptions>();
@@ -272,8 +378,6 @@ absl::Status SpectrogramCalculator::Open(CalculatorContext* cc) {
     frame_overlap_seconds = spectrogram_options.frame_overlap_seconds();
   }
 
-  use_local_timestamp_ = spectrogram_options.use_local_timestamp();
-
   if (frame_duration_seconds <= 0.0) {
     // TODO: return an error.
   }
@@ -307,7 +411,8 @@ absl::Status SpectrogramCalculator::Open(CalculatorContext* cc) {
   input_scale_ = spectrogram_options.input_scale();
   output_scale_ = spectrogram_options.output_scale();
 
-  auto window_fun = MakeWindowFun(spectrogram_options.window_type());
+  auto window_fun =
+      spectrogram_utils::MakeWindowFunction(spectrogram_options.window_type());
   if (window_fun == nullptr) {
     return absl::Status(absl::StatusCode::kInvalidArgument,
                         absl::StrCat("Invalid window type ",
@@ -323,12 +428,32 @@ absl::Status SpectrogramCalculator::Open(CalculatorContext* cc) {
     fft_size = spectrogram_options.fft_size();
   }
 
+  num_threads_ = std::max(
+      1, std::min(spectrogram_options.num_threads(), num_input_channels_));
+  thread_pool_.reset();
+  if (num_threads_ > 1) {
+    thread_pool_ = std::make_unique<ThreadPool>("SpectrogramCalculator",
+                                                num_threads_ - 1);
+    thread_pool_->StartWorkers();
+  }
+
   spectrogram_generators_.clear();
-  for (int i = 0; i < num_input_channels_; i++) {
-    spectrogram_generators_.push_back(
-        std::make_unique<audio_dsp::Spectrogram>());
-    spectrogram_generators_[i]->Initialize(window, frame_step_samples(),
-                                           fft_size);
+  batched_spectrogram_.reset();
+  if (spectrogram_options.use_batched_fft()) {
+    batched_spectrogram_ = std::make_unique<MultichannelSpectrogram>();
+    MP_RETURN_IF_ERROR(batched_spectrogram_->Initialize(
+        num_input_channels_, window, frame_step_samples(), fft_size,
+        input_scale_, num_threads_));
+    num_output_channels_ = batched_spectrogram_->output_frequency_channels();
+  } else {
+    for (int i = 0; i < num_input_channels_; i++) {
+      spectrogram_generators_.push_back(
+          std::make_unique<audio_dsp::Spectrogram>());
+      spectrogram_generators_[i]->Initialize(window, frame_step_samples(),
+                                             fft_size);
+    }
+    num_output_channels_ =
+        spectrogram_generators_[0]->output_frequency_channels();
   }
 
   switch (spectrogram_options.sample_buffer_mode()) {
@@ -343,8 +468,6 @@ absl::Status SpectrogramCalculator::Open(CalculatorContext* cc) {
                           "Unrecognized spectrogram sample buffer mode.");
   }
 
-  num_output_channels_ =
-      spectrogram_generators_[0]->output_frequency_channels();
   std::unique_ptr<TimeSeriesHeader> output_header(
       new TimeSeriesHeader(input_header));
   // Store the actual sample rate of the input audio in the TimeSeriesHeader
@@ -374,10 +497,10 @@ absl::Status SpectrogramCalculator::Open(CalculatorContext* cc) {
     cc->Outputs().Index(0).SetHeader(
         Adopt(multichannel_output_header.release()));
   }
-  cumulative_completed_frames_ = 0;
-  last_completed_frames_ = 0;
-  initial_input_timestamp_ = Timestamp::Unstarted();
-  if (use_local_timestamp_) {
+  output_timestamps_ = spectrogram_utils::SpectrogramTimestamps(
+      input_sample_rate_, frame_step_samples(),
+      spectrogram_options.use_local_timestamp());
+  if (output_timestamps_.use_local_timestamp()) {
     // Inform the framework that the calculator will output packets at the same
     // timestamps as input packets to enable packet queueing optimizations. The
     // final packet (emitted from Close()) does not follow this rule but it's
@@ -389,9 +512,7 @@ absl::Status SpectrogramCalculator::Open(CalculatorContext* cc) {
 }
 
 absl::Status SpectrogramCalculator::Process(CalculatorContext* cc) {
-  if (initial_input_timestamp_ == Timestamp::Unstarted()) {
-    initial_input_timestamp_ = cc->InputTimestamp();
-  }
+  output_timestamps_.AddInput(cc->InputTimestamp());
 
   const Matrix& input_stream = cc->Inputs().Index(0).Get<Matrix>();
   if (input_stream.rows() != num_input_channels_) {
@@ -403,64 +524,110 @@ absl::Status SpectrogramCalculator::Process(CalculatorContext* cc) {
   return ProcessVector(input_stream, cc);
 }
 
+template <class OutputMatrixType>
+absl::Status SpectrogramCalculator::ComputeChannelSpectrogram(
+    const Matrix& input_stream, int channel, OutputMatrixType* output_frames) {
+  std::vector<std::vector<typename OutputMatrixType::Scalar>> output_vectors;
+
+  // Copy one row (channel) of the input matrix into the std::vector.
+  std::vector<float> input_vector(input_stream.cols());
+  Eigen::Map<Matrix>(&input_vector[0], 1, input_vector.size()) =
+      input_stream.row(channel) * input_scale_;
+
+  if (reset_sample_buffer_) {
+    spectrogram_generators_[channel]->ResetSampleBuffer();
+  }
+  if (!spectrogram_generators_[channel]->ComputeSpectrogram(input_vector,
+                                                            &output_vectors)) {
+    return absl::Status(absl::StatusCode::kInternal,
+                        "Spectrogram returned failure");
+  }
+  // Translate the returned values into a matrix of output frames.
+  output_frames->resize(num_output_channels_, output_vectors.size());
+  for (int frame = 0; frame < output_vectors.size(); ++frame) {
+    output_frames->col(frame) = Eigen::Map<const OutputMatrixType>(
+        &output_vectors[frame][0], output_vectors[frame].size(), 1);
+  }
+  return absl::OkStatus();
+}
+
+void SpectrogramCalculator::ParallelForChannels(
+    int num_channels, absl::FunctionRef<void(int, int, int)> fn) {
+  const int num_workers = std::min(num_threads_, num_channels);
+  if (num_workers <= 1) {
+    fn(0, num_channels, /*worker=*/0);
+    return;
+  }
+  absl::BlockingCounter counter(num_workers - 1);
+  for (int worker = 1; worker < num_workers; ++worker) {
+    thread_pool_->Schedule([&fn, &counter, num_channels, num_workers, worker] {
+      fn(worker * num_channels / num_workers,
+         (worker + 1) * num_channels / num_workers, worker);
+      counter.DecrementCount();
+    });
+  }
+  // The calling thread computes the first channels.
+  fn(0, num_channels / num_workers, /*worker=*/0);
+  counter.Wait();
+}
+
 template <class OutputMatrixType>
 absl::Status SpectrogramCalculator::ProcessVectorToOutput(
     const Matrix& input_stream,
     const OutputMatrixType postprocess_output_fn(const OutputMatrixType&),
     CalculatorContext* cc) {
+  const int num_channels = input_stream.rows();
   std::unique_ptr<std::vector<OutputMatrixType>> spectrogram_matrices(
-      new std::vector<OutputMatrixType>());
-  std::vector<std::vector<typename OutputMatrixType::Scalar>> output_vectors;
+      new std::vector<OutputMatrixType>(num_channels));
 
   // Compute a spectrogram for each channel.
   int num_output_time_frames;
-  for (int channel = 0; channel < input_stream.rows(); ++channel) {
-    output_vectors.clear();
-
-    // Copy one row (channel) of the input matrix into the std::vector.
-    std::vector<float> input_vector(input_stream.cols());
-    Eigen::Map<Matrix>(&input_vector[0], 1, input_vector.size()) =
-        input_stream.row(channel) * input_scale_;
-
+  if (batched_spectrogram_ != nullptr) {
+    RET_CHECK_EQ(num_channels, num_input_channels_);
     if (reset_sample_buffer_) {
-      spectrogram_generators_[channel]->ResetSampleBuffer();
-    }
-    if (!spectrogram_generators_[channel]->ComputeSpectrogram(
-            input_vector, &output_vectors)) {
-      return absl::Status(absl::StatusCode::kInternal,
-                          "Spectrogram returned failure");
-    }
-    if (channel == 0) {
-      // Record the number of time frames we expect from each channel.
-      num_output_time_frames = output_vectors.size();
-    } else {
-      RET_CHECK_EQ(output_vectors.size(), num_output_time_frames)
-          << "Inconsistent spectrogram time frames for channel " << channel;
+      batched_spectrogram_->ResetSampleBuffer();
     }
-    // Skip remaining processing if there are too few input samples to trigger
-    // any output frames.
-    if (!output_vectors.empty()) {
-      // Translate the returned values into a matrix of output frames.
-      OutputMatrixType output_frames(num_output_channels_,
-                                     output_vectors.size());
-      for (int frame = 0; frame < output_vectors.size(); ++frame) {
-        Eigen::Map<const OutputMatrixType> frame_map(
-            &output_vectors[frame][0], output_vectors[frame].size(), 1);
-        // The underlying dsp object returns squared magnitudes; here
-        // we optionally translate to linear magnitude or dB.
-        output_frames.col(frame) =
-            output_scale_ * postprocess_output_fn(frame_map);
+    batched_spectrogram_->PushSamples(input_stream);
+    num_output_time_frames = batched_spectrogram_->num_frames();
+    ParallelForChannels(num_channels, [&](int begin, int end, int worker) {
+      for (int channel = begin; channel < end; ++channel) {
+        OutputMatrixType& output_frames = (*spectrogram_matrices)[channel];
+        output_frames.resize(num_output_channels_, num_output_time_frames);
+        for (int frame = 0; frame < num_output_time_frames; ++frame) {
+          batched_spectrogram_->ComputeFrame(channel, frame, worker,
+                                             output_frames.col(frame).data());
+        }
       }
-      spectrogram_matrices->push_back(output_frames);
+    });
+    batched_spectrogram_->DropFrames(num_output_time_frames);
+  } else {
+    std::vector<absl::Status> statuses(num_channels);
+    ParallelForChannels(num_channels, [&](int begin, int end, int worker) {
+      for (int channel = begin; channel < end; ++channel) {
+        statuses[channel] = ComputeChannelSpectrogram(
+            input_stream, channel, &(*spectrogram_matrices)[channel]);
+      }
+    });
+    for (int channel = 0; channel < num_channels; ++channel) {
+      MP_RETURN_IF_ERROR(statuses[channel]);
+      // Check the number of time frames of each channel against channel 0.
+      RET_CHECK_EQ(spectrogram_matrices->at(channel).cols(),
+                   spectrogram_matrices->at(0).cols())
+          << "Inconsistent spectrogram time frames for channel " << channel;
     }
+    num_output_time_frames = spectrogram_matrices->at(0).cols();
   }
+
   // If the input is very short, there may not be enough accumulated,
   // unprocessed samples to cause any new frames to be generated by
   // the spectrogram object.  If so, we don't want to emit
   // a packet at all.
-  if (!spectrogram_matrices->empty()) {
-    RET_CHECK_EQ(spectrogram_matrices->size(), input_stream.rows())
-        << "Inconsistent number of spectrogram channels.";
+  if (num_output_time_frames > 0) {
+    for (OutputMatrixType& output_frames : *spectrogram_matrices) {
+      // The spectrogram frames hold squared magnitudes; here we optionally
+      // translate to linear magnitude or dB.
+      output_frames = output_scale_ * postprocess_output_fn(output_frames);
+    }
 
     if (output_layout_ ==
         SpectrogramCalculatorOptions::SPECTROGRAM_CHANNELS_IN_ROWS) {
@@ -472,28 +639,30 @@ absl::Status SpectrogramCalculator::ProcessVectorToOutput(
         for (int j = 0; j < num_input_channels_; ++j) {
           output_matrix->row(j) = spectrogram_matrices->at(j).col(i);
         }
-        auto timestamp = CurrentOutputTimestamp(cc) +
-                         TimeStampDurationForSamples(i * frame_step_samples());
+        auto timestamp =
+            output_timestamps_.Current(cc->InputTimestamp()) +
+            output_timestamps_.DurationForSamples(i * frame_step_samples());
 
         cc->Outputs().Index(0).Add(output_matrix.release(), timestamp);
       }
     } else {
       if (allow_multichannel_input_) {
-        cc->Outputs().Index(0).Add(spectrogram_matrices.release(),
-                                   CurrentOutputTimestamp(cc));
+        cc->Outputs().Index(0).Add(
+            spectrogram_matrices.release(),
+            output_timestamps_.Current(cc->InputTimestamp()));
       } else {
         cc->Outputs().Index(0).Add(
             new OutputMatrixType(spectrogram_matrices->at(0)),
-            CurrentOutputTimestamp(cc));
+            output_timestamps_.Current(cc->InputTimestamp()));
       }
     }
-    cumulative_completed_frames_ += output_vectors.size();
-    last_completed_frames_ = output_vectors.size();
-    if (!use_local_timestamp_) {
+    output_timestamps_.AddCompletedFrames(num_output_time_frames);
+    if (!output_timestamps_.use_local_timestamp()) {
       // In non-local timestamp mode the timestamp of the next packet will be
-      // equal to CumulativeOutputTimestamp(). Inform the framework about this
+      // equal to the cumulative timestamp. Inform the framework about this
       // fact to enable packet queueing optimizations.
-      cc->Outputs().Index(0).SetNextTimestampBound(CumulativeOutputTimestamp());
+      cc->Outputs().Index(0).SetNextTimestampBound(
+          output_timestamps_.Cumulative());
     }
   }
   return absl::OkStatus();
@@ -548,11 +717,10 @@ absl::Status SpectrogramCalculator::Close(CalculatorContext* cc) {
     // UNLESS we have fewer than one window's worth of samples, in which case
     // we pad to exactly one frame_duration_samples.
     // Release the memory for the Spectrogram objects.
-    int required_padding_samples = frame_step_samples() - 1;
-    if (cumulative_input_samples_ < frame_duration_samples_) {
-      required_padding_samples =
-          frame_duration_samples_ - cumulative_input_samples_;
-    }
+    const int64_t required_padding_samples =
+        spectrogram_utils::FinalPaddingSamples(cumulative_input_samples_,
+                                               frame_duration_samples_,
+                                               frame_step_samples());
     return ProcessVector(
         Matrix::Zero(num_input_channels_, required_padding_samples), cc);
   }
@@ -169,6 +169,45 @@ class SpectrogramCalculatorTest
     }
   }
 
+  // Runs the graph on the input of SetupMultichannelInputPackets and returns
+  // the output packets.
+  std::vector<Packet> RunMultichannelGraph(
+      const std::vector<int>& packet_sizes_samples) {
+    InitializeGraph();
+    FillInputHeader();
+    SetupMultichannelInputPackets(packet_sizes_samples,
+                                  /*cosine_frequency_hz=*/440.0);
+    EXPECT_TRUE(Run().ok());
+    return output().packets;
+  }
+
+  // Checks that the multichannel spectrograms in `actual` match those in
+  // `expected` up to `tolerance`, relative to the largest value of each
+  // spectrogram.
+  template <class OutputMatrixType>
+  void ExpectSameSpectrograms(const std::vector<Packet>& expected,
+                              const std::vector<Packet>& actual,
+                              float tolerance) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(actual[i].Timestamp(), expected[i].Timestamp());
+      const auto& expected_matrices =
+          expected[i].Get<std::vector<OutputMatrixType>>();
+      const auto& actual_matrices =
+          actual[i].Get<std::vector<OutputMatrixType>>();
+      ASSERT_EQ(actual_matrices.size(), expected_matrices.size());
+      for (int channel = 0; channel < expected_matrices.size(); ++channel) {
+        const OutputMatrixType& expected_matrix = expected_matrices[channel];
+        const OutputMatrixType& actual_matrix = actual_matrices[channel];
+        ASSERT_EQ(actual_matrix.rows(), expected_matrix.rows());
+        ASSERT_EQ(actual_matrix.cols(), expected_matrix.cols());
+        EXPECT_LE((actual_matrix - expected_matrix).cwiseAbs().maxCoeff(),
+                  tolerance * expected_matrix.cwiseAbs().maxCoeff())
+            << "packet " << i << ", channel " << channel;
+      }
+    }
+  }
+
   // Return vector of the numbers of frames in each output packet.
   std::vector<int> OutputFramesPerPacket() {
     std::vector<int> frame_counts;
@@ -1035,6 +1074,81 @@ TEST_F(SpectrogramCalculatorTest,
   }
 }
 
+TEST_F(SpectrogramCalculatorTest, ParallelChannelsMatchSerialChannels) {
+  // Packets of less than a frame, of exactly a frame and of many frames.
+  const std::vector<int> input_packet_sizes = {50, 230, 100, 17, 400};
+  options_.set_frame_duration_seconds(100.0 / input_sample_rate_);
+  options_.set_frame_overlap_seconds(60.0 / input_sample_rate_);
+  options_.set_allow_multichannel_input(true);
+  num_input_channels_ = 7;
+  const std::vector<Packet> expected = RunMultichannelGraph(input_packet_sizes);
+
+  options_.set_num_threads(3);
+  const std::vector<Packet> actual = RunMultichannelGraph(input_packet_sizes);
+
+  ExpectSameSpectrograms<Matrix>(expected, actual, /*tolerance=*/0.0f);
+}
+
+TEST_F(SpectrogramCalculatorTest, BatchedFftMatchesSpectrogram) {
+  const std::vector<int> input_packet_sizes = {50, 230, 100, 17, 400};
+  options_.set_frame_duration_seconds(100.0 / input_sample_rate_);
+  options_.set_frame_overlap_seconds(60.0 / input_sample_rate_);
+  options_.set_allow_multichannel_input(true);
+  options_.set_input_scale(2.0);
+  num_input_channels_ = 7;
+  const std::vector<Packet> expected = RunMultichannelGraph(input_packet_sizes);
+
+  options_.set_use_batched_fft(true);
+  const std::vector<Packet> actual = RunMultichannelGraph(input_packet_sizes);
+
+  CheckOutputHeadersAndTimestamps();
+  ExpectSameSpectrograms<Matrix>(expected, actual, /*tolerance=*/1e-5f);
+}
+
+TEST_F(SpectrogramCalculatorTest, ParallelBatchedComplexFftMatchesSpectrogram) {
+  const std::vector<int> input_packet_sizes = {50, 230, 100, 17, 400};
+  options_.set_frame_duration_seconds(100.0 / input_sample_rate_);
+  options_.set_frame_overlap_seconds(60.0 / input_sample_rate_);
+  options_.set_allow_multichannel_input(true);
+  options_.set_output_type(SpectrogramCalculatorOptions::COMPLEX);
+  options_.set_fft_size(256);
+  num_input_channels_ = 7;
+  const std::vector<Packet> expected = RunMultichannelGraph(input_packet_sizes);
+
+  options_.set_use_batched_fft(true);
+  options_.set_num_threads(3);
+  const std::vector<Packet> actual = RunMultichannelGraph(input_packet_sizes);
+
+  ExpectSameSpectrograms<Eigen::MatrixXcf>(expected, actual,
+                                           /*tolerance=*/1e-5f);
+}
+
+TEST_F(SpectrogramCalculatorTest, BatchedFftSampleBufferModeReset) {
+  const std::vector<int> input_packet_sizes = {150, 230, 100, 17, 400};
+  options_.set_frame_duration_seconds(100.0 / input_sample_rate_);
+  options_.set_frame_overlap_seconds(60.0 / input_sample_rate_);
+  options_.set_allow_multichannel_input(true);
+  options_.set_sample_buffer_mode(SpectrogramCalculatorOptions::RESET);
+  options_.set_pad_final_packet(false);
+  num_input_channels_ = 2;
+  const std::vector<Packet> expected = RunMultichannelGraph(input_packet_sizes);
+
+  options_.set_use_batched_fft(true);
+  const std::vector<Packet> actual = RunMultichannelGraph(input_packet_sizes);
+
+  ExpectSameSpectrograms<Matrix>(expected, actual, /*tolerance=*/1e-5f);
+}
+
+TEST_F(SpectrogramCalculatorTest, BatchedFftRejectsUnsupportedFftSize) {
+  // 10 samples are transformed with a 16-point FFT.
+  options_.set_frame_duration_seconds(10.0 / input_sample_rate_);
+  options_.set_use_batched_fft(true);
+  InitializeGraph();
+  FillInputHeader();
+  SetupConstantInputPackets({100});
+  EXPECT_EQ(Run().code(), absl::StatusCode::kInvalidArgument);
+}
+
 void BM_ProcessDC(benchmark::State& state) {
   CalculatorGraphConfig::Node node_config;
   node_config.set_calculator("SpectrogramCalculator");
@@ -1080,5 +1194,51 @@ void BM_ProcessDC(benchmark::State& state) {
 
 BENCHMARK(BM_ProcessDC);
 
+// Computes the spectrograms of state.range(0) channels with the per channel
+// spectrograms (state.range(1) == 0), the batched FFT (1), or the batched FFT
+// on 4 threads (2).
+void BM_ProcessMultichannel(benchmark::State& state) {
+  const int num_input_channels = state.range(0);
+  CalculatorGraphConfig::Node node_config;
+  node_config.set_calculator("SpectrogramCalculator");
+  node_config.add_input_stream("input_audio");
+  node_config.add_output_stream("output_spectrogram");
+
+  SpectrogramCalculatorOptions* options =
+      node_config.mutable_options()->MutableExtension(
+          SpectrogramCalculatorOptions::ext);
+  options->set_frame_duration_seconds(0.025);
+  options->set_frame_overlap_seconds(0.015);
+  options->set_pad_final_packet(false);
+  options->set_allow_multichannel_input(true);
+  options->set_use_batched_fft(state.range(1) > 0);
+  options->set_num_threads(state.range(1) > 1 ? 4 : 1);
+
+  // One second of audio per packet.
+  const int packet_size_samples = 16000;
+  const int num_packets = 10;
+  TimeSeriesHeader* header = new TimeSeriesHeader();
+  header->set_sample_rate(16000.0);
+  header->set_num_channels(num_input_channels);
+
+  CalculatorRunner runner(node_config);
+  runner.MutableInputs()->Index(0).header = Adopt(header);
+  for (int i = 0; i < num_packets; ++i) {
+    Matrix* payload =
+        new Matrix(Matrix::Random(num_input_channels, packet_size_samples));
+    runner.MutableInputs()->Index(0).packets.push_back(
+        Adopt(payload).At(Timestamp(i * Timestamp::kTimestampUnitsPerSecond)));
+  }
+
+  for (auto _ : state) {
+    ASSERT_TRUE(runner.Run().ok());
+  }
+  state.SetItemsProcessed(state.iterations() * num_packets *
+                          packet_size_samples * num_input_channels);
+}
+BENCHMARK(BM_ProcessMultichannel)
+    ->ArgsProduct({{1, 8, 16}, {0, 1, 2}})
+    ->UseRealTime();
+
 }  // anonymous namespace
 }  // namespace mediapipe
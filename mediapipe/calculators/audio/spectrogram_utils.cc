@@ -0,0 +1,73 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/audio/spectrogram_utils.h"
+
+#include <math.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "audio/dsp/window_functions.h"
+#include "mediapipe/calculators/audio/spectrogram_calculator.pb.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+namespace spectrogram_utils {
+
+std::unique_ptr<audio_dsp::WindowFunction> MakeWindowFunction(
+    SpectrogramCalculatorOptions::WindowType window_type) {
+  switch (window_type) {
+    // The cosine window and square root of Hann are equivalent.
+    case SpectrogramCalculatorOptions::COSINE:
+    case SpectrogramCalculatorOptions::SQRT_HANN:
+      return std::make_unique<audio_dsp::CosineWindow>();
+    case SpectrogramCalculatorOptions::HANN:
+      return std::make_unique<audio_dsp::HannWindow>();
+    case SpectrogramCalculatorOptions::HAMMING:
+      return std::make_unique<audio_dsp::HammingWindow>();
+  }
+  return nullptr;
+}
+
+int64_t FinalPaddingSamples(int64_t cumulative_input_samples,
+                            int frame_duration_samples,
+                            int frame_step_samples) {
+  if (cumulative_input_samples < frame_duration_samples) {
+    return frame_duration_samples - cumulative_input_samples;
+  }
+  return frame_step_samples - 1;
+}
+
+Timestamp SpectrogramTimestamps::Current(Timestamp input_timestamp) {
+  if (!use_local_timestamp_) {
+    return Cumulative();
+  }
+  if (input_timestamp == Timestamp::Done()) {
+    // During Close the timestamp is not available, send an estimate.
+    return last_local_output_timestamp_ +
+           DurationForSamples(last_completed_frames_ * frame_step_samples_);
+  }
+  last_local_output_timestamp_ = input_timestamp;
+  return input_timestamp;
+}
+
+TimestampDiff SpectrogramTimestamps::DurationForSamples(
+    int64_t num_samples) const {
+  return TimestampDiff(
+      round(num_samples * Timestamp::kTimestampUnitsPerSecond / sample_rate_));
+}
+
+}  // namespace spectrogram_utils
+}  // namespace mediapipe
@@ -0,0 +1,104 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Framing helpers shared by the calculators computing spectrogram frames, so
+// that they output the same frames at the same timestamps.
+
+#ifndef MEDIAPIPE_CALCULATORS_AUDIO_SPECTROGRAM_UTILS_H_
+#define MEDIAPIPE_CALCULATORS_AUDIO_SPECTROGRAM_UTILS_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "audio/dsp/window_functions.h"
+#include "mediapipe/calculators/audio/spectrogram_calculator.pb.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+namespace spectrogram_utils {
+
+// Returns the window function of `window_type`, or nullptr if the type is not
+// supported.
+std::unique_ptr<audio_dsp::WindowFunction> MakeWindowFunction(
+    SpectrogramCalculatorOptions::WindowType window_type);
+
+// Returns the number of zero samples to process in Close to flush the frames
+// still buffered when pad_final_packet is set: frame_step_samples - 1, unless
+// fewer than one frame of samples was received, in which case the input is
+// padded to exactly one frame.
+int64_t FinalPaddingSamples(int64_t cumulative_input_samples,
+                            int frame_duration_samples,
+                            int frame_step_samples);
+
+// Computes the timestamps of the packets of spectrogram frames.
+//
+// By default, a packet is output at the center of its first frame, counted
+// from the first input timestamp. With use_local_timestamp, a packet is output
+// at the timestamp of the input packet completing its frames, and the packet
+// output in Close is estimated from the previous one.
+class SpectrogramTimestamps {
+ public:
+  SpectrogramTimestamps() = default;
+  SpectrogramTimestamps(double sample_rate, int frame_step_samples,
+                        bool use_local_timestamp)
+      : sample_rate_(sample_rate),
+        frame_step_samples_(frame_step_samples),
+        use_local_timestamp_(use_local_timestamp) {}
+
+  // Must be called with the timestamp of every input packet.
+  void AddInput(Timestamp input_timestamp) {
+    if (initial_input_timestamp_ == Timestamp::Unstarted()) {
+      initial_input_timestamp_ = input_timestamp;
+    }
+  }
+
+  // Returns the timestamp of the packet holding the next frames. In Close,
+  // `input_timestamp` is Timestamp::Done().
+  Timestamp Current(Timestamp input_timestamp);
+
+  // Returns the timestamp of the next frame to be output, counted from the
+  // first input timestamp.
+  Timestamp Cumulative() const {
+    return initial_input_timestamp_ +
+           DurationForSamples(cumulative_completed_frames_ *
+                              frame_step_samples_);
+  }
+
+  // Records that a packet of `num_frames` frames was output.
+  void AddCompletedFrames(int64_t num_frames) {
+    cumulative_completed_frames_ += num_frames;
+    last_completed_frames_ = num_frames;
+  }
+
+  // Returns the duration of `num_samples` samples.
+  TimestampDiff DurationForSamples(int64_t num_samples) const;
+
+  bool use_local_timestamp() const { return use_local_timestamp_; }
+
+ private:
+  double sample_rate_ = 0.0;
+  int frame_step_samples_ = 0;
+  bool use_local_timestamp_ = false;
+  Timestamp initial_input_timestamp_ = Timestamp::Unstarted();
+  Timestamp last_local_output_timestamp_;
+  // How many frames were output, for the cumulative timestamps.
+  int64_t cumulative_completed_frames_ = 0;
+  // How many frames were output last, for the estimate in Close.
+  int64_t last_completed_frames_ = 0;
+};
+
+}  // namespace spectrogram_utils
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_AUDIO_SPECTROGRAM_UTILS_H_
@@ -15,6 +15,8 @@
 // Defines TimeSeriesFramerCalculator.
 #include <math.h>
 
+#include <algorithm>
+#include <deque>
 #include <vector>
 
 #include "Eigen/Core"
@@ -128,21 +130,25 @@ class TimeSeriesFramerCalculator : public CalculatorBase {
   // The current timestamp is updated along with the incoming packets.
   Timestamp current_timestamp_;
 
-  // Samples are buffered in a vector of sample blocks.
+  // Samples are buffered contiguously, along with the timestamps of the
+  // blocks of samples they came in.
   class SampleBlockBuffer {
    public:
     // Initializes the buffer.
     void Init(double sample_rate, int num_channels) {
       ts_units_per_sample_ = Timestamp::kTimestampUnitsPerSecond / sample_rate;
-      num_channels_ = num_channels;
-      num_samples_ = 0;
+      samples_.Reset(num_channels);
+      blocks_.clear();
       first_block_offset_ = 0;
     }
 
+    // Allocates room for `num_samples` samples up front.
+    void Reserve(int num_samples) { samples_.Reserve(num_samples); }
+
     // Number of channels, equal to the number of rows in each Matrix.
-    int num_channels() const { return num_channels_; }
+    int num_channels() const { return samples_.num_channels(); }
     // Total number of available samples over all blocks.
-    int num_samples() const { return num_samples_; }
+    int num_samples() const { return samples_.num_samples(); }
 
     // Pushes a new block of samples on the back of the buffer with `timestamp`
     // being the input timestamp of the packet containing the Matrix.
@@ -160,27 +166,18 @@ class TimeSeriesFramerCalculator : public CalculatorBase {
 
    private:
     struct Block {
-      // Matrix of num_channels rows by num_samples columns, a block of possibly
-      // multiple samples.
-      Matrix samples;
+      // Number of samples in the block.
+      int num_samples;
       // Timestamp of the first sample in the Block. This comes from the input
       // packet's timestamp that contains this Matrix.
       Timestamp timestamp;
-
-      Block() : timestamp(Timestamp::Unstarted()) {}
-      Block(const Matrix& samples, Timestamp timestamp)
-          : samples(samples), timestamp(timestamp) {}
-      int num_samples() const { return samples.cols(); }
     };
-    std::vector<Block> blocks_;
+    // The samples of all blocks, without the discarded ones.
+    time_series_util::SampleBuffer samples_;
+    std::deque<Block> blocks_;
     // Number of timestamp units per sample. Used to compute timestamps as
     // nth sample timestamp = base_timestamp + round(ts_units_per_sample_ * n).
     double ts_units_per_sample_;
-    // Number of rows in each Matrix.
-    int num_channels_;
-    // The total number of samples over all blocks, equal to
-    // (sum_i blocks_[i].num_samples()) - first_block_offset_.
-    int num_samples_;
     // The number of samples in the first block that have been discarded. This
     // way we can cheaply represent "partially discarding" a block.
     int first_block_offset_;
@@ -195,28 +192,25 @@ REGISTER_CALCULATOR(TimeSeriesFramerCalculator);
 
 void TimeSeriesFramerCalculator::SampleBlockBuffer::Push(const Matrix& samples,
                                                          Timestamp timestamp) {
-  num_samples_ += samples.cols();
-  blocks_.emplace_back(samples, timestamp);
+  samples_.Push(samples);
+  blocks_.push_back({static_cast<int>(samples.cols()), timestamp});
 }
 
 Matrix TimeSeriesFramerCalculator::SampleBlockBuffer::CopySamples(
     int count, Timestamp* last_timestamp) const {
-  Matrix copied(num_channels_, count);
+  const int num_copied = std::min(count, num_samples());
+  Matrix copied(num_channels(), count);
+  copied.leftCols(num_copied) = samples_.Samples(0, num_copied);
 
   if (!blocks_.empty()) {
-    int num_copied = 0;
     // First block has an offset for samples that have been discarded.
     int offset = first_block_offset_;
-    int n;
     Timestamp last_block_ts;
     int last_sample_index;
 
     for (auto it = blocks_.begin(); it != blocks_.end() && count > 0; ++it) {
-      n = std::min(it->num_samples() - offset, count);
-      // Copy `n` samples from the next block.
-      copied.middleCols(num_copied, n) = it->samples.middleCols(offset, n);
+      const int n = std::min(it->num_samples - offset, count);
       count -= n;
-      num_copied += n;
       last_block_ts = it->timestamp;
       last_sample_index = offset + n - 1;
       offset = 0;  // No samples have been discarded in subsequent blocks.
@@ -227,45 +221,24 @@ Matrix TimeSeriesFramerCalculator::SampleBlockBuffer::CopySamples(
         last_block_ts + std::round(ts_units_per_sample_ * last_sample_index);
   }
 
-  if (count > 0) {
-    copied.rightCols(count).setZero();  // Zero pad if needed.
+  if (num_copied < copied.cols()) {
+    copied.rightCols(copied.cols() - num_copied).setZero();  // Zero pad.
   }
 
   return copied;
 }
 
 int TimeSeriesFramerCalculator::SampleBlockBuffer::DropSamples(int count) {
-  if (blocks_.empty()) {
-    return 0;
-  }
-
-  auto block_it = blocks_.begin();
-  if (first_block_offset_ + count < block_it->num_samples()) {
-    // `count` is less than the remaining samples in the first block.
-    first_block_offset_ += count;
-    num_samples_ -= count;
-    return count;
+  const int num_samples_dropped = samples_.Drop(count);
+  // Drops the blocks whose samples were all dropped.
+  int remaining = num_samples_dropped;
+  while (!blocks_.empty() &&
+         first_block_offset_ + remaining >= blocks_.front().num_samples) {
+    remaining -= blocks_.front().num_samples - first_block_offset_;
+    first_block_offset_ = 0;
+    blocks_.pop_front();
   }
-
-  int num_samples_dropped = block_it->num_samples() - first_block_offset_;
-  count -= num_samples_dropped;
-  first_block_offset_ = 0;
-
-  for (++block_it; block_it != blocks_.end(); ++block_it) {
-    if (block_it->num_samples() > count) {
-      break;
-    }
-    num_samples_dropped += block_it->num_samples();
-    count -= block_it->num_samples();
-  }
-
-  blocks_.erase(blocks_.begin(), block_it);  // Drop whole blocks.
-  if (!blocks_.empty()) {
-    first_block_offset_ = count;  // Drop part of the next block.
-    num_samples_dropped += count;
-  }
-
-  num_samples_ -= num_samples_dropped;
+  first_block_offset_ += remaining;
   return num_samples_dropped;
 }
 
@@ -345,6 +318,8 @@ absl::Status TimeSeriesFramerCalculator::Open(CalculatorContext* cc) {
   RET_CHECK_GT(frame_duration_samples_, 0)
       << "Frame duration of " << framer_options.frame_duration_seconds()
       << "s too small to cover a single sample at " << sample_rate_ << " Hz ";
+  // Leaves room for a frame and an input packet of up to a frame of samples.
+  sample_buffer_.Reserve(2 * frame_duration_samples_);
   if (framer_options.emulate_fractional_frame_overlap()) {
     // Frame step may be fractional.
     average_frame_step_samples_ = (framer_options.frame_duration_seconds() -
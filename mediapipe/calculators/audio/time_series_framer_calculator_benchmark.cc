@@ -12,7 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
-// Benchmark for TimeSeriesFramerCalculator.
+// Benchmark for TimeSeriesFramerCalculator and AudioToTensorCalculator.
 #include <memory>
 #include <random>
 #include <vector>
@@ -20,6 +20,7 @@
 #include "absl/log/absl_check.h"
 #include "benchmark/benchmark.h"
 #include "mediapipe/calculators/audio/time_series_framer_calculator.pb.h"
+#include "mediapipe/calculators/tensor/audio_to_tensor_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/framework/formats/time_series_header.pb.h"
@@ -27,10 +28,13 @@
 
 using ::mediapipe::Matrix;
 
-void BM_TimeSeriesFramerCalculator(benchmark::State& state) {
-  constexpr float kSampleRate = 32000.0;
-  constexpr int kNumChannels = 2;
-  constexpr int kFrameDurationSeconds = 5.0;
+constexpr float kSampleRate = 32000.0;
+constexpr int kNumChannels = 2;
+
+// Runs `config`, whose "input" stream takes blocks of samples, on 32 random
+// blocks of around a half second's worth of samples each.
+void RunSampleStreamBenchmark(const mediapipe::CalculatorGraphConfig& config,
+                              benchmark::State& state) {
   std::mt19937 rng(0 /*seed*/);
   // Input around a half second's worth of samples at a time.
   std::uniform_int_distribution<int> input_size_dist(15000, 17000);
@@ -42,18 +46,6 @@ void BM_TimeSeriesFramerCalculator(benchmark::State& state) {
   }
   std::uniform_int_distribution<int> pool_index_dist(0, sample_pool.size() - 1);
 
-  mediapipe::CalculatorGraphConfig config;
-  config.add_input_stream("input");
-  config.add_output_stream("output");
-  auto* node = config.add_node();
-  node->set_calculator("TimeSeriesFramerCalculator");
-  node->add_input_stream("input");
-  node->add_output_stream("output");
-  mediapipe::TimeSeriesFramerCalculatorOptions* options =
-      node->mutable_options()->MutableExtension(
-          mediapipe::TimeSeriesFramerCalculatorOptions::ext);
-  options->set_frame_duration_seconds(kFrameDurationSeconds);
-
   for (auto _ : state) {
     state.PauseTiming();  // Pause benchmark timing.
 
@@ -88,6 +80,43 @@ void BM_TimeSeriesFramerCalculator(benchmark::State& state) {
     ABSL_CHECK_OK(graph.WaitUntilIdle());
   }
 }
+
+void BM_TimeSeriesFramerCalculator(benchmark::State& state) {
+  constexpr int kFrameDurationSeconds = 5.0;
+  mediapipe::CalculatorGraphConfig config;
+  config.add_input_stream("input");
+  config.add_output_stream("output");
+  auto* node = config.add_node();
+  node->set_calculator("TimeSeriesFramerCalculator");
+  node->add_input_stream("input");
+  node->add_output_stream("output");
+  mediapipe::TimeSeriesFramerCalculatorOptions* options =
+      node->mutable_options()->MutableExtension(
+          mediapipe::TimeSeriesFramerCalculatorOptions::ext);
+  options->set_frame_duration_seconds(kFrameDurationSeconds);
+  RunSampleStreamBenchmark(config, state);
+}
 BENCHMARK(BM_TimeSeriesFramerCalculator);
 
+// Frames the samples into overlapping one second tensors in stream mode,
+// without resampling.
+void BM_AudioToTensorCalculator(benchmark::State& state) {
+  mediapipe::CalculatorGraphConfig config;
+  config.add_input_stream("input");
+  config.add_output_stream("output");
+  auto* node = config.add_node();
+  node->set_calculator("AudioToTensorCalculator");
+  node->add_input_stream("AUDIO:input");
+  node->add_output_stream("TENSORS:output");
+  mediapipe::AudioToTensorCalculatorOptions* options =
+      node->mutable_options()->MutableExtension(
+          mediapipe::AudioToTensorCalculatorOptions::ext);
+  options->set_num_channels(kNumChannels);
+  options->set_num_samples(kSampleRate);
+  options->set_num_overlapping_samples(kSampleRate / 2);
+  options->set_target_sample_rate(kSampleRate);
+  RunSampleStreamBenchmark(config, state);
+}
+BENCHMARK(BM_AudioToTensorCalculator);
+
 BENCHMARK_MAIN();
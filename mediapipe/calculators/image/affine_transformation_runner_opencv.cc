@@ -19,11 +19,13 @@
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
 #include "mediapipe/calculators/image/affine_transformation.h"
+#include "mediapipe/calculators/image/image_tiling_opencv.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 
 namespace mediapipe {
 
@@ -52,8 +54,10 @@ int GetInterpolationForOpenCv(
 class OpenCvRunner
     : public AffineTransformation::Runner<ImageFrame, ImageFrame> {
  public:
-  OpenCvRunner(AffineTransformation::Interpolation interpolation)
-      : interpolation_(GetInterpolationForOpenCv(interpolation)) {}
+  OpenCvRunner(AffineTransformation::Interpolation interpolation,
+               ThreadPoolExecutor* tile_executor)
+      : interpolation_(GetInterpolationForOpenCv(interpolation)),
+        tile_executor_(tile_executor) {}
 
   absl::StatusOr<ImageFrame> Run(
       const ImageFrame& input, const std::array<float, 16>& matrix,
@@ -153,16 +157,25 @@ class OpenCvRunner
     ImageFrame out_image(input.Format(), size.width, size.height);
     cv::Mat out_mat = formats::MatView(&out_image);
 
-    cv::warpAffine(in_mat, out_mat, cv_affine_transform,
-                   cv::Size(out_mat.cols, out_mat.rows),
-                   /*flags=*/interpolation_ | cv::WARP_INVERSE_MAP,
-                   GetBorderModeForOpenCv(border_mode));
+    if (tile_executor_ != nullptr) {
+      WarpAffineInTiles(in_mat, cv_affine_transform,
+                        /*flags=*/interpolation_ | cv::WARP_INVERSE_MAP,
+                        GetBorderModeForOpenCv(border_mode), cv::Scalar(),
+                        /*flip_horizontally=*/false,
+                        /*flip_vertically=*/false, tile_executor_, out_mat);
+    } else {
+      cv::warpAffine(in_mat, out_mat, cv_affine_transform,
+                     cv::Size(out_mat.cols, out_mat.rows),
+                     /*flags=*/interpolation_ | cv::WARP_INVERSE_MAP,
+                     GetBorderModeForOpenCv(border_mode));
+    }
 
     return out_image;
   }
 
  private:
   int interpolation_ = cv::INTER_LINEAR;
+  ThreadPoolExecutor* tile_executor_ = nullptr;
 };
 
 }  // namespace
@@ -170,8 +183,9 @@ class OpenCvRunner
 absl::StatusOr<
     std::unique_ptr<AffineTransformation::Runner<ImageFrame, ImageFrame>>>
 CreateAffineTransformationOpenCvRunner(
-    AffineTransformation::Interpolation interpolation) {
-  return absl::make_unique<OpenCvRunner>(interpolation);
+    AffineTransformation::Interpolation interpolation,
+    ThreadPoolExecutor* tile_executor) {
+  return absl::make_unique<OpenCvRunner>(interpolation, tile_executor);
 }
 
 }  // namespace mediapipe
@@ -20,13 +20,18 @@
 #include "absl/status/statusor.h"
 #include "mediapipe/calculators/image/affine_transformation.h"
 #include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 
 namespace mediapipe {
 
+// Creates a runner warping with cv::warpAffine. If "tile_executor" is not
+// null, the runner splits the output into row tiles processed on it, with
+// identical results.
 absl::StatusOr<
     std::unique_ptr<AffineTransformation::Runner<ImageFrame, ImageFrame>>>
 CreateAffineTransformationOpenCvRunner(
-    AffineTransformation::Interpolation interpolation);
+    AffineTransformation::Interpolation interpolation,
+    ThreadPoolExecutor* tile_executor = nullptr);
 
 }  // namespace mediapipe
 
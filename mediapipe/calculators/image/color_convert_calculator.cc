@@ -13,11 +13,14 @@
 // limitations under the License.
 
 #include <cstdint>
+#include <memory>
 
 #include "absl/log/absl_check.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/image_multi_pool.h"
+#include "mediapipe/framework/formats/image_multi_pool_service.h"
 #include "mediapipe/framework/port/logging.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/ret_check.h"
@@ -88,6 +91,9 @@ class ColorConvertCalculator : public CalculatorBase {
 
   absl::Status Open(CalculatorContext* cc) override {
     cc->SetOffset(TimestampDiff(0));
+    if (cc->Service(kImageMultiPoolService).IsAvailable()) {
+      image_pool_ = &cc->Service(kImageMultiPoolService).GetObject();
+    }
     return absl::OkStatus();
   }
 
@@ -101,6 +107,9 @@ class ColorConvertCalculator : public CalculatorBase {
                                 ImageFormat::Format output_format,
                                 int open_cv_convert_code,
                                 CalculatorContext* cc);
+
+  // Pool for the output frames, if the graph provides one.
+  ImageMultiPool* image_pool_ = nullptr;
 };
 
 REGISTER_CALCULATOR(ColorConvertCalculator);
@@ -147,6 +156,7 @@ absl::Status ColorConvertCalculator::GetContract(CalculatorContract* cc) {
     cc->Outputs().Tag(kBgraOutTag).Set<ImageFrame>();
   }
 
+  cc->UseService(kImageMultiPoolService).Optional();
   return absl::OkStatus();
 }
 
@@ -156,8 +166,8 @@ absl::Status ColorConvertCalculator::ConvertAndOutput(
     CalculatorContext* cc) {
   const cv::Mat& input_mat =
       formats::MatView(&cc->Inputs().Tag(input_tag).Get<ImageFrame>());
-  std::unique_ptr<ImageFrame> output_frame(
-      new ImageFrame(output_format, input_mat.cols, input_mat.rows));
+  std::unique_ptr<ImageFrame> output_frame =
+      NewImageFrame(image_pool_, output_format, input_mat.cols, input_mat.rows);
   cv::Mat output_mat = formats::MatView(output_frame.get());
   cv::cvtColor(input_mat, output_mat, open_cv_convert_code);
 
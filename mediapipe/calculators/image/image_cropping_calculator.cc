@@ -15,10 +15,12 @@
 #include "mediapipe/calculators/image/image_cropping_calculator.h"
 
 #include <cmath>
+#include <memory>
 
 #include "absl/log/absl_log.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/image_multi_pool_service.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
@@ -66,6 +68,7 @@ absl::Status ImageCroppingCalculator::GetContract(CalculatorContract* cc) {
     RET_CHECK(cc->Outputs().HasTag(kImageTag));
     cc->Inputs().Tag(kImageTag).Set<ImageFrame>();
     cc->Outputs().Tag(kImageTag).Set<ImageFrame>();
+    cc->UseService(kImageMultiPoolService).Optional();
   }
 #if !MEDIAPIPE_DISABLE_GPU
   if (cc->Inputs().HasTag(kImageGpuTag)) {
@@ -125,6 +128,8 @@ absl::Status ImageCroppingCalculator::Open(CalculatorContext* cc) {
 
   if (cc->Inputs().HasTag(kImageGpuTag)) {
     use_gpu_ = true;
+  } else if (cc->Service(kImageMultiPoolService).IsAvailable()) {
+    image_pool_ = &cc->Service(kImageMultiPoolService).GetObject();
   }
 
   options_ = cc->Options<mediapipe::ImageCroppingCalculatorOptions>();
@@ -267,16 +272,15 @@ absl::Status ImageCroppingCalculator::RenderCpu(CalculatorContext* cc) {
   const cv::Mat shift_dst = cv::Mat(3, 3, CV_64F, shift_dst_vec);
   const cv::Mat adjusted_projection_matrix =
       shift_dst * projection_matrix * shift_src;
-  cv::Mat cropped_image;
-  cv::warpPerspective(input_mat, cropped_image, adjusted_projection_matrix,
-                      cv::Size(output_width, output_height),
+  const cv::Size output_size(output_width, output_height);
+  std::unique_ptr<ImageFrame> output_frame = NewImageFrame(
+      image_pool_, input_img.Format(), output_size.width, output_size.height);
+  // Warps directly into the output frame.
+  cv::Mat output_mat = formats::MatView(output_frame.get());
+  cv::warpPerspective(input_mat, output_mat, adjusted_projection_matrix,
+                      output_size,
                       /* flags = */ 0,
                       /* borderMode = */ border_mode);
-
-  std::unique_ptr<ImageFrame> output_frame(new ImageFrame(
-      input_img.Format(), cropped_image.cols, cropped_image.rows));
-  cv::Mat output_mat = formats::MatView(output_frame.get());
-  cropped_image.copyTo(output_mat);
   cc->Outputs().Tag(kImageTag).Add(output_frame.release(),
                                    cc->InputTimestamp());
   return absl::OkStatus();
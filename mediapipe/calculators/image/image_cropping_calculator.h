@@ -5,6 +5,7 @@
 
 #include "mediapipe/calculators/image/image_cropping_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_multi_pool.h"
 
 #if !MEDIAPIPE_DISABLE_GPU
 #include "mediapipe/gpu/gl_calculator_helper.h"
@@ -79,6 +80,8 @@ class ImageCroppingCalculator : public CalculatorBase {
   mediapipe::ImageCroppingCalculatorOptions options_;
 
   bool use_gpu_ = false;
+  // Pool for the CPU output frames, if the graph provides one.
+  ImageMultiPool* image_pool_ = nullptr;
   // Output texture corners (4) after transformation in normalized coordinates.
   float transformed_points_[8];
   float output_max_width_ = FLT_MAX;
@@ -0,0 +1,353 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/image/image_tiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/log/absl_check.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+
+namespace mediapipe {
+
+namespace {
+
+// Number of tiles per executor thread that the rows are split into, so that
+// threads that are busy with other tasks of the executor don't delay the loop.
+constexpr int kTilesPerThread = 4;
+
+// The tiles of a ForEachRowTile loop.
+class TileLoop {
+ public:
+  explicit TileLoop(int num_tiles)
+      : num_tiles_(num_tiles), unfinished_tiles_(num_tiles) {}
+
+  // Claims the next tile to process. Returns false if all tiles were claimed.
+  bool ClaimTile(int* tile) {
+    *tile = next_tile_.fetch_add(1, std::memory_order_relaxed);
+    return *tile < num_tiles_;
+  }
+
+  // Marks a claimed tile as processed.
+  void FinishTile() {
+    absl::MutexLock lock(&mutex_);
+    --unfinished_tiles_;
+  }
+
+  // Waits for all the tiles to be processed.
+  void WaitForTiles() {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(
+        +[](int* unfinished_tiles) { return *unfinished_tiles == 0; },
+        &unfinished_tiles_));
+  }
+
+ private:
+  const int num_tiles_;
+  std::atomic<int> next_tile_{0};
+  absl::Mutex mutex_;
+  int unfinished_tiles_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Coordinate of padding pixels in PixelGather.
+constexpr int kPadding = -1;
+
+// Returns the coordinates of "coordinates" scaled to "size" entries as
+// cv::resize with cv::INTER_NEAREST, which samples the source at
+// floor(x / scale).
+std::vector<int> ScaleCoordinates(const std::vector<int>& coordinates,
+                                  int size) {
+  const int source_size = coordinates.size();
+  const double inverse_scale = 1.0 / (static_cast<double>(size) / source_size);
+  std::vector<int> scaled(size);
+  for (int i = 0; i < size; ++i) {
+    const int source_index = std::floor(i * inverse_scale);
+    scaled[i] = coordinates[std::min(source_index, source_size - 1)];
+  }
+  return scaled;
+}
+
+// Adds "before" and "after" padding entries to "coordinates", which
+// replicate the first and last entries if "replicate" is set.
+void PadCoordinates(int before, int after, bool replicate,
+                    std::vector<int>& coordinates) {
+  ABSL_CHECK(!coordinates.empty());
+  const int first = replicate ? coordinates.front() : kPadding;
+  const int last = replicate ? coordinates.back() : kPadding;
+  coordinates.insert(coordinates.begin(), before, first);
+  coordinates.insert(coordinates.end(), after, last);
+}
+
+// Arguments of GatherRows.
+struct GatherArgs {
+  const std::vector<int>& columns;
+  const std::vector<int>& rows;
+  const uint8_t* padding_pixel;
+  const uint8_t* source;
+  int source_step;
+  uint8_t* output;
+  int output_step;
+  int pixel_size;
+};
+
+// Copies pixels of kPixelSize bytes, so that the copies are inlined for
+// common formats, or of a size known at runtime if kPixelSize is 0.
+template <int kPixelSize>
+class PixelCopier {
+ public:
+  explicit PixelCopier(int pixel_size) : pixel_size_(pixel_size) {}
+
+  int pixel_size() const { return kPixelSize > 0 ? kPixelSize : pixel_size_; }
+
+  void Copy(const uint8_t* from, uint8_t* to) const {
+    std::memcpy(to, from, pixel_size());
+  }
+
+  // Copies "pixel" to pixels [begin, end) of "row".
+  void Fill(const uint8_t* pixel, int begin, int end, uint8_t* row) const {
+    for (int x = begin; x < end; ++x) {
+      Copy(pixel, row + x * pixel_size());
+    }
+  }
+
+ private:
+  const int pixel_size_;
+};
+
+template <int kPixelSize>
+void GatherRowsUntransposed(const GatherArgs& args, int row_begin,
+                            int row_end) {
+  const PixelCopier<kPixelSize> copier(args.pixel_size);
+  const int pixel_size = copier.pixel_size();
+  const int width = args.columns.size();
+  // Rows are copied with a single memcpy if the columns between the padding
+  // on both sides are consecutive source columns.
+  int first = 0;
+  while (first < width && args.columns[first] == kPadding) ++first;
+  int last = width;
+  while (last > first && args.columns[last - 1] == kPadding) --last;
+  bool consecutive = true;
+  for (int x = first; x < last; ++x) {
+    consecutive &= args.columns[x] == args.columns[first] + x - first;
+  }
+
+  for (int y = row_begin; y < row_end; ++y) {
+    uint8_t* output_row = args.output + y * args.output_step;
+    if (args.rows[y] == kPadding) {
+      copier.Fill(args.padding_pixel, 0, width, output_row);
+      continue;
+    }
+    const uint8_t* source_row = args.source + args.rows[y] * args.source_step;
+    if (consecutive) {
+      copier.Fill(args.padding_pixel, 0, first, output_row);
+      if (last > first) {
+        std::memcpy(output_row + first * pixel_size,
+                    source_row + args.columns[first] * pixel_size,
+                    (last - first) * pixel_size);
+      }
+      copier.Fill(args.padding_pixel, last, width, output_row);
+      continue;
+    }
+    for (int x = 0; x < width; ++x) {
+      const int source_x = args.columns[x];
+      copier.Copy(source_x == kPadding ? args.padding_pixel
+                                       : source_row + source_x * pixel_size,
+                  output_row + x * pixel_size);
+    }
+  }
+}
+
+template <int kPixelSize>
+void GatherRowsTransposed(const GatherArgs& args, int row_begin, int row_end) {
+  const PixelCopier<kPixelSize> copier(args.pixel_size);
+  const int pixel_size = copier.pixel_size();
+  const int width = args.columns.size();
+  // Output rows read source columns. They are processed in blocks of columns,
+  // so that the source rows of a block stay cached for the next output row.
+  constexpr int kBlockWidth = 64;
+  for (int block = 0; block < width; block += kBlockWidth) {
+    const int block_end = std::min(width, block + kBlockWidth);
+    for (int y = row_begin; y < row_end; ++y) {
+      uint8_t* output_row = args.output + y * args.output_step;
+      const int source_x = args.rows[y];
+      if (source_x == kPadding) {
+        copier.Fill(args.padding_pixel, block, block_end, output_row);
+        continue;
+      }
+      const uint8_t* source_column = args.source + source_x * pixel_size;
+      for (int x = block; x < block_end; ++x) {
+        const int source_y = args.columns[x];
+        copier.Copy(source_y == kPadding
+                        ? args.padding_pixel
+                        : source_column + source_y * args.source_step,
+                    output_row + x * pixel_size);
+      }
+    }
+  }
+}
+
+template <int kPixelSize>
+void GatherRowsWithPixelSize(const GatherArgs& args, bool transposed,
+                             int row_begin, int row_end) {
+  if (transposed) {
+    GatherRowsTransposed<kPixelSize>(args, row_begin, row_end);
+  } else {
+    GatherRowsUntransposed<kPixelSize>(args, row_begin, row_end);
+  }
+}
+
+}  // namespace
+
+void ForEachRowTile(ThreadPoolExecutor* executor, int num_rows,
+                    int min_tile_rows,
+                    absl::FunctionRef<void(int, int)> process_rows) {
+  const int num_threads = executor != nullptr ? executor->num_threads() : 0;
+  const int max_tiles = std::min(kTilesPerThread * num_threads,
+                                 num_rows / std::max(min_tile_rows, 1));
+  if (max_tiles <= 1) {
+    if (num_rows > 0) process_rows(0, num_rows);
+    return;
+  }
+  const int tile_rows = (num_rows + max_tiles - 1) / max_tiles;
+  const int num_tiles = (num_rows + tile_rows - 1) / tile_rows;
+
+  // Tasks that start once all the tiles were claimed only access "loop", as
+  // "process_rows" is only valid until the caller returns.
+  auto loop = std::make_shared<TileLoop>(num_tiles);
+  auto process_tiles = [loop, process_rows, tile_rows, num_rows]() {
+    for (int tile; loop->ClaimTile(&tile);) {
+      const int row_begin = tile * tile_rows;
+      process_rows(row_begin, std::min(num_rows, row_begin + tile_rows));
+      loop->FinishTile();
+    }
+  };
+  const int num_tasks = std::min(num_threads, num_tiles - 1);
+  for (int i = 0; i < num_tasks; ++i) {
+    executor->Schedule(process_tiles);
+  }
+  process_tiles();
+  loop->WaitForTiles();
+}
+
+void ForEachRowTileWithOpenCvFallback(
+    ThreadPoolExecutor* executor, int num_rows, int min_tile_rows,
+    absl::FunctionRef<void(int, int)> process_rows) {
+  if (executor != nullptr) {
+    ForEachRowTile(executor, num_rows, min_tile_rows, process_rows);
+    return;
+  }
+  cv::parallel_for_(
+      cv::Range(0, num_rows),
+      [&](const cv::Range& range) { process_rows(range.start, range.end); },
+      /*nstripes=*/std::max(num_rows / std::max(min_tile_rows, 1), 1));
+}
+
+PixelGather::PixelGather(int source_width, int source_height)
+    : source_width_(source_width),
+      source_height_(source_height),
+      columns_(source_width),
+      rows_(source_height) {
+  std::iota(columns_.begin(), columns_.end(), 0);
+  std::iota(rows_.begin(), rows_.end(), 0);
+}
+
+void PixelGather::ScaleNearest(int width, int height) {
+  columns_ = ScaleCoordinates(columns_, width);
+  rows_ = ScaleCoordinates(rows_, height);
+}
+
+void PixelGather::PadReplicate(int top, int bottom, int left, int right) {
+  PadCoordinates(left, right, /*replicate=*/true, columns_);
+  PadCoordinates(top, bottom, /*replicate=*/true, rows_);
+}
+
+void PixelGather::PadConstant(int top, int bottom, int left, int right,
+                              std::vector<uint8_t> padding_pixel) {
+  PadCoordinates(left, right, /*replicate=*/false, columns_);
+  PadCoordinates(top, bottom, /*replicate=*/false, rows_);
+  padding_pixel_ = std::move(padding_pixel);
+}
+
+void PixelGather::Transpose() {
+  std::swap(columns_, rows_);
+  transposed_ = !transposed_;
+}
+
+void PixelGather::FlipHorizontally() {
+  std::reverse(columns_.begin(), columns_.end());
+}
+
+void PixelGather::FlipVertically() { std::reverse(rows_.begin(), rows_.end()); }
+
+bool PixelGather::IsIdentity() const {
+  if (transposed_ || width() != source_width_ || height() != source_height_) {
+    return false;
+  }
+  for (int x = 0; x < width(); ++x) {
+    if (columns_[x] != x) return false;
+  }
+  for (int y = 0; y < height(); ++y) {
+    if (rows_[y] != y) return false;
+  }
+  return true;
+}
+
+void PixelGather::GatherRows(const ImageFrame& source, int row_begin,
+                             int row_end, ImageFrame* output) const {
+  ABSL_CHECK_EQ(source.Width(), source_width_);
+  ABSL_CHECK_EQ(source.Height(), source_height_);
+  ABSL_CHECK_EQ(output->Width(), width());
+  ABSL_CHECK_EQ(output->Height(), height());
+  ABSL_CHECK_EQ(output->Format(), source.Format());
+  const int pixel_size = source.NumberOfChannels() * source.ByteDepth();
+  ABSL_CHECK(padding_pixel_.empty() ||
+             static_cast<int>(padding_pixel_.size()) == pixel_size);
+  const GatherArgs args = {.columns = columns_,
+                           .rows = rows_,
+                           .padding_pixel = padding_pixel_.data(),
+                           .source = source.PixelData(),
+                           .source_step = source.WidthStep(),
+                           .output = output->MutablePixelData(),
+                           .output_step = output->WidthStep(),
+                           .pixel_size = pixel_size};
+  switch (pixel_size) {
+    case 1:
+      return GatherRowsWithPixelSize<1>(args, transposed_, row_begin, row_end);
+    case 2:
+      return GatherRowsWithPixelSize<2>(args, transposed_, row_begin, row_end);
+    case 3:
+      return GatherRowsWithPixelSize<3>(args, transposed_, row_begin, row_end);
+    case 4:
+      return GatherRowsWithPixelSize<4>(args, transposed_, row_begin, row_end);
+    case 8:
+      return GatherRowsWithPixelSize<8>(args, transposed_, row_begin, row_end);
+    default:
+      return GatherRowsWithPixelSize<0>(args, transposed_, row_begin, row_end);
+  }
+}
+
+}  // namespace mediapipe
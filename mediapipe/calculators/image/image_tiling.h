@@ -0,0 +1,125 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_IMAGE_IMAGE_TILING_H_
+#define MEDIAPIPE_CALCULATORS_IMAGE_IMAGE_TILING_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/graph_service.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+
+namespace mediapipe {
+
+// Graph service providing the executor that CPU image calculators with
+// enable_cpu_tiling set process their output row tiles on. Typically the
+// graph's default executor, so that the tiles share its threads:
+//
+//   auto executor = std::make_shared<ThreadPoolExecutor>(num_threads);
+//   MP_RETURN_IF_ERROR(graph.SetExecutor("", executor));
+//   MP_RETURN_IF_ERROR(
+//       graph.SetServiceObject(kImageTilingExecutorService, executor));
+//
+// Without it, the tiles run on the thread of the calculator.
+inline constexpr GraphService<ThreadPoolExecutor> kImageTilingExecutorService(
+    "ImageTilingExecutorService",
+    GraphServiceBase::kDisallowDefaultInitialization);
+
+// Default minimum number of rows of a tile, below which splitting a CPU image
+// loop further does not pay off.
+inline constexpr int kDefaultMinTileRows = 16;
+
+// Calls process_rows(row_begin, row_end) for consecutive row tiles covering
+// [0, num_rows), which have at least min_tile_rows rows except for the last
+// one. The tiles run on the calling thread and on "executor", if not null,
+// and ForEachRowTile returns once all of them are processed. As the calling
+// thread processes tiles too, the loop completes even if all the threads of
+// "executor" are busy, for example running the calling calculator's graph.
+void ForEachRowTile(ThreadPoolExecutor* executor, int num_rows,
+                    int min_tile_rows,
+                    absl::FunctionRef<void(int, int)> process_rows);
+
+// Like ForEachRowTile, except that without "executor" the tiles run on
+// OpenCV's threads with cv::parallel_for_ instead of the calling thread.
+void ForEachRowTileWithOpenCvFallback(
+    ThreadPoolExecutor* executor, int num_rows, int min_tile_rows,
+    absl::FunctionRef<void(int, int)> process_rows);
+
+// Describes an image whose pixels are copies of the pixels of a source image,
+// or padding, such as the result of nearest-neighbor scaling, padding,
+// transposition and flipping of the source image. The operations apply in
+// the order they are added, and GatherRows performs all of them in a single
+// pass over the output, without intermediate images.
+//
+// Each operation produces the same pixels as the corresponding OpenCV
+// function, e.g. cv::rotate(image, image, cv::ROTATE_90_CLOCKWISE) is
+//   pixel_gather.Transpose();
+//   pixel_gather.FlipHorizontally();
+class PixelGather {
+ public:
+  // Starts with the source image, unchanged.
+  PixelGather(int source_width, int source_height);
+
+  int width() const { return columns_.size(); }
+  int height() const { return rows_.size(); }
+
+  // Scales the image to width x height as cv::resize with cv::INTER_NEAREST.
+  void ScaleNearest(int width, int height);
+
+  // Adds padding pixels replicating the border pixels of the image, as
+  // cv::copyMakeBorder with cv::BORDER_REPLICATE.
+  void PadReplicate(int top, int bottom, int left, int right);
+
+  // Adds padding pixels with value "padding_pixel", the bytes of one pixel in
+  // the format of the source image, as cv::copyMakeBorder with
+  // cv::BORDER_CONSTANT. All constant padding has the value of the last call.
+  void PadConstant(int top, int bottom, int left, int right,
+                   std::vector<uint8_t> padding_pixel);
+
+  // Swaps rows and columns, as cv::transpose.
+  void Transpose();
+
+  // Flips the image around the vertical axis, as cv::flip with flip code 1.
+  void FlipHorizontally();
+
+  // Flips the image around the horizontal axis, as cv::flip with flip code 0.
+  void FlipVertically();
+
+  // Returns true if the image is the source image.
+  bool IsIdentity() const;
+
+  // Writes rows [row_begin, row_end) of the image to the same rows of
+  // "output", which must have the size of the image and the format of
+  // "source".
+  void GatherRows(const ImageFrame& source, int row_begin, int row_end,
+                  ImageFrame* output) const;
+
+ private:
+  int source_width_;
+  int source_height_;
+  // Source coordinates of the image columns and rows, or -1 for padding.
+  // Columns map to source columns and rows to source rows, or the reverse if
+  // transposed_ is set.
+  std::vector<int> columns_;
+  std::vector<int> rows_;
+  bool transposed_ = false;
+  std::vector<uint8_t> padding_pixel_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_IMAGE_IMAGE_TILING_H_
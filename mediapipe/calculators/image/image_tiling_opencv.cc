@@ -0,0 +1,166 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/image/image_tiling_opencv.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "mediapipe/calculators/image/image_tiling.h"
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+
+namespace mediapipe {
+namespace {
+
+// Fixed-point precision of the coordinates in cv::warpAffine.
+constexpr int kAffineBits = 10;
+constexpr int kAffineScale = 1 << kAffineBits;
+
+// Returns the integer factor by which cv::resize downscales "source_size" to
+// "output_size" with its fast area path, or 0 if it does not, computed as
+// cv::resize does.
+int FastAreaScale(int source_size, int output_size) {
+  const double scale = 1. / (static_cast<double>(output_size) / source_size);
+  const int integer_scale = cv::saturate_cast<int>(scale);
+  return std::abs(scale - integer_scale) < DBL_EPSILON ? integer_scale : 0;
+}
+
+// Returns the inverse map of cv::warpAffine with "matrix" and "flags", which
+// maps output to source coordinates, computed as cv::warpAffine does.
+cv::Matx23d InverseWarpMatrix(const cv::Mat& matrix, int flags) {
+  ABSL_CHECK(matrix.rows == 2 && matrix.cols == 3 && matrix.channels() == 1)
+      << "Affine transformations are 2x3 matrices.";
+  cv::Mat matrix_64f;
+  matrix.convertTo(matrix_64f, CV_64F);
+  cv::Matx23d m = matrix_64f;
+  if (!(flags & cv::WARP_INVERSE_MAP)) {
+    double d = m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+    d = d != 0 ? 1. / d : 0;
+    const double a11 = m(1, 1) * d;
+    const double a22 = m(0, 0) * d;
+    m(0, 0) = a11;
+    m(0, 1) *= -d;
+    m(1, 0) *= -d;
+    m(1, 1) = a22;
+    const double b1 = -m(0, 0) * m(0, 2) - m(0, 1) * m(1, 2);
+    const double b2 = -m(1, 0) * m(0, 2) - m(1, 1) * m(1, 2);
+    m(0, 2) = b1;
+    m(1, 2) = b2;
+  }
+  return m;
+}
+
+}  // namespace
+
+void ResizeInTiles(const cv::Mat& source, int interpolation,
+                   ThreadPoolExecutor* executor, cv::Mat& output) {
+  ABSL_CHECK_EQ(source.type(), output.type());
+  const int scale_x = FastAreaScale(source.cols, output.cols);
+  const int scale_y = FastAreaScale(source.rows, output.rows);
+  if (interpolation != cv::INTER_AREA || scale_x < 1 || scale_y < 1 ||
+      executor == nullptr) {
+    cv::resize(source, output, output.size(), 0, 0, interpolation);
+    return;
+  }
+  // Output rows [row_begin, row_end) average source rows
+  // [row_begin * scale_y, row_end * scale_y), and the tiles downscale by the
+  // same integer factors as the whole image.
+  ForEachRowTile(executor, output.rows, kDefaultMinTileRows,
+                 [&](int row_begin, int row_end) {
+                   cv::Mat output_rows = output.rowRange(row_begin, row_end);
+                   cv::resize(source.rowRange(row_begin * scale_y,
+                                              row_end * scale_y),
+                              output_rows, output_rows.size(), 0, 0,
+                              cv::INTER_AREA);
+                 });
+}
+
+void WarpAffineInTiles(const cv::Mat& source, const cv::Mat& matrix, int flags,
+                       int border_mode, const cv::Scalar& border_value,
+                       bool flip_horizontally, bool flip_vertically,
+                       ThreadPoolExecutor* executor, cv::Mat& output) {
+  ABSL_CHECK_EQ(source.type(), output.type());
+  ABSL_CHECK(source.data != output.data) << "Warping in place is unsupported.";
+  const cv::Matx23d m = InverseWarpMatrix(matrix, flags);
+  int interpolation = flags & cv::INTER_MAX;
+  if (interpolation == cv::INTER_AREA) interpolation = cv::INTER_LINEAR;
+  const bool nearest = interpolation == cv::INTER_NEAREST;
+  const int round_delta =
+      nearest ? kAffineScale / 2 : kAffineScale / cv::INTER_TAB_SIZE / 2;
+
+  std::vector<int> x_deltas(output.cols);
+  std::vector<int> y_deltas(output.cols);
+  for (int x = 0; x < output.cols; ++x) {
+    x_deltas[x] = cv::saturate_cast<int>(m(0, 0) * x * kAffineScale);
+    y_deltas[x] = cv::saturate_cast<int>(m(1, 0) * x * kAffineScale);
+  }
+
+  ForEachRowTile(
+      executor, output.rows, kDefaultMinTileRows,
+      [&](int row_begin, int row_end) {
+        const int rows = row_end - row_begin;
+        cv::Mat coordinates(rows, output.cols, CV_16SC2);
+        cv::Mat fractions;
+        if (!nearest) fractions.create(rows, output.cols, CV_16UC1);
+        for (int row = 0; row < rows; ++row) {
+          const int y = flip_vertically ? output.rows - 1 - (row_begin + row)
+                                        : row_begin + row;
+          const int x0 =
+              cv::saturate_cast<int>((m(0, 1) * y + m(0, 2)) * kAffineScale) +
+              round_delta;
+          const int y0 =
+              cv::saturate_cast<int>((m(1, 1) * y + m(1, 2)) * kAffineScale) +
+              round_delta;
+          int16_t* xy = coordinates.ptr<int16_t>(row);
+          uint16_t* alpha = nearest ? nullptr : fractions.ptr<uint16_t>(row);
+          for (int column = 0; column < output.cols; ++column) {
+            const int x =
+                flip_horizontally ? output.cols - 1 - column : column;
+            const int sx = x0 + x_deltas[x];
+            const int sy = y0 + y_deltas[x];
+            if (nearest) {
+              xy[2 * column] = cv::saturate_cast<int16_t>(sx >> kAffineBits);
+              xy[2 * column + 1] =
+                  cv::saturate_cast<int16_t>(sy >> kAffineBits);
+            } else {
+              // Coordinates with cv::INTER_BITS fractional bits.
+              const int fx = sx >> (kAffineBits - cv::INTER_BITS);
+              const int fy = sy >> (kAffineBits - cv::INTER_BITS);
+              xy[2 * column] = cv::saturate_cast<int16_t>(fx >> cv::INTER_BITS);
+              xy[2 * column + 1] =
+                  cv::saturate_cast<int16_t>(fy >> cv::INTER_BITS);
+              alpha[column] = static_cast<uint16_t>(
+                  (fy & (cv::INTER_TAB_SIZE - 1)) * cv::INTER_TAB_SIZE +
+                  (fx & (cv::INTER_TAB_SIZE - 1)));
+            }
+          }
+        }
+        cv::Mat output_rows = output.rowRange(row_begin, row_end);
+        cv::remap(source, output_rows, coordinates, fractions, interpolation,
+                  border_mode, border_value);
+      });
+}
+
+bool IsIdentityWarp(const cv::Mat& matrix, int flags) {
+  const cv::Matx23d m = InverseWarpMatrix(matrix, flags);
+  return m(0, 0) == 1 && m(0, 1) == 0 && m(0, 2) == 0 && m(1, 0) == 0 &&
+         m(1, 1) == 1 && m(1, 2) == 0;
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,60 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_IMAGE_IMAGE_TILING_OPENCV_H_
+#define MEDIAPIPE_CALCULATORS_IMAGE_IMAGE_TILING_OPENCV_H_
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+
+namespace mediapipe {
+
+// Row tiles of the OpenCV image operations, which produce the same output as
+// the corresponding OpenCV calls. The tiles run with ForEachRowTile on
+// "executor", if not null. "output" must be allocated with the output size
+// and the type of "source".
+
+// Resizes "source" to the size of "output" as
+//   cv::resize(source, output, output.size(), 0, 0, interpolation).
+// Every output row of a downscaling by integer factors with cv::INTER_AREA
+// only depends on its own source rows, so such resizes are split into row
+// tiles. Other resizes run in a single cv::resize call.
+void ResizeInTiles(const cv::Mat& source, int interpolation,
+                   ThreadPoolExecutor* executor, cv::Mat& output);
+
+// Warps "source" as
+//   cv::warpAffine(source, warped, matrix, output.size(), flags, border_mode,
+//                  border_value);
+// and writes "warped" to "output", flipped around the vertical axis if
+// flip_horizontally is set and around the horizontal axis if
+// flip_vertically is set.
+//
+// cv::warpAffine computes fixed-point source coordinates for blocks of
+// output pixels and interpolates them with cv::remap. The tiles compute the
+// same coordinates for their rows and call cv::remap on them, placing the
+// flipped coordinates directly instead of flipping the output afterwards.
+void WarpAffineInTiles(const cv::Mat& source, const cv::Mat& matrix, int flags,
+                       int border_mode, const cv::Scalar& border_value,
+                       bool flip_horizontally, bool flip_vertically,
+                       ThreadPoolExecutor* executor, cv::Mat& output);
+
+// Returns true if cv::warpAffine with "matrix" and "flags" copies each pixel
+// of the source to the same position of an output of the same size, i.e. if
+// the inverse map is the identity, which it checks as cv::warpAffine
+// computes it.
+bool IsIdentityWarp(const cv::Mat& matrix, int flags);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_IMAGE_IMAGE_TILING_OPENCV_H_
@@ -0,0 +1,172 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/image/image_tiling_opencv.h"
+
+#include <cstdint>
+
+#include "mediapipe/framework/port/benchmark.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+
+namespace mediapipe {
+namespace {
+
+// Returns an 8-bit image with "channels" channels and varying pixel values.
+cv::Mat MakeImage(int width, int height, int channels) {
+  cv::Mat image(height, width, CV_8UC(channels));
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = image.ptr<uint8_t>(y);
+    for (int i = 0; i < width * channels; ++i) {
+      row[i] = (i * 37 + y * 101 + (i * y) % 17) % 256;
+    }
+  }
+  return image;
+}
+
+// Returns true if "a" and "b" have the same size, type and pixels.
+bool SameImage(const cv::Mat& a, const cv::Mat& b) {
+  return a.size() == b.size() && a.type() == b.type() &&
+         cv::countNonZero(a.reshape(1) != b.reshape(1)) == 0;
+}
+
+TEST(ImageTilingOpenCvTest, WarpAffineInTilesMatchesWarpAffine) {
+  const cv::Mat source = MakeImage(97, 61, 3);
+  const cv::Mat matrix =
+      cv::getRotationMatrix2D(cv::Point2f(48.5f, 30.5f), 33.0, 1.3);
+  const cv::Size output_size(120, 90);
+  ThreadPoolExecutor executor(/*num_threads=*/4);
+  for (int interpolation :
+       {cv::INTER_NEAREST, cv::INTER_LINEAR, cv::INTER_CUBIC}) {
+    for (int border_mode : {cv::BORDER_CONSTANT, cv::BORDER_REPLICATE}) {
+      for (int inverse : {0, static_cast<int>(cv::WARP_INVERSE_MAP)}) {
+        const int flags = interpolation | inverse;
+        const cv::Scalar border_value(10, 20, 30);
+        cv::Mat expected;
+        cv::warpAffine(source, expected, matrix, output_size, flags,
+                       border_mode, border_value);
+        cv::Mat output(output_size, source.type());
+        WarpAffineInTiles(source, matrix, flags, border_mode, border_value,
+                          /*flip_horizontally=*/false,
+                          /*flip_vertically=*/false, &executor, output);
+        EXPECT_TRUE(SameImage(output, expected))
+            << interpolation << ", " << border_mode << ", " << inverse;
+      }
+    }
+  }
+}
+
+TEST(ImageTilingOpenCvTest, WarpAffineInTilesFlips) {
+  const cv::Mat source = MakeImage(64, 48, 4);
+  const cv::Mat matrix =
+      cv::getRotationMatrix2D(cv::Point2f(32.0f, 24.0f), -20.0, 0.8);
+  cv::Mat warped;
+  cv::warpAffine(source, warped, matrix, source.size(), cv::INTER_LINEAR,
+                 cv::BORDER_CONSTANT);
+  ThreadPoolExecutor executor(/*num_threads=*/2);
+  for (int flip_code : {1, 0, -1}) {
+    const bool flip_horizontally = flip_code != 0;
+    const bool flip_vertically = flip_code <= 0;
+    cv::Mat expected;
+    cv::flip(warped, expected, flip_code);
+    cv::Mat output(source.size(), source.type());
+    WarpAffineInTiles(source, matrix, cv::INTER_LINEAR, cv::BORDER_CONSTANT,
+                      cv::Scalar(), flip_horizontally, flip_vertically,
+                      &executor, output);
+    EXPECT_TRUE(SameImage(output, expected)) << flip_code;
+  }
+}
+
+TEST(ImageTilingOpenCvTest, ResizeInTilesMatchesResize) {
+  const cv::Mat source = MakeImage(240, 180, 3);
+  ThreadPoolExecutor executor(/*num_threads=*/4);
+  for (const cv::Size& output_size :
+       {cv::Size(120, 90), cv::Size(80, 60), cv::Size(100, 70),
+        cv::Size(300, 200)}) {
+    for (int interpolation : {cv::INTER_AREA, cv::INTER_LINEAR}) {
+      cv::Mat expected;
+      cv::resize(source, expected, output_size, 0, 0, interpolation);
+      cv::Mat output(output_size, source.type());
+      ResizeInTiles(source, interpolation, &executor, output);
+      EXPECT_TRUE(SameImage(output, expected))
+          << output_size << ", " << interpolation;
+    }
+  }
+}
+
+TEST(ImageTilingOpenCvTest, IsIdentityWarp) {
+  const cv::Point2f center(32.0f, 24.0f);
+  EXPECT_TRUE(IsIdentityWarp(cv::getRotationMatrix2D(center, 0.0, 1.0),
+                             cv::INTER_LINEAR));
+  EXPECT_TRUE(IsIdentityWarp(cv::getRotationMatrix2D(center, 0.0, 1.0),
+                             cv::INTER_LINEAR | cv::WARP_INVERSE_MAP));
+  EXPECT_FALSE(IsIdentityWarp(cv::getRotationMatrix2D(center, 90.0, 1.0),
+                              cv::INTER_LINEAR));
+  EXPECT_FALSE(IsIdentityWarp(cv::getRotationMatrix2D(center, 0.0, 2.0),
+                              cv::INTER_LINEAR));
+}
+
+// Compares cv::warpAffine (state.range(2) == 0) to WarpAffineInTiles on 4
+// threads (state.range(2) == 1), rotating an SRGB image of
+// state.range(0) x state.range(1) pixels.
+void BM_WarpAffine(benchmark::State& state) {
+  const cv::Mat source = MakeImage(state.range(0), state.range(1), 3);
+  const cv::Mat matrix = cv::getRotationMatrix2D(
+      cv::Point2f(source.cols / 2.0f, source.rows / 2.0f), 10.0, 1.0);
+  ThreadPoolExecutor executor(/*num_threads=*/4);
+  cv::Mat output(source.size(), source.type());
+  for (auto _ : state) {
+    if (state.range(2)) {
+      WarpAffineInTiles(source, matrix, cv::INTER_LINEAR, cv::BORDER_CONSTANT,
+                        cv::Scalar(), /*flip_horizontally=*/false,
+                        /*flip_vertically=*/false, &executor, output);
+    } else {
+      cv::warpAffine(source, output, matrix, source.size(), cv::INTER_LINEAR,
+                     cv::BORDER_CONSTANT);
+    }
+    benchmark::DoNotOptimize(output.data);
+  }
+}
+BENCHMARK(BM_WarpAffine)
+    ->Args({1920, 1080, 0})
+    ->Args({1920, 1080, 1})
+    ->Args({3840, 2160, 0})
+    ->Args({3840, 2160, 1});
+
+// Compares cv::resize (state.range(2) == 0) to ResizeInTiles on 4 threads
+// (state.range(2) == 1), halving an SRGB image of
+// state.range(0) x state.range(1) pixels with cv::INTER_AREA.
+void BM_ResizeArea(benchmark::State& state) {
+  const cv::Mat source = MakeImage(state.range(0), state.range(1), 3);
+  ThreadPoolExecutor executor(/*num_threads=*/4);
+  cv::Mat output(source.rows / 2, source.cols / 2, source.type());
+  for (auto _ : state) {
+    if (state.range(2)) {
+      ResizeInTiles(source, cv::INTER_AREA, &executor, output);
+    } else {
+      cv::resize(source, output, output.size(), 0, 0, cv::INTER_AREA);
+    }
+    benchmark::DoNotOptimize(output.data);
+  }
+}
+BENCHMARK(BM_ResizeArea)
+    ->Args({1920, 1080, 0})
+    ->Args({1920, 1080, 1})
+    ->Args({3840, 2160, 0})
+    ->Args({3840, 2160, 1});
+
+}  // namespace
+}  // namespace mediapipe
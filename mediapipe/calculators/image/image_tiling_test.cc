@@ -0,0 +1,200 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/image/image_tiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+// Returns a GRAY8 image whose pixel at (x, y) is 10 * y + x.
+ImageFrame MakeImage(int width, int height) {
+  ImageFrame image(ImageFormat::GRAY8, width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      image.MutablePixelData()[y * image.WidthStep() + x] = 10 * y + x;
+    }
+  }
+  return image;
+}
+
+// Returns the pixels of "gather" applied to "source", row by row.
+std::vector<int> Gather(const PixelGather& gather, const ImageFrame& source) {
+  ImageFrame output(source.Format(), gather.width(), gather.height());
+  gather.GatherRows(source, 0, gather.height(), &output);
+  std::vector<int> pixels;
+  const int pixel_size = output.NumberOfChannels() * output.ByteDepth();
+  for (int y = 0; y < output.Height(); ++y) {
+    const uint8_t* row = output.PixelData() + y * output.WidthStep();
+    for (int i = 0; i < output.Width() * pixel_size; ++i) {
+      pixels.push_back(row[i]);
+    }
+  }
+  return pixels;
+}
+
+TEST(ImageTilingTest, ForEachRowTileCoversAllRowsOnce) {
+  ThreadPoolExecutor executor(/*num_threads=*/3);
+  std::vector<std::atomic<int>> row_counts(1000);
+  absl::Mutex mutex;
+  std::vector<std::pair<int, int>> tiles;
+  ForEachRowTile(&executor, row_counts.size(), /*min_tile_rows=*/16,
+                 [&](int row_begin, int row_end) {
+                   for (int y = row_begin; y < row_end; ++y) ++row_counts[y];
+                   absl::MutexLock lock(&mutex);
+                   tiles.emplace_back(row_begin, row_end);
+                 });
+  for (int y = 0; y < row_counts.size(); ++y) {
+    EXPECT_EQ(row_counts[y], 1) << y;
+  }
+  EXPECT_EQ(tiles.size(), 12);
+  for (const auto& [row_begin, row_end] : tiles) {
+    EXPECT_TRUE(row_end - row_begin >= 16 || row_end == row_counts.size());
+  }
+}
+
+TEST(ImageTilingTest, ForEachRowTileUsesOneTileWithoutExecutor) {
+  std::vector<std::pair<int, int>> tiles;
+  ForEachRowTile(/*executor=*/nullptr, 100, /*min_tile_rows=*/16,
+                 [&](int row_begin, int row_end) {
+                   tiles.emplace_back(row_begin, row_end);
+                 });
+  EXPECT_THAT(tiles, ElementsAre(std::make_pair(0, 100)));
+}
+
+TEST(ImageTilingTest, ForEachRowTileKeepsMinTileRows) {
+  ThreadPoolExecutor executor(/*num_threads=*/8);
+  std::atomic<int> num_tiles = 0;
+  ForEachRowTile(&executor, 40, /*min_tile_rows=*/16,
+                 [&](int row_begin, int row_end) { ++num_tiles; });
+  EXPECT_EQ(num_tiles, 2);
+}
+
+TEST(ImageTilingTest, PixelGatherStartsWithIdentity) {
+  const ImageFrame image = MakeImage(3, 2);
+  const PixelGather gather(3, 2);
+  EXPECT_TRUE(gather.IsIdentity());
+  EXPECT_THAT(Gather(gather, image), ElementsAre(0, 1, 2, 10, 11, 12));
+}
+
+TEST(ImageTilingTest, PixelGatherScalesNearest) {
+  const ImageFrame image = MakeImage(5, 2);
+  PixelGather gather(5, 2);
+  // As cv::resize, samples columns floor(x * 5 / 3) and rows floor(y / 2).
+  gather.ScaleNearest(3, 4);
+  EXPECT_FALSE(gather.IsIdentity());
+  EXPECT_THAT(Gather(gather, image),
+              ElementsAre(0, 1, 3, 0, 1, 3, 10, 11, 13, 10, 11, 13));
+}
+
+TEST(ImageTilingTest, PixelGatherDownscalingIsNotIdentity) {
+  // Samples the first 9 of 10 columns.
+  PixelGather gather(10, 1);
+  gather.ScaleNearest(9, 1);
+  EXPECT_FALSE(gather.IsIdentity());
+}
+
+TEST(ImageTilingTest, PixelGatherRotates) {
+  const ImageFrame image = MakeImage(3, 2);
+  // As cv::rotate with cv::ROTATE_90_CLOCKWISE.
+  PixelGather clockwise(3, 2);
+  clockwise.Transpose();
+  clockwise.FlipHorizontally();
+  EXPECT_THAT(Gather(clockwise, image), ElementsAre(10, 0, 11, 1, 12, 2));
+  // As cv::rotate with cv::ROTATE_90_COUNTERCLOCKWISE.
+  PixelGather counterclockwise(3, 2);
+  counterclockwise.Transpose();
+  counterclockwise.FlipVertically();
+  EXPECT_THAT(Gather(counterclockwise, image),
+              ElementsAre(2, 12, 1, 11, 0, 10));
+  // As cv::rotate with cv::ROTATE_180.
+  PixelGather half_turn(3, 2);
+  half_turn.FlipHorizontally();
+  half_turn.FlipVertically();
+  EXPECT_THAT(Gather(half_turn, image), ElementsAre(12, 11, 10, 2, 1, 0));
+}
+
+TEST(ImageTilingTest, PixelGatherPads) {
+  const ImageFrame image = MakeImage(2, 2);
+  PixelGather replicate(2, 2);
+  replicate.PadReplicate(/*top=*/1, /*bottom=*/0, /*left=*/0, /*right=*/1);
+  EXPECT_THAT(Gather(replicate, image),
+              ElementsAre(0, 1, 1, 0, 1, 1, 10, 11, 11));
+  PixelGather constant(2, 2);
+  constant.PadConstant(/*top=*/0, /*bottom=*/1, /*left=*/1, /*right=*/0,
+                       /*padding_pixel=*/{99});
+  EXPECT_THAT(Gather(constant, image),
+              ElementsAre(99, 0, 1, 99, 10, 11, 99, 99, 99));
+}
+
+TEST(ImageTilingTest, PixelGatherCombinesOperations) {
+  ImageFrame image(ImageFormat::SRGB, 2, 1);
+  const uint8_t pixels[] = {1, 2, 3, 4, 5, 6};
+  std::copy(std::begin(pixels), std::end(pixels), image.MutablePixelData());
+  PixelGather gather(2, 1);
+  gather.ScaleNearest(4, 1);
+  gather.PadConstant(/*top=*/1, /*bottom=*/0, /*left=*/0, /*right=*/0,
+                     /*padding_pixel=*/{7, 8, 9});
+  gather.Transpose();
+  gather.FlipVertically();
+  EXPECT_EQ(gather.width(), 2);
+  EXPECT_EQ(gather.height(), 4);
+  EXPECT_THAT(Gather(gather, image),
+              ElementsAreArray({7, 8, 9, 4, 5, 6,  //
+                                7, 8, 9, 4, 5, 6,  //
+                                7, 8, 9, 1, 2, 3,  //
+                                7, 8, 9, 1, 2, 3}));
+}
+
+TEST(ImageTilingTest, PixelGatherTilesMatchSinglePass) {
+  const ImageFrame image = MakeImage(9, 7);
+  PixelGather gather(9, 7);
+  gather.ScaleNearest(150, 100);
+  gather.Transpose();
+  gather.FlipHorizontally();
+  ImageFrame output(ImageFormat::GRAY8, gather.width(), gather.height());
+  ThreadPoolExecutor executor(/*num_threads=*/4);
+  ForEachRowTile(&executor, output.Height(), /*min_tile_rows=*/4,
+                 [&](int row_begin, int row_end) {
+                   gather.GatherRows(image, row_begin, row_end, &output);
+                 });
+  ImageFrame expected(ImageFormat::GRAY8, gather.width(), gather.height());
+  gather.GatherRows(image, 0, gather.height(), &expected);
+  for (int y = 0; y < output.Height(); ++y) {
+    for (int x = 0; x < output.Width(); ++x) {
+      ASSERT_EQ(output.PixelData()[y * output.WidthStep() + x],
+                expected.PixelData()[y * expected.WidthStep() + x])
+          << x << ", " << y;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
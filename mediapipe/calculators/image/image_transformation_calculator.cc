@@ -12,18 +12,27 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <optional>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "mediapipe/calculators/image/image_tiling.h"
+#include "mediapipe/calculators/image/image_tiling_opencv.h"
 #include "mediapipe/calculators/image/image_transformation_calculator.pb.h"
 #include "mediapipe/calculators/image/rotation_mode.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/image_multi_pool.h"
+#include "mediapipe/framework/formats/image_multi_pool_service.h"
 #include "mediapipe/framework/formats/video_stream_header.h"
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 #include "mediapipe/framework/timestamp.h"
 #include "mediapipe/gpu/scale_mode.pb.h"
 
@@ -103,6 +112,13 @@ mediapipe::ScaleMode_Mode ParseScaleMode(
       return default_mode;
   }
 }
+
+// Returns the bytes of a pixel of OpenCV type "type" with value "color", as
+// cv::copyMakeBorder writes them.
+std::vector<uint8_t> PixelBytes(int type, const cv::Scalar& color) {
+  const cv::Mat pixel(1, 1, type, color);
+  return std::vector<uint8_t>(pixel.data, pixel.data + pixel.elemSize());
+}
 }  // namespace
 
 // Scales, rotates, and flips images horizontally or vertically.
@@ -190,12 +206,30 @@ class ImageTransformationCalculator : public CalculatorBase {
   absl::Status Close(CalculatorContext* cc) override;
 
  private:
+  // Resizing of the CPU input to the output dimensions, and padding of the
+  // resized image in FIT scale mode.
+  struct CpuScaling {
+    cv::Size size;
+    int interpolation = cv::INTER_LINEAR;
+    int top = 0;
+    int bottom = 0;
+    int left = 0;
+    int right = 0;
+  };
+
   absl::Status RenderCpu(CalculatorContext* cc);
+  // Renders "input" to "output" as RenderCpu, with a single pass over the
+  // output for nearest-neighbor scaling, padding, rotation and flipping, and
+  // in row tiles on tile_executor_. "scaling" is null without output
+  // dimensions.
+  void RenderCpuInTiles(const ImageFrame& input, const CpuScaling* scaling,
+                        ImageFrame* output);
   absl::Status RenderGpu(CalculatorContext* cc);
   absl::Status GlSetup();
 
   void ComputeOutputDimensions(int input_width, int input_height,
                                int* output_width, int* output_height);
+  CpuScaling ComputeCpuScaling(int input_width, int input_height);
   void ComputeOutputLetterboxPadding(int input_width, int input_height,
                                      int output_width, int output_height,
                                      std::array<float, 4>* padding);
@@ -209,6 +243,11 @@ class ImageTransformationCalculator : public CalculatorBase {
   bool flip_vertically_ = false;
 
   bool use_gpu_ = false;
+  // Pool for the CPU output frames, if the graph provides one.
+  ImageMultiPool* image_pool_ = nullptr;
+  // Executor for the CPU row tiles if enable_cpu_tiling is set and the graph
+  // provides one.
+  ThreadPoolExecutor* tile_executor_ = nullptr;
   cv::Scalar padding_color_;
   ImageTransformationCalculatorOptions::InterpolationMode interpolation_mode_;
 
@@ -234,6 +273,8 @@ absl::Status ImageTransformationCalculator::GetContract(
     RET_CHECK(cc->Outputs().HasTag(kImageFrameTag));
     cc->Inputs().Tag(kImageFrameTag).Set<ImageFrame>();
     cc->Outputs().Tag(kImageFrameTag).Set<ImageFrame>();
+    cc->UseService(kImageMultiPoolService).Optional();
+    cc->UseService(kImageTilingExecutorService).Optional();
   }
 #if !MEDIAPIPE_DISABLE_GPU
   if (cc->Inputs().HasTag(kGpuBufferTag)) {
@@ -308,6 +349,14 @@ absl::Status ImageTransformationCalculator::Open(CalculatorContext* cc) {
 
   if (cc->Inputs().HasTag(kGpuBufferTag)) {
     use_gpu_ = true;
+  } else {
+    if (cc->Service(kImageMultiPoolService).IsAvailable()) {
+      image_pool_ = &cc->Service(kImageMultiPoolService).GetObject();
+    }
+    if (options_.enable_cpu_tiling() &&
+        cc->Service(kImageTilingExecutorService).IsAvailable()) {
+      tile_executor_ = &cc->Service(kImageTilingExecutorService).GetObject();
+    }
   }
 
   if (cc->InputSidePackets().HasTag("OUTPUT_DIMENSIONS")) {
@@ -452,12 +501,8 @@ absl::Status ImageTransformationCalculator::Close(CalculatorContext* cc) {
 }
 
 absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
-  cv::Mat input_mat;
-  mediapipe::ImageFormat::Format format;
-
   const auto& input = cc->Inputs().Tag(kImageFrameTag).Get<ImageFrame>();
-  input_mat = formats::MatView(&input);
-  format = input.Format();
+  cv::Mat input_mat = formats::MatView(&input);
 
   const int input_width = input_mat.cols;
   const int input_height = input_mat.rows;
@@ -466,65 +511,11 @@ absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
   ComputeOutputDimensions(input_width, input_height, &output_width,
                           &output_height);
 
-  int opencv_interpolation_mode = cv::INTER_LINEAR;
+  std::optional<CpuScaling> scaling;
   if (output_width_ > 0 && output_height_ > 0) {
-    cv::Mat scaled_mat;
-    if (scale_mode_ == mediapipe::ScaleMode::STRETCH) {
-      if (interpolation_mode_ == ImageTransformationCalculatorOptions::LINEAR) {
-        // Use INTER_AREA for downscaling if interpolation mode is set to
-        // LINEAR.
-        if (input_mat.cols > output_width_ && input_mat.rows > output_height_) {
-          opencv_interpolation_mode = cv::INTER_AREA;
-
-        } else {
-          opencv_interpolation_mode = cv::INTER_LINEAR;
-        }
-      } else {
-        opencv_interpolation_mode = cv::INTER_NEAREST;
-      }
-      cv::resize(input_mat, scaled_mat, cv::Size(output_width_, output_height_),
-                 0, 0, opencv_interpolation_mode);
-    } else {
-      const float scale =
-          std::min(static_cast<float>(output_width_) / input_width,
-                   static_cast<float>(output_height_) / input_height);
-      const int target_width = std::round(input_width * scale);
-      const int target_height = std::round(input_height * scale);
-
-      if (interpolation_mode_ == ImageTransformationCalculatorOptions::LINEAR) {
-        // Use INTER_AREA for downscaling if interpolation mode is set to
-        // LINEAR.
-        if (scale < 1.0f) {
-          opencv_interpolation_mode = cv::INTER_AREA;
-        } else {
-          opencv_interpolation_mode = cv::INTER_LINEAR;
-        }
-      } else {
-        opencv_interpolation_mode = cv::INTER_NEAREST;
-      }
-
-      if (scale_mode_ == mediapipe::ScaleMode::FIT) {
-        cv::Mat intermediate_mat;
-        cv::resize(input_mat, intermediate_mat,
-                   cv::Size(target_width, target_height), 0, 0,
-                   opencv_interpolation_mode);
-        const int top = (output_height_ - target_height) / 2;
-        const int bottom = output_height_ - target_height - top;
-        const int left = (output_width_ - target_width) / 2;
-        const int right = output_width_ - target_width - left;
-        cv::copyMakeBorder(intermediate_mat, scaled_mat, top, bottom, left,
-                           right,
-                           options_.constant_padding() ? cv::BORDER_CONSTANT
-                                                       : cv::BORDER_REPLICATE,
-                           padding_color_);
-      } else {
-        cv::resize(input_mat, scaled_mat, cv::Size(target_width, target_height),
-                   0, 0, opencv_interpolation_mode);
-        output_width = target_width;
-        output_height = target_height;
-      }
-    }
-    input_mat = scaled_mat;
+    scaling = ComputeCpuScaling(input_width, input_height);
+    output_width = scaling->size.width + scaling->left + scaling->right;
+    output_height = scaling->size.height + scaling->top + scaling->bottom;
   }
 
   if (cc->Outputs().HasTag("LETTERBOX_PADDING")) {
@@ -536,6 +527,32 @@ absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
         .Add(padding.release(), cc->InputTimestamp());
   }
 
+  std::unique_ptr<ImageFrame> output_frame =
+      NewImageFrame(image_pool_, input.Format(), output_width, output_height);
+  if (options_.enable_cpu_tiling()) {
+    RenderCpuInTiles(input, scaling ? &*scaling : nullptr, output_frame.get());
+    cc->Outputs()
+        .Tag(kImageFrameTag)
+        .Add(output_frame.release(), cc->InputTimestamp());
+    return absl::OkStatus();
+  }
+
+  if (scaling) {
+    cv::Mat scaled_mat;
+    cv::resize(input_mat, scaled_mat, scaling->size, 0, 0,
+               scaling->interpolation);
+    if (scale_mode_ == mediapipe::ScaleMode::FIT) {
+      cv::Mat padded_mat;
+      cv::copyMakeBorder(scaled_mat, padded_mat, scaling->top,
+                         scaling->bottom, scaling->left, scaling->right,
+                         options_.constant_padding() ? cv::BORDER_CONSTANT
+                                                     : cv::BORDER_REPLICATE,
+                         padding_color_);
+      scaled_mat = padded_mat;
+    }
+    input_mat = scaled_mat;
+  }
+
   cv::Mat rotated_mat;
   cv::Size rotated_size(output_width, output_height);
   if (input_mat.size() == rotated_size) {
@@ -561,19 +578,14 @@ absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
     }
   }
 
-  cv::Mat flipped_mat;
+  cv::Mat output_mat = formats::MatView(output_frame.get());
   if (flip_horizontally_ || flip_vertically_) {
     const int flip_code =
         flip_horizontally_ && flip_vertically_ ? -1 : flip_horizontally_;
-    cv::flip(rotated_mat, flipped_mat, flip_code);
+    cv::flip(rotated_mat, output_mat, flip_code);
   } else {
-    flipped_mat = rotated_mat;
+    rotated_mat.copyTo(output_mat);
   }
-
-  std::unique_ptr<ImageFrame> output_frame(
-      new ImageFrame(format, output_width, output_height));
-  cv::Mat output_mat = formats::MatView(output_frame.get());
-  flipped_mat.copyTo(output_mat);
   cc->Outputs()
       .Tag(kImageFrameTag)
       .Add(output_frame.release(), cc->InputTimestamp());
@@ -581,6 +593,111 @@ absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+void ImageTransformationCalculator::RenderCpuInTiles(
+    const ImageFrame& input, const CpuScaling* scaling, ImageFrame* output) {
+  const cv::Mat input_mat = formats::MatView(&input);
+  const cv::Size output_size(output->Width(), output->Height());
+  // Scaling other than nearest-neighbor interpolates pixels, so it runs
+  // before the gather, on its own.
+  const bool interpolate = scaling != nullptr &&
+                           scaling->interpolation != cv::INTER_NEAREST &&
+                           scaling->size != input_mat.size();
+  PixelGather gather = interpolate ? PixelGather(scaling->size.width,
+                                                 scaling->size.height)
+                                   : PixelGather(input.Width(), input.Height());
+  if (scaling != nullptr) {
+    if (!interpolate) {
+      gather.ScaleNearest(scaling->size.width, scaling->size.height);
+    }
+    if (scale_mode_ == mediapipe::ScaleMode::FIT) {
+      if (options_.constant_padding()) {
+        gather.PadConstant(scaling->top, scaling->bottom, scaling->left,
+                           scaling->right,
+                           PixelBytes(input_mat.type(), padding_color_));
+      } else {
+        gather.PadReplicate(scaling->top, scaling->bottom, scaling->left,
+                            scaling->right);
+      }
+    }
+  }
+
+  // As RenderCpu, rotates with cv::warpAffine if the scaled image has the
+  // output size, else with cv::rotate.
+  cv::Mat rotation_mat;
+  if (cv::Size(gather.width(), gather.height()) == output_size) {
+    const cv::Point2f center(gather.width() / 2.0, gather.height() / 2.0);
+    rotation_mat = cv::getRotationMatrix2D(
+        center, RotationModeToDegrees(rotation_), 1.0);
+    if (IsIdentityWarp(rotation_mat, cv::INTER_LINEAR)) {
+      rotation_mat.release();
+    }
+  } else {
+    switch (rotation_) {
+      case mediapipe::RotationMode::UNKNOWN:
+      case mediapipe::RotationMode::ROTATION_0:
+        break;
+      case mediapipe::RotationMode::ROTATION_90:
+        gather.Transpose();
+        gather.FlipVertically();
+        break;
+      case mediapipe::RotationMode::ROTATION_180:
+        gather.FlipHorizontally();
+        gather.FlipVertically();
+        break;
+      case mediapipe::RotationMode::ROTATION_270:
+        gather.Transpose();
+        gather.FlipHorizontally();
+        break;
+    }
+  }
+  const bool warp = !rotation_mat.empty();
+  if (!warp) {
+    if (flip_horizontally_) gather.FlipHorizontally();
+    if (flip_vertically_) gather.FlipVertically();
+  }
+
+  if (interpolate && !warp && gather.IsIdentity()) {
+    cv::Mat output_mat = formats::MatView(output);
+    ResizeInTiles(input_mat, scaling->interpolation, tile_executor_,
+                  output_mat);
+    return;
+  }
+  ImageFrame interpolated;
+  if (interpolate) {
+    interpolated.Reset(input.Format(), scaling->size.width,
+                       scaling->size.height,
+                       ImageFrame::kDefaultAlignmentBoundary);
+    cv::Mat interpolated_mat = formats::MatView(&interpolated);
+    ResizeInTiles(input_mat, scaling->interpolation, tile_executor_,
+                  interpolated_mat);
+  }
+  const ImageFrame& source = interpolate ? interpolated : input;
+  if (!warp) {
+    ForEachRowTile(tile_executor_, output->Height(), kDefaultMinTileRows,
+                   [&](int row_begin, int row_end) {
+                     gather.GatherRows(source, row_begin, row_end, output);
+                   });
+    return;
+  }
+
+  // The warp reads the scaled and padded image, and flips its output.
+  ImageFrame scaled;
+  cv::Mat scaled_mat = formats::MatView(&source);
+  if (!gather.IsIdentity()) {
+    scaled.Reset(input.Format(), gather.width(), gather.height(),
+                 ImageFrame::kDefaultAlignmentBoundary);
+    ForEachRowTile(tile_executor_, scaled.Height(), kDefaultMinTileRows,
+                   [&](int row_begin, int row_end) {
+                     gather.GatherRows(source, row_begin, row_end, &scaled);
+                   });
+    scaled_mat = formats::MatView(&scaled);
+  }
+  cv::Mat output_mat = formats::MatView(output);
+  WarpAffineInTiles(scaled_mat, rotation_mat, cv::INTER_LINEAR,
+                    cv::BORDER_CONSTANT, cv::Scalar(), flip_horizontally_,
+                    flip_vertically_, tile_executor_, output_mat);
+}
+
 absl::Status ImageTransformationCalculator::RenderGpu(CalculatorContext* cc) {
 #if !MEDIAPIPE_DISABLE_GPU
   const auto& input = cc->Inputs().Tag(kGpuBufferTag).Get<GpuBuffer>();
@@ -708,6 +825,53 @@ void ImageTransformationCalculator::ComputeOutputDimensions(
   }
 }
 
+ImageTransformationCalculator::CpuScaling
+ImageTransformationCalculator::ComputeCpuScaling(int input_width,
+                                                 int input_height) {
+  CpuScaling scaling;
+  const bool linear =
+      interpolation_mode_ == ImageTransformationCalculatorOptions::LINEAR;
+  if (scale_mode_ == mediapipe::ScaleMode::STRETCH) {
+    scaling.size = cv::Size(output_width_, output_height_);
+    if (linear) {
+      // Use INTER_AREA for downscaling if interpolation mode is set to
+      // LINEAR.
+      if (input_width > output_width_ && input_height > output_height_) {
+        scaling.interpolation = cv::INTER_AREA;
+      } else {
+        scaling.interpolation = cv::INTER_LINEAR;
+      }
+    } else {
+      scaling.interpolation = cv::INTER_NEAREST;
+    }
+    return scaling;
+  }
+
+  const float scale =
+      std::min(static_cast<float>(output_width_) / input_width,
+               static_cast<float>(output_height_) / input_height);
+  const int target_width = std::round(input_width * scale);
+  const int target_height = std::round(input_height * scale);
+  scaling.size = cv::Size(target_width, target_height);
+  if (linear) {
+    // Use INTER_AREA for downscaling if interpolation mode is set to LINEAR.
+    if (scale < 1.0f) {
+      scaling.interpolation = cv::INTER_AREA;
+    } else {
+      scaling.interpolation = cv::INTER_LINEAR;
+    }
+  } else {
+    scaling.interpolation = cv::INTER_NEAREST;
+  }
+  if (scale_mode_ == mediapipe::ScaleMode::FIT) {
+    scaling.top = (output_height_ - target_height) / 2;
+    scaling.bottom = output_height_ - target_height - scaling.top;
+    scaling.left = (output_width_ - target_width) / 2;
+    scaling.right = output_width_ - target_width - scaling.left;
+  }
+  return scaling;
+}
+
 void ImageTransformationCalculator::ComputeOutputLetterboxPadding(
     int input_width, int input_height, int output_width, int output_height,
     std::array<float, 4>* padding) {
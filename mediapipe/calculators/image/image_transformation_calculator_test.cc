@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -6,7 +7,9 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
 #include "absl/log/absl_check.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "mediapipe/calculators/image/image_tiling.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/calculator_runner.h"
@@ -18,6 +21,7 @@
 #include "mediapipe/framework/port/opencv_imgcodecs_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 #include "mediapipe/gpu/multi_pool.h"
 #include "testing/base/public/gmock.h"
 #include "testing/base/public/googletest.h"
@@ -432,5 +436,87 @@ TEST(ImageTransformationCalculatorTest, FitScalingClearsBackground) {
             cv::Scalar(0));
 }
 
+// Returns the output of an ImageTransformationCalculator on the CPU with
+// "options" for "input", with enable_cpu_tiling set to "enable_cpu_tiling".
+ImageFrame RunCpuTransformation(const Packet& input, absl::string_view options,
+                                bool enable_cpu_tiling) {
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(absl::Substitute(
+          R"pb(
+            input_stream: "input_image"
+            output_stream: "output_image"
+            node {
+              calculator: "ImageTransformationCalculator"
+              input_stream: "IMAGE:input_image"
+              output_stream: "IMAGE:output_image"
+              options: {
+                [mediapipe.ImageTransformationCalculatorOptions.ext]: {
+                  $0
+                  enable_cpu_tiling: $1
+                }
+              }
+            })pb",
+          options, enable_cpu_tiling));
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("output_image", &graph_config, &output_packets);
+
+  CalculatorGraph graph(graph_config);
+  ABSL_QCHECK_OK(graph.SetServiceObject(
+      kImageTilingExecutorService,
+      std::make_shared<ThreadPoolExecutor>(/*num_threads=*/3)));
+  ABSL_QCHECK_OK(graph.StartRun({}));
+  ABSL_QCHECK_OK(
+      graph.AddPacketToInputStream("input_image", input.At(Timestamp(0))));
+  ABSL_QCHECK_OK(graph.CloseAllInputStreams());
+  ABSL_QCHECK_OK(graph.WaitUntilDone());
+  ABSL_QCHECK_EQ(output_packets.size(), 1);
+
+  const auto& output = output_packets[0].Get<ImageFrame>();
+  ImageFrame copy;
+  copy.CopyFrom(output, ImageFrame::kDefaultAlignmentBoundary);
+  return copy;
+}
+
+TEST(ImageTransformationCalculatorTest, CpuTilingMatchesUntiledOutput) {
+  constexpr int kWidth = 97, kHeight = 61;
+  ImageFrame input_image(ImageFormat::SRGB, kWidth, kHeight);
+  cv::Mat input_mat = formats::MatView(&input_image);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      input_mat.at<cv::Vec3b>(y, x) = cv::Vec3b(x * 5, y * 7, (x * y) % 251);
+    }
+  }
+  const Packet input_packet = MakePacket<ImageFrame>(std::move(input_image));
+
+  const std::vector<std::string> all_options = {
+      "rotation_mode: ROTATION_90",
+      "rotation_mode: ROTATION_180 flip_vertically: true",
+      "rotation_mode: ROTATION_270 flip_horizontally: true",
+      "output_width: 48 output_height: 30",
+      "output_width: 194 output_height: 122 rotation_mode: ROTATION_90",
+      "output_width: 200 output_height: 200 scale_mode: FIT "
+      "interpolation_mode: NEAREST flip_vertically: true",
+      "output_width: 150 output_height: 100 scale_mode: FIT "
+      "constant_padding: false",
+      "output_width: 120 output_height: 90 scale_mode: FIT "
+      "rotation_mode: ROTATION_90 "
+      "padding_color: { red: 1 green: 2 blue: 3 }",
+      "output_width: 60 output_height: 60 scale_mode: FILL_AND_CROP "
+      "interpolation_mode: NEAREST rotation_mode: ROTATION_270",
+  };
+  for (const std::string& options : all_options) {
+    const ImageFrame expected = RunCpuTransformation(
+        input_packet, options, /*enable_cpu_tiling=*/false);
+    const ImageFrame output = RunCpuTransformation(input_packet, options,
+                                                   /*enable_cpu_tiling=*/true);
+    ASSERT_EQ(output.Width(), expected.Width()) << options;
+    ASSERT_EQ(output.Height(), expected.Height()) << options;
+    const cv::Mat output_mat = formats::MatView(&output);
+    const cv::Mat expected_mat = formats::MatView(&expected);
+    EXPECT_EQ(cv::sum(cv::sum(output_mat != expected_mat)), cv::Scalar(0))
+        << options;
+  }
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -30,6 +30,8 @@
 #include "mediapipe/framework/formats/image_format.pb.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/image_multi_pool.h"
+#include "mediapipe/framework/formats/image_multi_pool_service.h"
 #include "mediapipe/framework/formats/video_stream_header.h"
 #include "mediapipe/framework/formats/yuv_image.h"
 #include "mediapipe/framework/port/image_resizer.h"
@@ -186,6 +188,7 @@ class ScaleImageCalculator : public CalculatorBase {
     if (cc->Inputs().HasTag("OVERRIDE_OPTIONS")) {
       cc->Inputs().Tag("OVERRIDE_OPTIONS").Set<ScaleImageCalculatorOptions>();
     }
+    cc->UseService(kImageMultiPoolService).Optional();
     return absl::OkStatus();
   }
 
@@ -245,6 +248,9 @@ class ScaleImageCalculator : public CalculatorBase {
 
   // Efficient image resizer with gamma correction and optional sharpening.
   std::unique_ptr<ImageResizer> downscaler_;
+
+  // Pool for the output and cropped frames, if the graph provides one.
+  ImageMultiPool* image_pool_ = nullptr;
 };
 
 REGISTER_CALCULATOR(ScaleImageCalculator);
@@ -306,6 +312,9 @@ absl::Status ScaleImageCalculator::InitializeFrameInfo(CalculatorContext* cc) {
 
 absl::Status ScaleImageCalculator::Open(CalculatorContext* cc) {
   options_ = cc->Options<ScaleImageCalculatorOptions>();
+  if (cc->Service(kImageMultiPoolService).IsAvailable()) {
+    image_pool_ = &cc->Service(kImageMultiPoolService).GetObject();
+  }
 
   input_data_id_ = cc->Inputs().GetId("FRAMES", 0);
   if (!input_data_id_.IsValid()) {
@@ -638,8 +647,9 @@ absl::Status ScaleImageCalculator::Process(CalculatorContext* cc) {
   if (crop_width_ < input_width_ || crop_height_ < input_height_) {
     cc->GetCounter("Crops")->Increment();
     // TODO Do the crop as a range restrict inside OpenCV code below.
-    cropped_image.reset(new ImageFrame(image_frame->Format(), crop_width_,
-                                       crop_height_, alignment_boundary_));
+    cropped_image = NewImageFrame(image_pool_, image_frame->Format(),
+                                  crop_width_, crop_height_,
+                                  alignment_boundary_);
     if (image_frame->ByteDepth() == 1 || image_frame->ByteDepth() == 2) {
       CropImageFrame(*image_frame, col_start_, row_start_, crop_width_,
                      crop_height_, cropped_image.get());
@@ -699,23 +709,24 @@ absl::Status ScaleImageCalculator::Process(CalculatorContext* cc) {
     return absl::InvalidArgumentError("Image frame is empty before rescaling.");
   }
 
-  // Rescale the image frame.
-  std::unique_ptr<ImageFrame> output_frame(new ImageFrame());
+  // Rescale the image frame directly into the output frame.
+  std::unique_ptr<ImageFrame> output_frame =
+      NewImageFrame(image_pool_, image_frame->Format(), output_width_,
+                    output_height_, alignment_boundary_);
+  cv::Mat input_mat = ::mediapipe::formats::MatView(image_frame);
+  cv::Mat output_mat = ::mediapipe::formats::MatView(output_frame.get());
   if (image_frame->Width() >= output_width_ &&
       image_frame->Height() >= output_height_) {
     // Downscale.
     cc->GetCounter("Downscales")->Increment();
-    cv::Mat input_mat = ::mediapipe::formats::MatView(image_frame);
-    output_frame->Reset(image_frame->Format(), output_width_, output_height_,
-                        alignment_boundary_);
-    cv::Mat output_mat = ::mediapipe::formats::MatView(output_frame.get());
     downscaler_->Resize(input_mat, &output_mat);
   } else {
     // Upscale. If upscaling is disallowed, output_width_ and output_height_ are
     // the same as the input/crop width and height.
-    image_frame_util::RescaleImageFrame(
-        *image_frame, output_width_, output_height_, alignment_boundary_,
-        interpolation_algorithm_, output_frame.get());
+    ABSL_CHECK_EQ(ImageFormat::SRGB, image_frame->Format());
+    image_frame_util::RescaleSrgbImage(input_mat, output_width_,
+                                       output_height_,
+                                       interpolation_algorithm_, &output_mat);
     if (interpolation_algorithm_ != -1) {
       cc->GetCounter("Upscales")->Increment();
     }
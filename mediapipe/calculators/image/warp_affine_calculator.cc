@@ -26,6 +26,7 @@
 #include "absl/status/statusor.h"
 #if !MEDIAPIPE_DISABLE_OPENCV
 #include "mediapipe/calculators/image/affine_transformation_runner_opencv.h"
+#include "mediapipe/calculators/image/image_tiling.h"
 #endif  // !MEDIAPIPE_DISABLE_OPENCV
 #include "mediapipe/calculators/image/warp_affine_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
@@ -74,14 +75,18 @@ class WarpAffineRunnerHolder<ImageFrame> {
  public:
   using RunnerType = AffineTransformation::Runner<ImageFrame, ImageFrame>;
   absl::Status Open(CalculatorContext* cc) {
-    interpolation_ = GetInterpolation(
-        cc->Options<mediapipe::WarpAffineCalculatorOptions>().interpolation());
+    const auto& options = cc->Options<mediapipe::WarpAffineCalculatorOptions>();
+    interpolation_ = GetInterpolation(options.interpolation());
+    if (options.enable_cpu_tiling() &&
+        cc->Service(kImageTilingExecutorService).IsAvailable()) {
+      tile_executor_ = &cc->Service(kImageTilingExecutorService).GetObject();
+    }
     return absl::OkStatus();
   }
   absl::StatusOr<RunnerType*> GetRunner() {
     if (!runner_) {
-      MP_ASSIGN_OR_RETURN(
-          runner_, CreateAffineTransformationOpenCvRunner(interpolation_));
+      MP_ASSIGN_OR_RETURN(runner_, CreateAffineTransformationOpenCvRunner(
+                                       interpolation_, tile_executor_));
     }
     return runner_.get();
   }
@@ -89,6 +94,7 @@ class WarpAffineRunnerHolder<ImageFrame> {
  private:
   std::unique_ptr<RunnerType> runner_;
   AffineTransformation::Interpolation interpolation_;
+  ThreadPoolExecutor* tile_executor_ = nullptr;
 };
 #endif  // !MEDIAPIPE_DISABLE_OPENCV
 
@@ -201,16 +207,22 @@ class WarpAffineRunnerHolder<mediapipe::Image> {
 template <typename InterfaceT>
 class WarpAffineCalculatorImpl : public mediapipe::api2::NodeImpl<InterfaceT> {
  public:
-#if !MEDIAPIPE_DISABLE_GPU
   static absl::Status UpdateContract(CalculatorContract* cc) {
+#if !MEDIAPIPE_DISABLE_GPU
     if constexpr (std::is_same_v<InterfaceT, WarpAffineCalculatorGpu> ||
                   std::is_same_v<InterfaceT, WarpAffineCalculator>) {
       MP_RETURN_IF_ERROR(mediapipe::GlCalculatorHelper::UpdateContract(
           cc, /*request_gpu_as_optional=*/true));
     }
+#endif  // !MEDIAPIPE_DISABLE_GPU
+#if !MEDIAPIPE_DISABLE_OPENCV
+    if constexpr (std::is_same_v<InterfaceT, WarpAffineCalculatorCpu> ||
+                  std::is_same_v<InterfaceT, WarpAffineCalculator>) {
+      cc->UseService(kImageTilingExecutorService).Optional();
+    }
+#endif  // !MEDIAPIPE_DISABLE_OPENCV
     return absl::OkStatus();
   }
-#endif  // !MEDIAPIPE_DISABLE_GPU
   absl::Status Process(CalculatorContext* cc) override {
     if (InterfaceT::kInImage(cc).IsEmpty() ||
         InterfaceT::kMatrix(cc).IsEmpty() ||
@@ -204,7 +204,9 @@ class AudioToTensorCalculator : public Node {
   audio_dsp::QResamplerParams params_;
   // A QResampler instance to resample an audio stream.
   std::unique_ptr<audio_dsp::QResampler<float>> resampler_;
-  Matrix sample_buffer_;
+  // Reused across packets to avoid reallocations.
+  Matrix resampled_buffer_;
+  time_series_util::SampleBuffer sample_buffer_;
   int processed_buffer_cols_ = 0;
   double gain_ = 1.0;
 
@@ -225,15 +227,16 @@ class AudioToTensorCalculator : public Node {
                                        const Matrix& input);
 
   absl::Status SetupStreamingResampler(double input_sample_rate_);
-  void AppendToSampleBuffer(Matrix buffer_to_append);
   void AppendZerosToSampleBuffer(int num_samples);
 
+  // The blocks of samples are contiguous views, so that frames are converted
+  // without intermediate copies.
   absl::StatusOr<std::vector<Tensor>> ConvertToTensor(
-      const Matrix& block, std::vector<int> tensor_dims);
-  absl::Status OutputTensor(const Matrix& block, Timestamp timestamp,
-                            CalculatorContext* cc);
-  absl::Status ProcessBuffer(const Matrix& buffer, bool should_flush,
-                             CalculatorContext* cc);
+      const Eigen::Ref<const Matrix>& block, std::vector<int> tensor_dims);
+  absl::Status OutputTensor(const Eigen::Ref<const Matrix>& block,
+                            Timestamp timestamp, CalculatorContext* cc);
+  absl::Status ProcessBuffer(const Eigen::Ref<const Matrix>& buffer,
+                             bool should_flush, CalculatorContext* cc);
 };
 
 absl::Status AudioToTensorCalculator::UpdateContract(CalculatorContract* cc) {
@@ -283,7 +286,10 @@ absl::Status AudioToTensorCalculator::Open(CalculatorContext* cc) {
   stream_mode_ = options.stream_mode();
   if (stream_mode_) {
     check_inconsistent_timestamps_ = options.check_inconsistent_timestamps();
-    sample_buffer_.resize(num_channels_, Eigen::NoChange);
+    sample_buffer_.Reset(num_channels_);
+    // Leaves room for a frame and an input packet of up to a frame of
+    // samples.
+    sample_buffer_.Reserve(2 * num_samples_);
   }
   padding_samples_before_ = options.padding_samples_before();
   padding_samples_after_ = options.padding_samples_after();
@@ -377,10 +383,11 @@ absl::Status AudioToTensorCalculator::Close(CalculatorContext* cc) {
   if (resampler_) {
     Matrix resampled_buffer(num_channels_, 0);
     resampler_->Flush(&resampled_buffer);
-    AppendToSampleBuffer(std::move(resampled_buffer));
+    sample_buffer_.Push(resampled_buffer);
   }
   AppendZerosToSampleBuffer(padding_samples_after_);
-  MP_RETURN_IF_ERROR(ProcessBuffer(sample_buffer_, /*should_flush=*/true, cc));
+  MP_RETURN_IF_ERROR(
+      ProcessBuffer(sample_buffer_.Samples(), /*should_flush=*/true, cc));
   if (fft_state_) {
     pffft_destroy_setup(fft_state_);
   }
@@ -410,25 +417,16 @@ absl::Status AudioToTensorCalculator::ProcessStreamingData(
   }
 
   if (resampler_) {
-    Matrix resampled_buffer(num_channels_, 0);
-    resampler_->ProcessSamples(input_buffer, &resampled_buffer);
-    AppendToSampleBuffer(std::move(resampled_buffer));
+    resampler_->ProcessSamples(input_buffer, &resampled_buffer_);
+    sample_buffer_.Push(resampled_buffer_);
   } else {
-    // Tries to consume the input matrix first to avoid extra data copy.
-    auto status_or_matrix = kAudioIn(cc).packet().Consume<Matrix>();
-    if (status_or_matrix.ok()) {
-      Matrix local_matrix(num_channels_, 0);
-      local_matrix.swap(*status_or_matrix.value());
-      AppendToSampleBuffer(std::move(local_matrix));
-    } else {
-      AppendToSampleBuffer(input_buffer);
-    }
+    sample_buffer_.Push(input_buffer);
   }
 
-  MP_RETURN_IF_ERROR(ProcessBuffer(sample_buffer_, /*should_flush=*/false, cc));
+  MP_RETURN_IF_ERROR(
+      ProcessBuffer(sample_buffer_.Samples(), /*should_flush=*/false, cc));
   // Removes the processed samples from the global sample buffer.
-  sample_buffer_ = Matrix(sample_buffer_.rightCols(sample_buffer_.cols() -
-                                                   processed_buffer_cols_ - 1));
+  sample_buffer_.Drop(processed_buffer_cols_ + 1);
   return absl::OkStatus();
 }
 
@@ -468,22 +466,13 @@ absl::Status AudioToTensorCalculator::SetupStreamingResampler(
 
 void AudioToTensorCalculator::AppendZerosToSampleBuffer(int num_samples) {
   ABSL_CHECK_GE(num_samples, 0);  // Ensured by `UpdateContract`.
-  if (num_samples == 0) {
-    return;
-  }
-  sample_buffer_.conservativeResize(Eigen::NoChange,
-                                    sample_buffer_.cols() + num_samples);
-  sample_buffer_.rightCols(num_samples).setZero();
-}
-
-void AudioToTensorCalculator::AppendToSampleBuffer(Matrix buffer_to_append) {
-  sample_buffer_.conservativeResize(
-      Eigen::NoChange, sample_buffer_.cols() + buffer_to_append.cols());
-  sample_buffer_.rightCols(buffer_to_append.cols()).swap(buffer_to_append);
+  sample_buffer_.PushZeros(num_samples);
 }
 
 absl::StatusOr<std::vector<Tensor>> AudioToTensorCalculator::ConvertToTensor(
-    const Matrix& block, std::vector<int> tensor_dims) {
+    const Eigen::Ref<const Matrix>& block, std::vector<int> tensor_dims) {
+  // Blocks span all the rows, so their samples are contiguous.
+  RET_CHECK_EQ(block.outerStride(), block.rows());
   Tensor tensor(Tensor::ElementType::kFloat32, Tensor::Shape(tensor_dims),
                 memory_manager_);
   auto buffer_view = tensor.GetCpuWriteView();
@@ -501,9 +490,9 @@ absl::StatusOr<std::vector<Tensor>> AudioToTensorCalculator::ConvertToTensor(
   return tensor_vector;
 }
 
-absl::Status AudioToTensorCalculator::OutputTensor(const Matrix& block,
-                                                   Timestamp timestamp,
-                                                   CalculatorContext* cc) {
+absl::Status AudioToTensorCalculator::OutputTensor(
+    const Eigen::Ref<const Matrix>& block, Timestamp timestamp,
+    CalculatorContext* cc) {
   std::vector<Tensor> output_tensor;
   if (fft_state_) {
     Eigen::VectorXf time_series_data =
@@ -564,9 +553,9 @@ absl::Status AudioToTensorCalculator::OutputTensor(const Matrix& block,
   return absl::OkStatus();
 }
 
-absl::Status AudioToTensorCalculator::ProcessBuffer(const Matrix& buffer,
-                                                    bool should_flush,
-                                                    CalculatorContext* cc) {
+absl::Status AudioToTensorCalculator::ProcessBuffer(
+    const Eigen::Ref<const Matrix>& buffer, bool should_flush,
+    CalculatorContext* cc) {
   const bool should_flush_at_timestamp_max =
       stream_mode_ && should_flush &&
       flush_mode_ == Options::ENTIRE_TAIL_AT_TIMESTAMP_MAX;
@@ -15,15 +15,18 @@
 #include "mediapipe/calculators/tensor/image_to_tensor_converter_opencv.h"
 
 #include <cmath>
+#include <cstdint>
 #include <memory>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_converter.h"
+#include "mediapipe/calculators/tensor/image_to_tensor_cpu.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image.h"
 #include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_opencv.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/canonical_errors.h"
@@ -40,7 +43,9 @@ class ImageToTensorOpenCvConverter : public ImageToTensorConverter {
   ImageToTensorOpenCvConverter(BorderMode border_mode,
                                Tensor::ElementType tensor_type,
                                cv::InterpolationFlags flags)
-      : tensor_type_(tensor_type), flags_(flags) {
+      : tensor_border_mode_(border_mode),
+        tensor_type_(tensor_type),
+        flags_(flags) {
     switch (border_mode) {
       case BorderMode::kReplicate:
         border_mode_ = cv::BORDER_REPLICATE;
@@ -130,6 +135,14 @@ class ImageToTensorOpenCvConverter : public ImageToTensorConverter {
             absl::StrCat("Unsupported tensor type: ", tensor_type_));
     }
 
+    if (flags_ == cv::INTER_LINEAR &&
+        (input.channels() == 1) == (output_channels == 1)) {
+      // Samples, normalizes and writes the output in a single pass.
+      return ConvertOnCpu(*input.GetImageFrameSharedPtr(), roi, range_min,
+                          range_max, output_width, output_height,
+                          output_channels, dst.data);
+    }
+
     const cv::RotatedRect rotated_rect(cv::Point2f(roi.center_x, roi.center_y),
                                        cv::Size2f(roi.width, roi.height),
                                        roi.rotation * 180.f / M_PI);
@@ -173,6 +186,32 @@ class ImageToTensorOpenCvConverter : public ImageToTensorConverter {
   }
 
  private:
+  absl::Status ConvertOnCpu(const ImageFrame& input, const RotatedRect& roi,
+                            float range_min, float range_max, int output_width,
+                            int output_height, int output_channels,
+                            uint8_t* output) {
+    switch (tensor_type_) {
+      case Tensor::ElementType::kInt8:
+        return ConvertImageRoiToTensorOnCpu(
+            input, roi, tensor_border_mode_, range_min, range_max,
+            output_width, output_height, output_channels,
+            /*channels_first=*/false, reinterpret_cast<int8_t*>(output));
+      case Tensor::ElementType::kFloat32:
+        return ConvertImageRoiToTensorOnCpu(
+            input, roi, tensor_border_mode_, range_min, range_max,
+            output_width, output_height, output_channels,
+            /*channels_first=*/false, reinterpret_cast<float*>(output));
+      case Tensor::ElementType::kUInt8:
+        return ConvertImageRoiToTensorOnCpu(
+            input, roi, tensor_border_mode_, range_min, range_max,
+            output_width, output_height, output_channels,
+            /*channels_first=*/false, output);
+      default:
+        return absl::InvalidArgumentError(
+            absl::StrCat("Unsupported tensor type: ", tensor_type_));
+    }
+  }
+
   absl::Status ValidateTensorShape(const Tensor::Shape& output_shape) {
     RET_CHECK_EQ(output_shape.dims.size(), 4)
         << "Wrong output dims size: " << output_shape.dims.size();
@@ -183,6 +222,7 @@ class ImageToTensorOpenCvConverter : public ImageToTensorConverter {
     return absl::OkStatus();
   }
 
+  BorderMode tensor_border_mode_;
   enum cv::BorderTypes border_mode_;
   Tensor::ElementType tensor_type_;
   cv::InterpolationFlags flags_;
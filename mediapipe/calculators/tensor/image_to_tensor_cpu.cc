@@ -0,0 +1,264 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/image_to_tensor_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/status/status.h"
+#include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+
+namespace mediapipe {
+namespace {
+
+template <typename T>
+T ConvertValue(float value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return value;
+  } else {
+    // Rounds half to even, as cv::saturate_cast.
+    const long rounded = std::lrint(value);  // NOLINT
+    return static_cast<T>(
+        std::clamp<long>(rounded, std::numeric_limits<T>::min(),  // NOLINT
+                         std::numeric_limits<T>::max()));
+  }
+}
+
+// The four input pixels around a position and the weights of the right and
+// bottom ones for bilinear interpolation.
+struct Neighbors {
+  const uint8_t* top_left;
+  const uint8_t* top_right;
+  const uint8_t* bottom_left;
+  const uint8_t* bottom_right;
+  float weight_x;
+  float weight_y;
+};
+
+// Finds the bilinear interpolation inputs at arbitrary positions of the input
+// image. Pixel centers are at integer coordinates.
+class NeighborFinder {
+ public:
+  NeighborFinder(const ImageFrame& input, BorderMode border_mode)
+      : data_(input.PixelData()),
+        width_(input.Width()),
+        height_(input.Height()),
+        width_step_(input.WidthStep()),
+        channels_(input.NumberOfChannels()),
+        max_interior_x_(width_ - 1),
+        max_interior_y_(height_ - 1),
+        border_mode_(border_mode) {}
+
+  // Inlined into the per-pixel loop, with the rare border case kept out of
+  // line.
+  ABSL_ATTRIBUTE_ALWAYS_INLINE Neighbors Find(float x, float y) const {
+    if (x >= 0.0f && y >= 0.0f && x < max_interior_x_ &&
+        y < max_interior_y_) {
+      // All four neighbors are inside of the image.
+      const int x0 = static_cast<int>(x);
+      const int y0 = static_cast<int>(y);
+      const uint8_t* top_left = data_ + y0 * width_step_ + x0 * channels_;
+      return {top_left,
+              top_left + channels_,
+              top_left + width_step_,
+              top_left + width_step_ + channels_,
+              x - x0,
+              y - y0};
+    }
+    return FindAtBorder(x, y);
+  }
+
+ private:
+  ABSL_ATTRIBUTE_NOINLINE Neighbors FindAtBorder(float x, float y) const {
+    // Positions beyond one pixel outside of the image have the same neighbors
+    // as positions at that distance, and are clamped to avoid overflows.
+    x = std::clamp(x, -1.0f, static_cast<float>(width_));
+    y = std::clamp(y, -1.0f, static_cast<float>(height_));
+    const int x0 = static_cast<int>(std::floor(x));
+    const int y0 = static_cast<int>(std::floor(y));
+    return {Pixel(x0, y0),
+            Pixel(x0 + 1, y0),
+            Pixel(x0, y0 + 1),
+            Pixel(x0 + 1, y0 + 1),
+            x - x0,
+            y - y0};
+  }
+
+  // Returns the pixel at (x, y), or the extrapolated pixel for positions
+  // outside of the image.
+  const uint8_t* Pixel(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+      if (border_mode_ == BorderMode::kZero) {
+        return kZeroPixel;
+      }
+      x = std::clamp(x, 0, width_ - 1);
+      y = std::clamp(y, 0, height_ - 1);
+    }
+    return data_ + y * width_step_ + x * channels_;
+  }
+
+  static constexpr uint8_t kZeroPixel[4] = {0, 0, 0, 0};
+
+  const uint8_t* const data_;
+  const int width_;
+  const int height_;
+  const int width_step_;
+  const int channels_;
+  const float max_interior_x_;
+  const float max_interior_y_;
+  const BorderMode border_mode_;
+};
+
+template <typename T, int kChannels, bool kChannelsFirst>
+void ConvertRoi(const NeighborFinder& finder, const RotatedRect& roi,
+                const ValueTransformation& transform, int output_width,
+                int output_height, T* output) {
+  // The input position of output pixel (x, y) is
+  // origin + x * x_step + y * y_step.
+  const float cos_r = std::cos(roi.rotation);
+  const float sin_r = std::sin(roi.rotation);
+  const float x_step_x = roi.width / output_width * cos_r;
+  const float x_step_y = roi.width / output_width * sin_r;
+  const float y_step_x = -roi.height / output_height * sin_r;
+  const float y_step_y = roi.height / output_height * cos_r;
+  const float origin_x =
+      roi.center_x - 0.5f * roi.width * cos_r + 0.5f * roi.height * sin_r;
+  const float origin_y =
+      roi.center_y - 0.5f * roi.width * sin_r - 0.5f * roi.height * cos_r;
+
+  // Each row is processed in three steps: the scattered input reads, the
+  // interpolation and normalization, which the compiler can vectorize, and
+  // the output writes.
+  const int row_size = output_width * kChannels;
+  std::vector<uint8_t> top_left(row_size);
+  std::vector<uint8_t> top_right(row_size);
+  std::vector<uint8_t> bottom_left(row_size);
+  std::vector<uint8_t> bottom_right(row_size);
+  std::vector<float> weight_x(row_size);
+  std::vector<float> weight_y(row_size);
+  std::vector<float> values(row_size);
+  // Raw pointers, as uint8_t stores could alias the vector members.
+  uint8_t* const top_left_data = top_left.data();
+  uint8_t* const top_right_data = top_right.data();
+  uint8_t* const bottom_left_data = bottom_left.data();
+  uint8_t* const bottom_right_data = bottom_right.data();
+  float* const weight_x_data = weight_x.data();
+  float* const weight_y_data = weight_y.data();
+  float* const values_data = values.data();
+  const float scale = transform.scale;
+  const float offset = transform.offset;
+  for (int y = 0; y < output_height; ++y) {
+    const float row_x = origin_x + y * y_step_x;
+    const float row_y = origin_y + y * y_step_y;
+    for (int x = 0; x < output_width; ++x) {
+      const Neighbors neighbors = finder.Find(row_x + x * x_step_x,
+                                              row_y + x * x_step_y);
+      for (int c = 0; c < kChannels; ++c) {
+        const int i = x * kChannels + c;
+        top_left_data[i] = neighbors.top_left[c];
+        top_right_data[i] = neighbors.top_right[c];
+        bottom_left_data[i] = neighbors.bottom_left[c];
+        bottom_right_data[i] = neighbors.bottom_right[c];
+        weight_x_data[i] = neighbors.weight_x;
+        weight_y_data[i] = neighbors.weight_y;
+      }
+    }
+    for (int i = 0; i < row_size; ++i) {
+      const float top = top_left_data[i] +
+                        (top_right_data[i] - top_left_data[i]) *
+                            weight_x_data[i];
+      const float bottom = bottom_left_data[i] +
+                           (bottom_right_data[i] - bottom_left_data[i]) *
+                               weight_x_data[i];
+      values_data[i] = (top + (bottom - top) * weight_y_data[i]) * scale +
+                       offset;
+    }
+    if constexpr (kChannelsFirst) {
+      const int plane_size = output_width * output_height;
+      for (int c = 0; c < kChannels; ++c) {
+        T* plane_row = output + c * plane_size + y * output_width;
+        for (int x = 0; x < output_width; ++x) {
+          plane_row[x] = ConvertValue<T>(values_data[x * kChannels + c]);
+        }
+      }
+    } else {
+      T* row = output + y * row_size;
+      for (int i = 0; i < row_size; ++i) {
+        row[i] = ConvertValue<T>(values_data[i]);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+absl::Status ConvertImageRoiToTensorOnCpu(const ImageFrame& input,
+                                          const RotatedRect& roi,
+                                          BorderMode border_mode,
+                                          float range_min, float range_max,
+                                          int output_width, int output_height,
+                                          int output_channels,
+                                          bool channels_first, T* output) {
+  const ImageFormat::Format format = input.Format();
+  RET_CHECK(format == ImageFormat::SRGB || format == ImageFormat::SRGBA ||
+            format == ImageFormat::GRAY8)
+      << "Unsupported format: " << format;
+  RET_CHECK_EQ(output_channels, format == ImageFormat::GRAY8 ? 1 : 3)
+      << "Wrong output channels for format " << format;
+  RET_CHECK_GT(output_width, 0);
+  RET_CHECK_GT(output_height, 0);
+
+  constexpr float kInputImageRangeMin = 0.0f;
+  constexpr float kInputImageRangeMax = 255.0f;
+  MP_ASSIGN_OR_RETURN(
+      const ValueTransformation transform,
+      GetValueRangeTransformation(kInputImageRangeMin, kInputImageRangeMax,
+                                  range_min, range_max));
+  const NeighborFinder finder(input, border_mode);
+  if (output_channels == 1) {
+    // Both layouts are the same for a single channel.
+    ConvertRoi<T, 1, false>(finder, roi, transform, output_width,
+                            output_height, output);
+  } else if (channels_first) {
+    ConvertRoi<T, 3, true>(finder, roi, transform, output_width,
+                           output_height, output);
+  } else {
+    ConvertRoi<T, 3, false>(finder, roi, transform, output_width,
+                            output_height, output);
+  }
+  return absl::OkStatus();
+}
+
+template absl::Status ConvertImageRoiToTensorOnCpu<float>(
+    const ImageFrame&, const RotatedRect&, BorderMode, float, float, int, int,
+    int, bool, float*);
+template absl::Status ConvertImageRoiToTensorOnCpu<uint8_t>(
+    const ImageFrame&, const RotatedRect&, BorderMode, float, float, int, int,
+    int, bool, uint8_t*);
+template absl::Status ConvertImageRoiToTensorOnCpu<int8_t>(
+    const ImageFrame&, const RotatedRect&, BorderMode, float, float, int, int,
+    int, bool, int8_t*);
+
+}  // namespace mediapipe
@@ -0,0 +1,61 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_IMAGE_TO_TENSOR_CPU_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_IMAGE_TO_TENSOR_CPU_H_
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
+#include "mediapipe/framework/formats/image_frame.h"
+
+namespace mediapipe {
+
+// Samples the region of interest "roi" of "input" into an image of
+// output_width x output_height pixels with bilinear interpolation, converts
+// the values from [0, 255] to [range_min, range_max] and writes them to
+// "output" in HWC order, or CHW order if channels_first is set. This is a
+// single pass over the output, without intermediate images.
+//
+// The corners of the output are mapped to the corners of roi, as in
+// ImageToTensorOpenCvConverter. Pixels outside of the input are extrapolated
+// according to border_mode.
+//
+// Supports SRGB, SRGBA and GRAY8 inputs. output_channels is 3 for SRGB and
+// SRGBA inputs, whose alpha channel is dropped, and 1 for GRAY8 inputs.
+// Integer outputs are rounded and saturated. T is one of float, uint8_t and
+// int8_t.
+template <typename T>
+absl::Status ConvertImageRoiToTensorOnCpu(const ImageFrame& input,
+                                          const RotatedRect& roi,
+                                          BorderMode border_mode,
+                                          float range_min, float range_max,
+                                          int output_width, int output_height,
+                                          int output_channels,
+                                          bool channels_first, T* output);
+
+extern template absl::Status ConvertImageRoiToTensorOnCpu<float>(
+    const ImageFrame&, const RotatedRect&, BorderMode, float, float, int, int,
+    int, bool, float*);
+extern template absl::Status ConvertImageRoiToTensorOnCpu<uint8_t>(
+    const ImageFrame&, const RotatedRect&, BorderMode, float, float, int, int,
+    int, bool, uint8_t*);
+extern template absl::Status ConvertImageRoiToTensorOnCpu<int8_t>(
+    const ImageFrame&, const RotatedRect&, BorderMode, float, float, int, int,
+    int, bool, int8_t*);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_IMAGE_TO_TENSOR_CPU_H_
@@ -0,0 +1,235 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/image_to_tensor_cpu.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/benchmark.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAreArray;
+
+// Returns an image whose channel c at (x, y) is (x + 3 * y + 50 * c) % 256.
+ImageFrame MakeImage(ImageFormat::Format format, int width, int height) {
+  ImageFrame image(format, width, height);
+  const int channels = image.NumberOfChannels();
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = image.MutablePixelData() + y * image.WidthStep();
+    for (int x = 0; x < width; ++x) {
+      for (int c = 0; c < channels; ++c) {
+        row[x * channels + c] = (x + 3 * y + 50 * c) % 256;
+      }
+    }
+  }
+  return image;
+}
+
+uint8_t PixelValue(const ImageFrame& image, int x, int y, int c) {
+  return image.PixelData()[y * image.WidthStep() +
+                           x * image.NumberOfChannels() + c];
+}
+
+RotatedRect WholeImage(const ImageFrame& image) {
+  return {.center_x = image.Width() / 2.0f,
+          .center_y = image.Height() / 2.0f,
+          .width = static_cast<float>(image.Width()),
+          .height = static_cast<float>(image.Height()),
+          .rotation = 0.0f};
+}
+
+TEST(ImageToTensorCpuTest, CopiesAndNormalizesWholeImage) {
+  const ImageFrame image = MakeImage(ImageFormat::SRGB, 8, 6);
+  std::vector<float> output(8 * 6 * 3);
+  MP_ASSERT_OK(ConvertImageRoiToTensorOnCpu(
+      image, WholeImage(image), BorderMode::kZero, /*range_min=*/0.0f,
+      /*range_max=*/1.0f, /*output_width=*/8, /*output_height=*/6,
+      /*output_channels=*/3, /*channels_first=*/false, output.data()));
+  for (int y = 0; y < 6; ++y) {
+    for (int x = 0; x < 8; ++x) {
+      for (int c = 0; c < 3; ++c) {
+        EXPECT_FLOAT_EQ(output[(y * 8 + x) * 3 + c],
+                        PixelValue(image, x, y, c) / 255.0f)
+            << x << ", " << y << ", " << c;
+      }
+    }
+  }
+}
+
+TEST(ImageToTensorCpuTest, DownscalesRoi) {
+  const ImageFrame image = MakeImage(ImageFormat::SRGBA, 16, 12);
+  std::vector<uint8_t> output(8 * 6 * 3);
+  MP_ASSERT_OK(ConvertImageRoiToTensorOnCpu(
+      image, WholeImage(image), BorderMode::kZero, /*range_min=*/0.0f,
+      /*range_max=*/255.0f, /*output_width=*/8, /*output_height=*/6,
+      /*output_channels=*/3, /*channels_first=*/false, output.data()));
+  // Output pixel (x, y) samples input pixel (2 * x, 2 * y). Alpha is dropped.
+  for (int y = 0; y < 6; ++y) {
+    for (int x = 0; x < 8; ++x) {
+      for (int c = 0; c < 3; ++c) {
+        EXPECT_EQ(output[(y * 8 + x) * 3 + c],
+                  PixelValue(image, 2 * x, 2 * y, c))
+            << x << ", " << y << ", " << c;
+      }
+    }
+  }
+}
+
+TEST(ImageToTensorCpuTest, InterpolatesBilinearly) {
+  const ImageFrame image = MakeImage(ImageFormat::GRAY8, 4, 4);
+  std::vector<float> output(1);
+  // The single output pixel samples the center of the 2x2 ROI at (1.5, 1.5).
+  MP_ASSERT_OK(ConvertImageRoiToTensorOnCpu(
+      image,
+      {.center_x = 2.5f, .center_y = 2.5f, .width = 2, .height = 2,
+       .rotation = 0},
+      BorderMode::kZero, /*range_min=*/0.0f, /*range_max=*/255.0f,
+      /*output_width=*/1, /*output_height=*/1, /*output_channels=*/1,
+      /*channels_first=*/false, output.data()));
+  EXPECT_FLOAT_EQ(output[0], (PixelValue(image, 1, 1, 0) +
+                              PixelValue(image, 2, 1, 0) +
+                              PixelValue(image, 1, 2, 0) +
+                              PixelValue(image, 2, 2, 0)) /
+                                 4.0f);
+}
+
+TEST(ImageToTensorCpuTest, ExtrapolatesBorder) {
+  // Row 1 of the image is {3, 4, 5, 6}.
+  const ImageFrame image = MakeImage(ImageFormat::GRAY8, 4, 4);
+  std::vector<int8_t> output(8);
+  auto convert = [&](float center_x, BorderMode border_mode) {
+    const RotatedRect roi = {.center_x = center_x,
+                             .center_y = 1.5f,
+                             .width = 8,
+                             .height = 1,
+                             .rotation = 0};
+    return ConvertImageRoiToTensorOnCpu(
+        image, roi, border_mode, /*range_min=*/-128.0f, /*range_max=*/127.0f,
+        /*output_width=*/8, /*output_height=*/1, /*output_channels=*/1,
+        /*channels_first=*/false, output.data());
+  };
+  // Columns -4 to 3.
+  MP_ASSERT_OK(convert(/*center_x=*/0, BorderMode::kZero));
+  EXPECT_THAT(output, ElementsAreArray<int8_t>(
+                          {-128, -128, -128, -128, -125, -124, -123, -122}));
+  MP_ASSERT_OK(convert(/*center_x=*/0, BorderMode::kReplicate));
+  EXPECT_THAT(output, ElementsAreArray<int8_t>(
+                          {-125, -125, -125, -125, -125, -124, -123, -122}));
+  // Columns -2 to 5.
+  MP_ASSERT_OK(convert(/*center_x=*/2, BorderMode::kZero));
+  EXPECT_THAT(output, ElementsAreArray<int8_t>(
+                          {-128, -128, -125, -124, -123, -122, -128, -128}));
+  MP_ASSERT_OK(convert(/*center_x=*/2, BorderMode::kReplicate));
+  EXPECT_THAT(output, ElementsAreArray<int8_t>(
+                          {-125, -125, -125, -124, -123, -122, -122, -122}));
+}
+
+TEST(ImageToTensorCpuTest, WritesChannelsFirst) {
+  const ImageFrame image = MakeImage(ImageFormat::SRGB, 10, 7);
+  const RotatedRect roi = {.center_x = 4.2f,
+                           .center_y = 3.1f,
+                           .width = 6.5f,
+                           .height = 5.0f,
+                           .rotation = 0.7f};
+  std::vector<float> hwc(5 * 4 * 3);
+  std::vector<float> chw(5 * 4 * 3);
+  MP_ASSERT_OK(ConvertImageRoiToTensorOnCpu(
+      image, roi, BorderMode::kReplicate, /*range_min=*/-1.0f,
+      /*range_max=*/1.0f, /*output_width=*/5, /*output_height=*/4,
+      /*output_channels=*/3, /*channels_first=*/false, hwc.data()));
+  MP_ASSERT_OK(ConvertImageRoiToTensorOnCpu(
+      image, roi, BorderMode::kReplicate, /*range_min=*/-1.0f,
+      /*range_max=*/1.0f, /*output_width=*/5, /*output_height=*/4,
+      /*output_channels=*/3, /*channels_first=*/true, chw.data()));
+  for (int i = 0; i < 5 * 4; ++i) {
+    for (int c = 0; c < 3; ++c) {
+      EXPECT_EQ(chw[c * 5 * 4 + i], hwc[i * 3 + c]) << i << ", " << c;
+    }
+  }
+}
+
+TEST(ImageToTensorCpuTest, RejectsWrongChannels) {
+  const ImageFrame image = MakeImage(ImageFormat::SRGB, 4, 4);
+  std::vector<float> output(4 * 4 * 3);
+  EXPECT_FALSE(ConvertImageRoiToTensorOnCpu(
+                   image, WholeImage(image), BorderMode::kZero,
+                   /*range_min=*/0.0f, /*range_max=*/1.0f,
+                   /*output_width=*/4, /*output_height=*/4,
+                   /*output_channels=*/1, /*channels_first=*/false,
+                   output.data())
+                   .ok());
+}
+
+// Compares the warpPerspective and convertTo passes of
+// ImageToTensorOpenCvConverter (state.range(1) == 0) to
+// ConvertImageRoiToTensorOnCpu (state.range(1) == 1), for a rotated ROI of a
+// square SRGB input of state.range(0) pixels and a 224x224 float output.
+void BM_ConvertImageRoiToTensor(benchmark::State& state) {
+  const int input_size = state.range(0);
+  constexpr int kOutputSize = 224;
+  const ImageFrame image =
+      MakeImage(ImageFormat::SRGB, input_size, input_size);
+  const RotatedRect roi = {.center_x = input_size / 2.0f,
+                           .center_y = input_size / 2.0f,
+                           .width = input_size * 0.8f,
+                           .height = input_size * 0.8f,
+                           .rotation = 0.3f};
+  std::vector<float> output(kOutputSize * kOutputSize * 3);
+  const cv::Mat input_mat = formats::MatView(&image);
+  cv::Mat output_mat(kOutputSize, kOutputSize, CV_32FC3, output.data());
+  const cv::RotatedRect rotated_rect(cv::Point2f(roi.center_x, roi.center_y),
+                                     cv::Size2f(roi.width, roi.height),
+                                     roi.rotation * 180.f / M_PI);
+  cv::Mat src_points;
+  cv::boxPoints(rotated_rect, src_points);
+  float dst_corners[8] = {0.0f, kOutputSize, 0.0f,        0.0f,
+                          kOutputSize, 0.0f, kOutputSize, kOutputSize};
+  const cv::Mat dst_points = cv::Mat(4, 2, CV_32F, dst_corners);
+  for (auto _ : state) {
+    if (state.range(1)) {
+      ABSL_CHECK_OK(ConvertImageRoiToTensorOnCpu(
+          image, roi, BorderMode::kReplicate, /*range_min=*/-1.0f,
+          /*range_max=*/1.0f, kOutputSize, kOutputSize,
+          /*output_channels=*/3, /*channels_first=*/false, output.data()));
+    } else {
+      const cv::Mat projection_matrix =
+          cv::getPerspectiveTransform(src_points, dst_points);
+      cv::Mat transformed;
+      cv::warpPerspective(input_mat, transformed, projection_matrix,
+                          cv::Size(kOutputSize, kOutputSize), cv::INTER_LINEAR,
+                          cv::BORDER_REPLICATE);
+      transformed.convertTo(output_mat, CV_32FC3, 2.0f / 255.0f, -1.0f);
+    }
+    benchmark::DoNotOptimize(output.data());
+  }
+}
+BENCHMARK(BM_ConvertImageRoiToTensor)
+    ->ArgsProduct({{224, 256, 640}, {0, 1}});
+
+}  // namespace
+}  // namespace mediapipe
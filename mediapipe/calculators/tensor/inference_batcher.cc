@@ -0,0 +1,137 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/inference_batcher.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/tensor_span.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+
+InferenceBatcher::InferenceBatcher(int max_batch_size,
+                                   absl::Duration max_batch_latency,
+                                   int memory_alignment)
+    : max_batch_size_(max_batch_size),
+      max_batch_latency_(max_batch_latency),
+      memory_alignment_(memory_alignment) {
+  entries_.reserve(max_batch_size_);
+}
+
+absl::Status InferenceBatcher::Add(Timestamp timestamp,
+                                   const TensorSpan& input_tensors,
+                                   std::vector<Packet> input_packets,
+                                   absl::Time now) {
+  RET_CHECK_GT(input_tensors.size(), 0);
+  if (!entries_.empty()) {
+    const Entry& first = entries_.front();
+    RET_CHECK_GT(timestamp, entries_.back().timestamp);
+    RET_CHECK_EQ(input_tensors.size(), first.tensors.size())
+        << "All the inputs of a batch must have the same number of tensors.";
+    for (int i = 0; i < input_tensors.size(); ++i) {
+      RET_CHECK(input_tensors[i].element_type() ==
+                    first.tensors[i].element_type() &&
+                input_tensors[i].shape().dims == first.tensors[i].shape().dims)
+          << "Input tensor " << i << " at " << timestamp
+          << " does not match the type and shape of the batch.";
+    }
+  } else {
+    first_entry_time_ = now;
+  }
+  entries_.push_back({timestamp, input_tensors, std::move(input_packets)});
+  return absl::OkStatus();
+}
+
+bool InferenceBatcher::IsBatchReady(absl::Time now) const {
+  if (entries_.empty()) return false;
+  return entries_.size() >= max_batch_size_ ||
+         now - first_entry_time_ >= max_batch_latency_;
+}
+
+absl::StatusOr<InferenceBatcher::Batch> InferenceBatcher::TakeBatch() {
+  RET_CHECK(!entries_.empty());
+  Batch batch;
+  batch.timestamps.reserve(entries_.size());
+  for (const Entry& entry : entries_) {
+    batch.timestamps.push_back(entry.timestamp);
+  }
+
+  const TensorSpan& first = entries_.front().tensors;
+  batch.tensors.reserve(first.size());
+  for (int i = 0; i < first.size(); ++i) {
+    const Tensor& reference = first[i];
+    RET_CHECK(!reference.shape().dims.empty())
+        << "Scalar tensors cannot be batched.";
+    std::vector<int> dims = reference.shape().dims;
+    dims[0] *= entries_.size();
+    // The batched shape is marked as dynamic, so that the inference runner
+    // resizes the model input to it.
+    Tensor& batched = batch.tensors.emplace_back(
+        reference.element_type(), Tensor::Shape(dims, /*is_dynamic=*/true),
+        reference.quantization_parameters(), /*memory_manager=*/nullptr,
+        memory_alignment_);
+    auto batched_view = batched.GetCpuWriteView();
+    char* dst = batched_view.buffer<char>();
+    const int entry_bytes = reference.bytes();
+    for (const Entry& entry : entries_) {
+      auto view = entry.tensors[i].GetCpuReadView();
+      std::memcpy(dst, view.buffer<char>(), entry_bytes);
+      dst += entry_bytes;
+    }
+  }
+  // Releases the input packets, but keeps the capacity.
+  entries_.clear();
+  return batch;
+}
+
+absl::StatusOr<std::vector<std::vector<Tensor>>> SplitBatchedTensors(
+    std::vector<Tensor> batched_tensors, int batch_size) {
+  RET_CHECK_GT(batch_size, 0);
+  std::vector<std::vector<Tensor>> outputs(batch_size);
+  for (std::vector<Tensor>& output : outputs) {
+    output.reserve(batched_tensors.size());
+  }
+  for (const Tensor& batched : batched_tensors) {
+    const std::vector<int>& batched_dims = batched.shape().dims;
+    RET_CHECK(!batched_dims.empty() && batched_dims[0] % batch_size == 0)
+        << "The leading dimension of the output tensor is not a multiple of "
+           "the batch size "
+        << batch_size;
+    std::vector<int> dims = batched_dims;
+    dims[0] /= batch_size;
+    const int entry_bytes = batched.bytes() / batch_size;
+    auto batched_view = batched.GetCpuReadView();
+    const char* src = batched_view.buffer<char>();
+    for (std::vector<Tensor>& output : outputs) {
+      Tensor& tensor = output.emplace_back(batched.element_type(),
+                                           Tensor::Shape(dims),
+                                           batched.quantization_parameters());
+      auto view = tensor.GetCpuWriteView();
+      std::memcpy(view.buffer<char>(), src, entry_bytes);
+      src += entry_bytes;
+    }
+  }
+  return outputs;
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,103 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_INFERENCE_BATCHER_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_INFERENCE_BATCHER_H_
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/tensor_span.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+
+// Accumulates the input tensors of consecutive timestamps, so that they can be
+// run through a model in a single invocation with a batched leading dimension.
+//
+// Example usage:
+// ```
+//   MP_RETURN_IF_ERROR(batcher.Add(timestamp, input_tensors, packets, now));
+//   if (batcher.IsBatchReady(now)) {
+//     MP_ASSIGN_OR_RETURN(InferenceBatcher::Batch batch, batcher.TakeBatch());
+//     ... run inference on batch.tensors ...
+//     MP_ASSIGN_OR_RETURN(auto outputs, SplitBatchedTensors(
+//         std::move(output_tensors), batch.timestamps.size()));
+//   }
+// ```
+class InferenceBatcher {
+ public:
+  // The input tensors of several timestamps, concatenated along their leading
+  // dimension.
+  struct Batch {
+    std::vector<Timestamp> timestamps;
+    std::vector<Tensor> tensors;
+  };
+
+  // A batch is ready once it holds `max_batch_size` timestamps, or once its
+  // first timestamp has been queued for `max_batch_latency`. An infinite
+  // `max_batch_latency` disables the deadline. Batched tensors are allocated
+  // with `memory_alignment`, see Tensor's constructor.
+  InferenceBatcher(int max_batch_size, absl::Duration max_batch_latency,
+                   int memory_alignment = 0);
+
+  // Queues the `input_tensors` of `timestamp`, which must be greater than the
+  // previously queued timestamps. `input_packets` must keep the tensors
+  // referenced by `input_tensors` alive until the batch is taken. All the
+  // timestamps of a batch must have the same number of tensors, and the
+  // tensors at the same index must have the same type and shape.
+  absl::Status Add(Timestamp timestamp, const TensorSpan& input_tensors,
+                   std::vector<Packet> input_packets, absl::Time now);
+
+  // Returns true if the queued timestamps should be processed now.
+  bool IsBatchReady(absl::Time now) const;
+
+  // Returns the number of queued timestamps.
+  int size() const { return static_cast<int>(entries_.size()); }
+  bool empty() const { return entries_.empty(); }
+
+  // Returns the first queued timestamp. The queue must not be empty.
+  Timestamp first_timestamp() const { return entries_.front().timestamp; }
+
+  // Concatenates the queued input tensors and empties the queue.
+  absl::StatusOr<Batch> TakeBatch();
+
+ private:
+  struct Entry {
+    Timestamp timestamp;
+    TensorSpan tensors;
+    std::vector<Packet> packets;
+  };
+
+  const int max_batch_size_;
+  const absl::Duration max_batch_latency_;
+  const int memory_alignment_;
+  std::vector<Entry> entries_;
+  // The time at which the first queued timestamp was added.
+  absl::Time first_entry_time_;
+};
+
+// Splits each of `batched_tensors` along its leading dimension into
+// `batch_size` tensors of equal size. Returns the tensors of each batch entry,
+// in order.
+absl::StatusOr<std::vector<std::vector<Tensor>>> SplitBatchedTensors(
+    std::vector<Tensor> batched_tensors, int batch_size);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_INFERENCE_BATCHER_H_
@@ -0,0 +1,143 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/inference_batcher.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/tensor_span.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+// Returns a packet holding a single float tensor of shape [1, 2] filled with
+// `value`.
+Packet MakeTensorsPacket(float value) {
+  std::vector<Tensor> tensors;
+  Tensor& tensor =
+      tensors.emplace_back(Tensor::ElementType::kFloat32, Tensor::Shape{1, 2});
+  auto view = tensor.GetCpuWriteView();
+  view.buffer<float>()[0] = value;
+  view.buffer<float>()[1] = value + 0.5f;
+  return MakePacket<std::vector<Tensor>>(std::move(tensors));
+}
+
+absl::Status AddPacket(InferenceBatcher& batcher, Timestamp timestamp,
+                       Packet packet, absl::Time now) {
+  const TensorSpan tensors =
+      MakeTensorSpan(packet.Get<std::vector<Tensor>>());
+  return batcher.Add(timestamp, tensors, {std::move(packet)}, now);
+}
+
+std::vector<float> Values(const Tensor& tensor) {
+  auto view = tensor.GetCpuReadView();
+  const float* buffer = view.buffer<float>();
+  return std::vector<float>(buffer, buffer + tensor.shape().num_elements());
+}
+
+TEST(InferenceBatcherTest, IsReadyWhenFull) {
+  InferenceBatcher batcher(/*max_batch_size=*/3, absl::InfiniteDuration());
+  const absl::Time now = absl::Now();
+  EXPECT_FALSE(batcher.IsBatchReady(now));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_FALSE(batcher.IsBatchReady(now));
+    MP_ASSERT_OK(AddPacket(batcher, Timestamp(i), MakeTensorsPacket(i), now));
+  }
+  EXPECT_TRUE(batcher.IsBatchReady(now));
+  EXPECT_EQ(batcher.size(), 3);
+}
+
+TEST(InferenceBatcherTest, IsReadyAfterLatency) {
+  InferenceBatcher batcher(/*max_batch_size=*/16, absl::Milliseconds(5));
+  const absl::Time start = absl::Now();
+  MP_ASSERT_OK(AddPacket(batcher, Timestamp(0), MakeTensorsPacket(0), start));
+  MP_ASSERT_OK(AddPacket(batcher, Timestamp(1), MakeTensorsPacket(1),
+                         start + absl::Milliseconds(4)));
+  EXPECT_FALSE(batcher.IsBatchReady(start + absl::Milliseconds(4)));
+  EXPECT_TRUE(batcher.IsBatchReady(start + absl::Milliseconds(5)));
+}
+
+TEST(InferenceBatcherTest, ConcatenatesAlongLeadingDimension) {
+  InferenceBatcher batcher(/*max_batch_size=*/3, absl::InfiniteDuration());
+  const absl::Time now = absl::Now();
+  for (int i = 0; i < 3; ++i) {
+    MP_ASSERT_OK(
+        AddPacket(batcher, Timestamp(10 * i), MakeTensorsPacket(i), now));
+  }
+  EXPECT_EQ(batcher.first_timestamp(), Timestamp(0));
+  MP_ASSERT_OK_AND_ASSIGN(InferenceBatcher::Batch batch, batcher.TakeBatch());
+  EXPECT_TRUE(batcher.empty());
+  EXPECT_THAT(batch.timestamps,
+              ElementsAre(Timestamp(0), Timestamp(10), Timestamp(20)));
+  ASSERT_EQ(batch.tensors.size(), 1);
+  EXPECT_THAT(batch.tensors[0].shape().dims, ElementsAre(3, 2));
+  EXPECT_TRUE(batch.tensors[0].shape().is_dynamic);
+  EXPECT_THAT(Values(batch.tensors[0]),
+              ElementsAre(0.0f, 0.5f, 1.0f, 1.5f, 2.0f, 2.5f));
+}
+
+TEST(InferenceBatcherTest, RejectsMismatchingShapes) {
+  InferenceBatcher batcher(/*max_batch_size=*/3, absl::InfiniteDuration());
+  const absl::Time now = absl::Now();
+  MP_ASSERT_OK(AddPacket(batcher, Timestamp(0), MakeTensorsPacket(0), now));
+
+  std::vector<Tensor> tensors;
+  tensors.emplace_back(Tensor::ElementType::kFloat32, Tensor::Shape{1, 3});
+  Packet packet = MakePacket<std::vector<Tensor>>(std::move(tensors));
+  EXPECT_THAT(AddPacket(batcher, Timestamp(1), packet, now),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("does not match the type and shape")));
+}
+
+TEST(InferenceBatcherTest, SplitsAlongLeadingDimension) {
+  std::vector<Tensor> batched;
+  Tensor& tensor =
+      batched.emplace_back(Tensor::ElementType::kFloat32, Tensor::Shape{4, 2});
+  {
+    auto view = tensor.GetCpuWriteView();
+    for (int i = 0; i < 8; ++i) {
+      view.buffer<float>()[i] = i;
+    }
+  }
+  MP_ASSERT_OK_AND_ASSIGN(auto outputs,
+                          SplitBatchedTensors(std::move(batched), 2));
+  ASSERT_EQ(outputs.size(), 2);
+  ASSERT_EQ(outputs[0].size(), 1);
+  EXPECT_THAT(outputs[0][0].shape().dims, ElementsAre(2, 2));
+  EXPECT_THAT(Values(outputs[0][0]), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(Values(outputs[1][0]), ElementsAre(4, 5, 6, 7));
+}
+
+TEST(InferenceBatcherTest, SplitFailsOnIndivisibleLeadingDimension) {
+  std::vector<Tensor> batched;
+  batched.emplace_back(Tensor::ElementType::kFloat32, Tensor::Shape{3, 2});
+  EXPECT_THAT(SplitBatchedTensors(std::move(batched), 2),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("not a multiple of the batch size")));
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -24,6 +24,9 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/inference_batcher.h"
 #include "mediapipe/calculators/tensor/inference_calculator.pb.h"
 #include "mediapipe/calculators/tensor/inference_io_mapper.h"
 #include "mediapipe/calculators/tensor/tensor_span.h"
@@ -31,11 +34,16 @@
 #include "mediapipe/framework/api2/packet.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/collection_item_id.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/timestamp.h"
 #include "mediapipe/util/tflite/tflite_model_loader.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
 #include "tensorflow/lite/kernels/register.h"
+#include "tensorflow/lite/util.h"
 
 namespace mediapipe {
 namespace api2 {
@@ -199,27 +207,35 @@ class InferenceCalculatorNodeImpl : public NodeImpl<Intf, Impl> {
       // Using old vector<Tensor> inputs; skip if empty input stream, but error
       // if the input vector is empty.
       if (InferenceCalculator::kInTensors(cc).IsEmpty()) {
-        return absl::OkStatus();
+        return UpdateBatchTimestampBound(cc);
       }
       const auto& input_tensors = *InferenceCalculator::kInTensors(cc);
       RET_CHECK(!input_tensors.empty());
+      if (batcher_ != nullptr) {
+        return AddToBatch(cc, MakeTensorSpan(input_tensors));
+      }
       MP_ASSIGN_OR_RETURN(
           auto output_tensors,
           RemapAndProcessTensors(cc, MakeTensorSpan(input_tensors)));
-      return SendOutputTensors(cc, std::move(output_tensors));
+      return SendOutputTensors(cc, std::move(output_tensors),
+                               cc->InputTimestamp());
     }
     // Using new direct Tensor inputs; return early if any empty streams.
     for (int i = 0; i < InferenceCalculator::kInTensor(cc).Count(); ++i) {
       if (InferenceCalculator::kInTensor(cc)[i].IsEmpty()) {
-        return absl::OkStatus();
+        return UpdateBatchTimestampBound(cc);
       }
     }
 
+    if (batcher_ != nullptr) {
+      return AddToBatch(cc, MakeTensorSpan(InferenceCalculator::kInTensor(cc)));
+    }
     MP_ASSIGN_OR_RETURN(
         auto output_tensors,
         RemapAndProcessTensors(
             cc, MakeTensorSpan(InferenceCalculator::kInTensor(cc))));
-    return SendOutputTensors(cc, std::move(output_tensors));
+    return SendOutputTensors(cc, std::move(output_tensors),
+                             cc->InputTimestamp());
   }
 
  protected:
@@ -232,11 +248,109 @@ class InferenceCalculatorNodeImpl : public NodeImpl<Intf, Impl> {
     return io_mapper_->UpdateIoMap(GetInputOutputConfig(cc), tensor_names);
   }
 
+  // Lets the outputs lag behind the inputs while a batch is pending. Must be
+  // called in UpdateContract by implementations which support batched CPU
+  // inference.
+  static void UpdateBatchingContract(CalculatorContract* cc) {
+    if (cc->Options<mediapipe::InferenceCalculatorOptions>()
+            .batching()
+            .max_batch_size() > 1) {
+      // Outputs are sent at the timestamps of earlier inputs, so the default
+      // timestamp offset of 0 would reject them. The bounds are advanced in
+      // UpdateBatchTimestampBound instead.
+      cc->SetTimestampOffset(TimestampDiff::Unset());
+    }
+  }
+
+  // Enables micro-batching if requested in the calculator options. Must be
+  // called in Open by implementations which support batched CPU inference.
+  absl::Status MaybeEnableBatching(CalculatorContext* cc) {
+    const auto& batching =
+        cc->Options<mediapipe::InferenceCalculatorOptions>().batching();
+    if (batching.max_batch_size() <= 1) {
+      return absl::OkStatus();
+    }
+    RET_CHECK(GetInputOutputConfig(cc).feedback_tensor_links().empty())
+        << "Batching is not supported for models with feedback tensors.";
+    const absl::Duration max_batch_latency =
+        batching.max_latency_usec() > 0
+            ? absl::Microseconds(batching.max_latency_usec())
+            : absl::InfiniteDuration();
+    batcher_ = std::make_unique<InferenceBatcher>(
+        batching.max_batch_size(), max_batch_latency,
+        tflite::kDefaultTensorAlignment);
+    return absl::OkStatus();
+  }
+
+  // Runs inference on the inputs still waiting for their batch to fill up.
+  // Must be called in Close by implementations which enable batching, before
+  // releasing their inference resources.
+  absl::Status ProcessPendingBatch(CalculatorContext* cc) {
+    if (batcher_ == nullptr || batcher_->empty()) {
+      return absl::OkStatus();
+    }
+    return ProcessBatch(cc);
+  }
+
   // Process call providing TensorSpan input.
   virtual absl::StatusOr<std::vector<Tensor>> Process(
       CalculatorContext* cc, const TensorSpan& tensor_span) = 0;
 
  private:
+  // Queues the input tensors of the current timestamp, and runs inference on
+  // the batch once it is complete.
+  absl::Status AddToBatch(CalculatorContext* cc,
+                          const TensorSpan& input_tensors) {
+    // The input packets keep the queued tensors alive.
+    std::vector<mediapipe::Packet> input_packets;
+    input_packets.reserve(cc->Inputs().NumEntries());
+    for (CollectionItemId id = cc->Inputs().BeginId();
+         id < cc->Inputs().EndId(); ++id) {
+      input_packets.push_back(cc->Inputs().Get(id).Value());
+    }
+    const absl::Time now = absl::Now();
+    MP_RETURN_IF_ERROR(batcher_->Add(cc->InputTimestamp(), input_tensors,
+                                     std::move(input_packets), now));
+    if (batcher_->IsBatchReady(now)) {
+      MP_RETURN_IF_ERROR(ProcessBatch(cc));
+    }
+    return UpdateBatchTimestampBound(cc);
+  }
+
+  // Holds the output bounds at the first pending timestamp while a batch is
+  // open, and advances them past the current input timestamp otherwise.
+  absl::Status UpdateBatchTimestampBound(CalculatorContext* cc) {
+    if (batcher_ == nullptr) {
+      return absl::OkStatus();
+    }
+    const Timestamp bound = batcher_->empty()
+                                ? cc->InputTimestamp().NextAllowedInStream()
+                                : batcher_->first_timestamp();
+    for (CollectionItemId id = cc->Outputs().BeginId();
+         id < cc->Outputs().EndId(); ++id) {
+      cc->Outputs().Get(id).SetNextTimestampBound(bound);
+    }
+    return absl::OkStatus();
+  }
+
+  // Runs inference once on the queued inputs, and sends the outputs of each
+  // input at its timestamp.
+  absl::Status ProcessBatch(CalculatorContext* cc) {
+    MP_ASSIGN_OR_RETURN(InferenceBatcher::Batch batch, batcher_->TakeBatch());
+    MP_ASSIGN_OR_RETURN(
+        std::vector<Tensor> output_tensors,
+        RemapAndProcessTensors(cc, MakeTensorSpan(batch.tensors)));
+    MP_ASSIGN_OR_RETURN(
+        std::vector<std::vector<Tensor>> outputs,
+        SplitBatchedTensors(std::move(output_tensors),
+                            static_cast<int>(batch.timestamps.size())));
+    for (int i = 0; i < outputs.size(); ++i) {
+      MP_RETURN_IF_ERROR(
+          SendOutputTensors(cc, std::move(outputs[i]), batch.timestamps[i]));
+    }
+    return absl::OkStatus();
+  }
+
   // Remaps input tensors according to the IO map, runs inference, and remaps
   // output tensors.
   absl::StatusOr<std::vector<Tensor>> RemapAndProcessTensors(
@@ -255,16 +369,18 @@ class InferenceCalculatorNodeImpl : public NodeImpl<Intf, Impl> {
   // those Tensors are expected to be sent. We take an rvalue-reference to
   // ensure we can destroy/move the tensors.
   static absl::Status SendOutputTensors(CalculatorContext* cc,
-                                        std::vector<Tensor>&& output_tensors) {
+                                        std::vector<Tensor>&& output_tensors,
+                                        Timestamp timestamp) {
     if (InferenceCalculator::kOutTensors(cc).IsConnected()) {
-      InferenceCalculator::kOutTensors(cc).Send(std::move(output_tensors));
+      InferenceCalculator::kOutTensors(cc).Send(std::move(output_tensors),
+                                                timestamp);
     } else {
       const int output_count =
           std::min(InferenceCalculator::kOutTensor(cc).Count(),
                    static_cast<int>(output_tensors.size()));
       for (int i = 0; i < output_count; ++i) {
         InferenceCalculator::kOutTensor(cc)[i].Send(
-            std::move(output_tensors[i]));
+            std::move(output_tensors[i]), timestamp);
       }
     }
     return absl::OkStatus();
@@ -288,6 +404,8 @@ class InferenceCalculatorNodeImpl : public NodeImpl<Intf, Impl> {
   }
 
   std::unique_ptr<InferenceIoMapper> io_mapper_;
+  // Set if micro-batching is enabled.
+  std::unique_ptr<InferenceBatcher> batcher_;
 };
 
 }  // namespace api2
@@ -26,6 +26,7 @@
 #include "mediapipe/calculators/tensor/inference_interpreter_delegate_runner.h"
 #include "mediapipe/calculators/tensor/inference_runner.h"
 #include "mediapipe/calculators/tensor/tensor_span.h"
+#include "mediapipe/calculators/tensor/xnnpack_weights_cache.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/ret_check.h"
@@ -50,9 +51,15 @@ class InferenceCalculatorCpuImpl
  private:
   absl::StatusOr<std::unique_ptr<InferenceRunner>> CreateInferenceRunner(
       CalculatorContext* cc);
-  absl::StatusOr<TfLiteDelegatePtr> MaybeCreateDelegate(CalculatorContext* cc);
+  absl::StatusOr<TfLiteDelegatePtr> MaybeCreateDelegate(
+      CalculatorContext* cc, const tflite::FlatBufferModel& model);
   absl::StatusOr<std::vector<Tensor>> Process(
       CalculatorContext* cc, const TensorSpan& tensor_span) override;
+  // Set if the XNNPACK delegate shares its packed weights. Must outlive the
+  // inference runner.
+  std::shared_ptr<XnnpackWeightsCache> weights_cache_;
+  // Set if the delegate loads or writes a file of packed weights.
+  std::unique_ptr<XnnpackWeightsCacheFile> weights_cache_file_;
   std::unique_ptr<InferenceRunner> inference_runner_;
 };
 
@@ -64,13 +71,15 @@ absl::Status InferenceCalculatorCpuImpl::UpdateContract(
 
   MP_RETURN_IF_ERROR(TensorContractCheck(cc));
 
+  InferenceCalculatorNodeImpl::UpdateBatchingContract(cc);
   return absl::OkStatus();
 }
 
 absl::Status InferenceCalculatorCpuImpl::Open(CalculatorContext* cc) {
   MP_ASSIGN_OR_RETURN(inference_runner_, CreateInferenceRunner(cc));
-  return InferenceCalculatorNodeImpl::UpdateIoMapping(
-      cc, inference_runner_->GetInputOutputTensorNames());
+  MP_RETURN_IF_ERROR(InferenceCalculatorNodeImpl::UpdateIoMapping(
+      cc, inference_runner_->GetInputOutputTensorNames()));
+  return InferenceCalculatorNodeImpl::MaybeEnableBatching(cc);
 }
 
 absl::StatusOr<std::vector<Tensor>> InferenceCalculatorCpuImpl::Process(
@@ -81,7 +90,10 @@ absl::StatusOr<std::vector<Tensor>> InferenceCalculatorCpuImpl::Process(
 }
 
 absl::Status InferenceCalculatorCpuImpl::Close(CalculatorContext* cc) {
+  MP_RETURN_IF_ERROR(InferenceCalculatorNodeImpl::ProcessPendingBatch(cc));
   inference_runner_ = nullptr;
+  weights_cache_ = nullptr;
+  weights_cache_file_ = nullptr;
   return absl::OkStatus();
 }
 
@@ -92,15 +104,29 @@ InferenceCalculatorCpuImpl::CreateInferenceRunner(CalculatorContext* cc) {
   const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
   const int interpreter_num_threads =
       cc->Options<mediapipe::InferenceCalculatorOptions>().cpu_num_thread();
-  MP_ASSIGN_OR_RETURN(TfLiteDelegatePtr delegate, MaybeCreateDelegate(cc));
-  return CreateInferenceInterpreterDelegateRunner(
-      std::move(model_packet), std::move(op_resolver_packet),
-      std::move(delegate), interpreter_num_threads,
-      &options.input_output_config());
+  MP_ASSIGN_OR_RETURN(TfLiteDelegatePtr delegate,
+                      MaybeCreateDelegate(cc, *model_packet.Get()));
+  auto create_runner = [&]() {
+    return CreateInferenceInterpreterDelegateRunner(
+        std::move(model_packet), std::move(op_resolver_packet),
+        std::move(delegate), interpreter_num_threads,
+        &options.input_output_config());
+  };
+  if (weights_cache_ != nullptr) {
+    return weights_cache_->CreateRunner(std::move(create_runner));
+  }
+  if (weights_cache_file_ != nullptr) {
+    MP_ASSIGN_OR_RETURN(std::unique_ptr<InferenceRunner> runner,
+                        create_runner());
+    weights_cache_file_->Publish();
+    return runner;
+  }
+  return create_runner();
 }
 
 absl::StatusOr<TfLiteDelegatePtr>
-InferenceCalculatorCpuImpl::MaybeCreateDelegate(CalculatorContext* cc) {
+InferenceCalculatorCpuImpl::MaybeCreateDelegate(
+    CalculatorContext* cc, const tflite::FlatBufferModel& model) {
   const auto& calculator_opts =
       cc->Options<mediapipe::InferenceCalculatorOptions>();
   auto opts_delegate = calculator_opts.delegate();
@@ -156,6 +182,17 @@ InferenceCalculatorCpuImpl::MaybeCreateDelegate(CalculatorContext* cc) {
     auto xnnpack_opts = TfLiteXNNPackDelegateOptionsDefault();
     xnnpack_opts.num_threads =
         GetXnnpackNumThreads(opts_has_delegate, opts_delegate);
+    const std::string& weights_cache_dir =
+        opts_delegate.xnnpack().weights_cache_dir();
+    if (!weights_cache_dir.empty()) {
+      MP_ASSIGN_OR_RETURN(
+          weights_cache_file_,
+          XnnpackWeightsCacheFile::Create(model, weights_cache_dir));
+      weights_cache_file_->ConfigureDelegateOptions(xnnpack_opts);
+    } else if (opts_delegate.xnnpack().share_weights_cache()) {
+      weights_cache_ = XnnpackWeightsCache::GetOrCreate(model);
+      xnnpack_opts.weights_cache = weights_cache_->Get();
+    }
     return TfLiteDelegatePtr(TfLiteXNNPackDelegateCreate(&xnnpack_opts),
                              &TfLiteXNNPackDelegateDelete);
   }
@@ -12,14 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/log/absl_check.h"
+#include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "mediapipe/calculators/tensor/inference_calculator.pb.h"
 #include "mediapipe/calculators/tensor/inference_calculator_test_base.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -27,6 +32,7 @@
 #include "mediapipe/framework/deps/file_path.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/benchmark.h"
+#include "mediapipe/framework/port/file_helpers.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/parse_text_proto.h"
@@ -44,10 +50,18 @@
 namespace mediapipe {
 namespace {
 
+using ::testing::ElementsAre;
+
 constexpr int kTensorWidth = 8;
 constexpr int kTensorHeight = 8;
 constexpr int kTensorChannels = 3;
 
+constexpr char kAddModelPath[] =
+    "mediapipe/calculators/tensor/testdata/add.bin";
+// A model with enough weights for their packing to show in startup times.
+constexpr char kStartupModelPath[] =
+    "mediapipe/modules/face_detection/face_detection_short_range.tflite";
+
 constexpr char kGraphWithModelPathInOption[] = R"(
     input_stream: "tensor_in"
     node {
@@ -95,6 +109,67 @@ constexpr char kGraphWithModelAsInputSidePacket[] = R"(
     }
   )";
 
+constexpr char kGraphWithBatching[] = R"(
+    input_stream: "tensor_in"
+    node {
+      calculator: "InferenceCalculator"
+      input_stream: "TENSORS:tensor_in"
+      output_stream: "TENSORS:tensor_out"
+      options {
+        [mediapipe.InferenceCalculatorOptions.ext] {
+          model_path: "mediapipe/calculators/tensor/testdata/add.bin"
+          $delegate
+          batching { max_batch_size: $batch_size }
+        }
+      }
+    }
+  )";
+
+// Runs two XNNPACK inference calculators on the same model side packet.
+constexpr char kGraphWithSharedModel[] = R"(
+    input_stream: "tensor_in"
+
+    node {
+      calculator: "ResourceProviderCalculator"
+      output_side_packet: "RESOURCE:model_resource"
+      node_options {
+        [type.googleapis.com/mediapipe.ResourceProviderCalculatorOptions]: {
+          resource_id: "mediapipe/calculators/tensor/testdata/add.bin"
+        }
+      }
+    }
+
+    node {
+      calculator: "TfLiteModelCalculator"
+      input_side_packet: "MODEL_RESOURCE:model_resource"
+      output_side_packet: "MODEL:model"
+    }
+
+    node {
+      calculator: "InferenceCalculator"
+      input_stream: "TENSORS:tensor_in"
+      output_stream: "TENSORS:tensor_out"
+      input_side_packet: "MODEL:model"
+      options {
+        [mediapipe.InferenceCalculatorOptions.ext] {
+          delegate { xnnpack { share_weights_cache: $share } }
+        }
+      }
+    }
+
+    node {
+      calculator: "InferenceCalculator"
+      input_stream: "TENSORS:tensor_in"
+      output_stream: "TENSORS:other_tensor_out"
+      input_side_packet: "MODEL:model"
+      options {
+        [mediapipe.InferenceCalculatorOptions.ext] {
+          delegate { xnnpack { share_weights_cache: $share } }
+        }
+      }
+    }
+  )";
+
 std::vector<Tensor> CreateInputs(bool apply_default_tflite_tensor_alignment) {
   std::vector<Tensor> input_vec;
   // Prepare input tensor.
@@ -253,6 +328,191 @@ TEST(InferenceCalculatorTest, SmokeTestTfliteWithTensorAlignment) {
       /*use_vectors=*/true, /*apply_default_tflite_tensor_alignment=*/true);
 }
 
+// Checks that the interpreters of a model produce the same outputs, whether or
+// not they share the XNNPACK packed weights.
+void DoSharedModelTest(bool share_weights_cache) {
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrReplaceAll(
+          kGraphWithSharedModel,
+          {{"$share", share_weights_cache ? "true" : "false"}}));
+  std::vector<Packet> output_packets;
+  std::vector<Packet> other_output_packets;
+  tool::AddVectorSink("tensor_out", &graph_config, &output_packets);
+  tool::AddVectorSink("other_tensor_out", &graph_config,
+                      &other_output_packets);
+  CalculatorGraph graph(graph_config);
+  RunGraphThenClose(
+      graph, CreateInputs(/*apply_default_tflite_tensor_alignment=*/false));
+
+  for (const auto* packets : {&output_packets, &other_output_packets}) {
+    ASSERT_EQ(packets->size(), 1);
+    const Tensor& result = (*packets)[0].Get<std::vector<Tensor>>()[0];
+    auto view = result.GetCpuReadView();
+    const float* result_buffer = view.buffer<float>();
+    for (int i = 0; i < result.shape().num_elements(); ++i) {
+      ASSERT_EQ(3, result_buffer[i]);
+    }
+  }
+}
+
+TEST(InferenceCalculatorTest, SharedModelXnnpack) {
+  DoSharedModelTest(/*share_weights_cache=*/true);
+}
+TEST(InferenceCalculatorTest, SharedModelXnnpackWithoutSharedWeights) {
+  DoSharedModelTest(/*share_weights_cache=*/false);
+}
+
+std::string XnnpackDelegateWithWeightsCacheDir(const std::string& cache_dir) {
+  return absl::StrCat("delegate { xnnpack { weights_cache_dir: \"", cache_dir,
+                      "\" } }");
+}
+
+TEST(InferenceCalculatorTest, XnnpackWeightsCacheDir) {
+  const std::string cache_dir =
+      file::JoinPath(::testing::TempDir(), "xnnpack_weights_cache");
+  MP_ASSERT_OK(file::RecursivelyCreateDir(cache_dir));
+  const std::string graph_proto = absl::StrReplaceAll(
+      kGraphWithModelPathInOption,
+      {{"$delegate", XnnpackDelegateWithWeightsCacheDir(cache_dir)},
+       {"$mmap", "false"}});
+  // The first run writes the cache file, which the second run loads.
+  for (int run = 0; run < 2; ++run) {
+    DoSmokeTest(graph_proto, /*use_vectors=*/true,
+                /*apply_default_tflite_tensor_alignment=*/false);
+    std::vector<std::string> cache_files;
+    MP_ASSERT_OK(file::MatchFileTypeInDirectory(cache_dir, ".xnnpack_cache",
+                                                &cache_files));
+    EXPECT_EQ(cache_files.size(), 1);
+  }
+}
+
+TEST(InferenceCalculatorTest, XnnpackWeightsCacheDirMustExist) {
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(
+      ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrReplaceAll(
+          kGraphWithModelPathInOption,
+          {{"$delegate", XnnpackDelegateWithWeightsCacheDir(file::JoinPath(
+                             ::testing::TempDir(), "missing_directory"))},
+           {"$mmap", "false"}}))));
+  EXPECT_EQ(graph.StartRun({}).code(), absl::StatusCode::kInvalidArgument);
+}
+
+// Runs inputs whose values depend on their timestamp through the graph, and
+// returns the output packets. Checks the number of outputs before the input
+// stream is closed, as batched inputs wait for their batch to fill up.
+std::vector<Packet> RunGraphOnTimestamps(const std::string& graph_proto,
+                                         bool use_vectors, int num_inputs,
+                                         int num_outputs_before_close) {
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(graph_proto);
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("tensor_out", &graph_config, &output_packets);
+  CalculatorGraph graph(graph_config);
+  MP_EXPECT_OK(graph.StartRun({}));
+  for (int i = 0; i < num_inputs; ++i) {
+    std::vector<Tensor> input_vec =
+        CreateInputs(/*apply_default_tflite_tensor_alignment=*/false);
+    {
+      auto view = input_vec[0].GetCpuWriteView();
+      float* buffer = view.buffer<float>();
+      for (int j = 0; j < input_vec[0].shape().num_elements(); ++j) {
+        buffer[j] = i + 0.01f * j;
+      }
+    }
+    Packet packet = use_vectors
+                        ? MakePacket<std::vector<Tensor>>(std::move(input_vec))
+                        : MakePacket<Tensor>(std::move(input_vec[0]));
+    MP_EXPECT_OK(
+        graph.AddPacketToInputStream("tensor_in", packet.At(Timestamp(i))));
+  }
+  MP_EXPECT_OK(graph.WaitUntilIdle());
+  EXPECT_EQ(output_packets.size(), num_outputs_before_close);
+  MP_EXPECT_OK(graph.CloseInputStream("tensor_in"));
+  MP_EXPECT_OK(graph.WaitUntilDone());
+  return output_packets;
+}
+
+std::vector<float> GetOutputValues(const Packet& packet, bool use_vectors) {
+  const Tensor& tensor = use_vectors ? packet.Get<std::vector<Tensor>>()[0]
+                                     : packet.Get<Tensor>();
+  EXPECT_THAT(tensor.shape().dims,
+              ElementsAre(1, kTensorHeight, kTensorWidth, kTensorChannels));
+  auto view = tensor.GetCpuReadView();
+  const float* buffer = view.buffer<float>();
+  return std::vector<float>(buffer, buffer + tensor.shape().num_elements());
+}
+
+// Checks that batching 4 timestamps at a time produces the same outputs at the
+// same timestamps as unbatched inference.
+void DoBatchingTest(const std::string& delegate, bool use_vectors) {
+  constexpr int kNumInputs = 10;
+  std::string graph_proto = kGraphWithBatching;
+  if (!use_vectors) {
+    graph_proto = absl::StrReplaceAll(graph_proto, {{"TENSORS:", "TENSOR:"}});
+  }
+  const std::vector<Packet> expected_packets = RunGraphOnTimestamps(
+      absl::StrReplaceAll(graph_proto,
+                          {{"$delegate", delegate}, {"$batch_size", "1"}}),
+      use_vectors, kNumInputs, /*num_outputs_before_close=*/kNumInputs);
+  // The last 2 inputs are processed when the input stream is closed.
+  const std::vector<Packet> batched_packets = RunGraphOnTimestamps(
+      absl::StrReplaceAll(graph_proto,
+                          {{"$delegate", delegate}, {"$batch_size", "4"}}),
+      use_vectors, kNumInputs, /*num_outputs_before_close=*/8);
+
+  ASSERT_EQ(expected_packets.size(), kNumInputs);
+  ASSERT_EQ(batched_packets.size(), kNumInputs);
+  for (int i = 0; i < kNumInputs; ++i) {
+    EXPECT_EQ(batched_packets[i].Timestamp(), Timestamp(i));
+    EXPECT_EQ(GetOutputValues(batched_packets[i], use_vectors),
+              GetOutputValues(expected_packets[i], use_vectors));
+  }
+}
+
+// Checks that the outputs of each full batch are sent at the timestamps of
+// its inputs, and that no outputs are sent while a batch is open.
+TEST(InferenceCalculatorTest, BatchingSendsConsecutiveBatches) {
+  constexpr int kBatchSize = 4;
+  constexpr int kNumBatches = 3;
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrReplaceAll(
+          kGraphWithBatching, {{"$delegate", "delegate { xnnpack {} }"},
+                               {"$batch_size", absl::StrCat(kBatchSize)}}));
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("tensor_out", &graph_config, &output_packets);
+  CalculatorGraph graph(graph_config);
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int batch = 0; batch < kNumBatches; ++batch) {
+    for (int i = 0; i < kBatchSize; ++i) {
+      MP_ASSERT_OK(graph.AddPacketToInputStream(
+          "tensor_in",
+          MakePacket<std::vector<Tensor>>(
+              CreateInputs(/*apply_default_tflite_tensor_alignment=*/false))
+              .At(Timestamp(batch * kBatchSize + i))));
+      MP_ASSERT_OK(graph.WaitUntilIdle());
+      const int num_expected_outputs =
+          i + 1 < kBatchSize ? batch * kBatchSize : (batch + 1) * kBatchSize;
+      ASSERT_EQ(output_packets.size(), num_expected_outputs);
+    }
+  }
+  MP_ASSERT_OK(graph.CloseInputStream("tensor_in"));
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  ASSERT_EQ(output_packets.size(), kNumBatches * kBatchSize);
+  for (int i = 0; i < output_packets.size(); ++i) {
+    EXPECT_EQ(output_packets[i].Timestamp(), Timestamp(i));
+  }
+}
+
+TEST(InferenceCalculatorTest, BatchingTflite) {
+  DoBatchingTest("delegate { tflite {} }", /*use_vectors=*/true);
+}
+TEST(InferenceCalculatorTest, BatchingXnnpack) {
+  DoBatchingTest("delegate { xnnpack {} }", /*use_vectors=*/true);
+}
+TEST(InferenceCalculatorTest, BatchingXnnpackUnwrapped) {
+  DoBatchingTest("delegate { xnnpack {} }", /*use_vectors=*/false);
+}
+
 void BM_InitializeCalculator(benchmark::State& state) {
   mediapipe::InferenceCalculatorOptions::Delegate delegate;
   delegate.mutable_tflite();
@@ -261,5 +521,74 @@ void BM_InitializeCalculator(benchmark::State& state) {
 
 BENCHMARK(BM_InitializeCalculator);
 
+// Measures the throughput and the mean latency of XNNPACK inference when
+// batching up to state.range(0) timestamps.
+void BM_BatchedInference(benchmark::State& state) {
+  constexpr int kNumPackets = 64;
+  CalculatorGraph graph;
+  ABSL_CHECK_OK(graph.Initialize(
+      ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrReplaceAll(
+          kGraphWithBatching,
+          {{"$delegate", "delegate { xnnpack {} }"},
+           {"$batch_size", absl::StrCat(state.range(0))}}))));
+  std::vector<absl::Time> input_times(kNumPackets);
+  absl::Duration total_latency;
+  int64_t num_outputs = 0;
+  ABSL_CHECK_OK(graph.ObserveOutputStream(
+      "tensor_out", [&](const Packet& packet) {
+        total_latency += absl::Now() - input_times[packet.Timestamp().Value()];
+        ++num_outputs;
+        return absl::OkStatus();
+      }));
+
+  for (auto _ : state) {
+    ABSL_CHECK_OK(graph.StartRun({}));
+    for (int i = 0; i < kNumPackets; ++i) {
+      auto packet = MakePacket<std::vector<Tensor>>(
+          CreateInputs(/*apply_default_tflite_tensor_alignment=*/false));
+      input_times[i] = absl::Now();
+      ABSL_CHECK_OK(
+          graph.AddPacketToInputStream("tensor_in", packet.At(Timestamp(i))));
+    }
+    ABSL_CHECK_OK(graph.CloseInputStream("tensor_in"));
+    ABSL_CHECK_OK(graph.WaitUntilDone());
+  }
+  ABSL_CHECK_EQ(num_outputs, state.iterations() * kNumPackets);
+  state.SetItemsProcessed(num_outputs);
+  state.counters["latency_us"] =
+      absl::ToDoubleMicroseconds(total_latency) / num_outputs;
+}
+BENCHMARK(BM_BatchedInference)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+// Measures the startup time of an XNNPACK inference calculator, loading the
+// packed weights from a cache file if state.range(0) is set.
+void BM_XnnpackStartup(benchmark::State& state) {
+  std::string delegate = "delegate { xnnpack {} }";
+  if (state.range(0)) {
+    const std::string cache_dir =
+        file::JoinPath(::testing::TempDir(), "xnnpack_startup_cache");
+    ABSL_CHECK_OK(file::RecursivelyCreateDir(cache_dir));
+    delegate = XnnpackDelegateWithWeightsCacheDir(cache_dir);
+  }
+  const auto graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrReplaceAll(
+          kGraphWithModelPathInOption, {{kAddModelPath, kStartupModelPath},
+                                        {"$delegate", delegate},
+                                        {"$mmap", "true"}}));
+  auto run_graph = [&graph_config]() {
+    CalculatorGraph graph;
+    ABSL_CHECK_OK(graph.Initialize(graph_config));
+    ABSL_CHECK_OK(graph.StartRun({}));
+    ABSL_CHECK_OK(graph.CloseAllInputStreams());
+    ABSL_CHECK_OK(graph.WaitUntilDone());
+  };
+  // Writes the cache file, if any, before the measurements.
+  run_graph();
+  for (auto _ : state) {
+    run_graph();
+  }
+}
+BENCHMARK(BM_XnnpackStartup)->Arg(0)->Arg(1)->UseRealTime();
+
 }  // namespace
 }  // namespace mediapipe
@@ -69,6 +69,22 @@ absl::Status VerifyModelTensorsForCustomAllocation(
   return absl::OkStatus();
 }
 
+// Returns true if `dims` only differs from the shape of `tensor` in the
+// leading dimension, and the model declares that dimension as static. Models
+// are commonly exported with a batch size of 1, which InferenceCalculator
+// batching resizes to the number of batched timestamps.
+bool IsBatchDimensionResize(const TfLiteTensor& tensor,
+                            const std::vector<int>& dims) {
+  if (tensor.dims->size != dims.size() || dims.empty()) return false;
+  const bool has_signature =
+      tensor.dims_signature != nullptr && tensor.dims_signature->size > 0;
+  if (has_signature && tensor.dims_signature->data[0] == -1) return false;
+  for (int i = 1; i < dims.size(); ++i) {
+    if (tensor.dims->data[i] != dims[i]) return false;
+  }
+  return true;
+}
+
 absl::StatusOr<std::vector<Tensor>> AllocateOutputTensors(
     const std::vector<int>& model_output_indexes,
     const Interpreter& interpreter) {
@@ -189,8 +205,17 @@ absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
           interpreter_tensor->dims->data,
           interpreter_tensor->dims->data + interpreter_tensor->dims->size};
       if (interpreter_dims != input_tensor.shape().dims) {
-        interpreter_->ResizeInputTensorStrict(input_tensor_index,
-                                              input_tensor.shape().dims);
+        if (IsBatchDimensionResize(*interpreter_tensor,
+                                   input_tensor.shape().dims)) {
+          RET_CHECK_EQ(
+              interpreter_->ResizeInputTensor(
+                  interpreter_->inputs()[input_tensor_index],
+                  input_tensor.shape().dims),
+              kTfLiteOk);
+        } else {
+          interpreter_->ResizeInputTensorStrict(input_tensor_index,
+                                                input_tensor.shape().dims);
+        }
         resized_tensor_shapes = true;
       }
     }
@@ -12,12 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "mediapipe/calculators/tensor/tensors_to_detections_calculator.pb.h"
+#include "mediapipe/calculators/tensor/tensors_to_detections_utils.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/deps/file_path.h"
@@ -206,9 +208,6 @@ class TensorsToDetectionsCalculator : public Node {
 
   absl::Status LoadOptions(CalculatorContext* cc);
   absl::Status GpuInit(CalculatorContext* cc);
-  absl::Status DecodeBoxes(const float* raw_boxes,
-                           const std::vector<Anchor>& anchors,
-                           std::vector<float>* boxes);
   absl::Status ConvertToDetections(const float* detection_boxes,
                                    const float* detection_scores,
                                    const int* detection_classes,
@@ -242,6 +241,10 @@ class TensorsToDetectionsCalculator : public Node {
   std::vector<int> box_indices_ = {0, 1, 2, 3};
   bool has_custom_box_indices_ = false;
   std::vector<Anchor> anchors_;
+  // The [y_center, x_center, h, w] values of anchors_, for box decoding.
+  std::vector<float> anchor_values_;
+  // The class score mask of tensors_to_detections_utils::FindTopScores.
+  std::vector<float> class_score_mask_;
 
 #ifndef MEDIAPIPE_DISABLE_GL_COMPUTE
   mediapipe::GlCalculatorHelper gpu_helper_;
@@ -416,40 +419,34 @@ absl::Status TensorsToDetectionsCalculator::ProcessCPU(
       }
       anchors_init_ = true;
     }
+    if (anchor_values_.empty()) {
+      RET_CHECK_GE(anchors_.size(), num_boxes_)
+          << "Not enough anchors for the boxes.";
+      anchor_values_.reserve(num_boxes_ * kNumCoordsPerBox);
+      for (int i = 0; i < num_boxes_; ++i) {
+        anchor_values_.insert(anchor_values_.end(),
+                              {anchors_[i].y_center(), anchors_[i].x_center(),
+                               anchors_[i].h(), anchors_[i].w()});
+      }
+    }
     std::vector<float> boxes(num_boxes_ * num_coords_);
-    MP_RETURN_IF_ERROR(DecodeBoxes(raw_boxes, anchors_, &boxes));
+    tensors_to_detections_utils::DecodeBoxes(raw_boxes, anchor_values_.data(),
+                                             num_boxes_, box_output_format_,
+                                             options_, boxes.data());
 
     std::vector<float> detection_scores(num_boxes_);
     std::vector<int> detection_classes(num_boxes_);
 
     // Filter classes by scores.
-    for (int i = 0; i < num_boxes_; ++i) {
-      int class_id = -1;
-      float max_score = -std::numeric_limits<float>::max();
-      // Find the top score for box i.
-      for (int score_idx = 0; score_idx < num_classes_; ++score_idx) {
-        if (IsClassIndexAllowed(score_idx)) {
-          auto score = raw_scores[i * num_classes_ + score_idx];
-          if (options_.sigmoid_score()) {
-            if (options_.has_score_clipping_thresh()) {
-              score = score < -options_.score_clipping_thresh()
-                          ? -options_.score_clipping_thresh()
-                          : score;
-              score = score > options_.score_clipping_thresh()
-                          ? options_.score_clipping_thresh()
-                          : score;
-            }
-            score = 1.0f / (1.0f + std::exp(-score));
-          }
-          if (max_score < score) {
-            max_score = score;
-            class_id = score_idx;
-          }
-        }
-      }
-      detection_scores[i] = max_score;
-      detection_classes[i] = class_id;
+    tensors_to_detections_utils::TopScoreOptions top_score_options;
+    top_score_options.sigmoid_score = options_.sigmoid_score();
+    if (options_.has_score_clipping_thresh()) {
+      top_score_options.score_clipping_thresh =
+          options_.score_clipping_thresh();
     }
+    tensors_to_detections_utils::FindTopScores(
+        raw_scores, num_boxes_, num_classes_, class_score_mask_,
+        top_score_options, detection_scores.data(), detection_classes.data());
 
     MP_RETURN_IF_ERROR(
         ConvertToDetections(boxes.data(), detection_scores.data(),
@@ -749,6 +746,13 @@ absl::Status TensorsToDetectionsCalculator::LoadOptions(CalculatorContext* cc) {
     }
   }
 
+  std::vector<bool> is_class_allowed(num_classes_);
+  for (int i = 0; i < num_classes_; ++i) {
+    is_class_allowed[i] = IsClassIndexAllowed(i);
+  }
+  class_score_mask_ = tensors_to_detections_utils::MakeClassScoreMask(
+      num_classes_, is_class_allowed);
+
   if (options_.has_tensor_mapping()) {
     RET_CHECK_OK(CheckCustomTensorMapping(options_.tensor_mapping()));
     tensor_mapping_ = options_.tensor_mapping();
@@ -783,93 +787,6 @@ absl::Status TensorsToDetectionsCalculator::LoadOptions(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
-absl::Status TensorsToDetectionsCalculator::DecodeBoxes(
-    const float* raw_boxes, const std::vector<Anchor>& anchors,
-    std::vector<float>* boxes) {
-  for (int i = 0; i < num_boxes_; ++i) {
-    const int box_offset = i * num_coords_ + options_.box_coord_offset();
-
-    float y_center = 0.0;
-    float x_center = 0.0;
-    float h = 0.0;
-    float w = 0.0;
-    // TODO
-    switch (box_output_format_) {
-      case mediapipe::TensorsToDetectionsCalculatorOptions::UNSPECIFIED:
-      case mediapipe::TensorsToDetectionsCalculatorOptions::YXHW:
-        y_center = raw_boxes[box_offset];
-        x_center = raw_boxes[box_offset + 1];
-        h = raw_boxes[box_offset + 2];
-        w = raw_boxes[box_offset + 3];
-        break;
-      case mediapipe::TensorsToDetectionsCalculatorOptions::XYWH:
-        x_center = raw_boxes[box_offset];
-        y_center = raw_boxes[box_offset + 1];
-        w = raw_boxes[box_offset + 2];
-        h = raw_boxes[box_offset + 3];
-        break;
-      case mediapipe::TensorsToDetectionsCalculatorOptions::XYXY:
-        x_center = (-raw_boxes[box_offset] + raw_boxes[box_offset + 2]) / 2;
-        y_center = (-raw_boxes[box_offset + 1] + raw_boxes[box_offset + 3]) / 2;
-        w = raw_boxes[box_offset + 2] + raw_boxes[box_offset];
-        h = raw_boxes[box_offset + 3] + raw_boxes[box_offset + 1];
-        break;
-    }
-    x_center =
-        x_center / options_.x_scale() * anchors[i].w() + anchors[i].x_center();
-    y_center =
-        y_center / options_.y_scale() * anchors[i].h() + anchors[i].y_center();
-
-    if (options_.apply_exponential_on_box_size()) {
-      h = std::exp(h / options_.h_scale()) * anchors[i].h();
-      w = std::exp(w / options_.w_scale()) * anchors[i].w();
-    } else {
-      h = h / options_.h_scale() * anchors[i].h();
-      w = w / options_.w_scale() * anchors[i].w();
-    }
-
-    const float ymin = y_center - h / 2.f;
-    const float xmin = x_center - w / 2.f;
-    const float ymax = y_center + h / 2.f;
-    const float xmax = x_center + w / 2.f;
-
-    (*boxes)[i * num_coords_ + 0] = ymin;
-    (*boxes)[i * num_coords_ + 1] = xmin;
-    (*boxes)[i * num_coords_ + 2] = ymax;
-    (*boxes)[i * num_coords_ + 3] = xmax;
-
-    if (options_.num_keypoints()) {
-      for (int k = 0; k < options_.num_keypoints(); ++k) {
-        const int offset = i * num_coords_ + options_.keypoint_coord_offset() +
-                           k * options_.num_values_per_keypoint();
-
-        float keypoint_y = 0.0;
-        float keypoint_x = 0.0;
-        switch (box_output_format_) {
-          case mediapipe::TensorsToDetectionsCalculatorOptions::UNSPECIFIED:
-          case mediapipe::TensorsToDetectionsCalculatorOptions::YXHW:
-            keypoint_y = raw_boxes[offset];
-            keypoint_x = raw_boxes[offset + 1];
-            break;
-          case mediapipe::TensorsToDetectionsCalculatorOptions::XYWH:
-          case mediapipe::TensorsToDetectionsCalculatorOptions::XYXY:
-            keypoint_x = raw_boxes[offset];
-            keypoint_y = raw_boxes[offset + 1];
-            break;
-        }
-
-        (*boxes)[offset] = keypoint_x / options_.x_scale() * anchors[i].w() +
-                           anchors[i].x_center();
-        (*boxes)[offset + 1] =
-            keypoint_y / options_.y_scale() * anchors[i].h() +
-            anchors[i].y_center();
-      }
-    }
-  }
-
-  return absl::OkStatus();
-}
-
 absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
     const float* detection_boxes, const float* detection_scores,
     const int* detection_classes, std::vector<Detection>* output_detections) {
@@ -878,6 +795,16 @@ absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
     if (max_results_ > 0 && output_detections->size() == max_results_) {
       break;
     }
+    // Rejects the boxes below the score threshold before building their
+    // detection, which is most of them.
+    if (options_.has_min_score_thresh() &&
+        std::all_of(detection_scores + i,
+                    detection_scores + i + classes_per_detection_,
+                    [this](float score) {
+                      return score < options_.min_score_thresh();
+                    })) {
+      continue;
+    }
     const int box_offset = i * num_coords_;
     Detection detection = ConvertToDetection(
         /*box_ymin=*/detection_boxes[box_offset + box_indices_[0]],
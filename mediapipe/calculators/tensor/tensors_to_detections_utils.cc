@@ -0,0 +1,244 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/tensors_to_detections_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Eigen/Core"
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "mediapipe/calculators/tensor/tensors_to_detections_calculator.pb.h"
+
+namespace mediapipe {
+namespace tensors_to_detections_utils {
+
+namespace {
+
+using ScoreRow = Eigen::Map<const Eigen::Array<float, 1, Eigen::Dynamic>>;
+
+constexpr int kNumCoordsPerBox = 4;
+
+// The initial distance below the top raw score of a box at which to look for
+// raw scores with the same sigmoid.
+constexpr float kTieSearchDelta = 1e-3f;
+
+float Sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+// Finds the top score of one box by scoring its allowed classes one by one.
+// Used for the boxes whose reduced top score is not finite: NaN scores never
+// win a comparison here, and infinite raw scores defeat the tie search.
+void FindTopScoreOfBox(const float* raw_scores, int num_classes,
+                       const ScoreRow& mask, const TopScoreOptions& options,
+                       float* top_score, int* top_class) {
+  *top_score = -std::numeric_limits<float>::max();
+  *top_class = kNoClass;
+  for (int c = 0; c < num_classes; ++c) {
+    if (mask[c] != 0.0f) {
+      continue;
+    }
+    float score = raw_scores[c];
+    if (options.sigmoid_score) {
+      if (options.score_clipping_thresh.has_value()) {
+        const float thresh = *options.score_clipping_thresh;
+        score = score < -thresh ? -thresh : score;
+        score = score > thresh ? thresh : score;
+      }
+      score = Sigmoid(score);
+    }
+    if (*top_score < score) {
+      *top_score = score;
+      *top_class = c;
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<float> MakeClassScoreMask(
+    int num_classes, const std::vector<bool>& is_class_allowed) {
+  ABSL_CHECK_EQ(is_class_allowed.size(), num_classes);
+  std::vector<float> mask(num_classes);
+  for (int i = 0; i < num_classes; ++i) {
+    mask[i] = is_class_allowed[i] ? 0.0f
+                                  : -std::numeric_limits<float>::infinity();
+  }
+  return mask;
+}
+
+void FindTopScores(const float* raw_scores, int num_boxes, int num_classes,
+                   absl::Span<const float> class_score_mask,
+                   const TopScoreOptions& options, float* scores,
+                   int* classes) {
+  ABSL_CHECK_EQ(class_score_mask.size(), num_classes);
+  const ScoreRow mask(class_score_mask.data(), num_classes);
+  const bool clip_scores =
+      options.sigmoid_score && options.score_clipping_thresh.has_value();
+  const float clipping_thresh =
+      clip_scores ? *options.score_clipping_thresh : 0.0f;
+  // Returns the score of class `c` in `row`, as compared by the reduction.
+  auto class_score = [&](const ScoreRow& row, int c) {
+    float score = row[c];
+    if (clip_scores) {
+      score = std::min(std::max(score, -clipping_thresh), clipping_thresh);
+    }
+    return score + mask[c];
+  };
+  const bool any_class_allowed = (mask == 0.0f).any();
+  for (int i = 0; i < num_boxes; ++i) {
+    if (!any_class_allowed) {
+      scores[i] = -std::numeric_limits<float>::max();
+      classes[i] = kNoClass;
+      continue;
+    }
+    const ScoreRow row(raw_scores + i * num_classes, num_classes);
+    // Adding the mask sends the disallowed classes to -infinity, which keeps
+    // the whole reduction in SIMD packets. A NaN score makes the reduction
+    // NaN, rather than an arbitrary score of the box.
+    float top_score =
+        clip_scores
+            ? (row.max(-clipping_thresh).min(clipping_thresh) + mask)
+                  .maxCoeff<Eigen::PropagateNaN>()
+            : (row + mask).maxCoeff<Eigen::PropagateNaN>();
+    if (!std::isfinite(top_score)) {
+      FindTopScoreOfBox(row.data(), num_classes, mask, options, &scores[i],
+                        &classes[i]);
+      continue;
+    }
+    // Scores below `bound` can't be the top score of the box.
+    float bound = top_score;
+    const float top_raw_score = top_score;
+    if (options.sigmoid_score) {
+      top_score = Sigmoid(top_raw_score);
+      // Distinct raw scores can round to the same sigmoid, in which case the
+      // first of their classes wins, as if every score went through the
+      // sigmoid. As the sigmoid is monotonic, these scores are all above a
+      // bound whose sigmoid is below the top score.
+      float delta = kTieSearchDelta;
+      bound = top_raw_score - delta;
+      while (bound > -std::numeric_limits<float>::infinity() &&
+             Sigmoid(bound) == top_score) {
+        delta *= 2.0f;
+        bound = top_raw_score - delta;
+      }
+    }
+    // Finds the first class with the top score, which is cheaper than
+    // tracking the class through the reduction. Ends at the latest on the
+    // class of the top raw score, unless clipping a NaN score produced it.
+    int class_id = 0;
+    for (; class_id < num_classes; ++class_id) {
+      const float score = class_score(row, class_id);
+      if (score >= bound &&
+          (score == top_raw_score ||
+           (options.sigmoid_score && Sigmoid(score) == top_score))) {
+        break;
+      }
+    }
+    if (class_id == num_classes) {
+      FindTopScoreOfBox(row.data(), num_classes, mask, options, &scores[i],
+                        &classes[i]);
+      continue;
+    }
+    scores[i] = top_score;
+    classes[i] = class_id;
+  }
+}
+
+void DecodeBoxes(const float* raw_boxes, const float* anchors, int num_boxes,
+                 TensorsToDetectionsCalculatorOptions::BoxFormat box_format,
+                 const TensorsToDetectionsCalculatorOptions& options,
+                 float* boxes) {
+  // Reads the options once, out of the loop over the boxes.
+  const int num_coords = options.num_coords();
+  const int box_coord_offset = options.box_coord_offset();
+  const float x_scale = options.x_scale();
+  const float y_scale = options.y_scale();
+  const float h_scale = options.h_scale();
+  const float w_scale = options.w_scale();
+  const bool apply_exponential_on_box_size =
+      options.apply_exponential_on_box_size();
+  const int num_keypoints = options.num_keypoints();
+  const int keypoint_coord_offset = options.keypoint_coord_offset();
+  const int num_values_per_keypoint = options.num_values_per_keypoint();
+  const bool keypoints_are_yx =
+      box_format == TensorsToDetectionsCalculatorOptions::UNSPECIFIED ||
+      box_format == TensorsToDetectionsCalculatorOptions::YXHW;
+
+  for (int i = 0; i < num_boxes; ++i) {
+    const float* raw_box = raw_boxes + i * num_coords + box_coord_offset;
+    const float anchor_y_center = anchors[i * kNumCoordsPerBox + 0];
+    const float anchor_x_center = anchors[i * kNumCoordsPerBox + 1];
+    const float anchor_h = anchors[i * kNumCoordsPerBox + 2];
+    const float anchor_w = anchors[i * kNumCoordsPerBox + 3];
+
+    float y_center = 0.0;
+    float x_center = 0.0;
+    float h = 0.0;
+    float w = 0.0;
+    switch (box_format) {
+      case TensorsToDetectionsCalculatorOptions::UNSPECIFIED:
+      case TensorsToDetectionsCalculatorOptions::YXHW:
+        y_center = raw_box[0];
+        x_center = raw_box[1];
+        h = raw_box[2];
+        w = raw_box[3];
+        break;
+      case TensorsToDetectionsCalculatorOptions::XYWH:
+        x_center = raw_box[0];
+        y_center = raw_box[1];
+        w = raw_box[2];
+        h = raw_box[3];
+        break;
+      case TensorsToDetectionsCalculatorOptions::XYXY:
+        x_center = (-raw_box[0] + raw_box[2]) / 2;
+        y_center = (-raw_box[1] + raw_box[3]) / 2;
+        w = raw_box[2] + raw_box[0];
+        h = raw_box[3] + raw_box[1];
+        break;
+    }
+    x_center = x_center / x_scale * anchor_w + anchor_x_center;
+    y_center = y_center / y_scale * anchor_h + anchor_y_center;
+
+    if (apply_exponential_on_box_size) {
+      h = std::exp(h / h_scale) * anchor_h;
+      w = std::exp(w / w_scale) * anchor_w;
+    } else {
+      h = h / h_scale * anchor_h;
+      w = w / w_scale * anchor_w;
+    }
+
+    float* box = boxes + i * num_coords;
+    box[0] = y_center - h / 2.f;
+    box[1] = x_center - w / 2.f;
+    box[2] = y_center + h / 2.f;
+    box[3] = x_center + w / 2.f;
+
+    for (int k = 0; k < num_keypoints; ++k) {
+      const int offset =
+          i * num_coords + keypoint_coord_offset + k * num_values_per_keypoint;
+      const float keypoint_y =
+          keypoints_are_yx ? raw_boxes[offset] : raw_boxes[offset + 1];
+      const float keypoint_x =
+          keypoints_are_yx ? raw_boxes[offset + 1] : raw_boxes[offset];
+      boxes[offset] = keypoint_x / x_scale * anchor_w + anchor_x_center;
+      boxes[offset + 1] = keypoint_y / y_scale * anchor_h + anchor_y_center;
+    }
+  }
+}
+
+}  // namespace tensors_to_detections_utils
+}  // namespace mediapipe
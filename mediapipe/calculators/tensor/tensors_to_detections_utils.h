@@ -0,0 +1,68 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_TENSORS_TO_DETECTIONS_UTILS_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_TENSORS_TO_DETECTIONS_UTILS_H_
+
+#include <optional>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "mediapipe/calculators/tensor/tensors_to_detections_calculator.pb.h"
+
+namespace mediapipe {
+namespace tensors_to_detections_utils {
+
+// The class id of the boxes without any allowed class.
+inline constexpr int kNoClass = -1;
+
+// Options to find the top class score of each box.
+struct TopScoreOptions {
+  // Whether to apply a sigmoid to the raw scores.
+  bool sigmoid_score = false;
+  // If set, the raw scores are clipped to [-thresh, thresh] before the
+  // sigmoid.
+  std::optional<float> score_clipping_thresh;
+};
+
+// Returns the mask to pass to FindTopScores: 0 for the allowed classes in
+// [0, num_classes) and -infinity for the others.
+std::vector<float> MakeClassScoreMask(
+    int num_classes, const std::vector<bool>& is_class_allowed);
+
+// Finds the top score of each of the `num_boxes` boxes, whose `num_classes`
+// raw scores are contiguous in `raw_scores`. Only the classes for which
+// `class_score_mask` is 0 are considered, and the first class wins ties. NaN
+// scores are ignored. Boxes without any allowed class or non-NaN score get the
+// score -FLT_MAX and the class kNoClass.
+//
+// The scores are reduced with SIMD packets, and the sigmoid, being monotonic,
+// is only applied to the top score of each box.
+void FindTopScores(const float* raw_scores, int num_boxes, int num_classes,
+                   absl::Span<const float> class_score_mask,
+                   const TopScoreOptions& options, float* scores,
+                   int* classes);
+
+// Decodes `num_boxes` raw boxes, each made of `options.num_coords()` values,
+// into [ymin, xmin, ymax, xmax] boxes followed by the [x, y] keypoints.
+// `anchors` holds the [y_center, x_center, h, w] values of each anchor.
+void DecodeBoxes(const float* raw_boxes, const float* anchors, int num_boxes,
+                 TensorsToDetectionsCalculatorOptions::BoxFormat box_format,
+                 const TensorsToDetectionsCalculatorOptions& options,
+                 float* boxes);
+
+}  // namespace tensors_to_detections_utils
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_TENSORS_TO_DETECTIONS_UTILS_H_
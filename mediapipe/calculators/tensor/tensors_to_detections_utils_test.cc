@@ -0,0 +1,236 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/tensors_to_detections_utils.h"
+
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "mediapipe/calculators/tensor/tensors_to_detections_calculator.pb.h"
+#include "mediapipe/framework/port/benchmark.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+
+namespace mediapipe {
+namespace tensors_to_detections_utils {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatEq;
+
+// Typical SSD sizes.
+constexpr int kNumBoxes = 1917;
+constexpr int kNumClasses = 91;
+
+std::vector<float> RandomScores(int num_values) {
+  std::mt19937 rng(/*seed=*/42);
+  std::uniform_real_distribution<float> distribution(-8.0f, 8.0f);
+  std::vector<float> values(num_values);
+  for (float& value : values) value = distribution(rng);
+  return values;
+}
+
+// The scalar reduction that FindTopScores replaces, which applies the sigmoid
+// to every score.
+void FindTopScoresScalar(const float* raw_scores, int num_boxes,
+                         int num_classes,
+                         const std::vector<bool>& is_class_allowed,
+                         const TopScoreOptions& options, float* scores,
+                         int* classes) {
+  for (int i = 0; i < num_boxes; ++i) {
+    int class_id = kNoClass;
+    float max_score = -std::numeric_limits<float>::max();
+    for (int c = 0; c < num_classes; ++c) {
+      if (!is_class_allowed[c]) continue;
+      float score = raw_scores[i * num_classes + c];
+      if (options.sigmoid_score) {
+        if (options.score_clipping_thresh.has_value()) {
+          const float thresh = *options.score_clipping_thresh;
+          score = score < -thresh ? -thresh : score;
+          score = score > thresh ? thresh : score;
+        }
+        score = 1.0f / (1.0f + std::exp(-score));
+      }
+      if (max_score < score) {
+        max_score = score;
+        class_id = c;
+      }
+    }
+    scores[i] = max_score;
+    classes[i] = class_id;
+  }
+}
+
+void ExpectSameTopScores(const std::vector<float>& raw_scores,
+                         int num_classes, const TopScoreOptions& options,
+                         const std::vector<bool>& is_class_allowed) {
+  const int num_boxes = raw_scores.size() / num_classes;
+  std::vector<float> expected_scores(num_boxes);
+  std::vector<int> expected_classes(num_boxes);
+  FindTopScoresScalar(raw_scores.data(), num_boxes, num_classes,
+                      is_class_allowed, options, expected_scores.data(),
+                      expected_classes.data());
+
+  std::vector<float> scores(num_boxes);
+  std::vector<int> classes(num_boxes);
+  FindTopScores(raw_scores.data(), num_boxes, num_classes,
+                MakeClassScoreMask(num_classes, is_class_allowed), options,
+                scores.data(), classes.data());
+
+  EXPECT_EQ(classes, expected_classes);
+  for (int i = 0; i < num_boxes; ++i) {
+    EXPECT_THAT(scores[i], FloatEq(expected_scores[i])) << "box " << i;
+  }
+}
+
+void ExpectSameTopScores(const TopScoreOptions& options,
+                         const std::vector<bool>& is_class_allowed) {
+  ExpectSameTopScores(RandomScores(kNumBoxes * kNumClasses), kNumClasses,
+                      options, is_class_allowed);
+}
+
+// Rows of 5 raw scores with NaN and infinite values.
+std::vector<float> NonFiniteScores() {
+  constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  return {
+      1.0f,  kNaN,  3.0f,  2.0f,  0.0f,   //
+      kNaN,  kNaN,  kNaN,  kNaN,  kNaN,   //
+      1.0f,  kInf,  3.0f,  kInf,  0.0f,   //
+      1e30f, kInf,  2.0f,  kNaN,  0.0f,   //
+      -kInf, -kInf, -kInf, -kInf, -kInf,  //
+      kNaN,  -kInf, kNaN,  0.5f,  kNaN,   //
+  };
+}
+
+TEST(TensorsToDetectionsUtilsTest, FindTopScoresMatchesScalar) {
+  ExpectSameTopScores(TopScoreOptions(),
+                      std::vector<bool>(kNumClasses, true));
+}
+
+TEST(TensorsToDetectionsUtilsTest, FindTopScoresWithSigmoidMatchesScalar) {
+  TopScoreOptions options;
+  options.sigmoid_score = true;
+  ExpectSameTopScores(options, std::vector<bool>(kNumClasses, true));
+}
+
+TEST(TensorsToDetectionsUtilsTest, FindTopScoresWithClippingMatchesScalar) {
+  TopScoreOptions options;
+  options.sigmoid_score = true;
+  options.score_clipping_thresh = 2.0f;
+  ExpectSameTopScores(options, std::vector<bool>(kNumClasses, true));
+}
+
+TEST(TensorsToDetectionsUtilsTest, FindTopScoresWithIgnoredClasses) {
+  TopScoreOptions options;
+  options.sigmoid_score = true;
+  std::vector<bool> is_class_allowed(kNumClasses, true);
+  for (int c = 0; c < kNumClasses; c += 3) is_class_allowed[c] = false;
+  ExpectSameTopScores(options, is_class_allowed);
+}
+
+TEST(TensorsToDetectionsUtilsTest, FindTopScoresWithNonFiniteScores) {
+  ExpectSameTopScores(NonFiniteScores(), /*num_classes=*/5, TopScoreOptions(),
+                      std::vector<bool>(5, true));
+}
+
+TEST(TensorsToDetectionsUtilsTest,
+     FindTopScoresWithSigmoidAndNonFiniteScores) {
+  TopScoreOptions options;
+  options.sigmoid_score = true;
+  ExpectSameTopScores(NonFiniteScores(), /*num_classes=*/5, options,
+                      std::vector<bool>(5, true));
+  options.score_clipping_thresh = 2.0f;
+  ExpectSameTopScores(NonFiniteScores(), /*num_classes=*/5, options,
+                      std::vector<bool>(5, true));
+  ExpectSameTopScores(NonFiniteScores(), /*num_classes=*/5, options,
+                      {true, false, true, true, false});
+}
+
+TEST(TensorsToDetectionsUtilsTest, FindTopScoresWithoutAllowedClass) {
+  const std::vector<float> raw_scores = {0.5f, 0.7f};
+  float score = 0.0f;
+  int class_id = 0;
+  FindTopScores(raw_scores.data(), /*num_boxes=*/1, /*num_classes=*/2,
+                MakeClassScoreMask(/*num_classes=*/2, {false, false}),
+                TopScoreOptions(), &score, &class_id);
+  EXPECT_EQ(score, -std::numeric_limits<float>::max());
+  EXPECT_EQ(class_id, kNoClass);
+}
+
+TEST(TensorsToDetectionsUtilsTest, FindTopScoresKeepsFirstOfTiedClasses) {
+  const std::vector<float> raw_scores = {0.1f, 0.9f, 0.3f, 0.9f};
+  float score = 0.0f;
+  int class_id = 0;
+  FindTopScores(raw_scores.data(), /*num_boxes=*/1, /*num_classes=*/4,
+                MakeClassScoreMask(/*num_classes=*/4, {true, true, true, true}),
+                TopScoreOptions(), &score, &class_id);
+  EXPECT_EQ(score, 0.9f);
+  EXPECT_EQ(class_id, 1);
+}
+
+TEST(TensorsToDetectionsUtilsTest, DecodeBoxesWithKeypoints) {
+  TensorsToDetectionsCalculatorOptions options;
+  options.set_num_coords(6);
+  options.set_num_keypoints(1);
+  options.set_keypoint_coord_offset(4);
+  options.set_x_scale(10.0f);
+  options.set_y_scale(10.0f);
+  options.set_w_scale(10.0f);
+  options.set_h_scale(10.0f);
+  // [y_center, x_center, h, w, keypoint_y, keypoint_x]
+  const std::vector<float> raw_boxes = {1.0f, 2.0f, 4.0f, 8.0f, 3.0f, 5.0f};
+  // [y_center, x_center, h, w]
+  const std::vector<float> anchors = {0.5f, 0.5f, 1.0f, 1.0f};
+  std::vector<float> boxes(6);
+  DecodeBoxes(raw_boxes.data(), anchors.data(), /*num_boxes=*/1,
+              TensorsToDetectionsCalculatorOptions::YXHW, options,
+              boxes.data());
+  EXPECT_THAT(boxes, ElementsAre(FloatEq(0.4f), FloatEq(0.3f), FloatEq(0.8f),
+                                 FloatEq(1.1f), FloatEq(1.0f), FloatEq(0.8f)));
+}
+
+// Compares FindTopScores (state.range(0) == 1) to the scalar reduction on SSD
+// sized scores.
+void BM_FindTopScores(benchmark::State& state) {
+  const std::vector<float> raw_scores = RandomScores(kNumBoxes * kNumClasses);
+  const std::vector<bool> is_class_allowed(kNumClasses, true);
+  const std::vector<float> mask =
+      MakeClassScoreMask(kNumClasses, is_class_allowed);
+  TopScoreOptions options;
+  options.sigmoid_score = true;
+  std::vector<float> scores(kNumBoxes);
+  std::vector<int> classes(kNumBoxes);
+  for (auto _ : state) {
+    if (state.range(0)) {
+      FindTopScores(raw_scores.data(), kNumBoxes, kNumClasses, mask, options,
+                    scores.data(), classes.data());
+    } else {
+      FindTopScoresScalar(raw_scores.data(), kNumBoxes, kNumClasses,
+                          is_class_allowed, options, scores.data(),
+                          classes.data());
+    }
+    benchmark::DoNotOptimize(scores.data());
+    benchmark::DoNotOptimize(classes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumBoxes);
+}
+BENCHMARK(BM_FindTopScores)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace tensors_to_detections_utils
+}  // namespace mediapipe
@@ -0,0 +1,165 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/xnnpack_weights_cache.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/crc/crc32c.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/framework/deps/file_path.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "tensorflow/lite/allocation.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace mediapipe {
+
+namespace {
+
+struct Registry {
+  absl::Mutex mutex;
+  absl::flat_hash_map<const tflite::FlatBufferModel*,
+                      std::weak_ptr<XnnpackWeightsCache>>
+      caches ABSL_GUARDED_BY(mutex);
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+}  // namespace
+
+/* static */
+std::shared_ptr<XnnpackWeightsCache> XnnpackWeightsCache::GetOrCreate(
+    const tflite::FlatBufferModel& model) {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  std::weak_ptr<XnnpackWeightsCache>& weak_cache = registry.caches[&model];
+  // An expired entry belongs to a model whose interpreters were all released,
+  // possibly a different model allocated at the same address.
+  std::shared_ptr<XnnpackWeightsCache> cache = weak_cache.lock();
+  if (cache == nullptr) {
+    cache = std::shared_ptr<XnnpackWeightsCache>(new XnnpackWeightsCache());
+    weak_cache = cache;
+  }
+  // Prunes the caches of the released models.
+  for (auto it = registry.caches.begin(); it != registry.caches.end();) {
+    if (it->second.expired()) {
+      registry.caches.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  return cache;
+}
+
+XnnpackWeightsCache::XnnpackWeightsCache()
+    : weights_cache_(TfLiteXNNPackDelegateWeightsCacheCreate()) {
+  ABSL_CHECK(weights_cache_ != nullptr);
+}
+
+XnnpackWeightsCache::~XnnpackWeightsCache() {
+  TfLiteXNNPackDelegateWeightsCacheDelete(weights_cache_);
+}
+
+absl::StatusOr<std::unique_ptr<InferenceRunner>>
+XnnpackWeightsCache::CreateRunner(
+    absl::AnyInvocable<absl::StatusOr<std::unique_ptr<InferenceRunner>>()>
+        create_runner) {
+  absl::MutexLock lock(&mutex_);
+  MP_ASSIGN_OR_RETURN(std::unique_ptr<InferenceRunner> runner,
+                      create_runner());
+  if (!finalized_) {
+    // Soft finalization still allows the following interpreters to look up
+    // the packed weights, while hard finalization would forbid any use by
+    // new interpreters.
+    RET_CHECK(TfLiteXNNPackDelegateWeightsCacheFinalizeSoft(weights_cache_))
+        << "Failed to finalize the XNNPACK weights cache.";
+    finalized_ = true;
+  }
+  return runner;
+}
+
+/* static */
+absl::StatusOr<std::unique_ptr<XnnpackWeightsCacheFile>>
+XnnpackWeightsCacheFile::Create(const tflite::FlatBufferModel& model,
+                                absl::string_view cache_dir) {
+  if (!file::IsDirectory(cache_dir).ok()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "The XNNPACK weights cache directory does not exist: ", cache_dir));
+  }
+  const tflite::Allocation* allocation = model.allocation();
+  RET_CHECK(allocation != nullptr);
+  const absl::string_view content(static_cast<const char*>(allocation->base()),
+                                  allocation->bytes());
+  // The fingerprint must be stable across processes, unlike absl::Hash.
+  const uint32_t crc = static_cast<uint32_t>(absl::ComputeCrc32c(content));
+  std::string path = file::JoinPath(
+      cache_dir,
+      absl::StrFormat("%08x_%d.xnnpack_cache", crc, content.size()));
+  if (file::Exists(path).ok()) {
+    return absl::WrapUnique(
+        new XnnpackWeightsCacheFile(std::move(path), /*build_path=*/""));
+  }
+  // The build path is unique to each builder, in this process or another.
+  static std::atomic<int> num_builds{0};
+  std::string build_path =
+      absl::StrCat(path, ".", absl::ToUnixNanos(absl::Now()), "-",
+                   num_builds.fetch_add(1), ".tmp");
+  return absl::WrapUnique(
+      new XnnpackWeightsCacheFile(std::move(path), std::move(build_path)));
+}
+
+void XnnpackWeightsCacheFile::ConfigureDelegateOptions(
+    TfLiteXNNPackDelegateOptions& options) const {
+  options.weight_cache_file_path =
+      build_path_.empty() ? path_.c_str() : build_path_.c_str();
+}
+
+void XnnpackWeightsCacheFile::Publish() {
+  if (build_path_.empty() || published_) return;
+  // The delegate keeps using the file through its descriptor, so the file can
+  // be renamed while it is mapped.
+  if (std::rename(build_path_.c_str(), path_.c_str()) != 0) {
+    ABSL_LOG(WARNING) << "Failed to publish the XNNPACK weights cache file "
+                      << path_;
+    std::remove(build_path_.c_str());
+  }
+  published_ = true;
+}
+
+}  // namespace mediapipe
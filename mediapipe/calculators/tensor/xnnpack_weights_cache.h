@@ -0,0 +1,117 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/calculators/tensor/inference_runner.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace mediapipe {
+
+// An XNNPACK weights cache shared by all the interpreters of the same
+// tflite::FlatBufferModel in the process.
+//
+// XNNPACK packs the weights of every interpreter it delegates to. With a
+// shared weights cache, the weights are packed once by the first interpreter
+// and looked up by the following ones, which cuts both their memory and their
+// initialization time. The packed weights are keyed by the addresses of the
+// model weights, so the interpreters must share the same FlatBufferModel (for
+// instance through mediapipe/tasks/cc/core/model_registry.h).
+class XnnpackWeightsCache {
+ public:
+  // Returns the weights cache shared by the interpreters of `model`, creating
+  // it if needed. The cache is released with its last user.
+  static std::shared_ptr<XnnpackWeightsCache> GetOrCreate(
+      const tflite::FlatBufferModel& model);
+
+  ~XnnpackWeightsCache();
+
+  // XnnpackWeightsCache is neither copyable nor movable.
+  XnnpackWeightsCache(const XnnpackWeightsCache&) = delete;
+  XnnpackWeightsCache& operator=(const XnnpackWeightsCache&) = delete;
+
+  // Returns the cache to set in TfLiteXNNPackDelegateOptions::weights_cache.
+  TfLiteXNNPackDelegateWeightsCache* Get() const { return weights_cache_; }
+
+  // Creates an inference runner with `create_runner`, which must apply an
+  // XNNPACK delegate using this cache, and finalizes the cache so that the
+  // runner can be invoked. Runner creations are serialized, as the cache can
+  // only be finalized once all the weights of the model have been packed.
+  // The cache must outlive the returned runner.
+  absl::StatusOr<std::unique_ptr<InferenceRunner>> CreateRunner(
+      absl::AnyInvocable<absl::StatusOr<std::unique_ptr<InferenceRunner>>()>
+          create_runner);
+
+ private:
+  XnnpackWeightsCache();
+
+  TfLiteXNNPackDelegateWeightsCache* weights_cache_ = nullptr;
+
+  absl::Mutex mutex_;
+  bool finalized_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+// A file of XNNPACK packed weights, persisted across runs so that the weights
+// are only packed by the first run on a machine. The file is mmapped when
+// loaded.
+//
+// The file is named after a fingerprint of the model content, so that it is
+// never loaded for a different model, and records the XNNPACK build that
+// packed the weights: TFLite rebuilds the file when it was written by another
+// XNNPACK build. New files are built under a temporary name and renamed when
+// complete, so concurrent processes never load a partially written file.
+class XnnpackWeightsCacheFile {
+ public:
+  // Returns the cache file of `model` in the existing directory `cache_dir`.
+  static absl::StatusOr<std::unique_ptr<XnnpackWeightsCacheFile>> Create(
+      const tflite::FlatBufferModel& model, absl::string_view cache_dir);
+
+  // Sets the file to load the packed weights from, or to write them to, in
+  // `options`, which must not outlive this object.
+  void ConfigureDelegateOptions(TfLiteXNNPackDelegateOptions& options) const;
+
+  // Publishes the newly built file under its final name. Must be called once
+  // the delegate has been applied to the interpreter. Failing to publish the
+  // file is only logged, as the packed weights were built anyway.
+  void Publish();
+
+  // Returns the final path of the cache file.
+  const std::string& GetPath() const { return path_; }
+
+ private:
+  XnnpackWeightsCacheFile(std::string path, std::string build_path)
+      : path_(std::move(path)), build_path_(std::move(build_path)) {}
+
+  const std::string path_;
+  // The temporary path of the file being built, or empty if the file exists.
+  // The delegate keeps a pointer to the path it was configured with, so the
+  // path stays unchanged after the file is published.
+  const std::string build_path_;
+  bool published_ = false;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
@@ -14,19 +14,19 @@
 
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
-#include "absl/log/absl_log.h"
 #include "mediapipe/calculators/util/non_max_suppression_calculator.pb.h"
+#include "mediapipe/calculators/util/non_max_suppression_utils.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/detection.pb.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/location.h"
-#include "mediapipe/framework/port/rectangle.h"
 #include "mediapipe/framework/port/status.h"
 
 namespace mediapipe {
@@ -75,53 +75,6 @@ bool RetainMaxScoringLabelOnly(Detection* detection) {
   return true;
 }
 
-// Computes an overlap similarity between two rectangles. Similarity measure is
-// defined by overlap_type parameter.
-float OverlapSimilarity(
-    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type,
-    const Rectangle_f& rect1, const Rectangle_f& rect2) {
-  if (!rect1.Intersects(rect2)) return 0.0f;
-  const float intersection_area = Rectangle_f(rect1).Intersect(rect2).Area();
-  float normalization;
-  switch (overlap_type) {
-    case NonMaxSuppressionCalculatorOptions::JACCARD:
-      normalization = Rectangle_f(rect1).Union(rect2).Area();
-      break;
-    case NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD:
-      normalization = rect2.Area();
-      break;
-    case NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION:
-      normalization = rect1.Area() + rect2.Area() - intersection_area;
-      break;
-    default:
-      ABSL_LOG(FATAL) << "Unrecognized overlap type: " << overlap_type;
-  }
-  return normalization > 0.0f ? intersection_area / normalization : 0.0f;
-}
-
-// Computes an overlap similarity between two locations by first extracting the
-// relative box (dimension normalized by frame width/height) from the location.
-float OverlapSimilarity(
-    const int frame_width, const int frame_height,
-    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type,
-    const Location& location1, const Location& location2) {
-  const auto rect1 = location1.ConvertToRelativeBBox(frame_width, frame_height);
-  const auto rect2 = location2.ConvertToRelativeBBox(frame_width, frame_height);
-  return OverlapSimilarity(overlap_type, rect1, rect2);
-}
-
-// Computes an overlap similarity between two locations by first extracting the
-// relative box from the location. It assumes that a relative-box representation
-// is already available in the location, and therefore frame width and height
-// are not needed for further normalization.
-float OverlapSimilarity(
-    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type,
-    const Location& location1, const Location& location2) {
-  const auto rect1 = location1.GetRelativeBBox();
-  const auto rect2 = location2.GetRelativeBBox();
-  return OverlapSimilarity(overlap_type, rect1, rect2);
-}
-
 // Copy all the scores (there is a single score in each detection after
 // pruning detections) to an indexed vector for sorting. The first value is
 // the index of the detection in the original vector from which the score
@@ -290,83 +243,78 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
     }
   }
 
+  // Returns the number of leading detections in indexed_scores which pass
+  // min_score_threshold.
+  int NumDetectionsAboveMinScore(const IndexedScores& indexed_scores) const {
+    if (options_.min_score_threshold() <= 0) {
+      return indexed_scores.size();
+    }
+    int num_detections = 0;
+    while (num_detections < indexed_scores.size() &&
+           !(indexed_scores[num_detections].second <
+             options_.min_score_threshold())) {
+      ++num_detections;
+    }
+    return num_detections;
+  }
+
   void NonMaxSuppression(const IndexedScores& indexed_scores,
                          const Detections& detections, int max_num_detections,
                          CalculatorContext* cc, Detections* output_detections) {
-    std::vector<Location> retained_locations;
-    retained_locations.reserve(max_num_detections);
-    // We traverse the detections by decreasing score.
-    for (const auto& indexed_score : indexed_scores) {
-      const auto& detection = detections[indexed_score.first];
-      if (options_.min_score_threshold() > 0 &&
-          detection.score(0) < options_.min_score_threshold()) {
-        break;
-      }
-      const Location location(detection.location_data());
-      bool suppressed = false;
-      // The current detection is suppressed iff there exists a retained
-      // detection, whose location overlaps more than the specified
-      // threshold with the location of the current detection.
-      for (const auto& retained_location : retained_locations) {
-        float similarity;
-        if (cc->Inputs().HasTag(kImageTag)) {
-          const auto& frame = cc->Inputs().Tag(kImageTag).Get<ImageFrame>();
-          similarity = OverlapSimilarity(frame.Width(), frame.Height(),
-                                         options_.overlap_type(),
-                                         retained_location, location);
-        } else {
-          similarity = OverlapSimilarity(options_.overlap_type(),
-                                         retained_location, location);
-        }
-        if (similarity > options_.min_suppression_threshold()) {
-          suppressed = true;
-          break;
-        }
-      }
-      if (!suppressed) {
-        output_detections->push_back(detection);
-        retained_locations.push_back(location);
-      }
-      if (output_detections->size() >= max_num_detections) {
-        break;
+    // The relative boxes of the detections passing min_score_threshold, by
+    // decreasing score.
+    const int num_detections = NumDetectionsAboveMinScore(indexed_scores);
+    nms::Boxes boxes;
+    boxes.Reserve(num_detections);
+    for (int i = 0; i < num_detections; ++i) {
+      const Location location(
+          detections[indexed_scores[i].first].location_data());
+      if (cc->Inputs().HasTag(kImageTag)) {
+        const auto& frame = cc->Inputs().Tag(kImageTag).Get<ImageFrame>();
+        boxes.Add(
+            location.ConvertToRelativeBBox(frame.Width(), frame.Height()));
+      } else {
+        boxes.Add(location.GetRelativeBBox());
       }
     }
+    std::vector<int> order(num_detections);
+    std::iota(order.begin(), order.end(), 0);
+    // A detection is suppressed iff there exists a retained detection, whose
+    // location overlaps more than the specified threshold with the location
+    // of the detection.
+    for (int i : nms::GreedyNonMaxSuppression(
+             boxes, order, options_.overlap_type(),
+             options_.min_suppression_threshold(), max_num_detections)) {
+      output_detections->push_back(detections[indexed_scores[i].first]);
+    }
   }
 
   void WeightedNonMaxSuppression(const IndexedScores& indexed_scores,
                                  const Detections& detections,
                                  int max_num_detections, CalculatorContext* cc,
                                  Detections* output_detections) {
-    IndexedScores remained_indexed_scores;
-    remained_indexed_scores.assign(indexed_scores.begin(),
-                                   indexed_scores.end());
-
-    IndexedScores remained;
-    IndexedScores candidates;
     output_detections->clear();
-    while (!remained_indexed_scores.empty()) {
-      const int original_indexed_scores_size = remained_indexed_scores.size();
-      const auto& detection = detections[remained_indexed_scores[0].first];
-      if (options_.min_score_threshold() > 0 &&
-          detection.score(0) < options_.min_score_threshold()) {
-        break;
-      }
-      remained.clear();
-      candidates.clear();
-      const Location location(detection.location_data());
-      // This includes the first box.
-      for (const auto& indexed_score : remained_indexed_scores) {
-        Location rest_location(detections[indexed_score.first].location_data());
-        float similarity =
-            OverlapSimilarity(options_.overlap_type(), rest_location, location);
-        if (similarity > options_.min_suppression_threshold()) {
-          candidates.push_back(indexed_score);
-        } else {
-          remained.push_back(indexed_score);
-        }
-      }
+    // Only detections passing min_score_threshold start clusters, but all
+    // detections contribute to them.
+    const int num_tops = NumDetectionsAboveMinScore(indexed_scores);
+    if (num_tops == 0) {
+      return;
+    }
+    nms::Boxes boxes;
+    boxes.Reserve(indexed_scores.size());
+    for (const auto& indexed_score : indexed_scores) {
+      boxes.Add(Location(detections[indexed_score.first].location_data())
+                    .GetRelativeBBox());
+    }
+    std::vector<int> order(indexed_scores.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    for (const auto& cluster : nms::ClusterOverlappingBoxes(
+             boxes, order, options_.overlap_type(),
+             options_.min_suppression_threshold(), num_tops)) {
+      const auto& detection = detections[indexed_scores[cluster.top].first];
       auto weighted_detection = detection;
-      if (!candidates.empty()) {
+      if (!cluster.members.empty()) {
         const int num_keypoints =
             detection.location_data().relative_keypoints_size();
         std::vector<float> keypoints(num_keypoints * 2);
@@ -375,7 +323,8 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
         float w_xmax = 0.0f;
         float w_ymax = 0.0f;
         float total_score = 0.0f;
-        for (const auto& candidate : candidates) {
+        for (int member : cluster.members) {
+          const auto& candidate = indexed_scores[member];
           total_score += candidate.second;
           const auto& location_data =
               detections[candidate.first].location_data();
@@ -407,15 +356,7 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
           keypoint->set_y(keypoints[i * 2 + 1] / total_score);
         }
       }
-
       output_detections->push_back(weighted_detection);
-      // Breaks the loop if the size of indexed scores doesn't change after an
-      // iteration.
-      if (original_indexed_scores_size == remained.size()) {
-        break;
-      } else {
-        remained_indexed_scores = std::move(remained);
-      }
     }
   }
 
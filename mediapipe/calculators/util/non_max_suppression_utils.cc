@@ -0,0 +1,486 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/util/non_max_suppression_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include "absl/log/absl_log.h"
+#include "absl/types/span.h"
+#include "mediapipe/calculators/util/non_max_suppression_calculator.pb.h"
+#include "mediapipe/framework/port/rectangle.h"
+
+namespace mediapipe {
+namespace nms {
+
+namespace {
+
+// Below this number of boxes, comparing all pairs is faster than building a
+// grid.
+constexpr int kMinGridBoxes = 128;
+// Bounds of the number of grid cells per dimension, and of the number of
+// cells relative to the number of boxes.
+constexpr int kMaxGridSize = 64;
+constexpr int kMinBoxesPerCell = 4;
+// Boxes covering more cells are compared with every box instead.
+constexpr int kMaxCellsPerBox = 16;
+
+// std::min and std::max on values rather than references, which compilers
+// turn into vector min and max.
+inline float Min(float a, float b) { return b < a ? b : a; }
+inline float Max(float a, float b) { return a < b ? b : a; }
+
+// Returns the overlap similarity of box a and box b as computed from
+// Rectangle_f by NonMaxSuppressionCalculator.
+template <OverlapType kOverlapType>
+inline float Similarity(float ax0, float ay0, float ax1, float ay1, float bx0,
+                        float by0, float bx1, float by1) {
+  if (ax0 > ax1 || ay0 > ay1 || bx0 > bx1 || by0 > by1 || bx1 < ax0 ||
+      ax1 < bx0 || by1 < ay0 || ay1 < by0) {
+    return 0.0f;
+  }
+  const float intersection_area =
+      (Min(ax1, bx1) - Max(ax0, bx0)) * (Min(ay1, by1) - Max(ay0, by0));
+  float normalization;
+  if constexpr (kOverlapType == NonMaxSuppressionCalculatorOptions::JACCARD) {
+    normalization = (Max(ax1, bx1) - Min(ax0, bx0)) *
+                    (Max(ay1, by1) - Min(ay0, by0));
+  } else if constexpr (kOverlapType ==
+                       NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD) {
+    normalization = (bx1 - bx0) * (by1 - by0);
+  } else {
+    normalization = (ax1 - ax0) * (ay1 - ay0) + (bx1 - bx0) * (by1 - by0) -
+                    intersection_area;
+  }
+  return normalization > 0.0f ? intersection_area / normalization : 0.0f;
+}
+
+template <OverlapType kOverlapType>
+inline float Similarity(const Boxes& boxes1, int i, const Boxes& boxes2,
+                        int j) {
+  return Similarity<kOverlapType>(boxes1.xmin[i], boxes1.ymin[i],
+                                  boxes1.xmax[i], boxes1.ymax[i],
+                                  boxes2.xmin[j], boxes2.ymin[j],
+                                  boxes2.xmax[j], boxes2.ymax[j]);
+}
+
+// Number of boxes compared at once by AnyOverlapAbove.
+constexpr int kLanes = 8;
+
+// Returns true if the overlap similarity of any of the kLanes boxes at xmin,
+// ymin, xmax and ymax with box b exceeds threshold. Same arithmetic as
+// Similarity, split into loops without control flow, which compilers
+// vectorize.
+template <OverlapType kOverlapType>
+bool AnyOverlapAboveInBlock(const float* xmin, const float* ymin,
+                            const float* xmax, const float* ymax, float bx0,
+                            float by0, float bx1, float by1, float threshold) {
+  // Boxes that do not intersect b have a similarity of zero.
+  const int b_valid = !(bx0 > bx1) & !(by0 > by1);
+  const int zero_above = 0.0f > threshold;
+  float intersection_area[kLanes];
+  float normalization[kLanes];
+  int valid[kLanes];
+  for (int k = 0; k < kLanes; ++k) {
+    intersection_area[k] = (Min(xmax[k], bx1) - Max(xmin[k], bx0)) *
+                           (Min(ymax[k], by1) - Max(ymin[k], by0));
+    if constexpr (kOverlapType == NonMaxSuppressionCalculatorOptions::JACCARD) {
+      normalization[k] = (Max(xmax[k], bx1) - Min(xmin[k], bx0)) *
+                         (Max(ymax[k], by1) - Min(ymin[k], by0));
+    } else if constexpr (kOverlapType ==
+                         NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD) {
+      normalization[k] = (bx1 - bx0) * (by1 - by0);
+    } else {
+      normalization[k] = (xmax[k] - xmin[k]) * (ymax[k] - ymin[k]) +
+                         (bx1 - bx0) * (by1 - by0) - intersection_area[k];
+    }
+    valid[k] = b_valid & !(xmin[k] > xmax[k]) & !(ymin[k] > ymax[k]) &
+               !(bx1 < xmin[k]) & !(xmax[k] < bx0) & !(by1 < ymin[k]) &
+               !(ymax[k] < by0) & (normalization[k] > 0.0f);
+  }
+  int any_above = 0;
+  for (int k = 0; k < kLanes; ++k) {
+    const int above = intersection_area[k] / normalization[k] > threshold;
+    any_above |= (valid[k] & above) | ((valid[k] ^ 1) & zero_above);
+  }
+  return any_above;
+}
+
+// Returns true if the overlap similarity of any box of boxes with box j of
+// queries exceeds threshold.
+template <OverlapType kOverlapType>
+bool AnyOverlapAbove(const Boxes& boxes, const Boxes& queries, int j,
+                     float threshold) {
+  const float* xmin = boxes.xmin.data();
+  const float* ymin = boxes.ymin.data();
+  const float* xmax = boxes.xmax.data();
+  const float* ymax = boxes.ymax.data();
+  const float bx0 = queries.xmin[j];
+  const float by0 = queries.ymin[j];
+  const float bx1 = queries.xmax[j];
+  const float by1 = queries.ymax[j];
+  const int num_boxes = boxes.size();
+  int i = 0;
+  for (; i + kLanes <= num_boxes; i += kLanes) {
+    if (AnyOverlapAboveInBlock<kOverlapType>(xmin + i, ymin + i, xmax + i,
+                                             ymax + i, bx0, by0, bx1, by1,
+                                             threshold)) {
+      return true;
+    }
+  }
+  for (; i < num_boxes; ++i) {
+    if (Similarity<kOverlapType>(xmin[i], ymin[i], xmax[i], ymax[i], bx0, by0,
+                                 bx1, by1) > threshold) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AddBox(const Boxes& from, int i, Boxes* to) {
+  to->Add(from.xmin[i], from.ymin[i], from.xmax[i], from.ymax[i]);
+}
+
+bool IsEmpty(const Boxes& boxes, int i) {
+  return boxes.xmin[i] > boxes.xmax[i] || boxes.ymin[i] > boxes.ymax[i];
+}
+
+// Pruning by grid cells is exact only if boxes that do not intersect cannot
+// be suppressed, i.e. for non-negative thresholds, and for finite boxes.
+bool CanUseGrid(const Boxes& boxes, absl::Span<const int> order,
+                float threshold) {
+  if (threshold < 0.0f || order.size() < kMinGridBoxes) return false;
+  for (int i : order) {
+    if (!std::isfinite(boxes.xmin[i]) || !std::isfinite(boxes.ymin[i]) ||
+        !std::isfinite(boxes.xmax[i]) || !std::isfinite(boxes.ymax[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// A uniform grid over the extent of a set of boxes, with cells of about the
+// mean box size. Boxes that intersect share a point, and the cell of that
+// point is within the cell ranges of both boxes, as cell coordinates are
+// monotonic in box coordinates.
+class Grid {
+ public:
+  struct CellRange {
+    int x0, y0, x1, y1;
+    int NumCells() const { return (x1 - x0 + 1) * (y1 - y0 + 1); }
+  };
+
+  // Covers the non-empty boxes at the given indices.
+  Grid(const Boxes& boxes, absl::Span<const int> indices) {
+    float xmin = 0.0f, ymin = 0.0f, xmax = 0.0f, ymax = 0.0f;
+    double sum_width = 0.0, sum_height = 0.0;
+    int num_boxes = 0;
+    for (int i : indices) {
+      if (IsEmpty(boxes, i)) continue;
+      xmin = num_boxes ? std::min(xmin, boxes.xmin[i]) : boxes.xmin[i];
+      ymin = num_boxes ? std::min(ymin, boxes.ymin[i]) : boxes.ymin[i];
+      xmax = num_boxes ? std::max(xmax, boxes.xmax[i]) : boxes.xmax[i];
+      ymax = num_boxes ? std::max(ymax, boxes.ymax[i]) : boxes.ymax[i];
+      sum_width += boxes.xmax[i] - boxes.xmin[i];
+      sum_height += boxes.ymax[i] - boxes.ymin[i];
+      ++num_boxes;
+    }
+    x_origin_ = xmin;
+    y_origin_ = ymin;
+    x_size_ = GridSize(xmax - xmin, sum_width / std::max(num_boxes, 1));
+    y_size_ = GridSize(ymax - ymin, sum_height / std::max(num_boxes, 1));
+    // Coarsens grids with many empty cells, which cost more to allocate than
+    // they save in comparisons.
+    const double coarsening = std::sqrt(
+        static_cast<double>(x_size_) * y_size_ /
+        std::max(num_boxes / kMinBoxesPerCell, 1));
+    if (coarsening > 1.0) {
+      x_size_ = std::max(static_cast<int>(x_size_ / coarsening), 1);
+      y_size_ = std::max(static_cast<int>(y_size_ / coarsening), 1);
+    }
+    x_scale_ = Scale(x_size_, xmin, xmax);
+    y_scale_ = Scale(y_size_, ymin, ymax);
+  }
+
+  int num_cells() const { return x_size_ * y_size_; }
+  int Cell(int cell_x, int cell_y) const { return cell_y * x_size_ + cell_x; }
+
+  // Returns the cells of the non-empty box i, which must be within the
+  // extent of the grid.
+  CellRange Range(const Boxes& boxes, int i) const {
+    return {CellCoordinate(boxes.xmin[i], x_origin_, x_scale_, x_size_),
+            CellCoordinate(boxes.ymin[i], y_origin_, y_scale_, y_size_),
+            CellCoordinate(boxes.xmax[i], x_origin_, x_scale_, x_size_),
+            CellCoordinate(boxes.ymax[i], y_origin_, y_scale_, y_size_)};
+  }
+
+ private:
+  // Returns the number of cells of about the mean box size along an extent.
+  static int GridSize(double extent, double mean_size) {
+    const double num_cells = mean_size > 0.0 ? extent / mean_size : 1.0;
+    return std::max(
+        static_cast<int>(std::min(num_cells, double{kMaxGridSize})), 1);
+  }
+
+  // Returns the scale from coordinates to cells, or zero for an extent too
+  // small to divide.
+  static float Scale(int size, float min_value, float max_value) {
+    const float scale = size / (max_value - min_value);
+    return std::isfinite(scale) ? scale : 0.0f;
+  }
+
+  static int CellCoordinate(float value, float origin, float scale, int size) {
+    return std::min(static_cast<int>((value - origin) * scale), size - 1);
+  }
+
+  int x_size_;
+  int y_size_;
+  float x_origin_;
+  float y_origin_;
+  float x_scale_;
+  float y_scale_;
+};
+
+template <OverlapType kOverlapType>
+std::vector<int> GreedyNonMaxSuppressionImpl(const Boxes& boxes,
+                                             absl::Span<const int> order,
+                                             float threshold,
+                                             int max_num_retained) {
+  std::vector<int> retained;
+  const auto limit_reached = [&]() {
+    return max_num_retained >= 0 && retained.size() >= max_num_retained;
+  };
+
+  if (!CanUseGrid(boxes, order, threshold)) {
+    Boxes retained_boxes;
+    for (int i : order) {
+      if (!AnyOverlapAbove<kOverlapType>(retained_boxes, boxes, i,
+                                         threshold)) {
+        retained.push_back(i);
+        AddBox(boxes, i, &retained_boxes);
+      }
+      if (limit_reached()) break;
+    }
+    return retained;
+  }
+
+  // Retained boxes, per grid cell they cover, and boxes covering many cells.
+  const Grid grid(boxes, order);
+  std::vector<Boxes> cell_boxes(grid.num_cells());
+  Boxes large_boxes;
+  for (int i : order) {
+    // Empty boxes intersect no box.
+    bool suppressed = false;
+    if (!IsEmpty(boxes, i)) {
+      const Grid::CellRange range = grid.Range(boxes, i);
+      suppressed =
+          AnyOverlapAbove<kOverlapType>(large_boxes, boxes, i, threshold);
+      for (int y = range.y0; y <= range.y1 && !suppressed; ++y) {
+        for (int x = range.x0; x <= range.x1 && !suppressed; ++x) {
+          suppressed = AnyOverlapAbove<kOverlapType>(
+              cell_boxes[grid.Cell(x, y)], boxes, i, threshold);
+        }
+      }
+      if (!suppressed) {
+        if (range.NumCells() > kMaxCellsPerBox) {
+          AddBox(boxes, i, &large_boxes);
+        } else {
+          for (int y = range.y0; y <= range.y1; ++y) {
+            for (int x = range.x0; x <= range.x1; ++x) {
+              AddBox(boxes, i, &cell_boxes[grid.Cell(x, y)]);
+            }
+          }
+        }
+      }
+    }
+    if (!suppressed) {
+      retained.push_back(i);
+    }
+    if (limit_reached()) break;
+  }
+  return retained;
+}
+
+template <OverlapType kOverlapType>
+std::vector<BoxCluster> ClusterOverlappingBoxesImpl(
+    const Boxes& boxes, absl::Span<const int> order, float threshold,
+    int num_tops) {
+  const int num_boxes = order.size();
+  std::vector<bool> removed(num_boxes, false);
+
+  // Positions in order of the boxes, per grid cell they cover, and of the
+  // boxes covering many cells.
+  std::optional<Grid> grid;
+  std::vector<std::vector<int>> cell_ranks;
+  std::vector<int> large_ranks;
+  if (CanUseGrid(boxes, order, threshold)) {
+    grid.emplace(boxes, order);
+    cell_ranks.resize(grid->num_cells());
+    for (int rank = 0; rank < num_boxes; ++rank) {
+      // Empty boxes intersect no box.
+      if (IsEmpty(boxes, order[rank])) continue;
+      const Grid::CellRange range = grid->Range(boxes, order[rank]);
+      if (range.NumCells() > kMaxCellsPerBox) {
+        large_ranks.push_back(rank);
+        continue;
+      }
+      for (int y = range.y0; y <= range.y1; ++y) {
+        for (int x = range.x0; x <= range.x1; ++x) {
+          cell_ranks[grid->Cell(x, y)].push_back(rank);
+        }
+      }
+    }
+  }
+
+  std::vector<BoxCluster> clusters;
+  // Cluster that last compared each box, as boxes may share several cells
+  // with the top box.
+  std::vector<int> compared_in(num_boxes, -1);
+  std::vector<int> member_ranks;
+  int first = 0;
+  while (first < num_boxes && first < num_tops) {
+    const int top = order[first];
+    const int cluster_id = clusters.size();
+    member_ranks.clear();
+    const auto compare = [&](int rank) {
+      if (removed[rank] || compared_in[rank] == cluster_id) return;
+      compared_in[rank] = cluster_id;
+      if (Similarity<kOverlapType>(boxes, order[rank], boxes, top) >
+          threshold) {
+        member_ranks.push_back(rank);
+      }
+    };
+    if (grid) {
+      if (!IsEmpty(boxes, top)) {
+        for (int rank : large_ranks) compare(rank);
+        const Grid::CellRange range = grid->Range(boxes, top);
+        for (int y = range.y0; y <= range.y1; ++y) {
+          for (int x = range.x0; x <= range.x1; ++x) {
+            for (int rank : cell_ranks[grid->Cell(x, y)]) compare(rank);
+          }
+        }
+        std::sort(member_ranks.begin(), member_ranks.end());
+      }
+    } else {
+      for (int rank = first; rank < num_boxes; ++rank) compare(rank);
+    }
+
+    BoxCluster& cluster = clusters.emplace_back();
+    cluster.top = top;
+    cluster.members.reserve(member_ranks.size());
+    for (int rank : member_ranks) {
+      removed[rank] = true;
+      cluster.members.push_back(order[rank]);
+    }
+    if (member_ranks.empty()) break;
+    while (first < num_boxes && removed[first]) ++first;
+  }
+  return clusters;
+}
+
+}  // namespace
+
+void Boxes::Reserve(int num_boxes) {
+  xmin.reserve(num_boxes);
+  ymin.reserve(num_boxes);
+  xmax.reserve(num_boxes);
+  ymax.reserve(num_boxes);
+}
+
+void Boxes::Add(const Rectangle_f& rect) {
+  Add(rect.xmin(), rect.ymin(), rect.xmax(), rect.ymax());
+}
+
+void Boxes::Add(float box_xmin, float box_ymin, float box_xmax,
+                float box_ymax) {
+  xmin.push_back(box_xmin);
+  ymin.push_back(box_ymin);
+  xmax.push_back(box_xmax);
+  ymax.push_back(box_ymax);
+}
+
+float OverlapSimilarity(OverlapType overlap_type, const Boxes& boxes1, int i,
+                        const Boxes& boxes2, int j) {
+  switch (overlap_type) {
+    case NonMaxSuppressionCalculatorOptions::JACCARD:
+      return Similarity<NonMaxSuppressionCalculatorOptions::JACCARD>(
+          boxes1, i, boxes2, j);
+    case NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD:
+      return Similarity<NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD>(
+          boxes1, i, boxes2, j);
+    case NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION:
+      return Similarity<
+          NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION>(
+          boxes1, i, boxes2, j);
+    default:
+      break;
+  }
+  ABSL_LOG(FATAL) << "Unrecognized overlap type: " << overlap_type;
+  return 0.0f;
+}
+
+std::vector<int> GreedyNonMaxSuppression(const Boxes& boxes,
+                                         absl::Span<const int> order,
+                                         OverlapType overlap_type,
+                                         float threshold,
+                                         int max_num_retained) {
+  switch (overlap_type) {
+    case NonMaxSuppressionCalculatorOptions::JACCARD:
+      return GreedyNonMaxSuppressionImpl<
+          NonMaxSuppressionCalculatorOptions::JACCARD>(boxes, order, threshold,
+                                                       max_num_retained);
+    case NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD:
+      return GreedyNonMaxSuppressionImpl<
+          NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD>(
+          boxes, order, threshold, max_num_retained);
+    case NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION:
+      return GreedyNonMaxSuppressionImpl<
+          NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION>(
+          boxes, order, threshold, max_num_retained);
+    default:
+      break;
+  }
+  ABSL_LOG(FATAL) << "Unrecognized overlap type: " << overlap_type;
+  return {};
+}
+
+std::vector<BoxCluster> ClusterOverlappingBoxes(const Boxes& boxes,
+                                                absl::Span<const int> order,
+                                                OverlapType overlap_type,
+                                                float threshold, int num_tops) {
+  switch (overlap_type) {
+    case NonMaxSuppressionCalculatorOptions::JACCARD:
+      return ClusterOverlappingBoxesImpl<
+          NonMaxSuppressionCalculatorOptions::JACCARD>(boxes, order, threshold,
+                                                       num_tops);
+    case NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD:
+      return ClusterOverlappingBoxesImpl<
+          NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD>(
+          boxes, order, threshold, num_tops);
+    case NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION:
+      return ClusterOverlappingBoxesImpl<
+          NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION>(
+          boxes, order, threshold, num_tops);
+    default:
+      break;
+  }
+  ABSL_LOG(FATAL) << "Unrecognized overlap type: " << overlap_type;
+  return {};
+}
+
+}  // namespace nms
+}  // namespace mediapipe
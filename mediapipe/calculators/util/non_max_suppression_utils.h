@@ -0,0 +1,84 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Non-maximum suppression on flat arrays of boxes, as used by
+// NonMaxSuppressionCalculator. Overlaps are computed with the arithmetic of
+// Rectangle_f, so results are identical to pairwise comparisons of the
+// rectangles. Boxes that cannot overlap are pruned with a uniform grid.
+
+#ifndef MEDIAPIPE_CALCULATORS_UTIL_NON_MAX_SUPPRESSION_UTILS_H_
+#define MEDIAPIPE_CALCULATORS_UTIL_NON_MAX_SUPPRESSION_UTILS_H_
+
+#include <vector>
+
+#include "absl/types/span.h"
+#include "mediapipe/calculators/util/non_max_suppression_calculator.pb.h"
+#include "mediapipe/framework/port/rectangle.h"
+
+namespace mediapipe {
+namespace nms {
+
+using OverlapType = NonMaxSuppressionCalculatorOptions::OverlapType;
+
+// Axis aligned boxes, stored as one array per coordinate.
+struct Boxes {
+  std::vector<float> xmin;
+  std::vector<float> ymin;
+  std::vector<float> xmax;
+  std::vector<float> ymax;
+
+  int size() const { return xmin.size(); }
+  void Reserve(int num_boxes);
+  void Add(const Rectangle_f& rect);
+  void Add(float box_xmin, float box_ymin, float box_xmax, float box_ymax);
+};
+
+// Returns the overlap similarity of boxes i of boxes1 and j of boxes2, with
+// the normalization of overlap_type. MODIFIED_JACCARD normalizes by the area
+// of the second box.
+float OverlapSimilarity(OverlapType overlap_type, const Boxes& boxes1, int i,
+                        const Boxes& boxes2, int j);
+
+// Greedy non-maximum suppression. Traverses the boxes in the given order and
+// retains a box unless its overlap similarity with a box retained before
+// exceeds threshold. Stops once max_num_retained boxes are retained, unless
+// max_num_retained is negative. Returns the indices of the retained boxes,
+// in order.
+std::vector<int> GreedyNonMaxSuppression(const Boxes& boxes,
+                                         absl::Span<const int> order,
+                                         OverlapType overlap_type,
+                                         float threshold, int max_num_retained);
+
+// A box together with the remaining boxes that overlap it.
+struct BoxCluster {
+  int top;
+  // Indices of the members, in traversal order, starting with top unless top
+  // does not overlap itself, e.g. as it has no area.
+  std::vector<int> members;
+};
+
+// Clustering for weighted non-maximum suppression. Repeatedly takes the first
+// remaining box in the given order and removes it together with all remaining
+// boxes whose overlap similarity with it exceeds threshold. Only the first
+// num_tops boxes in order start clusters. Stops after a cluster without
+// members, as no box was removed.
+std::vector<BoxCluster> ClusterOverlappingBoxes(const Boxes& boxes,
+                                                absl::Span<const int> order,
+                                                OverlapType overlap_type,
+                                                float threshold, int num_tops);
+
+}  // namespace nms
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_UTIL_NON_MAX_SUPPRESSION_UTILS_H_
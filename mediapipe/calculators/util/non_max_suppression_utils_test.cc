@@ -0,0 +1,322 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/util/non_max_suppression_utils.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "mediapipe/calculators/util/non_max_suppression_calculator.pb.h"
+#include "mediapipe/framework/port/benchmark.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/rectangle.h"
+
+namespace mediapipe {
+namespace nms {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+constexpr OverlapType kOverlapTypes[] = {
+    NonMaxSuppressionCalculatorOptions::JACCARD,
+    NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD,
+    NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION};
+
+// Random boxes of a crowd scene, with some boxes of zero or negative size.
+std::vector<Rectangle_f> RandomRects(int num_rects, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> position(0.0f, 1.0f);
+  std::uniform_real_distribution<float> size(0.01f, 0.15f);
+  std::uniform_int_distribution<int> kind(0, 19);
+  std::vector<Rectangle_f> rects;
+  for (int i = 0; i < num_rects; ++i) {
+    float width = size(rng);
+    float height = size(rng);
+    switch (kind(rng)) {
+      case 0:
+        width = 0.0f;
+        break;
+      case 1:
+        height = -height;
+        break;
+      case 2:
+        // Large boxes, covering many grid cells.
+        width = 0.8f;
+        break;
+    }
+    rects.emplace_back(position(rng), position(rng), width, height);
+  }
+  return rects;
+}
+
+// Candidate boxes of a detector in a crowd scene, several per object.
+std::vector<Rectangle_f> CrowdRects(int num_rects, int seed) {
+  constexpr int kCandidatesPerObject = 8;
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> position(0.0f, 1.0f);
+  std::uniform_real_distribution<float> size(0.02f, 0.1f);
+  std::uniform_real_distribution<float> jitter(-0.15f, 0.15f);
+  std::vector<Rectangle_f> rects;
+  float x, y, width, height;
+  for (int i = 0; i < num_rects; ++i) {
+    if (i % kCandidatesPerObject == 0) {
+      x = position(rng);
+      y = position(rng);
+      width = size(rng);
+      height = size(rng);
+    }
+    rects.emplace_back(x + jitter(rng) * width, y + jitter(rng) * height,
+                       width * (1.0f + jitter(rng)),
+                       height * (1.0f + jitter(rng)));
+  }
+  return rects;
+}
+
+Boxes ToBoxes(const std::vector<Rectangle_f>& rects) {
+  Boxes boxes;
+  for (const Rectangle_f& rect : rects) boxes.Add(rect);
+  return boxes;
+}
+
+std::vector<int> ShuffledOrder(int num_rects, int seed) {
+  std::vector<int> order(num_rects);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+  return order;
+}
+
+// The overlap similarity of NonMaxSuppressionCalculator, on Rectangle_f.
+float RectSimilarity(OverlapType overlap_type, const Rectangle_f& rect1,
+                     const Rectangle_f& rect2) {
+  if (!rect1.Intersects(rect2)) return 0.0f;
+  const float intersection_area = Rectangle_f(rect1).Intersect(rect2).Area();
+  float normalization;
+  switch (overlap_type) {
+    case NonMaxSuppressionCalculatorOptions::JACCARD:
+      normalization = Rectangle_f(rect1).Union(rect2).Area();
+      break;
+    case NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD:
+      normalization = rect2.Area();
+      break;
+    default:
+      normalization = rect1.Area() + rect2.Area() - intersection_area;
+      break;
+  }
+  return normalization > 0.0f ? intersection_area / normalization : 0.0f;
+}
+
+// The pairwise loop NonMaxSuppressionCalculator used for greedy suppression.
+std::vector<int> PairwiseGreedyNonMaxSuppression(
+    const std::vector<Rectangle_f>& rects, const std::vector<int>& order,
+    OverlapType overlap_type, float threshold, int max_num_retained) {
+  std::vector<int> retained;
+  for (int i : order) {
+    bool suppressed = false;
+    for (int j : retained) {
+      if (RectSimilarity(overlap_type, rects[j], rects[i]) > threshold) {
+        suppressed = true;
+        break;
+      }
+    }
+    if (!suppressed) retained.push_back(i);
+    if (max_num_retained >= 0 && retained.size() >= max_num_retained) break;
+  }
+  return retained;
+}
+
+// The pairwise loop NonMaxSuppressionCalculator used for weighted
+// suppression.
+std::vector<BoxCluster> PairwiseClusterOverlappingBoxes(
+    const std::vector<Rectangle_f>& rects, const std::vector<int>& order,
+    OverlapType overlap_type, float threshold, int num_tops) {
+  std::vector<BoxCluster> clusters;
+  std::vector<int> remaining(order.begin(), order.end());
+  while (!remaining.empty()) {
+    const int top = remaining[0];
+    if (std::find(order.begin(), order.begin() + num_tops, top) ==
+        order.begin() + num_tops) {
+      break;
+    }
+    BoxCluster cluster;
+    cluster.top = top;
+    std::vector<int> rest;
+    for (int i : remaining) {
+      if (RectSimilarity(overlap_type, rects[i], rects[top]) > threshold) {
+        cluster.members.push_back(i);
+      } else {
+        rest.push_back(i);
+      }
+    }
+    clusters.push_back(cluster);
+    if (rest.size() == remaining.size()) break;
+    remaining = std::move(rest);
+  }
+  return clusters;
+}
+
+TEST(NonMaxSuppressionUtilsTest, OverlapSimilarityMatchesRectangles) {
+  const std::vector<Rectangle_f> rects = RandomRects(200, /*seed=*/1);
+  const Boxes boxes = ToBoxes(rects);
+  for (OverlapType overlap_type : kOverlapTypes) {
+    for (int i = 0; i < rects.size(); ++i) {
+      for (int j = 0; j < rects.size(); ++j) {
+        ASSERT_EQ(OverlapSimilarity(overlap_type, boxes, i, boxes, j),
+                  RectSimilarity(overlap_type, rects[i], rects[j]))
+            << overlap_type << ": " << i << ", " << j;
+      }
+    }
+  }
+}
+
+// Random boxes and crowd scene boxes, of increasing number.
+std::vector<std::vector<Rectangle_f>> TestRects() {
+  std::vector<std::vector<Rectangle_f>> test_rects;
+  for (int num_rects : {0, 1, 20, 300, 2000}) {
+    test_rects.push_back(RandomRects(num_rects, /*seed=*/num_rects));
+    test_rects.push_back(CrowdRects(num_rects, /*seed=*/num_rects));
+  }
+  return test_rects;
+}
+
+TEST(NonMaxSuppressionUtilsTest, GreedyMatchesPairwise) {
+  for (const std::vector<Rectangle_f>& rects : TestRects()) {
+    const Boxes boxes = ToBoxes(rects);
+    const std::vector<int> order = ShuffledOrder(rects.size(), /*seed=*/2);
+    for (OverlapType overlap_type : kOverlapTypes) {
+      for (float threshold : {-0.1f, 0.0f, 0.3f, 0.7f}) {
+        for (int max_num_retained : {-1, 10}) {
+          EXPECT_EQ(GreedyNonMaxSuppression(boxes, order, overlap_type,
+                                            threshold, max_num_retained),
+                    PairwiseGreedyNonMaxSuppression(rects, order, overlap_type,
+                                                    threshold,
+                                                    max_num_retained))
+              << rects.size() << " boxes, " << overlap_type << ", "
+              << threshold << ", " << max_num_retained;
+        }
+      }
+    }
+  }
+}
+
+TEST(NonMaxSuppressionUtilsTest, ClustersMatchPairwise) {
+  for (const std::vector<Rectangle_f>& rects : TestRects()) {
+    const Boxes boxes = ToBoxes(rects);
+    const int num_rects = rects.size();
+    const std::vector<int> order = ShuffledOrder(num_rects, /*seed=*/3);
+    for (OverlapType overlap_type : kOverlapTypes) {
+      for (float threshold : {-0.1f, 0.0f, 0.3f, 0.7f}) {
+        for (int num_tops : {num_rects, num_rects / 2}) {
+          const std::vector<BoxCluster> clusters = ClusterOverlappingBoxes(
+              boxes, order, overlap_type, threshold, num_tops);
+          const std::vector<BoxCluster> expected =
+              PairwiseClusterOverlappingBoxes(rects, order, overlap_type,
+                                              threshold, num_tops);
+          ASSERT_EQ(clusters.size(), expected.size())
+              << num_rects << " boxes, " << overlap_type << ", " << threshold
+              << ", " << num_tops;
+          for (int k = 0; k < clusters.size(); ++k) {
+            EXPECT_EQ(clusters[k].top, expected[k].top);
+            EXPECT_THAT(clusters[k].members,
+                        ElementsAreArray(expected[k].members));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(NonMaxSuppressionUtilsTest, ClusteringStopsAtBoxWithoutArea) {
+  const std::vector<Rectangle_f> rects = {Rectangle_f(0.1f, 0.1f, 0.0f, 0.2f),
+                                          Rectangle_f(0.1f, 0.1f, 0.2f, 0.2f)};
+  const std::vector<BoxCluster> clusters = ClusterOverlappingBoxes(
+      ToBoxes(rects), {0, 1}, NonMaxSuppressionCalculatorOptions::JACCARD,
+      /*threshold=*/0.3f, /*num_tops=*/2);
+  ASSERT_EQ(clusters.size(), 1);
+  EXPECT_EQ(clusters[0].top, 0);
+  EXPECT_THAT(clusters[0].members, ElementsAre());
+}
+
+// Measures greedy suppression of state.range(0) boxes with the pairwise loop
+// over rectangles (state.range(1) == 0) and with GreedyNonMaxSuppression.
+void BM_GreedyNonMaxSuppression(benchmark::State& state) {
+  const int num_rects = state.range(0);
+  const std::vector<Rectangle_f> rects = CrowdRects(num_rects, /*seed=*/4);
+  const Boxes boxes = ToBoxes(rects);
+  const std::vector<int> order = ShuffledOrder(num_rects, /*seed=*/5);
+  for (auto _ : state) {
+    std::vector<int> retained;
+    if (state.range(1)) {
+      retained = GreedyNonMaxSuppression(
+          boxes, order, NonMaxSuppressionCalculatorOptions::JACCARD,
+          /*threshold=*/0.3f, /*max_num_retained=*/-1);
+    } else {
+      retained = PairwiseGreedyNonMaxSuppression(
+          rects, order, NonMaxSuppressionCalculatorOptions::JACCARD,
+          /*threshold=*/0.3f, /*max_num_retained=*/-1);
+    }
+    benchmark::DoNotOptimize(retained);
+  }
+  state.SetItemsProcessed(state.iterations() * num_rects);
+}
+BENCHMARK(BM_GreedyNonMaxSuppression)
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({300, 0})
+    ->Args({300, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({4000, 0})
+    ->Args({4000, 1});
+
+// Measures weighted suppression clustering of state.range(0) boxes with the
+// pairwise loop over rectangles (state.range(1) == 0) and with
+// ClusterOverlappingBoxes.
+void BM_ClusterOverlappingBoxes(benchmark::State& state) {
+  const int num_rects = state.range(0);
+  const std::vector<Rectangle_f> rects = CrowdRects(num_rects, /*seed=*/6);
+  const Boxes boxes = ToBoxes(rects);
+  const std::vector<int> order = ShuffledOrder(num_rects, /*seed=*/7);
+  for (auto _ : state) {
+    std::vector<BoxCluster> clusters;
+    if (state.range(1)) {
+      clusters = ClusterOverlappingBoxes(
+          boxes, order, NonMaxSuppressionCalculatorOptions::JACCARD,
+          /*threshold=*/0.3f, num_rects);
+    } else {
+      clusters = PairwiseClusterOverlappingBoxes(
+          rects, order, NonMaxSuppressionCalculatorOptions::JACCARD,
+          /*threshold=*/0.3f, num_rects);
+    }
+    benchmark::DoNotOptimize(clusters);
+  }
+  state.SetItemsProcessed(state.iterations() * num_rects);
+}
+BENCHMARK(BM_ClusterOverlappingBoxes)
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({300, 0})
+    ->Args({300, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({4000, 0})
+    ->Args({4000, 1});
+
+}  // namespace
+}  // namespace nms
+}  // namespace mediapipe
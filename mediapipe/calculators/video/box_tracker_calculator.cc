@@ -19,6 +19,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
@@ -542,9 +543,14 @@ absl::Status BoxTrackerCalculator::Open(CalculatorContext* cc) {
 absl::Status BoxTrackerCalculator::Process(CalculatorContext* cc) {
   // Batch mode, issue tracking requests.
   if (box_tracker_ && !tracking_issued_) {
+    std::vector<TimedBox> positions;
+    std::vector<int> ids;
     for (const auto& pos : initial_pos_.box()) {
-      box_tracker_->NewBoxTrack(TimedBox::FromProto(pos), pos.id());
+      positions.push_back(TimedBox::FromProto(pos));
+      ids.push_back(pos.id());
     }
+    // Boxes starting at the same time are tracked jointly.
+    box_tracker_->NewBoxTrackBatch(positions, ids);
     tracking_issued_ = true;
   }
 
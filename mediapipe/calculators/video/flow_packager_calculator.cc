@@ -25,6 +25,7 @@
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/util/tracking/camera_motion.pb.h"
 #include "mediapipe/util/tracking/flow_packager.h"
+#include "mediapipe/util/tracking/indexed_tracking_data_chunk.h"
 #include "mediapipe/util/tracking/region_flow.pb.h"
 
 namespace mediapipe {
@@ -248,7 +249,11 @@ void FlowPackagerCalculator::WriteChunk(const TrackingDataChunk& chunk) const {
   }
 
   std::string data;
-  chunk.SerializeToString(&data);
+  if (options_.index_cache_files()) {
+    data = SerializeIndexedTrackingDataChunk(chunk);
+  } else {
+    chunk.SerializeToString(&data);
+  }
 
   const char* temp_filename = tempnam(cache_dir_.c_str(), nullptr);
   std::ofstream out_file(temp_filename);
@@ -15,6 +15,7 @@
 #include <cmath>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "absl/log/absl_check.h"
@@ -30,12 +31,15 @@
 #include "mediapipe/framework/port/logging.h"
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 #include "mediapipe/util/tracking/camera_motion.h"
 #include "mediapipe/util/tracking/camera_motion.pb.h"
 #include "mediapipe/util/tracking/frame_selection.pb.h"
 #include "mediapipe/util/tracking/motion_analysis.h"
 #include "mediapipe/util/tracking/motion_estimation.h"
 #include "mediapipe/util/tracking/motion_models.h"
+#include "mediapipe/util/tracking/parallel_invoker.h"
+#include "mediapipe/util/tracking/parallel_invoker_service.h"
 #include "mediapipe/util/tracking/region_flow.pb.h"
 
 namespace mediapipe {
@@ -102,6 +106,10 @@ const char kOptionsTag[] = "OPTIONS";
 //              VIDEO at the selected frames. Required VIDEO to be present.
 //   GRAY_VIDEO_OUT: Optional output stream for downsampled, grayscale video.
 //                   Requires VIDEO to be present and SELECTION to not be used.
+//
+// If the graph provides kParallelInvokerExecutorService, the parallel loops of
+// the motion analysis run on its executor instead of the parallel invoker
+// thread pool.
 class MotionAnalysisCalculator : public CalculatorBase {
   // TODO: Activate once leakr approval is ready.
   // typedef com::google::android::libraries::micro::proto::Data HomographyData;
@@ -120,6 +128,10 @@ class MotionAnalysisCalculator : public CalculatorBase {
   // Otherwise no-op. Set flush to true to force output of all buffered data.
   void OutputMotionAnalyzedFrames(bool flush, CalculatorContext* cc);
 
+  // Returns the scope dispatching the parallel loops onto parallel_executor_,
+  // if set.
+  std::optional<ParallelInvokerExecutorScope> MakeParallelExecutorScope();
+
   // Lazy init function to be called on Process.
   absl::Status InitOnProcess(InputStream* video_stream,
                              InputStream* selection_stream);
@@ -199,6 +211,9 @@ class MotionAnalysisCalculator : public CalculatorBase {
   std::unique_ptr<MotionAnalysis> motion_analysis_;
 
   std::unique_ptr<MixtureRowWeights> row_weights_;
+
+  // Executor running the parallel loops, from kParallelInvokerExecutorService.
+  ThreadPoolExecutor* parallel_executor_ = nullptr;
 };
 
 REGISTER_CALCULATOR(MotionAnalysisCalculator);
@@ -260,6 +275,8 @@ absl::Status MotionAnalysisCalculator::GetContract(CalculatorContract* cc) {
     cc->InputSidePackets().Tag(kOptionsTag).Set<CalculatorOptions>();
   }
 
+  cc->UseService(kParallelInvokerExecutorService).Optional();
+
   return absl::OkStatus();
 }
 
@@ -278,6 +295,11 @@ absl::Status MotionAnalysisCalculator::Open(CalculatorContext* cc) {
   video_output_ = cc->Outputs().HasTag(kVideoOutTag);
   grayscale_output_ = cc->Outputs().HasTag(kGrayVideoOutTag);
   csv_file_input_ = cc->InputSidePackets().HasTag(kCsvFileTag);
+
+  if (cc->Service(kParallelInvokerExecutorService).IsAvailable()) {
+    parallel_executor_ =
+        &cc->Service(kParallelInvokerExecutorService).GetObject();
+  }
   hybrid_meta_analysis_ = options_.meta_analysis() ==
                           MotionAnalysisCalculatorOptions::META_ANALYSIS_HYBRID;
 
@@ -422,6 +444,7 @@ absl::Status MotionAnalysisCalculator::Process(CalculatorContext* cc) {
   if (options_.bypass_mode()) {
     return absl::OkStatus();
   }
+  const auto executor_scope = MakeParallelExecutorScope();
 
   InputStream* video_stream =
       video_input_ ? &(cc->Inputs().Tag(kVideoTag)) : nullptr;
@@ -600,6 +623,7 @@ absl::Status MotionAnalysisCalculator::Process(CalculatorContext* cc) {
 absl::Status MotionAnalysisCalculator::Close(CalculatorContext* cc) {
   // Guard against empty videos.
   if (motion_analysis_) {
+    const auto executor_scope = MakeParallelExecutorScope();
     OutputMotionAnalyzedFrames(true, cc);
   }
   if (csv_file_input_) {
@@ -611,6 +635,13 @@ absl::Status MotionAnalysisCalculator::Close(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+std::optional<ParallelInvokerExecutorScope>
+MotionAnalysisCalculator::MakeParallelExecutorScope() {
+  if (parallel_executor_ == nullptr) return std::nullopt;
+  return std::make_optional<ParallelInvokerExecutorScope>(
+      parallel_executor_, parallel_executor_->num_threads());
+}
+
 void MotionAnalysisCalculator::OutputMotionAnalyzedFrames(
     bool flush, CalculatorContext* cc) {
   std::vector<std::unique_ptr<RegionFlowFeatureList>> features;
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -36,7 +37,9 @@
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/port/status_matchers.h"
 #include "mediapipe/framework/tool/test_util.h"
+#include "mediapipe/util/tracking/box_tracker.h"
 #include "mediapipe/util/tracking/box_tracker.pb.h"
+#include "mediapipe/util/tracking/flow_packager.pb.h"
 #include "mediapipe/util/tracking/tracking.pb.h"
 
 namespace mediapipe {
@@ -682,6 +685,93 @@ TEST_F(TrackingGraphTest, TestTransitionFramesForReacquisition) {
   }
 }
 
+// Tracks the boxes of BasicBoxTrackingSanityCheck with BoxTracker on the
+// tracking data of the graph, jointly via NewBoxTrackBatch and separately via
+// NewBoxTrack.
+TEST_F(TrackingGraphTest, BoxTrackerBatchMatchesSeparateTracks) {
+  std::map<std::string, mediapipe::Packet> side_packets;
+  side_packets.insert(std::make_pair("analysis_downsample_factor",
+                                     mediapipe::MakePacket<float>(1.0f)));
+  side_packets.insert(std::make_pair(
+      "calculator_options",
+      mediapipe::MakePacket<CalculatorOptions>(CalculatorOptions())));
+
+  CalculatorGraphConfig config = config_;
+  std::vector<Packet> tracking_data_packets;
+  mediapipe::tool::AddVectorSink("tracking_data", &config,
+                                 &tracking_data_packets);
+  BoxTrackerOptions tracker_options;
+  for (const auto& node : config.node()) {
+    if (node.calculator() == "BoxTrackerCalculator") {
+      tracker_options =
+          node.options().GetExtension(BoxTrackerCalculatorOptions::ext)
+              .tracker_options();
+    }
+  }
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun(side_packets));
+  for (const auto& frame_packet : input_frames_packets_) {
+    MP_ASSERT_OK(
+        graph.AddPacketToInputStream("image_cpu_frames", frame_packet));
+    MP_ASSERT_OK(graph.WaitUntilIdle());
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  ASSERT_EQ(tracking_data_packets.size(), input_frames_packets_.size());
+
+  TrackingDataChunk chunk;
+  chunk.set_first_chunk(true);
+  chunk.set_last_chunk(true);
+  for (int i = 0; i < tracking_data_packets.size(); ++i) {
+    TrackingDataChunk::Item* item = chunk.add_item();
+    *item->mutable_tracking_data() =
+        tracking_data_packets[i].Get<TrackingData>();
+    item->set_frame_idx(i);
+    item->set_timestamp_usec(tracking_data_packets[i].Timestamp().Value());
+    if (i > 0) {
+      item->set_prev_timestamp_usec(
+          tracking_data_packets[i - 1].Timestamp().Value());
+    }
+  }
+
+  constexpr int kNumBoxes = 3;
+  auto start_box_list = MakeBoxList(
+      input_frames_packets_[0].Timestamp(), std::vector<bool>(kNumBoxes),
+      std::vector<bool>(kNumBoxes), std::vector<bool>(kNumBoxes));
+  std::vector<TimedBox> positions;
+  std::vector<int> ids;
+  for (int j = 0; j < kNumBoxes; ++j) {
+    positions.push_back(TimedBox::FromProto(start_box_list->box(j)));
+    ids.push_back(j);
+  }
+
+  BoxTracker batch_tracker({&chunk}, /*copy_data=*/false, tracker_options);
+  BoxTracker separate_tracker({&chunk}, /*copy_data=*/false, tracker_options);
+  batch_tracker.NewBoxTrackBatch(positions, ids);
+  for (int j = 0; j < kNumBoxes; ++j) {
+    separate_tracker.NewBoxTrack(positions[j], ids[j]);
+  }
+  ASSERT_TRUE(batch_tracker.WaitForAllOngoingTracks());
+  ASSERT_TRUE(separate_tracker.WaitForAllOngoingTracks());
+
+  for (int i = 0; i < chunk.item_size(); ++i) {
+    const int64_t time_msec = chunk.item(i).timestamp_usec() / 1000;
+    for (int id : ids) {
+      TimedBox batch_box;
+      TimedBox separate_box;
+      ASSERT_TRUE(batch_tracker.GetTimedPosition(id, time_msec, &batch_box));
+      ASSERT_TRUE(
+          separate_tracker.GetTimedPosition(id, time_msec, &separate_box));
+      EXPECT_EQ(batch_box.left, separate_box.left);
+      EXPECT_EQ(batch_box.top, separate_box.top);
+      EXPECT_EQ(batch_box.right, separate_box.right);
+      EXPECT_EQ(batch_box.bottom, separate_box.bottom);
+      ExpectBoxAtFrame(batch_box.ToProto(), i, false);
+    }
+  }
+}
+
 // TODO: Add test for reacquisition.
 
 }  // namespace
@@ -14,12 +14,17 @@
 
 #include "mediapipe/framework/calculator_context_manager.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 #include "absl/log/absl_check.h"
 #include "absl/memory/memory.h"
+#include "absl/numeric/bits.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/port/logging.h"
+#include "mediapipe/framework/port/status_macros.h"
 
 namespace mediapipe {
 
@@ -27,12 +32,13 @@ void CalculatorContextManager::Initialize(
     CalculatorState* calculator_state,
     std::shared_ptr<tool::TagMap> input_tag_map,
     std::shared_ptr<tool::TagMap> output_tag_map,
-    bool calculator_run_in_parallel) {
+    bool calculator_run_in_parallel, int max_in_flight) {
   ABSL_CHECK(calculator_state);
   calculator_state_ = calculator_state;
   input_tag_map_ = std::move(input_tag_map);
   output_tag_map_ = std::move(output_tag_map);
   calculator_run_in_parallel_ = calculator_run_in_parallel;
+  max_in_flight_ = std::max(max_in_flight, 1);
 }
 
 absl::Status CalculatorContextManager::PrepareForRun(
@@ -40,14 +46,34 @@ absl::Status CalculatorContextManager::PrepareForRun(
   setup_shards_callback_ = std::move(setup_shards_callback);
   default_context_ = absl::make_unique<CalculatorContext>(
       calculator_state_, input_tag_map_, output_tag_map_);
-  return setup_shards_callback_(default_context_.get());
+  MP_RETURN_IF_ERROR(setup_shards_callback_(default_context_.get()));
+  if (!calculator_run_in_parallel_) {
+    return absl::OkStatus();
+  }
+  absl::MutexLock lock(&contexts_mutex_);
+  active_contexts_.resize(absl::bit_ceil(static_cast<uint32_t>(max_in_flight_)));
+  active_begin_ = 0;
+  num_active_contexts_ = 0;
+  contexts_.reserve(max_in_flight_);
+  idle_contexts_.reserve(max_in_flight_);
+  for (int i = 0; i < max_in_flight_; ++i) {
+    auto context = absl::make_unique<CalculatorContext>(
+        calculator_state_, input_tag_map_, output_tag_map_);
+    MP_RETURN_IF_ERROR(setup_shards_callback_(context.get()));
+    idle_contexts_.push_back(context.get());
+    contexts_.push_back(std::move(context));
+  }
+  return absl::OkStatus();
 }
 
 void CalculatorContextManager::CleanupAfterRun() {
   default_context_ = nullptr;
   absl::MutexLock lock(&contexts_mutex_);
   active_contexts_.clear();
+  active_begin_ = 0;
+  num_active_contexts_ = 0;
   idle_contexts_.clear();
+  contexts_.clear();
 }
 
 CalculatorContext* CalculatorContextManager::GetDefaultCalculatorContext()
@@ -60,9 +86,28 @@ CalculatorContext* CalculatorContextManager::GetFrontCalculatorContext(
     Timestamp* context_input_timestamp) {
   ABSL_CHECK(calculator_run_in_parallel_);
   absl::MutexLock lock(&contexts_mutex_);
-  ABSL_CHECK(!active_contexts_.empty());
-  *context_input_timestamp = active_contexts_.begin()->first;
-  return active_contexts_.begin()->second.get();
+  ABSL_CHECK_GT(num_active_contexts_, 0);
+  const ActiveContext& front = ActiveContextAt(0);
+  *context_input_timestamp = front.input_timestamp;
+  return front.context;
+}
+
+CalculatorContext* CalculatorContextManager::CreateCalculatorContext() {
+  auto context = absl::make_unique<CalculatorContext>(
+      calculator_state_, input_tag_map_, output_tag_map_);
+  MEDIAPIPE_CHECK_OK(setup_shards_callback_(context.get()));
+  contexts_.push_back(std::move(context));
+  return contexts_.back().get();
+}
+
+void CalculatorContextManager::GrowActiveContexts() {
+  std::vector<ActiveContext> grown(std::max<size_t>(
+      2 * active_contexts_.size(), 1));
+  for (int i = 0; i < num_active_contexts_; ++i) {
+    grown[i] = ActiveContextAt(i);
+  }
+  active_contexts_ = std::move(grown);
+  active_begin_ = 0;
 }
 
 CalculatorContext* CalculatorContextManager::PrepareCalculatorContext(
@@ -71,33 +116,42 @@ CalculatorContext* CalculatorContextManager::PrepareCalculatorContext(
     return GetDefaultCalculatorContext();
   }
   absl::MutexLock lock(&contexts_mutex_);
-  ABSL_CHECK(!mediapipe::ContainsKey(active_contexts_, input_timestamp))
-      << "Multiple invocations with the same timestamps are not allowed with "
-         "parallel execution, input_timestamp = "
-      << input_timestamp;
+  if (num_active_contexts_ == static_cast<int>(active_contexts_.size())) {
+    GrowActiveContexts();
+  }
+  // Invocations are normally prepared in increasing timestamp order, so the
+  // new context is usually appended at the back.
+  int position = num_active_contexts_;
+  while (position > 0 &&
+         ActiveContextAt(position - 1).input_timestamp >= input_timestamp) {
+    ABSL_CHECK(ActiveContextAt(position - 1).input_timestamp !=
+               input_timestamp)
+        << "Multiple invocations with the same timestamps are not allowed "
+           "with parallel execution, input_timestamp = "
+        << input_timestamp;
+    ActiveContextAt(position) = ActiveContextAt(position - 1);
+    --position;
+  }
   CalculatorContext* calculator_context = nullptr;
   if (idle_contexts_.empty()) {
-    auto new_context = absl::make_unique<CalculatorContext>(
-        calculator_state_, input_tag_map_, output_tag_map_);
-    MEDIAPIPE_CHECK_OK(setup_shards_callback_(new_context.get()));
-    calculator_context = new_context.get();
-    active_contexts_.emplace(input_timestamp, std::move(new_context));
+    calculator_context = CreateCalculatorContext();
   } else {
     // Retrieves an inactive calculator context from idle_contexts_.
-    calculator_context = idle_contexts_.front().get();
-    active_contexts_.emplace(input_timestamp,
-                             std::move(idle_contexts_.front()));
-    idle_contexts_.pop_front();
+    calculator_context = idle_contexts_.back();
+    idle_contexts_.pop_back();
   }
+  ActiveContextAt(position) = {input_timestamp, calculator_context};
+  ++num_active_contexts_;
   return calculator_context;
 }
 
 void CalculatorContextManager::RecycleCalculatorContext() {
   absl::MutexLock lock(&contexts_mutex_);
+  ABSL_CHECK_GT(num_active_contexts_, 0);
   // The first element in active_contexts_ will be recycled.
-  auto iter = active_contexts_.begin();
-  idle_contexts_.push_back(std::move(iter->second));
-  active_contexts_.erase(iter);
+  idle_contexts_.push_back(ActiveContextAt(0).context);
+  active_begin_ = (active_begin_ + 1) & (active_contexts_.size() - 1);
+  --num_active_contexts_;
 }
 
 bool CalculatorContextManager::HasActiveContexts() {
@@ -105,7 +159,7 @@ bool CalculatorContextManager::HasActiveContexts() {
     return false;
   }
   absl::MutexLock lock(&contexts_mutex_);
-  return !active_contexts_.empty();
+  return num_active_contexts_ > 0;
 }
 
 }  // namespace mediapipe
@@ -15,10 +15,9 @@
 #ifndef MEDIAPIPE_FRAMEWORK_CALCULATOR_CONTEXT_MANAGER_H_
 #define MEDIAPIPE_FRAMEWORK_CALCULATOR_CONTEXT_MANAGER_H_
 
-#include <deque>
 #include <functional>
-#include <map>
 #include <memory>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/log/absl_check.h"
@@ -38,14 +37,17 @@ class CalculatorContextManager {
  public:
   CalculatorContextManager() {}
 
+  // For parallel execution, "max_in_flight" is the expected number of
+  // concurrently active calculator contexts; it is used to preallocate them.
   void Initialize(CalculatorState* calculator_state,
                   std::shared_ptr<tool::TagMap> input_tag_map,
                   std::shared_ptr<tool::TagMap> output_tag_map,
-                  bool calculator_run_in_parallel);
+                  bool calculator_run_in_parallel, int max_in_flight = 1);
 
   // Sets the callback that can setup the input and output stream shards in a
   // newly constructed calculator context. Then, initializes the default
-  // calculator context.
+  // calculator context and, for parallel execution, max_in_flight idle
+  // calculator contexts.
   absl::Status PrepareForRun(
       std::function<absl::Status(CalculatorContext*)> setup_shards_callback);
 
@@ -78,7 +80,7 @@ class CalculatorContextManager {
       ABSL_LOCKS_EXCLUDED(contexts_mutex_);
 
   // Removes the context with the smallest input timestamp from active_contexts_
-  // and moves the calculator context to idle_contexts_. The caller must
+  // and returns the calculator context to idle_contexts_. The caller must
   // guarantee that the output shards in the calculator context have been
   // propagated before calling this function.
   void RecycleCalculatorContext() ABSL_LOCKS_EXCLUDED(contexts_mutex_);
@@ -114,10 +116,31 @@ class CalculatorContextManager {
   }
 
  private:
+  // An entry of active_contexts_.
+  struct ActiveContext {
+    Timestamp input_timestamp;
+    CalculatorContext* context;
+  };
+
+  // Creates a calculator context with its shards set up, and takes ownership
+  // of it.
+  CalculatorContext* CreateCalculatorContext()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(contexts_mutex_);
+
+  // Returns the i-th active context, in increasing input timestamp order.
+  ActiveContext& ActiveContextAt(int i)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(contexts_mutex_) {
+    return active_contexts_[(active_begin_ + i) & (active_contexts_.size() - 1)];
+  }
+
+  // Doubles the capacity of active_contexts_.
+  void GrowActiveContexts() ABSL_EXCLUSIVE_LOCKS_REQUIRED(contexts_mutex_);
+
   CalculatorState* calculator_state_;
   std::shared_ptr<tool::TagMap> input_tag_map_;
   std::shared_ptr<tool::TagMap> output_tag_map_;
   bool calculator_run_in_parallel_;
+  int max_in_flight_ = 1;
 
   // The callback to setup the input and output stream shards in a newly
   // constructed calculator context.
@@ -133,11 +156,18 @@ class CalculatorContextManager {
   // The mutex for synchronizing the operations on active_contexts_ and
   // idle_contexts_ during parallel execution.
   absl::Mutex contexts_mutex_;
-  // A map from input timestamps to calculator contexts.
-  std::map<Timestamp, std::unique_ptr<CalculatorContext>> active_contexts_
+  // All calculator contexts created for parallel execution. They are
+  // preallocated in PrepareForRun() and reused across invocations, so that
+  // steady state parallel execution doesn't allocate.
+  std::vector<std::unique_ptr<CalculatorContext>> contexts_
       ABSL_GUARDED_BY(contexts_mutex_);
+  // A ring buffer of the active calculator contexts, sorted by input timestamp.
+  // Its capacity is a power of two, at least max_in_flight_.
+  std::vector<ActiveContext> active_contexts_ ABSL_GUARDED_BY(contexts_mutex_);
+  int active_begin_ ABSL_GUARDED_BY(contexts_mutex_) = 0;
+  int num_active_contexts_ ABSL_GUARDED_BY(contexts_mutex_) = 0;
   // Idle calculator contexts that are ready for reuse.
-  std::deque<std::unique_ptr<CalculatorContext>> idle_contexts_
+  std::vector<CalculatorContext*> idle_contexts_
       ABSL_GUARDED_BY(contexts_mutex_);
 };
 
@@ -44,6 +44,7 @@
 #include "mediapipe/framework/delegating_executor.h"
 #include "mediapipe/framework/deps/clock.h"
 #include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/formats/image_multi_pool_service.h"
 #include "mediapipe/framework/graph_output_stream.h"
 #include "mediapipe/framework/graph_service_manager.h"
 #include "mediapipe/framework/input_stream_manager.h"
@@ -446,6 +447,7 @@ absl::Status CalculatorGraph::InitializeDefaultExecutor(
   // If specified, run synchronously on the calling thread.
   if (use_application_thread) {
     use_application_thread_ = true;
+    single_threaded_default_executor_ = true;
     MEDIAPIPE_CHECK_OK(SetExecutorInternal(
         "", std::make_shared<internal::DelegatingExecutor>(
                 std::bind(&internal::Scheduler::AddApplicationThreadTask,
@@ -470,6 +472,7 @@ absl::Status CalculatorGraph::InitializeDefaultExecutor(
   }
   MP_RETURN_IF_ERROR(
       CreateDefaultThreadPool(default_executor_options, num_threads));
+  single_threaded_default_executor_ = num_threads == 1;
   VLOG(1) << absl::StrCat("Using default executor with num_threads: ",
                           num_threads);
   return absl::OkStatus();
@@ -751,6 +754,37 @@ absl::Status CalculatorGraph::PrepareServices() {
       }
     }
   }
+  if (auto image_pool =
+          service_manager_.GetServiceObject(kImageMultiPoolService)) {
+    profiler_->SetImagePoolCountsCallback(
+        [image_pool] { return image_pool->GetInUseAndAvailableCounts(); });
+  }
+  return absl::OkStatus();
+}
+
+absl::Status CalculatorGraph::CheckStaticScheduleSupported() const {
+  if (!single_threaded_default_executor_) {
+    return absl::FailedPreconditionError(
+        "the default executor is not single-threaded.");
+  }
+  // Node ids follow the topological order established by ValidatedGraphConfig,
+  // which is the order of the static schedule.
+  for (const auto& node : nodes_) {
+    if (!node->Executor().empty()) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          node->DebugName(), " runs on executor \"", node->Executor(), "\"."));
+    }
+    if (node->input_stream_handler_type() != "DefaultInputStreamHandler") {
+      return absl::FailedPreconditionError(
+          absl::StrCat(node->DebugName(), " uses ",
+                       node->input_stream_handler_type(), "."));
+    }
+    if (node->max_in_flight() > 1) {
+      return absl::FailedPreconditionError(
+          absl::StrCat(node->DebugName(), " has max_in_flight ",
+                       node->max_in_flight(), "."));
+    }
+  }
   return absl::OkStatus();
 }
 
@@ -831,6 +865,19 @@ absl::Status CalculatorGraph::PrepareForRun(
   scheduler_.Reset();
 
   MP_RETURN_IF_ERROR(InitializePacketGeneratorNodes(non_scheduled_generators));
+  if (validated_graph_->Config().use_node_bucket_scheduler_queue()) {
+    scheduler_.EnableNodeBuckets(nodes_.size());
+  }
+  if (validated_graph_->Config().use_static_schedule()) {
+    const absl::Status supported = CheckStaticScheduleSupported();
+    if (supported.ok()) {
+      scheduler_.EnableStaticSchedule(nodes_.size());
+      VLOG(1) << "Using static schedule.";
+    } else {
+      ABSL_LOG_FIRST_N(WARNING, 1)
+          << "Ignoring use_static_schedule: " << supported.message();
+    }
+  }
 
   {
     absl::MutexLock lock(&full_input_streams_mutex_);
@@ -1004,13 +1051,8 @@ absl::Status CalculatorGraph::SetInputStreamTimestampBound(
   return absl::OkStatus();
 }
 
-// We avoid having two copies of this code for AddPacketToInputStream(
-// const Packet&) and AddPacketToInputStream(Packet &&) by having this
-// internal-only templated version.  T&& is a forwarding reference here, so
-// std::forward will deduce the correct type as we pass along packet.
-template <typename T>
-absl::Status CalculatorGraph::AddPacketToInputStreamInternal(
-    absl::string_view stream_name, T&& packet) {
+absl::StatusOr<CalculatorGraph::GraphInputStream*>
+CalculatorGraph::WaitForGraphInputStream(absl::string_view stream_name) {
   auto stream_it = graph_input_streams_.find(stream_name);
   std::unique_ptr<GraphInputStream>* stream =
       stream_it == graph_input_streams_.end() ? nullptr : &stream_it->second;
@@ -1060,27 +1102,17 @@ absl::Status CalculatorGraph::AddPacketToInputStreamInternal(
       }
     }
   }
+  return stream->get();
+}
 
-  // Adding profiling info for a new packet entering the graph.
-  const std::string* stream_id = &(*stream)->GetManager()->Name();
-  profiler_->LogEvent(TraceEvent(TraceEvent::PROCESS)
-                          .set_is_finish(true)
-                          .set_input_ts(packet.Timestamp())
-                          .set_stream_id(stream_id)
-                          .set_packet_ts(packet.Timestamp())
-                          .set_packet_data_id(&packet));
-
-  // InputStreamManager is thread safe. GraphInputStream is not, so this method
-  // should not be called by multiple threads concurrently. Note that this could
-  // potentially lead to the max queue size being exceeded by one packet at most
-  // because we don't have the lock over the input stream.
-  (*stream)->AddPacket(std::forward<T>(packet));
+absl::Status CalculatorGraph::FinishAddingToGraphInputStream(
+    absl::string_view stream_name, GraphInputStream* stream) {
   if (has_error_) {
     absl::Status error_status;
     GetCombinedErrors("Graph has errors: ", &error_status);
     return error_status;
   }
-  (*stream)->PropagateUpdatesToMirrors();
+  stream->PropagateUpdatesToMirrors();
 
   VLOG(2) << "Packet added directly to: " << stream_name;
   // Note: one reason why we need to call the scheduler here is that we have
@@ -1091,6 +1123,58 @@ absl::Status CalculatorGraph::AddPacketToInputStreamInternal(
   return absl::OkStatus();
 }
 
+// We avoid having two copies of this code for AddPacketToInputStream(
+// const Packet&) and AddPacketToInputStream(Packet &&) by having this
+// internal-only templated version.  T&& is a forwarding reference here, so
+// std::forward will deduce the correct type as we pass along packet.
+template <typename T>
+absl::Status CalculatorGraph::AddPacketToInputStreamInternal(
+    absl::string_view stream_name, T&& packet) {
+  MP_ASSIGN_OR_RETURN(GraphInputStream * stream,
+                      WaitForGraphInputStream(stream_name));
+
+  // Adding profiling info for a new packet entering the graph.
+  const std::string* stream_id = &stream->GetManager()->Name();
+  profiler_->LogEvent(TraceEvent(TraceEvent::PROCESS)
+                          .set_is_finish(true)
+                          .set_input_ts(packet.Timestamp())
+                          .set_stream_id(stream_id)
+                          .set_packet_ts(packet.Timestamp())
+                          .set_packet_data_id(&packet));
+
+  // InputStreamManager is thread safe. GraphInputStream is not, so this method
+  // should not be called by multiple threads concurrently. Note that this could
+  // potentially lead to the max queue size being exceeded by one packet at most
+  // because we don't have the lock over the input stream.
+  stream->AddPacket(std::forward<T>(packet));
+  return FinishAddingToGraphInputStream(stream_name, stream);
+}
+
+absl::Status CalculatorGraph::AddPacketsToInputStream(
+    absl::string_view stream_name, std::vector<Packet> packets) {
+  if (packets.empty()) {
+    return absl::OkStatus();
+  }
+  MP_ASSIGN_OR_RETURN(GraphInputStream * stream,
+                      WaitForGraphInputStream(stream_name));
+
+  const std::string* stream_id = &stream->GetManager()->Name();
+  for (Packet& packet : packets) {
+    // Adding profiling info for a new packet entering the graph.
+    profiler_->LogEvent(TraceEvent(TraceEvent::PROCESS)
+                            .set_is_finish(true)
+                            .set_input_ts(packet.Timestamp())
+                            .set_stream_id(stream_id)
+                            .set_packet_ts(packet.Timestamp())
+                            .set_packet_data_id(&packet));
+    // The packets are only queued in the output shard of the graph input
+    // stream here. They reach the consuming input streams together in
+    // FinishAddingToGraphInputStream().
+    stream->AddPacket(std::move(packet));
+  }
+  return FinishAddingToGraphInputStream(stream_name, stream);
+}
+
 absl::Status CalculatorGraph::SetInputStreamMaxQueueSize(
     const std::string& stream_name, int max_queue_size) {
   // graph_input_streams_ has not been filled in yet, so we'll check this when
@@ -289,6 +289,16 @@ class CalculatorGraph {
   absl::Status AddPacketToInputStream(absl::string_view stream_name,
                                       Packet&& packet);
 
+  // Adds a batch of packets to a graph input stream, in order. This is
+  // equivalent to calling AddPacketToInputStream() for each packet, except
+  // that the graph input stream add mode is applied once for the whole batch,
+  // the packets are queued into each consuming input stream under a single
+  // lock, and the scheduler is notified once. The max_queue_size may thus be
+  // exceeded by the size of the batch. This is intended for high rate streams,
+  // such as audio or sensor streams, receiving many small packets.
+  absl::Status AddPacketsToInputStream(absl::string_view stream_name,
+                                       std::vector<Packet> packets);
+
   // Indicates that input will arrive no earlier than a certain timestamp.
   absl::Status SetInputStreamTimestampBound(const std::string& stream_name,
                                             Timestamp timestamp);
@@ -559,6 +569,17 @@ class CalculatorGraph {
   absl::Status AddPacketToInputStreamInternal(absl::string_view stream_name,
                                               T&& packet);
 
+  // Returns the graph input stream "stream_name" once packets may be added to
+  // it according to graph_input_stream_add_mode_. Used by
+  // AddPacketToInputStream() and AddPacketsToInputStream().
+  absl::StatusOr<GraphInputStream*> WaitForGraphInputStream(
+      absl::string_view stream_name);
+
+  // Propagates the packets added to a graph input stream and notifies the
+  // scheduler.
+  absl::Status FinishAddingToGraphInputStream(absl::string_view stream_name,
+                                              GraphInputStream* stream);
+
   // Sets the executor that will run the nodes assigned to the executor
   // named |name|.  If |name| is empty, this sets the default executor.
   // Does not check that the graph is uninitialized and |name| is not a
@@ -604,6 +625,10 @@ class CalculatorGraph {
 
   absl::Status PrepareServices();
 
+  // Returns an error explaining why the static schedule requested by
+  // CalculatorGraphConfig::use_static_schedule cannot be used.
+  absl::Status CheckStaticScheduleSupported() const;
+
 #if !MEDIAPIPE_DISABLE_GPU
   absl::Status MaybeSetUpGpuServiceFromLegacySidePacket(Packet legacy_sp);
   // Helper for PrepareForRun. If it returns a non-empty map, those packets
@@ -745,6 +770,10 @@ class CalculatorGraph {
   // True if the default executor uses the application thread.
   bool use_application_thread_ = false;
 
+  // True if the default executor was created by the graph and runs on a
+  // single thread, either the application thread or a one-thread pool.
+  bool single_threaded_default_executor_ = false;
+
   // Condition variable that waits until all input streams that depend on a
   // graph input stream are below the maximum queue size.
   absl::CondVar wait_to_add_packet_cond_var_
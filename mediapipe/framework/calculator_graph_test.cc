@@ -1520,6 +1520,113 @@ TEST(CalculatorGraph, RunsCorrectlyWithCurrentThreadExecutor) {
   RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
 }
 
+TEST(CalculatorGraph, RunsCorrectlyWithNodeBucketSchedulerQueue) {
+  CalculatorGraph graph;
+  CalculatorGraphConfig proto = GetConfig();
+  proto.set_use_node_bucket_scheduler_queue(true);
+  RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
+}
+
+TEST(CalculatorGraph, RunsCorrectlyWithNodeBucketSchedulerQueueOnAppThread) {
+  CalculatorGraph graph;
+  CalculatorGraphConfig proto = GetConfig();
+  proto.set_use_node_bucket_scheduler_queue(true);
+  // Force application thread to be used.
+  proto.set_num_threads(0);
+  RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
+}
+
+TEST(CalculatorGraph,
+     RunsCorrectlyWithNodeBucketSchedulerQueueAndCurrentThreadExecutor) {
+  CalculatorGraph graph;
+  MP_ASSERT_OK(
+      graph.SetExecutor("", std::make_shared<CurrentThreadExecutor>()));
+  CalculatorGraphConfig proto = GetConfig();
+  proto.set_use_node_bucket_scheduler_queue(true);
+  RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
+}
+
+TEST(CalculatorGraph, RunsCorrectlyWithStaticScheduleOnAppThread) {
+  CalculatorGraph graph;
+  CalculatorGraphConfig proto = GetConfig();
+  proto.set_use_static_schedule(true);
+  proto.add_executor()->set_type("ApplicationThreadExecutor");
+  RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
+}
+
+TEST(CalculatorGraph, RunsCorrectlyWithStaticScheduleOnOneThread) {
+  CalculatorGraph graph;
+  CalculatorGraphConfig proto = GetConfig();
+  proto.set_use_static_schedule(true);
+  proto.set_num_threads(1);
+  RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
+}
+
+TEST(CalculatorGraph, RunsCorrectlyWithStaticScheduleWhenUnsupported) {
+  CalculatorGraph graph;
+  CalculatorGraphConfig proto = GetConfig();
+  proto.set_use_static_schedule(true);
+  proto.set_num_threads(4);
+  RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
+}
+
+// Runs a diamond of pass-through nodes fed by a throttled graph input stream.
+TEST(CalculatorGraph, StaticScheduleProcessesGraphInputStream) {
+  for (const char* executor_type : {"ApplicationThreadExecutor", ""}) {
+    CalculatorGraphConfig config =
+        mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+          input_stream: 'in'
+          use_static_schedule: true
+          max_queue_size: 2
+          node {
+            calculator: 'PassThroughCalculator'
+            input_stream: 'in'
+            output_stream: 'left'
+          }
+          node {
+            calculator: 'PassThroughCalculator'
+            input_stream: 'in'
+            output_stream: 'right'
+          }
+          node {
+            calculator: 'PassThroughCalculator'
+            input_stream: 'left'
+            input_stream: 'right'
+            output_stream: 'out_left'
+            output_stream: 'out_right'
+          }
+        )pb");
+    ExecutorConfig* executor = config.add_executor();
+    executor->set_type(executor_type);
+    executor->mutable_options()
+        ->MutableExtension(ThreadPoolExecutorOptions::ext)
+        ->set_num_threads(1);
+    CalculatorGraph graph;
+    MP_ASSERT_OK(graph.Initialize(config));
+    graph.SetGraphInputStreamAddMode(
+        CalculatorGraph::GraphInputStreamAddMode::WAIT_TILL_NOT_FULL);
+    std::vector<Packet> out_packets;
+    MP_ASSERT_OK(graph.ObserveOutputStream(
+        "out_right", [&out_packets](const Packet& packet) {
+          out_packets.push_back(packet);
+          return absl::OkStatus();
+        }));
+    MP_ASSERT_OK(graph.StartRun({}));
+    constexpr int kNumPackets = 100;
+    for (int i = 0; i < kNumPackets; ++i) {
+      MP_ASSERT_OK(graph.AddPacketToInputStream(
+          "in", MakePacket<int>(i).At(Timestamp(i))));
+    }
+    MP_ASSERT_OK(graph.CloseAllInputStreams());
+    MP_ASSERT_OK(graph.WaitUntilDone());
+    ASSERT_EQ(out_packets.size(), kNumPackets) << executor_type;
+    for (int i = 0; i < kNumPackets; ++i) {
+      EXPECT_EQ(out_packets[i].Timestamp(), Timestamp(i));
+      EXPECT_EQ(out_packets[i].Get<int>(), i);
+    }
+  }
+}
+
 TEST(CalculatorGraph, RunsCorrectlyWithNonDefaultExecutors) {
   CalculatorGraph graph;
   // Add executors "second" and "third".
@@ -4522,6 +4629,84 @@ TEST(CalculatorGraph, GraphInputStreamBeforeStartRun) {
             absl::StatusCode::kFailedPrecondition);
 }
 
+TEST(CalculatorGraph, AddPacketsToInputStream) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input"
+        max_queue_size: 32
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "input"
+          output_stream: "output"
+        }
+      )pb");
+  std::vector<Packet> packet_dump;
+  tool::AddVectorSink("output", &config, &packet_dump);
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int batch = 0; batch < 10; ++batch) {
+    std::vector<Packet> packets;
+    for (int i = 0; i < 16; ++i) {
+      const int value = batch * 16 + i;
+      packets.push_back(MakePacket<int>(value).At(Timestamp(value)));
+    }
+    MP_ASSERT_OK(graph.AddPacketsToInputStream("input", std::move(packets)));
+  }
+  MP_ASSERT_OK(graph.AddPacketsToInputStream("input", {}));
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  ASSERT_EQ(packet_dump.size(), 160);
+  for (int i = 0; i < 160; ++i) {
+    EXPECT_EQ(packet_dump[i].Get<int>(), i);
+    EXPECT_EQ(packet_dump[i].Timestamp(), Timestamp(i));
+  }
+}
+
+TEST(CalculatorGraph, AddPacketsToInputStreamFailsOnDecreasingTimestamps) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "input"
+          output_stream: "output"
+        }
+      )pb");
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  MP_EXPECT_OK(graph.AddPacketsToInputStream(
+      "input", {MakePacket<int>(0).At(Timestamp(1)),
+                MakePacket<int>(1).At(Timestamp(0))}));
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  EXPECT_FALSE(graph.WaitUntilDone().ok());
+}
+
+TEST(CalculatorGraph, AddPacketsToInputStreamBeforeStartRun) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "input"
+          output_stream: "output"
+        }
+      )pb");
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  EXPECT_EQ(graph
+                .AddPacketsToInputStream("input",
+                                         {MakePacket<int>(0).At(Timestamp(0))})
+                .code(),
+            absl::StatusCode::kFailedPrecondition);
+  EXPECT_EQ(graph
+                .AddPacketsToInputStream("missing",
+                                         {MakePacket<int>(0).At(Timestamp(0))})
+                .code(),
+            absl::StatusCode::kInternal);
+}
+
 // Returns the first packet of the input stream.
 class FirstPacketFilterCalculator : public CalculatorBase {
  public:
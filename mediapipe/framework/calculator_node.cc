@@ -193,7 +193,7 @@ absl::Status CalculatorNode::Initialize(
   calculator_context_manager_.Initialize(
       calculator_state_.get(), node_type_info_->InputStreamTypes().TagMap(),
       node_type_info_->OutputStreamTypes().TagMap(),
-      /*calculator_run_in_parallel=*/max_in_flight_ > 1);
+      /*calculator_run_in_parallel=*/max_in_flight_ > 1, max_in_flight_);
 
   // The graph specified InputStreamHandler takes priority.
   const bool graph_specified =
@@ -358,6 +358,7 @@ absl::Status CalculatorNode::InitializeInputStreamHandler(
           /*calculator_run_in_parallel=*/max_in_flight_ > 1),
       _ << "\"" << input_stream_handler_name
         << "\" is not a registered input stream handler.");
+  input_stream_handler_type_ = input_stream_handler_name;
 
   return absl::OkStatus();
 }
@@ -167,6 +167,14 @@ class CalculatorNode {
 
   int source_layer() const { return source_layer_; }
 
+  // The max number of invocations that can be scheduled in parallel.
+  int max_in_flight() const { return max_in_flight_; }
+
+  // The registered name of the node's InputStreamHandler.
+  const std::string& input_stream_handler_type() const {
+    return input_stream_handler_type_;
+  }
+
   // Checks if the node can be scheduled; if so, increases current_in_flight_
   // and returns true; otherwise, returns false.
   // If true is returned, the scheduler must commit to executing the node, and
@@ -376,6 +384,7 @@ class CalculatorNode {
   std::unique_ptr<OutputSidePacketSet> output_side_packets_;
 
   std::unique_ptr<InputStreamHandler> input_stream_handler_;
+  std::string input_stream_handler_type_;
 
   std::unique_ptr<OutputStreamHandler> output_stream_handler_;
 
@@ -0,0 +1,81 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/formats/cpu_buffer_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "mediapipe/framework/counter_factory.h"
+#include "mediapipe/framework/port/aligned_malloc_and_free.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/gpu/multi_pool.h"
+
+namespace mediapipe {
+
+absl::StatusOr<std::unique_ptr<CpuBuffer>> CpuBuffer::Create(
+    const CpuBufferSpec& spec) {
+  void* data;
+  if (spec.alignment > 0) {
+    RET_CHECK_EQ(spec.alignment & (spec.alignment - 1), 0)
+        << "Alignment must be a power of two: " << spec.alignment;
+    // Matches the allocation of Tensor: TfLite custom allocation requires at
+    // least alignment bytes.
+    data = aligned_malloc(
+        std::max(static_cast<size_t>(spec.alignment), spec.size_bytes),
+        spec.alignment);
+  } else {
+    data = malloc(spec.size_bytes);
+  }
+  RET_CHECK(data) << "Failed to allocate CPU buffer of " << spec.size_bytes
+                  << " bytes.";
+  return absl::WrapUnique(new CpuBuffer(spec, data));
+}
+
+CpuBuffer::~CpuBuffer() {
+  if (spec_.alignment > 0) {
+    aligned_free(data_);
+  } else {
+    free(data_);
+  }
+}
+
+absl::StatusOr<std::shared_ptr<CpuBuffer>> CpuBufferPool::GetBuffer(
+    const CpuBufferSpec& spec) {
+  MP_ASSIGN_OR_RETURN(std::shared_ptr<CpuBuffer> buffer, Get(spec));
+  // A buffer is handed out by a pool again only after CpuBuffer::Reuse.
+  if (buffer->reused()) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return buffer;
+}
+
+void CpuBufferPool::ExportCounters(CounterFactory* counter_factory) {
+  const int64_t hits = num_hits();
+  const int64_t misses = num_misses();
+  counter_factory->GetCounter(kHitsCounterName)
+      ->IncrementBy(static_cast<int>(hits - exported_hits_.exchange(hits)));
+  counter_factory->GetCounter(kMissesCounterName)
+      ->IncrementBy(
+          static_cast<int>(misses - exported_misses_.exchange(misses)));
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,152 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_FORMATS_CPU_BUFFER_POOL_H_
+#define MEDIAPIPE_FRAMEWORK_FORMATS_CPU_BUFFER_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "mediapipe/framework/counter_factory.h"
+#include "mediapipe/gpu/multi_pool.h"
+#include "mediapipe/gpu/reusable_pool.h"
+
+namespace mediapipe {
+
+// Size and alignment of a CPU buffer.
+struct CpuBufferSpec {
+  size_t size_bytes = 0;
+  // Alignment of the buffer in bytes, a power of two. 0 requests the default
+  // alignment of malloc.
+  int alignment = 0;
+
+  bool operator==(const CpuBufferSpec& other) const {
+    return size_bytes == other.size_bytes && alignment == other.alignment;
+  }
+  bool operator!=(const CpuBufferSpec& other) const {
+    return !(*this == other);
+  }
+
+  // Hashing required to use CpuBufferSpec as key in buffer pools. See
+  // absl::Hash for details.
+  template <typename H>
+  friend H AbslHashValue(H h, const CpuBufferSpec& spec) {
+    return H::combine(std::move(h), spec.size_bytes, spec.alignment);
+  }
+};
+
+// Uninitialized CPU memory as described by a CpuBufferSpec.
+class CpuBuffer {
+ public:
+  static absl::StatusOr<std::unique_ptr<CpuBuffer>> Create(
+      const CpuBufferSpec& spec);
+  ~CpuBuffer();
+
+  CpuBuffer(const CpuBuffer&) = delete;
+  CpuBuffer& operator=(const CpuBuffer&) = delete;
+
+  void* data() const { return data_; }
+  const CpuBufferSpec& spec() const { return spec_; }
+
+  // Called by the pool when the buffer is handed out again. The contents are
+  // left as they are.
+  void Reuse() { reused_ = true; }
+  // Whether the buffer has been handed out by a pool before.
+  bool reused() const { return reused_; }
+
+ private:
+  CpuBuffer(const CpuBufferSpec& spec, void* data) : spec_(spec), data_(data) {}
+
+  const CpuBufferSpec spec_;
+  void* const data_;
+  bool reused_ = false;
+};
+
+namespace internal {
+
+// Pools CpuBuffers with identical CpuBufferSpec.
+class CpuBufferSpecPool : public ReusablePool<CpuBuffer> {
+ public:
+  // Creates a pool. We enforce creation as a shared_ptr so that we can use a
+  // weak reference in the buffers' deleters.
+  static std::shared_ptr<CpuBufferSpecPool> Create(
+      const CpuBufferSpec& spec, const MultiPoolOptions& options) {
+    return std::shared_ptr<CpuBufferSpecPool>(
+        new CpuBufferSpecPool(spec, options));
+  }
+  static absl::StatusOr<std::unique_ptr<CpuBuffer>> CreateBufferWithoutPool(
+      const CpuBufferSpec& spec) {
+    return CpuBuffer::Create(spec);
+  }
+  const CpuBufferSpec& spec() const { return spec_; }
+
+ protected:
+  CpuBufferSpecPool(const CpuBufferSpec& spec, const MultiPoolOptions& options)
+      : ReusablePool<CpuBuffer>(
+            [this] { return CreateBufferWithoutPool(spec_); }, options),
+        spec_(spec) {}
+
+  const CpuBufferSpec spec_;
+};
+
+}  // namespace internal
+
+// Pools CPU memory, e.g. for the CPU storage of Tensors, so that calculators
+// producing a buffer of the same size for every packet reuse memory instead of
+// allocating it anew.
+//
+// Requests served by a pooled buffer are counted as hits, requests that
+// allocate a new buffer as misses. The pool owns these counts, since Tensors
+// keep the pool alive and may outlive the graph. ExportCounters copies them to
+// the counters of a CounterFactory, e.g. CalculatorGraph::GetCounterFactory().
+class CpuBufferPool
+    : public MultiPool<internal::CpuBufferSpecPool, CpuBufferSpec,
+                       std::shared_ptr<CpuBuffer>> {
+ public:
+  static constexpr char kHitsCounterName[] = "CpuBufferPool hits";
+  static constexpr char kMissesCounterName[] = "CpuBufferPool misses";
+
+  CpuBufferPool() : CpuBufferPool(kDefaultMultiPoolOptions) {}
+  explicit CpuBufferPool(const MultiPoolOptions& options)
+      : MultiPool<internal::CpuBufferSpecPool, CpuBufferSpec,
+                  std::shared_ptr<CpuBuffer>>(options) {}
+
+  absl::StatusOr<std::shared_ptr<CpuBuffer>> GetBuffer(
+      const CpuBufferSpec& spec);
+
+  int64_t num_hits() const { return hits_.load(std::memory_order_relaxed); }
+  int64_t num_misses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+  // Adds the hits and misses counted since the previous call to the counters
+  // kHitsCounterName and kMissesCounterName of "counter_factory". The
+  // CounterFactory is not retained.
+  void ExportCounters(CounterFactory* counter_factory);
+
+ private:
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+  // Values of hits_ and misses_ at the previous ExportCounters call.
+  std::atomic<int64_t> exported_hits_{0};
+  std::atomic<int64_t> exported_misses_{0};
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_FORMATS_CPU_BUFFER_POOL_H_
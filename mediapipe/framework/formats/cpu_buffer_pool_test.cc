@@ -0,0 +1,116 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/formats/cpu_buffer_pool.h"
+
+#include <cstdint>
+
+#include "mediapipe/framework/counter_factory.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/gpu/multi_pool.h"
+
+namespace mediapipe {
+namespace {
+
+MultiPoolOptions GetTestMultiPoolOptions() {
+  MultiPoolOptions options;
+  options.min_requests_before_pool = 0;
+  return options;
+}
+
+TEST(CpuBufferPoolTest, ShouldPoolCpuBuffer) {
+  CpuBufferPool pool(GetTestMultiPoolOptions());
+  const CpuBufferSpec spec{.size_bytes = 123};
+
+  void* data = nullptr;
+  // First request allocates a new CpuBuffer.
+  {
+    MP_ASSERT_OK_AND_ASSIGN(auto buffer, pool.GetBuffer(spec));
+    data = buffer->data();
+    EXPECT_NE(data, nullptr);
+  }
+  // Second request returns the same CpuBuffer.
+  {
+    MP_ASSERT_OK_AND_ASSIGN(auto buffer, pool.GetBuffer(spec));
+    EXPECT_EQ(buffer->data(), data);
+  }
+  EXPECT_EQ(pool.num_misses(), 1);
+  EXPECT_EQ(pool.num_hits(), 1);
+}
+
+TEST(CpuBufferPoolTest, ShouldReturnNewCpuBufferForDifferentSpec) {
+  CpuBufferPool pool(GetTestMultiPoolOptions());
+  MP_ASSERT_OK_AND_ASSIGN(auto buffer1,
+                          pool.GetBuffer({.size_bytes = 123, .alignment = 64}));
+  MP_ASSERT_OK_AND_ASSIGN(auto buffer2,
+                          pool.GetBuffer({.size_bytes = 567, .alignment = 64}));
+  MP_ASSERT_OK_AND_ASSIGN(auto buffer3,
+                          pool.GetBuffer({.size_bytes = 123, .alignment = 0}));
+  EXPECT_NE(buffer1->data(), buffer2->data());
+  EXPECT_NE(buffer1->data(), buffer3->data());
+  EXPECT_EQ(pool.num_misses(), 3);
+  EXPECT_EQ(pool.num_hits(), 0);
+}
+
+TEST(CpuBufferPoolTest, ShouldAlignCpuBuffer) {
+  CpuBufferPool pool(GetTestMultiPoolOptions());
+  for (int alignment : {16, 64, 4096}) {
+    MP_ASSERT_OK_AND_ASSIGN(
+        auto buffer,
+        pool.GetBuffer({.size_bytes = 10, .alignment = alignment}));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer->data()) % alignment, 0);
+  }
+  EXPECT_FALSE(pool.GetBuffer({.size_bytes = 10, .alignment = 48}).ok());
+}
+
+TEST(CpuBufferPoolTest, ShouldNotPoolBeforeMinRequests) {
+  MultiPoolOptions options;
+  options.min_requests_before_pool = 2;
+  CpuBufferPool pool(options);
+  const CpuBufferSpec spec{.size_bytes = 123};
+  for (int i = 0; i < 4; ++i) {
+    MP_ASSERT_OK(pool.GetBuffer(spec));
+  }
+  // The first request is served without a pool, the second one creates the
+  // pool and the remaining ones reuse its buffer.
+  EXPECT_EQ(pool.num_misses(), 2);
+  EXPECT_EQ(pool.num_hits(), 2);
+}
+
+TEST(CpuBufferPoolTest, ShouldExportCountersToCounterFactory) {
+  CpuBufferPool pool(GetTestMultiPoolOptions());
+  const CpuBufferSpec spec{.size_bytes = 123};
+  MP_ASSERT_OK(pool.GetBuffer(spec));
+  MP_ASSERT_OK(pool.GetBuffer(spec));
+  MP_ASSERT_OK(pool.GetBuffer(spec));
+  BasicCounterFactory counter_factory;
+  pool.ExportCounters(&counter_factory);
+  EXPECT_THAT(counter_factory.GetCounterSet()->GetCountersValues(),
+              testing::UnorderedElementsAre(
+                  testing::Pair(CpuBufferPool::kMissesCounterName, 1),
+                  testing::Pair(CpuBufferPool::kHitsCounterName, 2)));
+
+  // A second export only adds the requests made since the first one.
+  MP_ASSERT_OK(pool.GetBuffer(spec));
+  pool.ExportCounters(&counter_factory);
+  EXPECT_THAT(counter_factory.GetCounterSet()->GetCountersValues(),
+              testing::UnorderedElementsAre(
+                  testing::Pair(CpuBufferPool::kMissesCounterName, 1),
+                  testing::Pair(CpuBufferPool::kHitsCounterName, 3)));
+}
+
+}  // namespace
+}  // namespace mediapipe
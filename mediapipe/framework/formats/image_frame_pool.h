@@ -18,6 +18,8 @@
 #ifndef MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_FRAME_POOL_H_
 #define MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_FRAME_POOL_H_
 
+#include <cstdint>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -30,15 +32,15 @@ using ImageFrameSharedPtr = std::shared_ptr<ImageFrame>;
 
 class ImageFramePool : public std::enable_shared_from_this<ImageFramePool> {
  public:
-  // Creates a pool. This pool will manage buffers of the specified dimensions,
-  // and will keep keep_count buffers around for reuse.
+  // Creates a pool. This pool will manage buffers of the specified dimensions
+  // and alignment, and will keep keep_count buffers around for reuse.
   // We enforce creation as a shared_ptr so that we can use a weak reference in
   // the buffers' deleters.
-  static std::shared_ptr<ImageFramePool> Create(int width, int height,
-                                                ImageFormat::Format format,
-                                                int keep_count) {
-    return std::shared_ptr<ImageFramePool>(
-        new ImageFramePool(width, height, format, keep_count));
+  static std::shared_ptr<ImageFramePool> Create(
+      int width, int height, ImageFormat::Format format, int keep_count,
+      uint32_t alignment_boundary = ImageFrame::kGlDefaultAlignmentBoundary) {
+    return std::shared_ptr<ImageFramePool>(new ImageFramePool(
+        width, height, format, keep_count, alignment_boundary));
   }
 
   // Obtains a buffers. May either be reused or created anew.
@@ -47,13 +49,14 @@ class ImageFramePool : public std::enable_shared_from_this<ImageFramePool> {
   int width() const { return width_; }
   int height() const { return height_; }
   ImageFormat::Format format() const { return format_; }
+  uint32_t alignment_boundary() const { return alignment_boundary_; }
 
   // This method is meant for testing.
   std::pair<int, int> GetInUseAndAvailableCounts();
 
  private:
   ImageFramePool(int width, int height, ImageFormat::Format format,
-                 int keep_count);
+                 int keep_count, uint32_t alignment_boundary);
 
   // Return a buffer to the pool.
   void Return(ImageFrame* buf);
@@ -67,6 +70,7 @@ class ImageFramePool : public std::enable_shared_from_this<ImageFramePool> {
   const int height_;
   const ImageFormat::Format format_;
   const int keep_count_;
+  const uint32_t alignment_boundary_;
 
   absl::Mutex mutex_;
   int in_use_count_ ABSL_GUARDED_BY(mutex_) = 0;
@@ -14,7 +14,10 @@
 
 #include "mediapipe/framework/formats/image_multi_pool.h"
 
+#include <cstdint>
+#include <memory>
 #include <tuple>
+#include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/memory/memory.h"
@@ -116,12 +119,7 @@ Image ImageMultiPool::GetBufferFromSimplePool(
 ImageMultiPool::SimplePoolCpu ImageMultiPool::MakeSimplePoolCpu(
     IBufferSpec spec) {
   return ImageFramePool::Create(spec.width, spec.height, spec.format,
-                                kKeepCount);
-}
-
-Image ImageMultiPool::GetBufferFromSimplePool(
-    IBufferSpec spec, const ImageMultiPool::SimplePoolCpu& pool) {
-  return Image(pool->GetBuffer());
+                                kKeepCount, spec.alignment_boundary);
 }
 
 Image ImageMultiPool::GetBuffer(int width, int height, bool use_gpu,
@@ -158,34 +156,63 @@ Image ImageMultiPool::GetBuffer(int width, int height, bool use_gpu,
   } else  // NOLINT(readability/braces)
 #endif    // !MEDIAPIPE_DISABLE_GPU
   {
-    absl::MutexLock lock(&mutex_cpu_);
-    IBufferSpec key(width, height, format);
-    auto pool_it = pools_cpu_.find(key);
-    if (pool_it == pools_cpu_.end()) {
-      // Discard the least recently used pool in LRU cache.
-      if (pools_cpu_.size() >= kMaxPoolCount) {
-        auto old_spec = buffer_specs_cpu_.front();  // Front has LRU.
-        buffer_specs_cpu_.pop_front();
-        pools_cpu_.erase(old_spec);
-      }
-      buffer_specs_cpu_.push_back(key);  // Push new spec to back.
-      std::tie(pool_it, std::ignore) = pools_cpu_.emplace(
-          std::piecewise_construct, std::forward_as_tuple(key),
-          std::forward_as_tuple(MakeSimplePoolCpu(key)));
-    } else {
-      // Find and move current 'key' spec to back, keeping others in same order.
-      auto specs_it = buffer_specs_cpu_.begin();
-      while (specs_it != buffer_specs_cpu_.end()) {
-        if (*specs_it == key) {
-          buffer_specs_cpu_.erase(specs_it);
-          break;
-        }
-        ++specs_it;
+    return Image(GetImageFrameSharedPtr(IBufferSpec(width, height, format)));
+  }
+}
+
+ImageFrameSharedPtr ImageMultiPool::GetImageFrameSharedPtr(IBufferSpec key) {
+  absl::MutexLock lock(&mutex_cpu_);
+  auto pool_it = pools_cpu_.find(key);
+  if (pool_it == pools_cpu_.end()) {
+    // Discard the least recently used pool in LRU cache.
+    if (pools_cpu_.size() >= kMaxPoolCount) {
+      auto old_spec = buffer_specs_cpu_.front();  // Front has LRU.
+      buffer_specs_cpu_.pop_front();
+      pools_cpu_.erase(old_spec);
+    }
+    buffer_specs_cpu_.push_back(key);  // Push new spec to back.
+    std::tie(pool_it, std::ignore) = pools_cpu_.emplace(
+        std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(MakeSimplePoolCpu(key)));
+  } else {
+    // Find and move current 'key' spec to back, keeping others in same order.
+    auto specs_it = buffer_specs_cpu_.begin();
+    while (specs_it != buffer_specs_cpu_.end()) {
+      if (*specs_it == key) {
+        buffer_specs_cpu_.erase(specs_it);
+        break;
       }
-      buffer_specs_cpu_.push_back(key);
+      ++specs_it;
     }
-    return GetBufferFromSimplePool(pool_it->first, pool_it->second);
+    buffer_specs_cpu_.push_back(key);
+  }
+  return pool_it->second->GetBuffer();
+}
+
+std::unique_ptr<ImageFrame> ImageMultiPool::GetImageFrame(
+    int width, int height, ImageFormat::Format format,
+    uint32_t alignment_boundary) {
+  ImageFrameSharedPtr buffer = GetImageFrameSharedPtr(
+      IBufferSpec(width, height, format, alignment_boundary));
+  if (!buffer) return nullptr;
+  uint8_t* pixel_data = buffer->MutablePixelData();
+  const int width_step = buffer->WidthStep();
+  // The deleter keeps the pooled frame, which owns the pixel data, alive
+  // until the returned frame releases it.
+  return std::make_unique<ImageFrame>(
+      format, width, height, width_step, pixel_data,
+      [buffer = std::move(buffer)](uint8_t*) mutable { buffer = nullptr; });
+}
+
+std::pair<int, int> ImageMultiPool::GetInUseAndAvailableCounts() {
+  absl::MutexLock lock(&mutex_cpu_);
+  std::pair<int, int> counts = {0, 0};
+  for (auto& [spec, pool] : pools_cpu_) {
+    const auto [in_use, available] = pool->GetInUseAndAvailableCounts();
+    counts.first += in_use;
+    counts.second += available;
   }
+  return counts;
 }
 
 ImageMultiPool::~ImageMultiPool() {
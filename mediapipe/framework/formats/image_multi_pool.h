@@ -22,12 +22,17 @@
 #ifndef MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_MULTI_POOL_H_
 #define MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_MULTI_POOL_H_
 
+#include <cstdint>
 #include <deque>
 #include <limits>
+#include <memory>
 #include <unordered_map>
+#include <utility>
 
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_pool.h"
 
 #if !MEDIAPIPE_DISABLE_GPU
@@ -57,6 +62,17 @@ class ImageMultiPool {
   Image GetBuffer(int width, int height, bool use_gpu,
                   ImageFormat::Format format /*= ImageFormat::SRGBA*/);
 
+  // Obtains a CPU ImageFrame. May either be reused or created anew. The pixel
+  // data goes back to the pool when the returned frame is destroyed, so the
+  // frame can be sent in a packet like a newly allocated one.
+  std::unique_ptr<ImageFrame> GetImageFrame(
+      int width, int height, ImageFormat::Format format,
+      uint32_t alignment_boundary = ImageFrame::kGlDefaultAlignmentBoundary);
+
+  // Returns the number of CPU buffers that are in use and available for reuse,
+  // summed over the pools of all sizes and formats.
+  std::pair<int, int> GetInUseAndAvailableCounts();
+
 #if !MEDIAPIPE_DISABLE_GPU
 #ifdef __APPLE__
   // TODO: add tests for the texture cache registration.
@@ -76,14 +92,16 @@ class ImageMultiPool {
   }
 
   struct IBufferSpec {
-    IBufferSpec(int w, int h, mediapipe::ImageFormat::Format f)
-        : width(w), height(h), format(f) {}
+    IBufferSpec(
+        int w, int h, mediapipe::ImageFormat::Format f,
+        uint32_t a = mediapipe::ImageFrame::kGlDefaultAlignmentBoundary)
+        : width(w), height(h), format(f), alignment_boundary(a) {}
     int width;
     int height;
     mediapipe::ImageFormat::Format format;
-    // Note: alignment should be added here if ImageFrameBufferPool is changed
-    // to allow for customizable alignment sizes (currently fixed at 4 for best
-    // compatability with OpenGL).
+    // Only used by the CPU pools. Defaults to 4 for best compatability with
+    // OpenGL.
+    uint32_t alignment_boundary;
   };
 
   struct IBufferSpecHash {
@@ -93,10 +111,8 @@ class ImageMultiPool {
       constexpr int kWidth = std::numeric_limits<size_t>::digits;
       return std::hash<std::size_t>{}(
           spec.width ^ RotateLeftN(spec.height, kWidth / 2) ^
-          RotateLeftN(static_cast<uint32_t>(spec.format), kWidth / 4));
-      // Note: alignment should be added here if ImageFrameBufferPool is changed
-      // to allow for customizable alignment sizes (currently fixed at 4 for
-      // best compatability with OpenGL).
+          RotateLeftN(static_cast<uint32_t>(spec.format), kWidth / 4) ^
+          RotateLeftN(spec.alignment_boundary, kWidth * 3 / 4));
     }
   };
 
@@ -120,7 +136,7 @@ class ImageMultiPool {
 
   typedef std::shared_ptr<ImageFramePool> SimplePoolCpu;
   SimplePoolCpu MakeSimplePoolCpu(IBufferSpec spec);
-  Image GetBufferFromSimplePool(IBufferSpec spec, const SimplePoolCpu& pool);
+  ImageFrameSharedPtr GetImageFrameSharedPtr(IBufferSpec spec);
 
   absl::Mutex mutex_cpu_;
   std::unordered_map<IBufferSpec, SimplePoolCpu, IBufferSpecHash> pools_cpu_
@@ -142,7 +158,8 @@ class ImageMultiPool {
 inline bool operator==(const ImageMultiPool::IBufferSpec& lhs,
                        const ImageMultiPool::IBufferSpec& rhs) {
   return lhs.width == rhs.width && lhs.height == rhs.height &&
-         lhs.format == rhs.format;
+         lhs.format == rhs.format &&
+         lhs.alignment_boundary == rhs.alignment_boundary;
 }
 inline bool operator!=(const ImageMultiPool::IBufferSpec& lhs,
                        const ImageMultiPool::IBufferSpec& rhs) {
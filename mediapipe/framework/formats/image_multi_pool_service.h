@@ -0,0 +1,63 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_MULTI_POOL_SERVICE_H_
+#define MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_MULTI_POOL_SERVICE_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_multi_pool.h"
+#include "mediapipe/framework/graph_service.h"
+
+namespace mediapipe {
+
+// Graph service providing a per-graph pool of CPU image buffers, analogous to
+// the GPU buffer pool of GpuResources. The graph creates the pool on demand,
+// so calculators can request the service as optional:
+//
+//   static absl::Status GetContract(CalculatorContract* cc) {
+//     cc->UseService(kImageMultiPoolService).Optional();
+//     ...
+//   }
+//
+//   absl::Status Open(CalculatorContext* cc) {
+//     auto pool_service = cc->Service(kImageMultiPoolService);
+//     if (pool_service.IsAvailable()) {
+//       image_pool_ = &pool_service.GetObject();
+//     }
+//     ...
+//   }
+//
+// and allocate their outputs with NewImageFrame(image_pool_, ...).
+inline constexpr GraphService<ImageMultiPool> kImageMultiPoolService(
+    "ImageMultiPoolService", GraphServiceBase::kAllowDefaultInitialization);
+
+// Returns an ImageFrame from "pool", or a newly allocated one if "pool" is
+// null. Both have the same layout.
+inline std::unique_ptr<ImageFrame> NewImageFrame(
+    ImageMultiPool* pool, ImageFormat::Format format, int width, int height,
+    uint32_t alignment_boundary = ImageFrame::kDefaultAlignmentBoundary) {
+  if (pool != nullptr) {
+    return pool->GetImageFrame(width, height, format, alignment_boundary);
+  }
+  return std::make_unique<ImageFrame>(format, width, height,
+                                      alignment_boundary);
+}
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_MULTI_POOL_SERVICE_H_
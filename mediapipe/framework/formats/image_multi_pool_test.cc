@@ -0,0 +1,91 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/formats/image_multi_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_multi_pool_service.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+
+namespace mediapipe {
+namespace {
+
+using Pair = std::pair<int, int>;
+
+constexpr int kWidth = 30;
+constexpr int kHeight = 20;
+constexpr ImageFormat::Format kFormat = ImageFormat::SRGB;
+
+TEST(ImageMultiPoolTest, GetImageFrameReusesPixelData) {
+  ImageMultiPool pool;
+  std::unique_ptr<ImageFrame> frame =
+      pool.GetImageFrame(kWidth, kHeight, kFormat);
+  ASSERT_NE(frame, nullptr);
+  EXPECT_EQ(frame->Width(), kWidth);
+  EXPECT_EQ(frame->Height(), kHeight);
+  EXPECT_EQ(frame->Format(), kFormat);
+  EXPECT_EQ(Pair(1, 0), pool.GetInUseAndAvailableCounts());
+
+  const uint8_t* pixel_data = frame->PixelData();
+  frame = nullptr;
+  EXPECT_EQ(Pair(0, 1), pool.GetInUseAndAvailableCounts());
+
+  frame = pool.GetImageFrame(kWidth, kHeight, kFormat);
+  EXPECT_EQ(frame->PixelData(), pixel_data);
+  EXPECT_EQ(Pair(1, 0), pool.GetInUseAndAvailableCounts());
+}
+
+TEST(ImageMultiPoolTest, ReleasedPixelDataReturnsToPool) {
+  ImageMultiPool pool;
+  std::unique_ptr<ImageFrame> frame =
+      pool.GetImageFrame(kWidth, kHeight, kFormat);
+  auto pixel_data = frame->Release();
+  frame = nullptr;
+  EXPECT_EQ(Pair(1, 0), pool.GetInUseAndAvailableCounts());
+  pixel_data = nullptr;
+  EXPECT_EQ(Pair(0, 1), pool.GetInUseAndAvailableCounts());
+}
+
+TEST(ImageMultiPoolTest, PoolsBySizeFormatAndAlignment) {
+  ImageMultiPool pool;
+  auto frame1 = pool.GetImageFrame(kWidth, kHeight, kFormat);
+  auto frame2 = pool.GetImageFrame(kWidth + 1, kHeight, kFormat);
+  auto frame3 = pool.GetImageFrame(kWidth, kHeight, ImageFormat::GRAY8);
+  auto frame4 = pool.GetImageFrame(kWidth, kHeight, kFormat,
+                                   /*alignment_boundary=*/16);
+  EXPECT_EQ(Pair(4, 0), pool.GetInUseAndAvailableCounts());
+  EXPECT_EQ(frame1->WidthStep(), 92);
+  EXPECT_EQ(frame4->WidthStep(), 96);
+  EXPECT_TRUE(frame4->IsAligned(16));
+}
+
+TEST(ImageMultiPoolTest, NewImageFrameMatchesUnpooledLayout) {
+  ImageMultiPool pool;
+  std::unique_ptr<ImageFrame> pooled =
+      NewImageFrame(&pool, kFormat, kWidth, kHeight);
+  std::unique_ptr<ImageFrame> unpooled =
+      NewImageFrame(nullptr, kFormat, kWidth, kHeight);
+  EXPECT_EQ(pooled->WidthStep(), unpooled->WidthStep());
+  EXPECT_TRUE(pooled->IsAligned(ImageFrame::kDefaultAlignmentBoundary));
+  EXPECT_EQ(Pair(1, 0), pool.GetInUseAndAvailableCounts());
+}
+
+}  // namespace
+}  // namespace mediapipe
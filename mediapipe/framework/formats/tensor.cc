@@ -448,6 +448,8 @@ void Tensor::Move(Tensor* src) {
   element_type_ = src->element_type();
   src->element_type_ = ElementType::kNone;  // Mark as invalidated.
   cpu_buffer_ = std::exchange(src->cpu_buffer_, nullptr);
+  cpu_buffer_pool_ = std::move(src->cpu_buffer_pool_);
+  pooled_cpu_buffer_ = std::move(src->pooled_cpu_buffer_);
   ahwb_tracking_key_ = src->ahwb_tracking_key_;
   mtl_resources_ = std::move(src->mtl_resources_);
   MoveAhwbStuff(src);
@@ -479,6 +481,9 @@ Tensor::Tensor(ElementType element_type, const Shape& shape,
       shape_(shape),
       memory_alignment_(memory_alignment),
       mtl_resources_(std::make_unique<MtlResources>()) {
+  if (memory_manager) {
+    cpu_buffer_pool_ = memory_manager->GetCpuBufferPool();
+  }
 #ifdef MEDIAPIPE_TENSOR_USE_AHWB
   if (memory_manager) {
     hardware_buffer_pool_ = memory_manager->GetAndroidHardwareBufferPool();
@@ -493,6 +498,9 @@ Tensor::Tensor(ElementType element_type, const Shape& shape,
       quantization_parameters_(quantization_parameters),
       memory_alignment_(memory_alignment),
       mtl_resources_(std::make_unique<MtlResources>()) {
+  if (memory_manager) {
+    cpu_buffer_pool_ = memory_manager->GetCpuBufferPool();
+  }
 #ifdef MEDIAPIPE_TENSOR_USE_AHWB
   if (memory_manager) {
     hardware_buffer_pool_ = memory_manager->GetAndroidHardwareBufferPool();
@@ -767,7 +775,13 @@ absl::Status Tensor::AllocateCpuBuffer() const {
     // memory page which should match common alignment requirements.
     cpu_buffer_ = AllocateVirtualMemory(bytes());
 #else
-    if (memory_alignment_ > 0) {
+    if (cpu_buffer_pool_) {
+      MP_ASSIGN_OR_RETURN(
+          pooled_cpu_buffer_,
+          cpu_buffer_pool_->GetBuffer({.size_bytes = bytes(),
+                                       .alignment = memory_alignment_}));
+      cpu_buffer_ = pooled_cpu_buffer_->data();
+    } else if (memory_alignment_ > 0) {
       // TODO b/339271330 - Investigate how aligned memory performs in
       // MP WebAssembly targets.
       // TfLite custom allocation requires at least memory_alignment_ bytes.
@@ -789,7 +803,10 @@ void Tensor::FreeCpuBuffer() const {
 #if MEDIAPIPE_METAL_ENABLED
   free(cpu_buffer_);
 #else
-  if (memory_alignment_ > 0) {
+  if (pooled_cpu_buffer_) {
+    // Returns the buffer to the pool.
+    pooled_cpu_buffer_.reset();
+  } else if (memory_alignment_ > 0) {
     aligned_free(cpu_buffer_);
   } else {
     free(cpu_buffer_);
@@ -29,6 +29,7 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/formats/cpu_buffer_pool.h"
 #include "mediapipe/framework/formats/tensor/internal.h"
 #include "mediapipe/framework/memory_manager.h"
 // Exports MEDIAPIPE_TENSOR_USE_AHWB macro.
@@ -513,6 +514,10 @@ class Tensor {
   mutable absl::Mutex view_mutex_;
 
   mutable void* cpu_buffer_ = nullptr;
+  // Provides cpu_buffer_ if the tensor is constructed with a MemoryManager.
+  // Holding the shared_ptr to the pool ensures it outlives the pooled buffer.
+  std::shared_ptr<CpuBufferPool> cpu_buffer_pool_;
+  mutable std::shared_ptr<CpuBuffer> pooled_cpu_buffer_;
   absl::Status AllocateCpuBuffer() const;
   void FreeCpuBuffer() const;
   // Forward declaration of the MtlResources provides compile-time verification
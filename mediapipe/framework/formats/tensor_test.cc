@@ -5,9 +5,11 @@
 #include <utility>
 #include <vector>
 
+#include "mediapipe/framework/memory_manager.h"
 #include "mediapipe/framework/port.h"  // IWYU pragma: keep
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/gpu/multi_pool.h"
 #if !MEDIAPIPE_DISABLE_GPU
 #include "mediapipe/gpu/gl_calculator_helper.h"
 #include "mediapipe/gpu/gl_context.h"  // IWYU pragma: keep
@@ -71,6 +73,30 @@ TEST(Cpu, TestAlignedMemoryAllocation) {
   }
 }
 
+// With Metal the CPU storage is allocated as virtual memory and not pooled.
+#if !MEDIAPIPE_METAL_ENABLED
+TEST(Cpu, TestPooledMemoryAllocation) {
+  MultiPoolOptions options;
+  options.min_requests_before_pool = 0;
+  MemoryManager memory_manager(options);
+  void* data_ptr = nullptr;
+  {
+    Tensor t1(Tensor::ElementType::kFloat32, Tensor::Shape{4, 3, 2, 3},
+              &memory_manager, /*memory_alignment=*/64);
+    data_ptr = t1.GetCpuWriteView().buffer<void>();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data_ptr) % 64, 0);
+  }
+  Tensor t2(Tensor::ElementType::kFloat32, Tensor::Shape{4, 3, 2, 3},
+            &memory_manager, /*memory_alignment=*/64);
+  EXPECT_EQ(t2.GetCpuWriteView().buffer<void>(), data_ptr);
+  // The buffer moves with the tensor and is returned to the pool only once.
+  Tensor t3(std::move(t2));
+  EXPECT_EQ(t3.GetCpuReadView().buffer<void>(), data_ptr);
+  EXPECT_EQ(memory_manager.GetCpuBufferPool()->num_misses(), 1);
+  EXPECT_EQ(memory_manager.GetCpuBufferPool()->num_hits(), 1);
+}
+#endif  // !MEDIAPIPE_METAL_ENABLED
+
 TEST(Cpu, TestTensorMove) {
   Tensor t1(Tensor::ElementType::kFloat32, Tensor::Shape{4, 3, 2, 3},
             Tensor::QuantizationParameters(0.5, 127));
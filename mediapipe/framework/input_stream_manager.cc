@@ -14,6 +14,7 @@
 
 #include "mediapipe/framework/input_stream_manager.h"
 
+#include <algorithm>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -177,9 +178,9 @@ absl::Status InputStreamManager::AddOrMovePacketsInternal(Container container,
               << " has added packet at time: " << packet.Timestamp();
       if (std::is_const<
               typename std::remove_reference<Container>::type>::value) {
-        queue_.emplace_back(packet);
+        queue_.push_back(packet);
       } else {
-        queue_.emplace_back(std::move(packet));
+        queue_.push_back(std::move(packet));
       }
     }
     queue_became_full = (!was_queue_full && max_queue_size_ != -1 &&
@@ -374,6 +375,9 @@ void InputStreamManager::SetMaxQueueSize(int max_queue_size) {
     absl::MutexLock lock(&stream_mutex_);
     was_full = (max_queue_size_ != -1 && queue_.size() >= max_queue_size_);
     max_queue_size_ = max_queue_size;
+    if (max_queue_size_ > 0) {
+      queue_.reserve(std::min(max_queue_size_, kMaxPreallocatedQueueSize));
+    }
     is_full = (max_queue_size_ != -1 && queue_.size() >= max_queue_size_);
   }
 
@@ -397,7 +401,8 @@ Timestamp InputStreamManager::GetMinTimestampAmongNLatest(int n) const {
   if (queue_.empty()) {
     return Timestamp::Unset();
   }
-  return (queue_.cend() - std::min((size_t)n, queue_.size()))->Timestamp();
+  return queue_[queue_.size() - std::min((size_t)n, queue_.size())]
+      .Timestamp();
 }
 
 void InputStreamManager::ErasePacketsEarlierThan(Timestamp timestamp) {
@@ -16,7 +16,6 @@
 #define MEDIAPIPE_FRAMEWORK_INPUT_STREAM_MANAGER_H_
 
 #include <cstdint>
-#include <deque>
 #include <functional>
 #include <list>
 #include <string>
@@ -25,6 +24,7 @@
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/packet_ring_buffer.h"
 #include "mediapipe/framework/packet_type.h"
 #include "mediapipe/framework/timestamp.h"
 
@@ -158,7 +158,8 @@ class InputStreamManager {
 
   // Sets the maximum queue size for the stream. Used to determine when the
   // callbacks for becomes_full and becomes_not_full should be invoked. A value
-  // of -1 means that there is no maximum queue size.
+  // of -1 means that there is no maximum queue size. The queue storage is
+  // preallocated for up to kMaxPreallocatedQueueSize packets.
   void SetMaxQueueSize(int max_queue_size) ABSL_LOCKS_EXCLUDED(stream_mutex_);
 
   // If there are equal to or more than n packets in the queue, this function
@@ -197,8 +198,14 @@ class InputStreamManager {
   // Returns the smallest timestamp at which this stream might see an input.
   Timestamp MinTimestampOrBoundHelper() const;
 
+  // The maximum number of packets for which SetMaxQueueSize() preallocates
+  // queue storage. A larger queue grows on demand.
+  static constexpr int kMaxPreallocatedQueueSize = 1024;
+
   mutable absl::Mutex stream_mutex_;
-  std::deque<Packet> queue_ ABSL_GUARDED_BY(stream_mutex_);
+  // The queued packets. Since max_queue_size_ is a soft limit, the queue may
+  // grow beyond it.
+  PacketRingBuffer queue_ ABSL_GUARDED_BY(stream_mutex_);
   // The number of packets added to queue_.  Used to verify a packet at
   // Timestamp::PostStream() is the only Packet in the stream.
   int64_t num_packets_added_ ABSL_GUARDED_BY(stream_mutex_);
@@ -15,8 +15,9 @@
 #ifndef MEDIAPIPE_FRAMEWORK_INPUT_STREAM_SHARD_H_
 #define MEDIAPIPE_FRAMEWORK_INPUT_STREAM_SHARD_H_
 
-#include <queue>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "mediapipe/framework/input_stream.h"
 #include "mediapipe/framework/packet.h"
@@ -43,11 +44,13 @@ class InputStreamShard : public InputStream {
   // Returns the first packet in the queue if there is any, otherwise returns an
   // empty packet.
   const Packet& Value() const override {
-    return !packet_queue_.empty() ? packet_queue_.front() : empty_packet_;
+    return front_ < packet_queue_.size() ? packet_queue_[front_]
+                                         : empty_packet_;
   }
 
   Packet& Value() override {
-    return !packet_queue_.empty() ? packet_queue_.front() : empty_packet_;
+    return front_ < packet_queue_.size() ? packet_queue_[front_]
+                                         : empty_packet_;
   }
 
   // Returns a reference to the name string of the InputStreamManager.
@@ -58,11 +61,19 @@ class InputStreamShard : public InputStream {
  private:
   void SetName(const std::string* name) { name_ = name; }
 
-  int NumberOfPackets() const { return static_cast<int>(packet_queue_.size()); }
+  int NumberOfPackets() const {
+    return static_cast<int>(packet_queue_.size() - front_);
+  }
 
   void ClearCurrentPacket() {
-    if (!packet_queue_.empty()) {
-      packet_queue_.pop();
+    if (front_ < packet_queue_.size()) {
+      packet_queue_[front_++] = Packet();
+      if (front_ == packet_queue_.size()) {
+        // Keeps the capacity, so that the storage is reused by the next
+        // invocation.
+        packet_queue_.clear();
+        front_ = 0;
+      }
     }
   }
 
@@ -70,8 +81,10 @@ class InputStreamShard : public InputStream {
 
   void AddPacket(Packet&& value, bool is_done);
 
-  // Packet storage for batch processing.
-  std::queue<Packet> packet_queue_;
+  // Packet storage for batch processing. Packets are consumed from index
+  // front_, and the vector is cleared once all of them have been consumed.
+  std::vector<Packet> packet_queue_;
+  size_t front_ = 0;
   Packet empty_packet_;
 
   // Pointer to the name string of the InputStreamManager.
@@ -16,12 +16,13 @@
 
 #include <memory>
 
+#include "mediapipe/framework/formats/cpu_buffer_pool.h"
 // Defines MEDIAPIPE_TENSOR_USE_AHWB
 #include "mediapipe/framework/port.h"
+#include "mediapipe/gpu/multi_pool.h"
 
 #ifdef MEDIAPIPE_TENSOR_USE_AHWB
 #include "mediapipe/framework/formats/hardware_buffer_pool.h"
-#include "mediapipe/gpu/multi_pool.h"
 #endif
 
 namespace mediapipe {
@@ -52,9 +53,14 @@ namespace mediapipe {
 // 3) Pass Calculator::memory_manager_ to the Tensor class constructor:
 //       Tensor tensor(Tensor::ElementType::kFloat32,
 //                     Tensor::Shape{kTensorSize}, &memory_manager_);
+//
+// The CPU storage of such Tensors comes from the CpuBufferPool. Its hit and
+// miss counts can be copied to the graph's counters with
+//    memory_manager->GetCpuBufferPool()->ExportCounters(
+//        graph.GetCounterFactory());
 class MemoryManager {
  public:
-  MemoryManager() {
+  MemoryManager() : cpu_buffer_pool_(std::make_shared<CpuBufferPool>()) {
 #ifdef MEDIAPIPE_TENSOR_USE_AHWB
     hardware_buffer_pool_ = std::make_shared<HardwareBufferPool>();
 #endif
@@ -66,12 +72,19 @@ class MemoryManager {
   }
 #endif
 
-#ifdef MEDIAPIPE_TENSOR_USE_AHWB
+  std::shared_ptr<CpuBufferPool> GetCpuBufferPool() const {
+    return cpu_buffer_pool_;
+  }
+
   explicit MemoryManager(const MultiPoolOptions& options)
-      : hardware_buffer_pool_(std::make_shared<HardwareBufferPool>(options)) {}
+      : cpu_buffer_pool_(std::make_shared<CpuBufferPool>(options)) {
+#ifdef MEDIAPIPE_TENSOR_USE_AHWB
+    hardware_buffer_pool_ = std::make_shared<HardwareBufferPool>(options);
 #endif
+  }
 
  private:
+  std::shared_ptr<CpuBufferPool> cpu_buffer_pool_;
 #ifdef MEDIAPIPE_TENSOR_USE_AHWB
   std::shared_ptr<HardwareBufferPool> hardware_buffer_pool_;
 #endif
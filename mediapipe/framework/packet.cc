@@ -38,13 +38,33 @@ namespace packet_internal {
 
 HolderBase::~HolderBase() {}
 
+namespace {
+
+// Accounts for a packet created around a heap allocated holder: the holder,
+// the shared_ptr control block and, unless the holder does not own it, the
+// payload.
+void CountHeapAllocatedHolder(const HolderBase* holder) {
+  PacketAllocationCounts& counts = ThreadPacketAllocationCounts();
+  ++counts.created_packets;
+  counts.heap_allocations += holder->HasForeignOwner() ? 2 : 3;
+}
+
+}  // namespace
+
+PacketAllocationCounts& ThreadPacketAllocationCounts() {
+  static thread_local PacketAllocationCounts counts;
+  return counts;
+}
+
 Packet Create(HolderBase* holder) {
+  CountHeapAllocatedHolder(holder);
   Packet result;
   result.holder_.reset(holder);
   return result;
 }
 
 Packet Create(HolderBase* holder, Timestamp timestamp) {
+  CountHeapAllocatedHolder(holder);
   Packet result;
   result.holder_.reset(holder);
   result.timestamp_ = timestamp;
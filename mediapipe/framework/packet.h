@@ -69,6 +69,16 @@ const std::shared_ptr<const HolderBase>& GetHolderShared(const Packet& packet);
 std::shared_ptr<const HolderBase> GetHolderShared(Packet&& packet);
 absl::StatusOr<Packet> PacketFromDynamicProto(const std::string& type_name,
                                               const std::string& serialized);
+
+// Number of packets created on a thread, and of heap allocations made to
+// create them. Used by the GraphProfiler to report allocations per packet.
+struct PacketAllocationCounts {
+  int64_t created_packets = 0;
+  int64_t heap_allocations = 0;
+};
+
+// Returns the counts for the calling thread.
+PacketAllocationCounts& ThreadPacketAllocationCounts();
 }  // namespace packet_internal
 
 // A generic container class which can hold data of any type.  The type of
@@ -0,0 +1,233 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/packet_pool.h"
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/deps/no_destructor.h"
+#include "mediapipe/framework/packet.h"
+
+namespace mediapipe {
+
+namespace {
+
+constexpr size_t kNumSizeClasses =
+    PacketPool::kMaxBlockSize / PacketPool::kBlockAlignment;
+// Number of blocks moved between a thread cache and the central free list at
+// once, and number of blocks carved out of each chunk of system memory.
+constexpr int kTransferBatchSize = 32;
+// A thread cache returns a batch to the central free list when it holds more
+// than this many blocks of a size class.
+constexpr int kMaxCachedBlocks = 4 * kTransferBatchSize;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+size_t SizeClassIndex(size_t size) {
+  return (size + PacketPool::kBlockAlignment - 1) /
+             PacketPool::kBlockAlignment -
+         1;
+}
+
+size_t BlockSize(size_t size_class) {
+  return (size_class + 1) * PacketPool::kBlockAlignment;
+}
+
+class CentralFreeList {
+ public:
+  // Returns a list of kTransferBatchSize blocks of "block_size" bytes.
+  FreeBlock* FetchBatch(size_t block_size) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (!batches_.empty()) {
+        FreeBlock* batch = batches_.back();
+        batches_.pop_back();
+        return batch;
+      }
+    }
+    return NewBatch(block_size);
+  }
+
+  // Takes a list of kTransferBatchSize blocks.
+  void ReleaseBatch(FreeBlock* batch) {
+    absl::MutexLock lock(&mutex_);
+    batches_.push_back(batch);
+  }
+
+  // Returns a single block of "block_size" bytes, for a thread whose cache is
+  // already destroyed.
+  void* AllocateBlock(size_t block_size) {
+    absl::MutexLock lock(&mutex_);
+    if (partial_ == nullptr) {
+      if (batches_.empty()) {
+        batches_.push_back(NewBatch(block_size));
+      }
+      partial_ = batches_.back();
+      batches_.pop_back();
+      partial_count_ = kTransferBatchSize;
+    }
+    FreeBlock* block = partial_;
+    partial_ = block->next;
+    --partial_count_;
+    return block;
+  }
+
+  // Takes a single block, from a thread whose cache is already destroyed.
+  void DeallocateBlock(void* ptr) {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = nullptr;
+    ReleasePartialBatch(block);
+  }
+
+  // Takes a list of fewer than kTransferBatchSize blocks, when a thread exits.
+  void ReleasePartialBatch(FreeBlock* head) {
+    // Partial batches are simply returned block by block through a full batch
+    // list; they are merged until a full batch is formed.
+    absl::MutexLock lock(&mutex_);
+    while (head != nullptr) {
+      FreeBlock* next = head->next;
+      head->next = partial_;
+      partial_ = head;
+      if (++partial_count_ == kTransferBatchSize) {
+        batches_.push_back(partial_);
+        partial_ = nullptr;
+        partial_count_ = 0;
+      }
+      head = next;
+    }
+  }
+
+ private:
+  // Carves a list of kTransferBatchSize blocks out of a new chunk of system
+  // memory.
+  static FreeBlock* NewBatch(size_t block_size) {
+    ++packet_internal::ThreadPacketAllocationCounts().heap_allocations;
+    char* chunk = static_cast<char*>(::operator new(
+        block_size * kTransferBatchSize));
+    FreeBlock* head = nullptr;
+    for (int i = kTransferBatchSize - 1; i >= 0; --i) {
+      FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * block_size);
+      block->next = head;
+      head = block;
+    }
+    return head;
+  }
+
+  absl::Mutex mutex_;
+  std::vector<FreeBlock*> batches_ ABSL_GUARDED_BY(mutex_);
+  FreeBlock* partial_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  int partial_count_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+std::array<CentralFreeList, kNumSizeClasses>& CentralFreeLists() {
+  static NoDestructor<std::array<CentralFreeList, kNumSizeClasses>> lists;
+  return *lists;
+}
+
+// Set once the calling thread's cache is destroyed. Pooled packets can still
+// be freed afterwards on that thread, by thread_locals destroyed later; their
+// blocks then go straight to the central free lists. Being trivially
+// destructible, the flag itself stays valid until the thread exits.
+thread_local bool thread_cache_destroyed = false;
+
+class ThreadCache {
+ public:
+  ~ThreadCache() {
+    thread_cache_destroyed = true;
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      if (heads_[i] != nullptr) {
+        CentralFreeLists()[i].ReleasePartialBatch(heads_[i]);
+        heads_[i] = nullptr;
+        counts_[i] = 0;
+      }
+    }
+  }
+
+  void* Allocate(size_t size_class) {
+    if (heads_[size_class] == nullptr) {
+      heads_[size_class] =
+          CentralFreeLists()[size_class].FetchBatch(BlockSize(size_class));
+      counts_[size_class] = kTransferBatchSize;
+    }
+    FreeBlock* block = heads_[size_class];
+    heads_[size_class] = block->next;
+    --counts_[size_class];
+    return block;
+  }
+
+  void Deallocate(size_t size_class, void* ptr) {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = heads_[size_class];
+    heads_[size_class] = block;
+    if (++counts_[size_class] > kMaxCachedBlocks) {
+      // Detach the first kTransferBatchSize blocks as a batch.
+      FreeBlock* batch = heads_[size_class];
+      FreeBlock* last = batch;
+      for (int i = 1; i < kTransferBatchSize; ++i) {
+        last = last->next;
+      }
+      heads_[size_class] = last->next;
+      last->next = nullptr;
+      counts_[size_class] -= kTransferBatchSize;
+      CentralFreeLists()[size_class].ReleaseBatch(batch);
+    }
+  }
+
+ private:
+  FreeBlock* heads_[kNumSizeClasses] = {};
+  int counts_[kNumSizeClasses] = {};
+};
+
+ThreadCache& GetThreadCache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+}  // namespace
+
+// static
+void* PacketPool::Allocate(size_t size) {
+  if (size > kMaxBlockSize) {
+    ++packet_internal::ThreadPacketAllocationCounts().heap_allocations;
+    return ::operator new(size);
+  }
+  const size_t size_class = SizeClassIndex(size);
+  if (thread_cache_destroyed) {
+    return CentralFreeLists()[size_class].AllocateBlock(BlockSize(size_class));
+  }
+  return GetThreadCache().Allocate(size_class);
+}
+
+// static
+void PacketPool::Deallocate(void* ptr, size_t size) {
+  if (size > kMaxBlockSize) {
+    ::operator delete(ptr);
+    return;
+  }
+  const size_t size_class = SizeClassIndex(size);
+  if (thread_cache_destroyed) {
+    CentralFreeLists()[size_class].DeallocateBlock(ptr);
+    return;
+  }
+  GetThreadCache().Deallocate(size_class, ptr);
+}
+
+}  // namespace mediapipe
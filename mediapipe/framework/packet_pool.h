@@ -0,0 +1,138 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PACKET_POOL_H_
+#define MEDIAPIPE_FRAMEWORK_PACKET_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+
+// A process-wide pool of small memory blocks used by MakePooledPacket.
+//
+// Blocks are grouped in size classes of kBlockAlignment bytes, up to
+// kMaxBlockSize bytes. Every thread caches freed blocks of each size class and
+// exchanges them in batches with a central free list, so allocating and
+// freeing a block usually takes no lock. Memory taken from the system is
+// never returned to it.
+class PacketPool {
+ public:
+  static constexpr size_t kBlockAlignment = alignof(std::max_align_t);
+  static constexpr size_t kMaxBlockSize = 512;
+
+  // Returns a block of at least "size" bytes aligned to kBlockAlignment.
+  // Sizes above kMaxBlockSize are served by operator new.
+  static void* Allocate(size_t size);
+
+  // Returns a block obtained from Allocate(size) to the pool.
+  static void Deallocate(void* ptr, size_t size);
+};
+
+// A stateless allocator backed by PacketPool, for use with
+// std::allocate_shared.
+template <typename T>
+class PacketPoolAllocator {
+ public:
+  using value_type = T;
+
+  PacketPoolAllocator() = default;
+  template <typename U>
+  PacketPoolAllocator(const PacketPoolAllocator<U>&) {}  // NOLINT
+
+  T* allocate(size_t n) {
+    if constexpr (alignof(T) > PacketPool::kBlockAlignment) {
+      ++packet_internal::ThreadPacketAllocationCounts().heap_allocations;
+      return static_cast<T*>(
+          ::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    } else {
+      return static_cast<T*>(PacketPool::Allocate(n * sizeof(T)));
+    }
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    if constexpr (alignof(T) > PacketPool::kBlockAlignment) {
+      ::operator delete(ptr, std::align_val_t(alignof(T)));
+    } else {
+      PacketPool::Deallocate(ptr, n * sizeof(T));
+    }
+  }
+
+  template <typename U>
+  bool operator==(const PacketPoolAllocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const PacketPoolAllocator<U>&) const {
+    return false;
+  }
+};
+
+namespace packet_internal {
+
+// A Holder that stores its payload inline. Since the payload is not
+// individually heap allocated, it reports a foreign owner so that
+// Packet::Consume() does not try to release it.
+template <typename T>
+class PooledHolder : public Holder<T> {
+ public:
+  template <typename... Args>
+  explicit PooledHolder(Args&&... args)
+      : Holder<T>(nullptr), value_(std::forward<Args>(args)...) {
+    this->ptr_ = &value_;
+  }
+
+  ~PooledHolder() override {
+    // Null out ptr_ so it doesn't get deleted by ~Holder.
+    this->ptr_ = nullptr;
+  }
+
+  bool HasForeignOwner() const final { return true; }
+
+ private:
+  T value_;
+};
+
+}  // namespace packet_internal
+
+// Creates a packet containing an object of type T initialized with the
+// provided arguments, like MakePacket<T>(). The reference count, the holder
+// and the payload are placed in a single block from PacketPool, so that in
+// steady state creating the packet does not touch the system allocator.
+// Intended for small payloads such as timestamps, rects, floats or short
+// vectors of detections.
+//
+// Unlike packets created by MakePacket, the payload can't be taken out of the
+// packet with Packet::Consume().
+template <typename T, typename... Args>
+Packet MakePooledPacket(Args&&... args) {
+  static_assert(!std::is_array<T>::value,
+                "MakePooledPacket does not support arrays.");
+  ++packet_internal::ThreadPacketAllocationCounts().created_packets;
+  return packet_internal::Create(
+      std::allocate_shared<packet_internal::PooledHolder<T>>(
+          PacketPoolAllocator<packet_internal::PooledHolder<T>>(),
+          std::forward<Args>(args)...),
+      Timestamp::Unset());
+}
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PACKET_POOL_H_
@@ -0,0 +1,174 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/packet_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+namespace {
+
+struct alignas(64) OverAligned {
+  int value = 0;
+};
+
+class Tracked {
+ public:
+  explicit Tracked(bool* exists) : exists_(exists) { *exists_ = true; }
+  ~Tracked() { *exists_ = false; }
+
+ private:
+  bool* exists_;
+};
+
+TEST(PacketPoolTest, MakePooledPacketHoldsValue) {
+  Packet packet = MakePooledPacket<std::string>("pooled").At(Timestamp(10));
+  MP_EXPECT_OK(packet.ValidateAsType<std::string>());
+  EXPECT_EQ(packet.Get<std::string>(), "pooled");
+  EXPECT_EQ(packet.Timestamp(), Timestamp(10));
+}
+
+TEST(PacketPoolTest, MakePooledPacketHoldsProtoValue) {
+  Detection detection;
+  detection.add_score(0.5f);
+  Packet packet = MakePooledPacket<std::vector<Detection>>(
+      std::vector<Detection>{detection, detection});
+  ASSERT_EQ(packet.Get<std::vector<Detection>>().size(), 2);
+  MP_ASSERT_OK_AND_ASSIGN(auto protos, packet.GetVectorOfProtoMessageLitePtrs());
+  EXPECT_EQ(protos.size(), 2);
+}
+
+TEST(PacketPoolTest, DestroysValueWithLastPacket) {
+  bool exists = false;
+  Packet packet = MakePooledPacket<Tracked>(&exists);
+  EXPECT_TRUE(exists);
+  Packet copy = packet.At(Timestamp(1));
+  packet = Packet();
+  EXPECT_TRUE(exists);
+  copy = Packet();
+  EXPECT_FALSE(exists);
+}
+
+TEST(PacketPoolTest, CannotConsume) {
+  Packet packet = MakePooledPacket<int>(7);
+  EXPECT_FALSE(packet.Consume<int>().ok());
+  EXPECT_EQ(packet.Get<int>(), 7);
+}
+
+TEST(PacketPoolTest, SupportsOverAlignedTypes) {
+  Packet packet = MakePooledPacket<OverAligned>();
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(&packet.Get<OverAligned>()) %
+                alignof(OverAligned),
+            0);
+}
+
+TEST(PacketPoolTest, ReusesBlocksWithoutHeapAllocations) {
+  // Warm up the size class used for float packets.
+  std::vector<Packet> packets;
+  for (int i = 0; i < 64; ++i) {
+    packets.push_back(MakePooledPacket<float>(i));
+  }
+  packets.clear();
+
+  const packet_internal::PacketAllocationCounts start =
+      packet_internal::ThreadPacketAllocationCounts();
+  for (int i = 0; i < 64; ++i) {
+    packets.push_back(MakePooledPacket<float>(i));
+  }
+  const packet_internal::PacketAllocationCounts& end =
+      packet_internal::ThreadPacketAllocationCounts();
+  EXPECT_EQ(end.created_packets - start.created_packets, 64);
+  EXPECT_EQ(end.heap_allocations - start.heap_allocations, 0);
+  for (int i = 0; i < 64; ++i) {
+    EXPECT_EQ(packets[i].Get<float>(), i);
+  }
+}
+
+TEST(PacketPoolTest, CountsHeapAllocationsOfMakePacket) {
+  const packet_internal::PacketAllocationCounts start =
+      packet_internal::ThreadPacketAllocationCounts();
+  Packet packet = MakePacket<float>(1.0f);
+  const packet_internal::PacketAllocationCounts& end =
+      packet_internal::ThreadPacketAllocationCounts();
+  EXPECT_EQ(end.created_packets - start.created_packets, 1);
+  EXPECT_EQ(end.heap_allocations - start.heap_allocations, 3);
+}
+
+TEST(PacketPoolTest, PacketsCanBeReleasedOnOtherThreads) {
+  constexpr int kNumPackets = 1000;
+  std::vector<Packet> packets;
+  for (int i = 0; i < kNumPackets; ++i) {
+    packets.push_back(MakePooledPacket<int64_t>(i));
+  }
+  std::thread releaser([&packets] {
+    for (int i = 0; i < kNumPackets; ++i) {
+      EXPECT_EQ(packets[i].Get<int64_t>(), i);
+    }
+    packets.clear();
+    // Allocate again on this thread so that it also reuses released blocks.
+    for (int i = 0; i < kNumPackets; ++i) {
+      Packet packet = MakePooledPacket<int64_t>(i);
+      EXPECT_EQ(packet.Get<int64_t>(), i);
+    }
+  });
+  releaser.join();
+  EXPECT_TRUE(packets.empty());
+  Packet packet = MakePooledPacket<int64_t>(42);
+  EXPECT_EQ(packet.Get<int64_t>(), 42);
+}
+
+// Holds pooled packets in a thread_local that is constructed before, and hence
+// destroyed after, the pool's cache of the same thread.
+struct ThreadExitPackets {
+  ~ThreadExitPackets() {
+    packets.clear();
+    // Allocating again after the cache is destroyed must still work.
+    Packet packet = MakePooledPacket<int64_t>(7);
+    EXPECT_EQ(packet.Get<int64_t>(), 7);
+  }
+  std::vector<Packet> packets;
+};
+
+TEST(PacketPoolTest, PacketsCanBeReleasedAfterThreadCacheDestruction) {
+  constexpr int kNumPackets = 100;
+  std::thread thread([] {
+    static thread_local ThreadExitPackets exit_packets;
+    for (int i = 0; i < kNumPackets; ++i) {
+      exit_packets.packets.push_back(MakePooledPacket<int64_t>(i));
+    }
+  });
+  thread.join();
+  // The blocks released during the thread's exit can be reused.
+  std::vector<Packet> packets;
+  for (int i = 0; i < 2 * kNumPackets; ++i) {
+    packets.push_back(MakePooledPacket<int64_t>(i));
+  }
+  for (int i = 0; i < packets.size(); ++i) {
+    EXPECT_EQ(packets[i].Get<int64_t>(), i);
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,127 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PACKET_RING_BUFFER_H_
+#define MEDIAPIPE_FRAMEWORK_PACKET_RING_BUFFER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "mediapipe/framework/packet.h"
+
+namespace mediapipe {
+
+// A FIFO queue of packets stored in a contiguous circular buffer.
+//
+// Unlike std::deque, pushing and popping packets never allocates or frees
+// memory once the buffer has reached the steady state queue size. The buffer
+// grows geometrically when a packet is pushed into a full buffer, and never
+// shrinks.
+class PacketRingBuffer {
+ public:
+  PacketRingBuffer() = default;
+  PacketRingBuffer(const PacketRingBuffer&) = delete;
+  PacketRingBuffer& operator=(const PacketRingBuffer&) = delete;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return buffer_.size(); }
+
+  // Returns the i-th packet from the front of the queue.
+  const Packet& operator[](size_t i) const {
+    ABSL_DCHECK_LT(i, size_);
+    return buffer_[Index(i)];
+  }
+  Packet& operator[](size_t i) {
+    ABSL_DCHECK_LT(i, size_);
+    return buffer_[Index(i)];
+  }
+
+  const Packet& front() const { return (*this)[0]; }
+  Packet& front() { return (*this)[0]; }
+  const Packet& back() const { return (*this)[size_ - 1]; }
+  Packet& back() { return (*this)[size_ - 1]; }
+
+  void push_back(const Packet& packet) {
+    GrowIfFull();
+    buffer_[Index(size_)] = packet;
+    ++size_;
+  }
+
+  void push_back(Packet&& packet) {
+    GrowIfFull();
+    buffer_[Index(size_)] = std::move(packet);
+    ++size_;
+  }
+
+  // Removes the front packet, releasing its payload.
+  void pop_front() {
+    ABSL_DCHECK_GT(size_, 0);
+    buffer_[head_] = Packet();
+    head_ = head_ + 1 == buffer_.size() ? 0 : head_ + 1;
+    --size_;
+  }
+
+  // Removes all packets but keeps the capacity.
+  void clear() {
+    while (!empty()) {
+      pop_front();
+    }
+    head_ = 0;
+  }
+
+  // Ensures that at least "capacity" packets can be queued without
+  // reallocating the buffer.
+  void reserve(size_t capacity) {
+    if (capacity > buffer_.size()) {
+      Reallocate(capacity);
+    }
+  }
+
+ private:
+  size_t Index(size_t i) const {
+    size_t index = head_ + i;
+    return index < buffer_.size() ? index : index - buffer_.size();
+  }
+
+  void GrowIfFull() {
+    if (size_ == buffer_.size()) {
+      Reallocate(std::max<size_t>(2 * buffer_.size(), kMinCapacity));
+    }
+  }
+
+  void Reallocate(size_t capacity) {
+    std::vector<Packet> buffer(capacity);
+    for (size_t i = 0; i < size_; ++i) {
+      buffer[i] = std::move(buffer_[Index(i)]);
+    }
+    buffer_ = std::move(buffer);
+    head_ = 0;
+  }
+
+  static constexpr size_t kMinCapacity = 4;
+
+  std::vector<Packet> buffer_;
+  // The index in buffer_ of the front packet.
+  size_t head_ = 0;
+  // The number of queued packets.
+  size_t size_ = 0;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PACKET_RING_BUFFER_H_
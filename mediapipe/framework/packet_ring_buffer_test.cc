@@ -0,0 +1,106 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/packet_ring_buffer.h"
+
+#include <memory>
+
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(PacketRingBufferTest, IsFifo) {
+  PacketRingBuffer queue;
+  EXPECT_TRUE(queue.empty());
+  for (int i = 0; i < 10; ++i) {
+    queue.push_back(MakePacket<int>(i).At(Timestamp(i)));
+  }
+  EXPECT_EQ(queue.size(), 10);
+  EXPECT_EQ(queue.front().Get<int>(), 0);
+  EXPECT_EQ(queue.back().Get<int>(), 9);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(queue[i].Timestamp(), Timestamp(i));
+  }
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(queue.front().Get<int>(), i);
+    queue.pop_front();
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(PacketRingBufferTest, WrapsAroundWithoutGrowing) {
+  PacketRingBuffer queue;
+  queue.reserve(4);
+  const size_t capacity = queue.capacity();
+  int next_value = 0;
+  int expected_value = 0;
+  for (int round = 0; round < 100; ++round) {
+    while (queue.size() < 3) {
+      queue.push_back(MakePacket<int>(next_value++));
+    }
+    EXPECT_EQ(queue.front().Get<int>(), expected_value++);
+    queue.pop_front();
+  }
+  EXPECT_EQ(queue.capacity(), capacity);
+}
+
+TEST(PacketRingBufferTest, GrowsPreservingOrder) {
+  PacketRingBuffer queue;
+  queue.reserve(4);
+  // Moves the head away from the start of the buffer before growing.
+  queue.push_back(MakePacket<int>(-2));
+  queue.push_back(MakePacket<int>(-1));
+  queue.pop_front();
+  queue.pop_front();
+  for (int i = 0; i < 100; ++i) {
+    queue.push_back(MakePacket<int>(i));
+  }
+  EXPECT_GE(queue.capacity(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(queue[i].Get<int>(), i);
+  }
+}
+
+TEST(PacketRingBufferTest, ReleasesPoppedPackets) {
+  auto payload = std::make_shared<int>(1);
+  std::weak_ptr<int> weak_payload = payload;
+  PacketRingBuffer queue;
+  queue.push_back(PointToForeign(payload.get(), [payload]() mutable {
+    payload.reset();
+  }));
+  payload.reset();
+  EXPECT_FALSE(weak_payload.expired());
+  queue.pop_front();
+  EXPECT_TRUE(weak_payload.expired());
+}
+
+TEST(PacketRingBufferTest, ClearKeepsCapacity) {
+  PacketRingBuffer queue;
+  for (int i = 0; i < 20; ++i) {
+    queue.push_back(MakePacket<int>(i));
+  }
+  const size_t capacity = queue.capacity();
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.capacity(), capacity);
+  queue.push_back(MakePacket<int>(7));
+  EXPECT_EQ(queue.front().Get<int>(), 7);
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -15,8 +15,10 @@
 #include "mediapipe/framework/profiler/graph_profiler.h"
 
 #include <fstream>
+#include <functional>
 #include <list>
 #include <memory>
+#include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -211,6 +213,12 @@ const std::shared_ptr<mediapipe::Clock> GraphProfiler::GetClock() const {
   return clock_;
 }
 
+void GraphProfiler::SetImagePoolCountsCallback(
+    std::function<std::pair<int, int>()> image_pool_counts) {
+  absl::WriterMutexLock lock(&profiler_mutex_);
+  image_pool_counts_ = std::move(image_pool_counts);
+}
+
 void GraphProfiler::Pause() {
   is_profiling_ = false;
   is_tracing_ = false;
@@ -233,6 +241,8 @@ void GraphProfiler::Reset() {
     ResetTimeHistogram(calculator_profile->mutable_process_runtime());
     ResetTimeHistogram(calculator_profile->mutable_process_input_latency());
     ResetTimeHistogram(calculator_profile->mutable_process_output_latency());
+    calculator_profile->clear_process_created_packets();
+    calculator_profile->clear_process_packet_heap_allocations();
     for (auto& input_stream_profile :
          *(calculator_profile->mutable_input_stream_profiles())) {
       ResetTimeHistogram(input_stream_profile.mutable_latency());
@@ -549,7 +559,8 @@ int64_t GraphProfiler::AddInputStreamTimeSamples(
 
 void GraphProfiler::AddProcessSample(
     const CalculatorContext& calculator_context, int64_t start_time_usec,
-    int64_t end_time_usec) {
+    int64_t end_time_usec, int64_t created_packets,
+    int64_t packet_heap_allocations) {
   absl::ReaderMutexLock lock(&profiler_mutex_);
   if (!is_profiling_) {
     return;
@@ -565,6 +576,13 @@ void GraphProfiler::AddProcessSample(
   // Update Process() runtime.
   AddTimeSample(start_time_usec, end_time_usec,
                 calculator_profile->mutable_process_runtime());
+  if (created_packets != 0 || packet_heap_allocations != 0) {
+    calculator_profile->set_process_created_packets(
+        calculator_profile->process_created_packets() + created_packets);
+    calculator_profile->set_process_packet_heap_allocations(
+        calculator_profile->process_packet_heap_allocations() +
+        packet_heap_allocations);
+  }
 
   if (profiler_config_.enable_stream_latency()) {
     int64_t min_source_process_start_usec = AddStreamLatencies(
@@ -705,6 +723,14 @@ absl::Status GraphProfiler::CaptureProfile(
   }
   this->Reset();
   CleanCalculatorProfiles(result);
+  {
+    absl::ReaderMutexLock lock(&profiler_mutex_);
+    if (image_pool_counts_) {
+      const auto [in_use, available] = image_pool_counts_();
+      result->set_image_pool_in_use_count(in_use);
+      result->set_image_pool_available_count(available);
+    }
+  }
   if (populate_config == PopulateGraphConfig::kFull) {
     *result->mutable_config() = validated_graph_->Config();
     AssignNodeNames(result);
@@ -18,9 +18,11 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/time/time.h"
@@ -30,6 +32,7 @@
 #include "mediapipe/framework/deps/clock.h"
 #include "mediapipe/framework/deps/monotonic_clock.h"
 #include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/profiler/graph_tracer.h"
 #include "mediapipe/framework/profiler/sharded_map.h"
 #include "mediapipe/framework/validated_graph_config.h"
@@ -125,6 +128,12 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
   const std::shared_ptr<mediapipe::Clock> GetClock() const
       ABSL_LOCKS_EXCLUDED(profiler_mutex_);
 
+  // Sets a function returning the number of pooled CPU image frames in use and
+  // available for reuse, which CaptureProfile records in the GraphProfile.
+  void SetImagePoolCountsCallback(
+      std::function<std::pair<int, int>()> image_pool_counts)
+      ABSL_LOCKS_EXCLUDED(profiler_mutex_);
+
   // Pauses profiling. No-op if already paused.
   void Pause();
   // Resumes profiling. No-op if already profiling.
@@ -183,6 +192,7 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
           calculator_context_(*calculator_context),
           profiler_(profiler) {
       start_time_usec_ = profiler_->TimeNowUsec();
+      start_allocation_counts_ = packet_internal::ThreadPacketAllocationCounts();
       if (profiler_->is_tracing_) {
         absl::Time time_now = absl::FromUnixMicros(start_time_usec_);
         profiler_->packet_tracer_->LogInputEvents(
@@ -203,10 +213,17 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
                                       end_time_usec);
             break;
 
-          case GraphTrace::PROCESS:
-            profiler_->AddProcessSample(calculator_context_, start_time_usec_,
-                                        end_time_usec);
+          case GraphTrace::PROCESS: {
+            const packet_internal::PacketAllocationCounts& counts =
+                packet_internal::ThreadPacketAllocationCounts();
+            profiler_->AddProcessSample(
+                calculator_context_, start_time_usec_, end_time_usec,
+                counts.created_packets -
+                    start_allocation_counts_.created_packets,
+                counts.heap_allocations -
+                    start_allocation_counts_.heap_allocations);
             break;
+          }
 
           case GraphTrace::CLOSE:
             profiler_->SetCloseRuntime(calculator_context_, start_time_usec_,
@@ -228,6 +245,7 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
     const CalculatorContext& calculator_context_;
     GraphProfiler* profiler_;
     int64_t start_time_usec_;
+    packet_internal::PacketAllocationCounts start_allocation_counts_;
   };
 
   const ProfilerConfig& profiler_config() { return profiler_config_; }
@@ -299,10 +317,13 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
                                     int64_t start_time_usec,
                                     CalculatorProfile* calculator_profile);
 
-  // Updates the Process() data for calculator.
+  // Updates the Process() data for calculator, including the number of packets
+  // created and heap allocations made for them during the Process() call.
   // Requires ReaderLock for is_profiling_.
   void AddProcessSample(const CalculatorContext& calculator_context,
-                        int64_t start_time_usec, int64_t end_time_usec)
+                        int64_t start_time_usec, int64_t end_time_usec,
+                        int64_t created_packets = 0,
+                        int64_t packet_heap_allocations = 0)
       ABSL_LOCKS_EXCLUDED(profiler_mutex_);
 
   // Helper method to get trace_log_path.  If the trace_log_path is empty and
@@ -338,6 +359,10 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
   // Global mutex for the profiler.
   mutable absl::Mutex profiler_mutex_;
 
+  // Returns the number of pooled CPU image frames in use and available.
+  std::function<std::pair<int, int>()> image_pool_counts_
+      ABSL_GUARDED_BY(profiler_mutex_);
+
   // Buffer of recent profile trace events.
   std::unique_ptr<GraphTracer> packet_tracer_;
 
@@ -16,6 +16,8 @@
 #define MEDIAPIPE_FRAMEWORK_PROFILER_MEDIAPIPE_PROFILER_STUB_H_
 
 #include <cstdint>
+#include <functional>
+#include <utility>
 
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/timestamp.h"
@@ -85,6 +87,8 @@ class GraphProfilerStub {
  public:
   inline void Initialize(const ValidatedGraphConfig& validated_graph_config) {}
   inline void SetClock(const std::shared_ptr<mediapipe::Clock>& clock) {}
+  inline void SetImagePoolCountsCallback(
+      std::function<std::pair<int, int>()> image_pool_counts) {}
   inline void LogEvent(const TraceEvent& event) {}
   inline absl::Status GetCalculatorProfiles(
       std::vector<CalculatorProfile>*) const {
@@ -15,6 +15,7 @@
 #include "mediapipe/framework/profiler/graph_profiler.h"
 
 #include <functional>
+#include <memory>
 #include <queue>
 
 #include "absl/log/absl_log.h"
@@ -23,6 +24,9 @@
 #include "absl/time/time.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_multi_pool.h"
+#include "mediapipe/framework/formats/image_multi_pool_service.h"
 #include "mediapipe/framework/mediapipe_profiling.h"
 #include "mediapipe/framework/port/core_proto_inc.h"
 #include "mediapipe/framework/port/gmock.h"
@@ -1067,6 +1071,47 @@ TEST_F(GraphProfilerTestPeer, AddProcessSample) {
   ASSERT_EQ(GetPacketsInfoMap()->size(), 0);
 }
 
+// Tests that the packets created within a Process() scope and the heap
+// allocations made for them are added to the calculator profile.
+TEST_F(GraphProfilerTestPeer, AddProcessSampleCountsPacketAllocations) {
+  InitializeProfilerWithGraphConfig(R"(
+    profiler_config {
+      enable_profiler: true
+    }
+    input_stream: "input_stream"
+    node {
+      calculator: "DummyTestCalculator"
+      input_stream: "input_stream"
+      output_stream: "output_stream"
+    })");
+  std::shared_ptr<mediapipe::SimulationClock> simulation_clock(
+      new SimulationClock());
+  simulation_clock->ThreadStart();
+  profiler_.SetClock(simulation_clock);
+
+  TestContextBuilder context(kDummyTestCalculatorName, /*node_id=*/0,
+                             {"input_stream"}, {"output_stream"});
+  context.AddInputs({MakePacket<std::string>("5").At(Timestamp(100))});
+
+  for (int i = 0; i < 2; ++i) {
+    GraphProfiler::Scope profiler_scope(GraphTrace::PROCESS, context.get(),
+                                        &profiler_);
+    Packet output = MakePacket<std::string>("15").At(Timestamp(100 + i));
+    Packet foreign = PointToForeign(&output.Get<std::string>());
+    simulation_clock->Sleep(absl::Microseconds(10));
+  }
+
+  std::vector<CalculatorProfile> profiles = Profiles();
+  simulation_clock->ThreadFinish();
+
+  ASSERT_EQ(profiles.size(), 1);
+  // Each MakePacket() allocates the holder, the payload and the shared_ptr
+  // control block. PointToForeign() does not allocate the payload.
+  EXPECT_EQ(profiles[0].process_created_packets(), 4);
+  EXPECT_EQ(profiles[0].process_packet_heap_allocations(), 10);
+  EXPECT_EQ(profiles[0].process_runtime().count(), 2);
+}
+
 // Tests that AddProcessSample() updates |process_runtime| and also updates the
 // packet info map when stream latency is enabled.
 TEST_F(GraphProfilerTestPeer, AddProcessSampleWithStreamLatency) {
@@ -1363,6 +1408,37 @@ TEST(GraphProfilerTest, CaptureProfilePopulateConfig) {
                   )pb"))));
 }
 
+TEST(GraphProfilerTest, CaptureProfileReportsImagePoolCounts) {
+  CalculatorGraphConfig config;
+  QCHECK(google::protobuf::TextFormat::ParseFromString(R"(
+    profiler_config {
+      enable_profiler: true
+    }
+    input_stream: "input_stream"
+    node {
+      calculator: "DummyTestCalculator"
+      input_stream: "input_stream"
+    }
+    )",
+                                                       &config));
+  auto image_pool = std::make_shared<ImageMultiPool>();
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.SetServiceObject(kImageMultiPoolService, image_pool));
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  auto frame1 = image_pool->GetImageFrame(4, 4, ImageFormat::SRGB);
+  auto frame2 = image_pool->GetImageFrame(4, 4, ImageFormat::SRGB);
+  frame2 = nullptr;
+
+  GraphProfile profile;
+  MP_ASSERT_OK(graph.profiler()->CaptureProfile(&profile));
+  EXPECT_EQ(profile.image_pool_in_use_count(), 1);
+  EXPECT_EQ(profile.image_pool_available_count(), 1);
+
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
 TEST_F(GraphProfilerTestPeer, ExecutorRunEarly) {
   // Checks defaults before initialization.
   ASSERT_EQ(GetIsInitialized(), false);
@@ -79,6 +79,22 @@ void Scheduler::Reset() {
   shared_.has_error = false;
 }
 
+void Scheduler::EnableNodeBuckets(int num_nodes) {
+  ABSL_CHECK_EQ(state_, STATE_NOT_STARTED)
+      << "EnableNodeBuckets must not be called after the scheduler has "
+         "started";
+  for (auto queue : scheduler_queues_) {
+    queue->EnableNodeBuckets(num_nodes);
+  }
+}
+
+void Scheduler::EnableStaticSchedule(int num_nodes) {
+  ABSL_CHECK_EQ(state_, STATE_NOT_STARTED)
+      << "EnableStaticSchedule must not be called after the scheduler has "
+         "started";
+  default_queue_.EnableStaticSchedule(num_nodes);
+}
+
 void Scheduler::CloseAllSourceNodes() { shared_.stopping = true; }
 
 void Scheduler::SetExecutor(Executor* executor) {
@@ -58,6 +58,16 @@ class Scheduler {
   absl::Status SetNonDefaultExecutor(const std::string& name,
                                      Executor* executor);
 
+  // Makes all scheduler queues keep ready non-source nodes in per-node
+  // buckets. See SchedulerQueue::EnableNodeBuckets. Must be called before
+  // the scheduler is started.
+  void EnableNodeBuckets(int num_nodes);
+
+  // Makes the default scheduler queue run ready nodes in a fixed order. See
+  // SchedulerQueue::EnableStaticSchedule. Must be called before the scheduler
+  // is started.
+  void EnableStaticSchedule(int num_nodes);
+
   // Resets the data members at the beginning of each graph run.
   void Reset();
 
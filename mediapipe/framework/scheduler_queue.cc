@@ -14,11 +14,15 @@
 
 #include "mediapipe/framework/scheduler_queue.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <queue>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/numeric/bits.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/calculator_node.h"
 #include "mediapipe/framework/executor.h"
@@ -33,6 +37,65 @@
 namespace mediapipe {
 namespace internal {
 
+NodeBucketQueue::NodeBucketQueue(int num_nodes)
+    : num_nodes_(num_nodes),
+      num_words_((num_nodes + 63) / 64),
+      buckets_(new Bucket[num_nodes]),
+      non_empty_(new std::atomic<uint64_t>[num_words_]) {
+  for (int i = 0; i < num_words_; ++i) {
+    non_empty_[i].store(0);
+  }
+}
+
+void NodeBucketQueue::Push(int node_id, CalculatorNode* node,
+                           CalculatorContext* cc) {
+  ABSL_DCHECK_GE(node_id, 0);
+  ABSL_DCHECK_LT(node_id, num_nodes_);
+  Bucket& bucket = buckets_[node_id];
+  absl::MutexLock lock(&bucket.mutex);
+  bucket.entries.emplace_back(node, cc);
+  if (bucket.entries.size() == 1) {
+    non_empty_[node_id / 64].fetch_or(uint64_t{1} << (node_id % 64));
+  }
+}
+
+bool NodeBucketQueue::PopHighestId(CalculatorNode** node,
+                                   CalculatorContext** cc) {
+  for (int word = num_words_ - 1; word >= 0; --word) {
+    uint64_t bits = non_empty_[word].load();
+    while (bits != 0) {
+      const int bit = 63 - absl::countl_zero(bits);
+      const uint64_t mask = uint64_t{1} << bit;
+      Bucket& bucket = buckets_[word * 64 + bit];
+      {
+        absl::MutexLock lock(&bucket.mutex);
+        if (!bucket.entries.empty()) {
+          *node = bucket.entries.front().first;
+          *cc = bucket.entries.front().second;
+          bucket.entries.pop_front();
+          if (bucket.entries.empty()) {
+            non_empty_[word].fetch_and(~mask);
+          }
+          return true;
+        }
+      }
+      // Another thread emptied the bucket after we loaded the bitmap.
+      bits &= ~mask;
+    }
+  }
+  return false;
+}
+
+void NodeBucketQueue::Clear() {
+  for (int i = 0; i < num_nodes_; ++i) {
+    absl::MutexLock lock(&buckets_[i].mutex);
+    buckets_[i].entries.clear();
+  }
+  for (int i = 0; i < num_words_; ++i) {
+    non_empty_[i].store(0);
+  }
+}
+
 SchedulerQueue::Item::Item(CalculatorNode* node, CalculatorContext* cc)
     : node_(node), cc_(cc) {
   ABSL_CHECK(node);
@@ -85,11 +148,32 @@ bool SchedulerQueue::Item::operator<(const SchedulerQueue::Item& that) const {
   }
 }
 
+void SchedulerQueue::EnableNodeBuckets(int num_nodes) {
+  if (node_buckets_ && node_buckets_->num_nodes() == num_nodes) {
+    return;
+  }
+  node_buckets_ = std::make_unique<NodeBucketQueue>(num_nodes);
+}
+
+void SchedulerQueue::EnableStaticSchedule(int num_nodes) {
+  absl::MutexLock lock(&mutex_);
+  static_schedule_ = true;
+  static_nodes_.assign(num_nodes, nullptr);
+  static_contexts_.assign(num_nodes, nullptr);
+  static_ready_.assign((num_nodes + 63) / 64, 0);
+  num_static_ready_ = 0;
+  static_task_active_ = false;
+}
+
 void SchedulerQueue::Reset() {
   absl::MutexLock lock(&mutex_);
   num_pending_tasks_ = 0;
   num_tasks_to_add_ = 0;
   running_count_ = 0;
+  running_.store(false, std::memory_order_release);
+  num_active_items_ = 0;
+  num_queue_items_ = 0;
+  static_task_active_ = false;
 }
 
 void SchedulerQueue::SetExecutor(Executor* executor) { executor_ = executor; }
@@ -97,13 +181,14 @@ void SchedulerQueue::SetExecutor(Executor* executor) { executor_ = executor; }
 bool SchedulerQueue::IsIdle() {
   VLOG(3) << "Scheduler queue (" << queue_name_ << ") empty: " << queue_.empty()
           << ", # of pending tasks: " << num_pending_tasks_;
-  return queue_.empty() && num_pending_tasks_ == 0;
+  return queue_.empty() && num_static_ready_ == 0 && num_pending_tasks_ == 0;
 }
 
 void SchedulerQueue::SetRunning(bool running) {
   absl::MutexLock lock(&mutex_);
   running_count_ += running ? 1 : -1;
   ABSL_DCHECK_LE(running_count_, 1);
+  running_.store(running_count_ > 0, std::memory_order_release);
 }
 
 void SchedulerQueue::AddNode(CalculatorNode* node, CalculatorContext* cc) {
@@ -130,6 +215,14 @@ void SchedulerQueue::AddNodeForOpen(CalculatorNode* node) {
 }
 
 void SchedulerQueue::AddItemToQueue(Item&& item) {
+  if (static_schedule_) {
+    AddStaticItem(std::move(item));
+    return;
+  }
+  if (node_buckets_) {
+    AddBucketedItem(std::move(item));
+    return;
+  }
   const CalculatorNode* node = item.Node();
   bool was_idle;
   int tasks_to_add = 0;
@@ -161,10 +254,95 @@ void SchedulerQueue::AddItemToQueue(Item&& item) {
   }
 }
 
+void SchedulerQueue::AddBucketedItem(Item&& item) {
+  const CalculatorNode* node = item.Node();
+  const bool was_idle = num_active_items_.fetch_add(1) == 0;
+  if (item.IsOpenNode() || item.IsSource() ||
+      item.Id() >= node_buckets_->num_nodes()) {
+    absl::MutexLock lock(&mutex_);
+    queue_.push(item);
+    ++num_queue_items_;
+  } else {
+    node_buckets_->Push(item.Id(), item.Node(), item.Context());
+  }
+  VLOG(4) << node->DebugName() << " was added to the scheduler queue ("
+          << queue_name_ << ")";
+
+  // mutex_ is only needed to wake a task waiting in PopBucketedItem, or to
+  // defer the task of a queue that is not running until
+  // SubmitWaitingTasksToExecutor.
+  bool submit = running_.load(std::memory_order_acquire);
+  if (!submit || num_pop_waiters_.load() > 0) {
+    absl::MutexLock lock(&mutex_);
+    if (num_pop_waiters_ > 0) {
+      ++num_bucketed_pushes_;
+      item_pushed_.SignalAll();
+    }
+    submit = running_count_ > 0;
+    if (!submit) {
+      ++num_tasks_to_add_;
+    }
+  }
+  if (was_idle && idle_callback_) {
+    // Became not idle.
+    idle_callback_(false);
+  }
+  // As in AddItemToQueue, the task is submitted after idle_callback_(false).
+  if (submit) {
+    executor_->AddTask(this);
+  }
+}
+
+void SchedulerQueue::AddStaticItem(Item&& item) {
+  const CalculatorNode* node = item.Node();
+  bool was_idle;
+  int tasks_to_add = 0;
+  {
+    absl::MutexLock lock(&mutex_);
+    was_idle = IsIdle();
+    const int id = item.Id();
+    if (item.IsOpenNode() || item.IsSource() ||
+        id >= static_cast<int>(static_nodes_.size())) {
+      queue_.push(item);
+    } else {
+      ABSL_DCHECK(!static_contexts_[id])
+          << node->DebugName() << " was scheduled while it was ready.";
+      static_nodes_[id] = item.Node();
+      static_contexts_[id] = item.Context();
+      static_ready_[id / 64] |= uint64_t{1} << (id % 64);
+      ++num_static_ready_;
+    }
+    VLOG(4) << node->DebugName() << " was added to the scheduler queue ("
+            << queue_name_ << ")";
+
+    // An active task runs the item, or submits itself again if its sweep
+    // has already passed the node.
+    if (!static_task_active_) {
+      static_task_active_ = true;
+      ++num_tasks_to_add_;
+      if (running_count_ > 0) {
+        tasks_to_add = GetTasksToSubmitToExecutor();
+      }
+    }
+  }
+  if (was_idle && idle_callback_) {
+    // Became not idle.
+    idle_callback_(false);
+  }
+  // As in AddItemToQueue, the task is submitted after idle_callback_(false).
+  while (tasks_to_add > 0) {
+    executor_->AddTask(this);
+    --tasks_to_add;
+  }
+}
+
 int SchedulerQueue::GetTasksToSubmitToExecutor() {
   int tasks_to_add = num_tasks_to_add_;
   num_tasks_to_add_ = 0;
-  num_pending_tasks_ += tasks_to_add;
+  // With node buckets, pending tasks are accounted for in num_active_items_.
+  if (!node_buckets_) {
+    num_pending_tasks_ += tasks_to_add;
+  }
   return tasks_to_add;
 }
 
@@ -186,10 +364,18 @@ void SchedulerQueue::SubmitWaitingTasksToExecutor() {
 }
 
 void SchedulerQueue::RunNextTask() {
+  if (static_schedule_) {
+    RunStaticScheduleTask();
+    return;
+  }
   CalculatorNode* node;
   CalculatorContext* calculator_context;
   bool is_open_node;
-  {
+  if (node_buckets_) {
+    PopBucketedItem(&node, &calculator_context, &is_open_node);
+    ABSL_CHECK(!node->Closed())
+        << "Scheduled a node that was closed. This should not happen.";
+  } else {
     absl::MutexLock lock(&mutex_);
 
     ABSL_CHECK(!queue_.empty())
@@ -220,7 +406,9 @@ void SchedulerQueue::RunNextTask() {
   }
 
   bool is_idle;
-  {
+  if (node_buckets_) {
+    is_idle = num_active_items_.fetch_sub(1) == 1;
+  } else {
     absl::MutexLock lock(&mutex_);
     ABSL_DCHECK_GT(num_pending_tasks_, 0);
     --num_pending_tasks_;
@@ -232,6 +420,161 @@ void SchedulerQueue::RunNextTask() {
   }
 }
 
+void SchedulerQueue::RunStaticScheduleTask() {
+  CalculatorNode* node;
+  CalculatorContext* calculator_context;
+  bool is_open_node;
+  int next_id = 0;
+  bool allow_source = true;
+  while (PopStaticItem(allow_source, &next_id, &node, &calculator_context,
+                       &is_open_node)) {
+    ABSL_CHECK(!node->Closed())
+        << "Scheduled a node that was closed. This should not happen.";
+    if (!is_open_node) {
+      allow_source = false;
+    }
+    // See RunNextTask for the autorelease pool.
+    AUTORELEASEPOOL {
+      if (is_open_node) {
+        OpenCalculatorNode(node);
+      } else {
+        RunCalculatorNode(node, calculator_context);
+      }
+    }
+  }
+
+  bool is_idle = false;
+  bool submit_again = false;
+  {
+    absl::MutexLock lock(&mutex_);
+    ABSL_DCHECK_GT(num_pending_tasks_, 0);
+    if (queue_.empty() && num_static_ready_ == 0) {
+      static_task_active_ = false;
+      --num_pending_tasks_;
+      is_idle = IsIdle();
+    } else if (running_count_ > 0) {
+      // Nodes became ready behind the sweep. The task stays pending and is
+      // submitted again, which lets an application thread check its wait
+      // condition between sweeps.
+      submit_again = true;
+    } else {
+      --num_pending_tasks_;
+      ++num_tasks_to_add_;
+    }
+  }
+  if (submit_again) {
+    executor_->AddTask(this);
+  } else if (is_idle && idle_callback_) {
+    // Became idle.
+    idle_callback_(true);
+  }
+}
+
+bool SchedulerQueue::PopStaticItem(bool allow_source, int* next_id,
+                                   CalculatorNode** node,
+                                   CalculatorContext** cc,
+                                   bool* is_open_node) {
+  absl::MutexLock lock(&mutex_);
+  // OpenNode() runs before ProcessNode().
+  if (!queue_.empty() && queue_.top().IsOpenNode()) {
+    *node = queue_.top().Node();
+    *cc = queue_.top().Context();
+    *is_open_node = true;
+    queue_.pop();
+    return true;
+  }
+  const int num_nodes = static_nodes_.size();
+  while (*next_id < num_nodes) {
+    const int word = *next_id / 64;
+    const uint64_t bits =
+        static_ready_[word] & (~uint64_t{0} << (*next_id % 64));
+    if (bits == 0) {
+      *next_id = (word + 1) * 64;
+      continue;
+    }
+    const int id = word * 64 + absl::countr_zero(bits);
+    static_ready_[word] &= ~(uint64_t{1} << (id % 64));
+    --num_static_ready_;
+    *node = static_nodes_[id];
+    *cc = static_contexts_[id];
+    *is_open_node = false;
+    static_nodes_[id] = nullptr;
+    static_contexts_[id] = nullptr;
+    *next_id = id + 1;
+    return true;
+  }
+  // Non-sources run before sources. A source starts a task, and the sweep
+  // then runs the nodes that became ready downstream of it.
+  if (allow_source && !queue_.empty()) {
+    *node = queue_.top().Node();
+    *cc = queue_.top().Context();
+    *is_open_node = false;
+    queue_.pop();
+    *next_id = 0;
+    return true;
+  }
+  return false;
+}
+
+void SchedulerQueue::PopBucketedItem(CalculatorNode** node,
+                                     CalculatorContext** cc,
+                                     bool* is_open_node) {
+  if (TryPopBucketedItem(node, cc, is_open_node)) {
+    return;
+  }
+  // The item for this task was pushed before the task was submitted, so the
+  // pop only fails when another task took that item, and the item left for
+  // this task was pushed after the search passed it. Wait for pushes until
+  // the pop succeeds. A push that precedes the registration below is found
+  // by the retry that follows it.
+  ++num_pop_waiters_;
+  while (true) {
+    int64_t num_pushes;
+    {
+      absl::MutexLock lock(&mutex_);
+      num_pushes = num_bucketed_pushes_;
+    }
+    if (TryPopBucketedItem(node, cc, is_open_node)) {
+      break;
+    }
+    absl::MutexLock lock(&mutex_);
+    while (num_bucketed_pushes_ == num_pushes) {
+      item_pushed_.Wait(&mutex_);
+    }
+  }
+  --num_pop_waiters_;
+}
+
+bool SchedulerQueue::TryPopBucketedItem(CalculatorNode** node,
+                                        CalculatorContext** cc,
+                                        bool* is_open_node) {
+  // OpenNode() tasks run before non-sources, which run before sources.
+  if (num_queue_items_ > 0 &&
+      PopQueueTop(/*open_node_only=*/true, node, cc, is_open_node)) {
+    return true;
+  }
+  if (node_buckets_->PopHighestId(node, cc)) {
+    *is_open_node = false;
+    return true;
+  }
+  return num_queue_items_ > 0 &&
+         PopQueueTop(/*open_node_only=*/false, node, cc, is_open_node);
+}
+
+bool SchedulerQueue::PopQueueTop(bool open_node_only, CalculatorNode** node,
+                                 CalculatorContext** cc, bool* is_open_node) {
+  absl::MutexLock lock(&mutex_);
+  if (queue_.empty() || (open_node_only && !queue_.top().IsOpenNode())) {
+    return false;
+  }
+  *node = queue_.top().Node();
+  *cc = queue_.top().Context();
+  *is_open_node = queue_.top().IsOpenNode();
+  queue_.pop();
+  --num_queue_items_;
+  return true;
+}
+
 void SchedulerQueue::RunCalculatorNode(CalculatorNode* node,
                                        CalculatorContext* cc) {
   VLOG(3) << "Running " << node->DebugName() << " on queue (" << queue_name_
@@ -304,7 +647,34 @@ void SchedulerQueue::OpenCalculatorNode(CalculatorNode* node) {
 
 void SchedulerQueue::CleanupAfterRun() {
   bool was_idle;
-  {
+  if (static_schedule_) {
+    absl::MutexLock lock(&mutex_);
+    was_idle = IsIdle();
+    ABSL_CHECK_EQ(num_pending_tasks_, 0);
+    // The remaining items belong to a task that was never submitted.
+    ABSL_CHECK_EQ(num_tasks_to_add_, static_task_active_ ? 1 : 0);
+    num_tasks_to_add_ = 0;
+    while (!queue_.empty()) {
+      queue_.pop();
+    }
+    std::fill(static_nodes_.begin(), static_nodes_.end(), nullptr);
+    std::fill(static_contexts_.begin(), static_contexts_.end(), nullptr);
+    std::fill(static_ready_.begin(), static_ready_.end(), 0);
+    num_static_ready_ = 0;
+    static_task_active_ = false;
+  } else if (node_buckets_) {
+    absl::MutexLock lock(&mutex_);
+    was_idle = num_active_items_ == 0;
+    // Every remaining item belongs to a task that was never submitted.
+    ABSL_CHECK_EQ(num_tasks_to_add_, num_active_items_);
+    num_tasks_to_add_ = 0;
+    while (!queue_.empty()) {
+      queue_.pop();
+    }
+    num_queue_items_ = 0;
+    node_buckets_->Clear();
+    num_active_items_ = 0;
+  } else {
     absl::MutexLock lock(&mutex_);
     was_idle = IsIdle();
     ABSL_CHECK_EQ(num_pending_tasks_, 0);
@@ -15,11 +15,15 @@
 #ifndef MEDIAPIPE_FRAMEWORK_SCHEDULER_QUEUE_H_
 #define MEDIAPIPE_FRAMEWORK_SCHEDULER_QUEUE_H_
 
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <queue>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
@@ -34,6 +38,43 @@ class CalculatorNode;
 
 namespace internal {
 
+// A concurrent collection of ready-to-run (node, calculator context) pairs,
+// bucketed by node id. Every bucket has its own mutex, and a bitmap of
+// non-empty buckets lets PopHighestId() find the highest-priority non-source
+// node without a lock shared by all nodes. Within a bucket, contexts are
+// returned in FIFO order.
+class NodeBucketQueue {
+ public:
+  // "num_nodes" must be greater than every node id pushed to the queue.
+  explicit NodeBucketQueue(int num_nodes);
+
+  int num_nodes() const { return num_nodes_; }
+
+  void Push(int node_id, CalculatorNode* node, CalculatorContext* cc);
+
+  // Removes an entry of the non-empty bucket with the highest node id. Returns
+  // false if no bucket was found to be non-empty.
+  bool PopHighestId(CalculatorNode** node, CalculatorContext** cc);
+
+  // Removes all entries. Must not be called concurrently with Push() or
+  // PopHighestId().
+  void Clear();
+
+ private:
+  struct Bucket {
+    absl::Mutex mutex;
+    std::deque<std::pair<CalculatorNode*, CalculatorContext*>> entries
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  const int num_nodes_;
+  const int num_words_;
+  std::unique_ptr<Bucket[]> buckets_;
+  // Bit (id % 64) of word (id / 64) is set iff bucket id is non-empty. A bit
+  // is only modified while holding the corresponding bucket's mutex.
+  std::unique_ptr<std::atomic<uint64_t>[]> non_empty_;
+};
+
 // Manages a priority queue of nodes to be run on the associated executor.
 class SchedulerQueue : public TaskQueue {
  public:
@@ -55,6 +96,10 @@ class SchedulerQueue : public TaskQueue {
 
     bool IsOpenNode() const { return is_open_node_; }
 
+    bool IsSource() const { return is_source_; }
+
+    int Id() const { return id_; }
+
     // This comparison is meant to be used with a std::priority_queue. Since
     // the priority queue returns higher priority items first, this function
     // means "this is lower priority than that", i.e. "this runs after that".
@@ -97,6 +142,25 @@ class SchedulerQueue : public TaskQueue {
     idle_callback_ = std::move(callback);
   }
 
+  // Keeps ready non-source nodes in a NodeBucketQueue instead of queue_, so
+  // that adding and running them does not take mutex_. OpenNode() tasks and
+  // sources still go through queue_. The ordering rules of Item::operator<
+  // are preserved. "num_nodes" must be greater than the id of every node
+  // assigned to this queue. Must be called before the scheduler is started.
+  void EnableNodeBuckets(int num_nodes);
+
+  // Runs ready non-source nodes in a fixed order instead of submitting one
+  // executor task per node. A single task at a time is submitted to the
+  // executor. It runs pending OpenNode() calls, then sweeps the non-source
+  // nodes once in increasing id order, running each node that is ready when
+  // the sweep reaches it. Since node ids follow the topological order of the
+  // graph, one sweep moves a timestamp from the sources to the sinks. Sources
+  // run in tasks of their own, when no non-source node is ready. Nodes must
+  // use max_in_flight 1. "num_nodes" must be greater than the id of every
+  // node assigned to this queue. Must be called before the scheduler is
+  // started. Takes precedence over EnableNodeBuckets.
+  void EnableStaticSchedule(int num_nodes);
+
   // Resets the data members at the beginning of each graph run.
   void Reset();
 
@@ -146,6 +210,39 @@ class SchedulerQueue : public TaskQueue {
   // Checks whether the queue has no queued nodes or pending tasks.
   bool IsIdle() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Used by AddItemToQueue when node buckets are enabled.
+  void AddBucketedItem(Item&& item) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Used by AddItemToQueue when the static schedule is enabled.
+  void AddStaticItem(Item&& item) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Used by RunNextTask when the static schedule is enabled. Runs one sweep.
+  void RunStaticScheduleTask() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Pops the next item of the sweep that has reached node id "*next_id".
+  // When "allow_source" is true and no non-source node is ready, pops a
+  // source and restarts the sweep. Returns false when the sweep is complete.
+  bool PopStaticItem(bool allow_source, int* next_id, CalculatorNode** node,
+                     CalculatorContext** cc, bool* is_open_node)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Used by RunNextTask when node buckets are enabled. Pops the highest
+  // priority item from queue_ and node_buckets_, waiting for a concurrent
+  // AddBucketedItem if needed.
+  void PopBucketedItem(CalculatorNode** node, CalculatorContext** cc,
+                       bool* is_open_node) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Pops the highest priority item from queue_ and node_buckets_. Returns
+  // false if no item was found.
+  bool TryPopBucketedItem(CalculatorNode** node, CalculatorContext** cc,
+                          bool* is_open_node) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Pops the top of queue_ if it is non-empty and, when "open_node_only" is
+  // true, the top item is an OpenNode() task.
+  bool PopQueueTop(bool open_node_only, CalculatorNode** node,
+                   CalculatorContext** cc, bool* is_open_node)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   // Queue name for logging purposes.
   const std::string queue_name_;
 
@@ -169,6 +266,37 @@ class SchedulerQueue : public TaskQueue {
   // Queue of nodes that need to be run.
   std::priority_queue<Item> queue_ ABSL_GUARDED_BY(mutex_);
 
+  // The following are only used if static_schedule_ is true.
+  bool static_schedule_ = false;
+  // Ready non-source nodes and their contexts, indexed by node id.
+  std::vector<CalculatorNode*> static_nodes_ ABSL_GUARDED_BY(mutex_);
+  std::vector<CalculatorContext*> static_contexts_ ABSL_GUARDED_BY(mutex_);
+  // Bit (id % 64) of word (id / 64) is set iff node id is ready.
+  std::vector<uint64_t> static_ready_ ABSL_GUARDED_BY(mutex_);
+  int num_static_ready_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Whether a task has been submitted, or is waiting to be submitted, that
+  // has not completed its sweep yet.
+  bool static_task_active_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Ready non-source nodes, if EnableNodeBuckets was called.
+  std::unique_ptr<NodeBucketQueue> node_buckets_;
+
+  // The following are only used if node_buckets_ is set.
+  // Number of items added and whose task has not completed. The queue is idle
+  // iff this is 0.
+  std::atomic<int> num_active_items_{0};
+  // Number of items in queue_.
+  std::atomic<int> num_queue_items_{0};
+  // Whether running_count_ > 0. Written under mutex_, and read without it by
+  // AddBucketedItem.
+  std::atomic<bool> running_{false};
+  // Number of tasks waiting in PopBucketedItem for an item to be pushed.
+  std::atomic<int> num_pop_waiters_{0};
+  // Number of items pushed while num_pop_waiters_ > 0.
+  int64_t num_bucketed_pushes_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Signaled when num_bucketed_pushes_ is incremented.
+  absl::CondVar item_pushed_;
+
   SchedulerShared* const shared_;
 
   absl::Mutex mutex_;
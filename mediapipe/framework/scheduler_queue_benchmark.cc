@@ -0,0 +1,92 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmark for the scheduler queue: drives a chain of 50 pass-through nodes
+// with the default priority queue, with node buckets
+// (CalculatorGraphConfig.use_node_bucket_scheduler_queue) and with the static
+// schedule (CalculatorGraphConfig.use_static_schedule). num_threads 0 runs the
+// graph on the application thread with the ApplicationThreadExecutor.
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/calculator_framework.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr int kNumNodes = 50;
+constexpr int kNumPackets = 1000;
+
+enum class QueueType { kPriorityQueue, kNodeBuckets, kStaticSchedule };
+
+CalculatorGraphConfig PassThroughChainConfig(int num_threads,
+                                             QueueType queue_type) {
+  CalculatorGraphConfig config;
+  config.add_input_stream("stream_0");
+  if (num_threads == 0) {
+    config.add_executor()->set_type("ApplicationThreadExecutor");
+  } else {
+    config.set_num_threads(num_threads);
+  }
+  config.set_use_node_bucket_scheduler_queue(queue_type ==
+                                             QueueType::kNodeBuckets);
+  config.set_use_static_schedule(queue_type == QueueType::kStaticSchedule);
+  for (int i = 0; i < kNumNodes; ++i) {
+    auto* node = config.add_node();
+    node->set_calculator("PassThroughCalculator");
+    node->add_input_stream(absl::StrCat("stream_", i));
+    node->add_output_stream(absl::StrCat("stream_", i + 1));
+  }
+  return config;
+}
+
+void BM_PassThroughChain(benchmark::State& state, QueueType queue_type) {
+  const CalculatorGraphConfig config =
+      PassThroughChainConfig(state.range(0), queue_type);
+  CalculatorGraph graph;
+  ABSL_CHECK_OK(graph.Initialize(config));
+  for (auto _ : state) {
+    ABSL_CHECK_OK(graph.StartRun({}));
+    for (int i = 0; i < kNumPackets; ++i) {
+      ABSL_CHECK_OK(graph.AddPacketToInputStream(
+          "stream_0", MakePacket<int>(i).At(Timestamp(i))));
+    }
+    ABSL_CHECK_OK(graph.CloseAllInputStreams());
+    ABSL_CHECK_OK(graph.WaitUntilDone());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPackets * kNumNodes);
+}
+
+BENCHMARK_CAPTURE(BM_PassThroughChain, PriorityQueue,
+                  QueueType::kPriorityQueue)
+    ->Arg(0)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PassThroughChain, NodeBuckets, QueueType::kNodeBuckets)
+    ->Arg(0)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+// The static schedule only applies to single-threaded graphs.
+BENCHMARK_CAPTURE(BM_PassThroughChain, StaticSchedule,
+                  QueueType::kStaticSchedule)
+    ->Arg(0)
+    ->Arg(1)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
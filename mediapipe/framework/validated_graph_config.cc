@@ -17,6 +17,8 @@
 #include <memory>
 #include <string>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -24,7 +26,9 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_base.h"
 #include "mediapipe/framework/graph_service_manager.h"
@@ -144,6 +148,73 @@ absl::Status AddPredefinedExecutorConfigs(CalculatorGraphConfig* graph_config) {
   return absl::OkStatus();
 }
 
+// The maximum number of expanded configs kept by ExpandedConfigCache.
+constexpr int kMaxExpandedConfigs = 256;
+
+// Process-wide cache of expanded configs, for
+// CalculatorGraphConfig::cache_expanded_config.
+class ExpandedConfigCache {
+ public:
+  static ExpandedConfigCache& Get() {
+    static ExpandedConfigCache* cache = new ExpandedConfigCache();
+    return *cache;
+  }
+
+  std::shared_ptr<const CalculatorGraphConfig> Lookup(const std::string& key)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    auto iter = configs_.find(key);
+    return iter == configs_.end() ? nullptr : iter->second;
+  }
+
+  // Once the cache is full, further configs are not cached.
+  void Insert(std::string key,
+              std::shared_ptr<const CalculatorGraphConfig> config)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    if (configs_.size() < kMaxExpandedConfigs) {
+      configs_.emplace(std::move(key), std::move(config));
+    }
+  }
+
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    configs_.clear();
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::shared_ptr<const CalculatorGraphConfig>>
+      configs_ ABSL_GUARDED_BY(mutex_);
+};
+
+void AppendKeyPart(absl::string_view part, std::string* key) {
+  absl::StrAppend(key, part.size(), ":", part);
+}
+
+// Returns the ExpandedConfigCache key for expanding input_config. Every input
+// of the expansion is serialized into the key, so that equal keys imply equal
+// expansions. Since proto serialization is not guaranteed to be canonical,
+// equal inputs may occasionally map to different keys, which only costs a
+// cache miss.
+std::string ExpandedConfigCacheKey(
+    const CalculatorGraphConfig& input_config,
+    const Subgraph::SubgraphOptions* graph_options,
+    const GraphServiceManager* service_manager) {
+  std::string key;
+  AppendKeyPart(input_config.SerializeAsString(), &key);
+  AppendKeyPart(graph_options ? graph_options->SerializeAsString() : "", &key);
+  if (service_manager) {
+    for (const auto& [service_key, packet] :
+         service_manager->ServicePackets()) {
+      if (!packet.IsEmpty()) {
+        AppendKeyPart(service_key, &key);
+      }
+    }
+  }
+  return key;
+}
+
 }  // namespace
 
 // static
@@ -334,9 +405,31 @@ absl::Status ValidatedGraphConfig::Initialize(
                      input_config.DebugString()));
   }
 
-  config_ = std::move(input_config);
-  MP_RETURN_IF_ERROR(
-      PerformBasicTransforms(graph_registry, graph_options, service_manager));
+  // Expansions with a local graph registry depend on its contents, and are
+  // not cached.
+  std::string cache_key;
+  if (input_config.cache_expanded_config() &&
+      (graph_registry == nullptr ||
+       graph_registry == &GraphRegistry::global_graph_registry)) {
+    cache_key =
+        ExpandedConfigCacheKey(input_config, graph_options, service_manager);
+  }
+  std::shared_ptr<const CalculatorGraphConfig> expanded_config;
+  if (!cache_key.empty()) {
+    expanded_config = ExpandedConfigCache::Get().Lookup(cache_key);
+  }
+  const bool cache_hit = expanded_config != nullptr;
+  if (cache_hit) {
+    VLOG(2) << "Using cached expanded config.";
+    config_ = *expanded_config;
+  } else {
+    config_ = std::move(input_config);
+    MP_RETURN_IF_ERROR(
+        PerformBasicTransforms(graph_registry, graph_options, service_manager));
+    if (!cache_key.empty()) {
+      expanded_config = std::make_shared<const CalculatorGraphConfig>(config_);
+    }
+  }
   // Initialize the basic node information.
   MP_RETURN_IF_ERROR(InitializeGeneratorInfo());
   MP_RETURN_IF_ERROR(InitializeCalculatorInfo());
@@ -411,10 +504,21 @@ absl::Status ValidatedGraphConfig::Initialize(
                      config_.DebugString()));
   }
 
+  // Only expansions of valid configs are cached.
+  if (expanded_config && !cache_hit) {
+    ExpandedConfigCache::Get().Insert(std::move(cache_key),
+                                      std::move(expanded_config));
+  }
+
   initialized_ = true;
   return absl::OkStatus();
 }
 
+// static
+void ValidatedGraphConfig::ClearExpandedConfigCache() {
+  ExpandedConfigCache::Get().Clear();
+}
+
 absl::Status ValidatedGraphConfig::Initialize(
     const std::string& graph_type, const GraphRegistry* graph_registry,
     const Subgraph::SubgraphOptions* graph_options,
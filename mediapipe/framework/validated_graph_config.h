@@ -235,6 +235,10 @@ class ValidatedGraphConfig {
   // Returns true if the ValidatedGraphConfig has been initialized.
   bool Initialized() const { return initialized_; }
 
+  // Removes all expanded configs cached for
+  // CalculatorGraphConfig::cache_expanded_config.
+  static void ClearExpandedConfigCache();
+
   // Returns an error if the provided side packets will be generated by
   // the PacketGenerators in this graph.
   template <typename T>
@@ -0,0 +1,128 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmark for graph startup, broken into phases: subgraph expansion,
+// validation of an expanded config, ValidatedGraphConfig::Initialize, which
+// runs both, and CalculatorGraph::Initialize. The last two are measured with
+// (state.range(0) == 1) and without
+// CalculatorGraphConfig.cache_expanded_config.
+// The graph has 8 blocks of 4 chains of 8 pass-through nodes.
+#include <string>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/subgraph.h"
+#include "mediapipe/framework/tool/subgraph_expansion.h"
+#include "mediapipe/framework/validated_graph_config.h"
+
+namespace mediapipe {
+namespace {
+
+// Returns a chain of "length" nodes of type "calculator". Subgraph nodes are
+// connected through the tags IN and OUT.
+CalculatorGraphConfig ChainConfig(const std::string& calculator, int length,
+                                  bool is_subgraph) {
+  const std::string in_tag = is_subgraph ? "IN:" : "";
+  const std::string out_tag = is_subgraph ? "OUT:" : "";
+  CalculatorGraphConfig config;
+  for (int i = 0; i < length; ++i) {
+    auto* node = config.add_node();
+    node->set_calculator(calculator);
+    node->add_input_stream(absl::StrCat(in_tag, "stream_", i));
+    node->add_output_stream(absl::StrCat(out_tag, "stream_", i + 1));
+  }
+  return config;
+}
+
+class StartupChainSubgraph : public Subgraph {
+ public:
+  absl::StatusOr<CalculatorGraphConfig> GetConfig(
+      const SubgraphOptions& options) override {
+    CalculatorGraphConfig config =
+        ChainConfig("PassThroughCalculator", 8, /*is_subgraph=*/false);
+    config.add_input_stream("IN:stream_0");
+    config.add_output_stream("OUT:stream_8");
+    return config;
+  }
+};
+REGISTER_MEDIAPIPE_GRAPH(StartupChainSubgraph);
+
+class StartupBlockSubgraph : public Subgraph {
+ public:
+  absl::StatusOr<CalculatorGraphConfig> GetConfig(
+      const SubgraphOptions& options) override {
+    CalculatorGraphConfig config =
+        ChainConfig("StartupChainSubgraph", 4, /*is_subgraph=*/true);
+    config.add_input_stream("IN:stream_0");
+    config.add_output_stream("OUT:stream_4");
+    return config;
+  }
+};
+REGISTER_MEDIAPIPE_GRAPH(StartupBlockSubgraph);
+
+CalculatorGraphConfig StartupGraphConfig(bool cache_expanded_config) {
+  CalculatorGraphConfig config =
+      ChainConfig("StartupBlockSubgraph", 8, /*is_subgraph=*/true);
+  config.add_input_stream("stream_0");
+  config.set_cache_expanded_config(cache_expanded_config);
+  return config;
+}
+
+void BM_ExpandSubgraphs(benchmark::State& state) {
+  const CalculatorGraphConfig input_config = StartupGraphConfig(false);
+  for (auto _ : state) {
+    CalculatorGraphConfig config = input_config;
+    ABSL_CHECK_OK(tool::ExpandSubgraphs(&config));
+    benchmark::DoNotOptimize(config);
+  }
+}
+BENCHMARK(BM_ExpandSubgraphs);
+
+void BM_ValidateExpandedConfig(benchmark::State& state) {
+  CalculatorGraphConfig expanded_config = StartupGraphConfig(false);
+  ABSL_CHECK_OK(tool::ExpandSubgraphs(&expanded_config));
+  for (auto _ : state) {
+    ValidatedGraphConfig validated_graph;
+    ABSL_CHECK_OK(validated_graph.Initialize(expanded_config));
+  }
+}
+BENCHMARK(BM_ValidateExpandedConfig);
+
+void BM_ValidatedGraphConfigInitialize(benchmark::State& state) {
+  ValidatedGraphConfig::ClearExpandedConfigCache();
+  const CalculatorGraphConfig config = StartupGraphConfig(state.range(0));
+  for (auto _ : state) {
+    ValidatedGraphConfig validated_graph;
+    ABSL_CHECK_OK(validated_graph.Initialize(config));
+  }
+}
+BENCHMARK(BM_ValidatedGraphConfigInitialize)->Arg(0)->Arg(1);
+
+void BM_CalculatorGraphInitialize(benchmark::State& state) {
+  ValidatedGraphConfig::ClearExpandedConfigCache();
+  const CalculatorGraphConfig config = StartupGraphConfig(state.range(0));
+  for (auto _ : state) {
+    CalculatorGraph graph;
+    ABSL_CHECK_OK(graph.Initialize(config));
+  }
+}
+BENCHMARK(BM_CalculatorGraphInitialize)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
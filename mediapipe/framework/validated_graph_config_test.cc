@@ -164,4 +164,95 @@ TEST(ValidatedGraphConfigTest, InitializeSubgraphWithServiceCalculatorB) {
   }
 }
 
+// Counts how often it is expanded.
+class CountingSubgraph : public Subgraph {
+ public:
+  absl::StatusOr<CalculatorGraphConfig> GetConfig(
+      const SubgraphOptions& options) override {
+    ++num_expansions;
+    return ExpectedConfig("CalculatorA");
+  }
+
+  static int num_expansions;
+};
+int CountingSubgraph::num_expansions = 0;
+REGISTER_MEDIAPIPE_GRAPH(CountingSubgraph);
+
+CalculatorGraphConfig CountingSubgraphGraph(bool cache_expanded_config) {
+  CalculatorGraphConfig graph;
+  graph.add_node()->set_calculator("CountingSubgraph");
+  graph.set_cache_expanded_config(cache_expanded_config);
+  return graph;
+}
+
+TEST(ValidatedGraphConfigTest, CachesExpandedConfig) {
+  ValidatedGraphConfig::ClearExpandedConfigCache();
+  CountingSubgraph::num_expansions = 0;
+  ValidatedGraphConfig first;
+  MP_ASSERT_OK(first.Initialize(CountingSubgraphGraph(true)));
+  ValidatedGraphConfig second;
+  MP_ASSERT_OK(second.Initialize(CountingSubgraphGraph(true)));
+  EXPECT_EQ(CountingSubgraph::num_expansions, 1);
+  EXPECT_THAT(second.Config(), EqualsProto(first.Config()));
+  EXPECT_EQ(second.CalculatorInfos().size(), 1);
+
+  ValidatedGraphConfig::ClearExpandedConfigCache();
+  ValidatedGraphConfig third;
+  MP_ASSERT_OK(third.Initialize(CountingSubgraphGraph(true)));
+  EXPECT_EQ(CountingSubgraph::num_expansions, 2);
+}
+
+TEST(ValidatedGraphConfigTest, DoesNotCacheExpandedConfigByDefault) {
+  ValidatedGraphConfig::ClearExpandedConfigCache();
+  CountingSubgraph::num_expansions = 0;
+  for (int i = 0; i < 2; ++i) {
+    ValidatedGraphConfig config;
+    MP_ASSERT_OK(config.Initialize(CountingSubgraphGraph(false)));
+  }
+  EXPECT_EQ(CountingSubgraph::num_expansions, 2);
+}
+
+TEST(ValidatedGraphConfigTest, CachesExpandedConfigPerGraphOptions) {
+  ValidatedGraphConfig::ClearExpandedConfigCache();
+  CountingSubgraph::num_expansions = 0;
+  for (const std::string& name : {"a", "b", "a"}) {
+    Subgraph::SubgraphOptions graph_options;
+    graph_options.set_name(name);
+    ValidatedGraphConfig config;
+    MP_ASSERT_OK(config.Initialize(CountingSubgraphGraph(true),
+                                   /*graph_registry=*/nullptr,
+                                   &graph_options));
+  }
+  EXPECT_EQ(CountingSubgraph::num_expansions, 2);
+}
+
+TEST(ValidatedGraphConfigTest, CachesExpandedConfigPerServices) {
+  ValidatedGraphConfig::ClearExpandedConfigCache();
+  CountingSubgraph::num_expansions = 0;
+  GraphServiceManager service_manager;
+  ValidatedGraphConfig first;
+  MP_ASSERT_OK(first.Initialize(CountingSubgraphGraph(true),
+                                /*graph_registry=*/nullptr,
+                                /*graph_options=*/nullptr, &service_manager));
+  MP_ASSERT_OK(service_manager.SetServiceObject(
+      kStringTestService, std::make_shared<std::string>("CalculatorA")));
+  ValidatedGraphConfig second;
+  MP_ASSERT_OK(second.Initialize(CountingSubgraphGraph(true),
+                                 /*graph_registry=*/nullptr,
+                                 /*graph_options=*/nullptr, &service_manager));
+  EXPECT_EQ(CountingSubgraph::num_expansions, 2);
+}
+
+TEST(ValidatedGraphConfigTest, DoesNotCacheInvalidConfig) {
+  ValidatedGraphConfig::ClearExpandedConfigCache();
+  CountingSubgraph::num_expansions = 0;
+  CalculatorGraphConfig graph = CountingSubgraphGraph(true);
+  graph.add_node()->set_calculator("UnknownCalculator");
+  for (int i = 0; i < 2; ++i) {
+    ValidatedGraphConfig config;
+    EXPECT_FALSE(config.Initialize(graph).ok());
+  }
+  EXPECT_EQ(CountingSubgraph::num_expansions, 2);
+}
+
 }  // namespace mediapipe
@@ -0,0 +1,235 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/work_stealing_executor.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#endif  // __linux__
+
+#include <set>
+#include <utility>
+
+#include "absl/log/absl_log.h"
+#include "mediapipe/framework/port/canonical_errors.h"
+#include "mediapipe/framework/port/logging.h"
+#include "mediapipe/framework/port/status_builder.h"
+#include "mediapipe/framework/thread_pool_executor.pb.h"
+#include "mediapipe/framework/work_stealing_executor.pb.h"
+#include "mediapipe/util/cpu_util.h"
+
+namespace mediapipe {
+
+namespace {
+
+// The executor and worker index of the current thread, if the current thread
+// is a WorkStealingExecutor worker.
+thread_local const WorkStealingExecutor* current_executor = nullptr;
+thread_local int current_worker_index = -1;
+
+}  // namespace
+
+// static
+absl::StatusOr<Executor*> WorkStealingExecutor::Create(
+    const MediaPipeOptions& extendable_options) {
+  auto& options =
+      extendable_options.GetExtension(WorkStealingExecutorOptions::ext);
+  if (!options.has_num_threads()) {
+    return absl::InvalidArgumentError(
+        "num_threads is not specified in WorkStealingExecutorOptions.");
+  }
+  if (options.num_threads() <= 0) {
+    return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+           << "The num_threads field in WorkStealingExecutorOptions should be "
+              "positive but is "
+           << options.num_threads();
+  }
+
+  ThreadOptions thread_options;
+  if (options.has_stack_size()) {
+    if (options.stack_size() <= 0) {
+      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+             << "The stack_size field in WorkStealingExecutorOptions should "
+                "be positive but is "
+             << options.stack_size();
+    }
+    thread_options.set_stack_size(options.stack_size());
+  }
+  if (options.has_nice_priority_level()) {
+    thread_options.set_nice_priority_level(options.nice_priority_level());
+  }
+  if (options.has_thread_name_prefix()) {
+    thread_options.set_name_prefix(options.thread_name_prefix());
+  }
+  std::vector<int> core_ids;
+#if defined(__linux__)
+  std::set<int> cpu_set;
+  switch (options.require_processor_performance()) {
+    case ThreadPoolExecutorOptions::LOW:
+      cpu_set = InferLowerCoreIds();
+      break;
+    case ThreadPoolExecutorOptions::HIGH:
+      cpu_set = InferHigherCoreIds();
+      break;
+    default:
+      break;
+  }
+  if (options.pin_threads_to_cores()) {
+    if (cpu_set.empty()) {
+      for (int i = 0; i < NumCPUCores(); ++i) {
+        cpu_set.insert(i);
+      }
+    }
+    core_ids.assign(cpu_set.begin(), cpu_set.end());
+  } else {
+    thread_options.set_cpu_set(cpu_set);
+  }
+#endif  // __linux__
+  return new WorkStealingExecutor(thread_options, options.num_threads(),
+                                  std::move(core_ids));
+}
+
+WorkStealingExecutor::WorkStealingExecutor(int num_threads)
+    : WorkStealingExecutor(ThreadOptions(), num_threads, {}) {}
+
+WorkStealingExecutor::WorkStealingExecutor(const ThreadOptions& thread_options,
+                                           int num_threads,
+                                           std::vector<int> core_ids)
+    : core_ids_(std::move(core_ids)),
+      thread_pool_(thread_options,
+                   thread_options.name_prefix().empty()
+                       ? "mediapipe"
+                       : thread_options.name_prefix(),
+                   num_threads) {
+  for (int i = 0; i < thread_pool_.num_threads(); ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  Start();
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  VLOG(2) << "Terminating work stealing executor.";
+  absl::MutexLock lock(&sleep_mutex_);
+  stopped_ = true;
+  sleep_condition_.SignalAll();
+}
+
+void WorkStealingExecutor::Schedule(std::function<void()> task) {
+  int index;
+  if (current_executor == this) {
+    index = current_worker_index;
+  } else {
+    index = next_worker_.fetch_add(1, std::memory_order_relaxed) %
+            workers_.size();
+  }
+  Worker& worker = *workers_[index];
+  {
+    absl::MutexLock lock(&worker.mutex);
+    worker.tasks.push_back(std::move(task));
+  }
+  // The increment of num_pending_tasks_ and the load of num_sleeping_workers_
+  // pair with the opposite operations in WaitForTask(), so either the waiting
+  // worker observes the new task or this thread observes the waiting worker.
+  num_pending_tasks_.fetch_add(1);
+  if (num_sleeping_workers_.load() > 0) {
+    absl::MutexLock lock(&sleep_mutex_);
+    sleep_condition_.Signal();
+  }
+}
+
+void WorkStealingExecutor::Start() {
+  thread_pool_.StartWorkers();
+  // Every pool thread picks up exactly one worker loop, because a worker loop
+  // only returns once the executor is stopped.
+  for (int i = 0; i < workers_.size(); ++i) {
+    thread_pool_.Schedule([this, i] { RunWorker(i); });
+  }
+  VLOG(2) << "Started work stealing executor with " << workers_.size()
+          << " threads.";
+}
+
+void WorkStealingExecutor::RunWorker(int index) {
+  current_executor = this;
+  current_worker_index = index;
+#if defined(__linux__)
+  if (!core_ids_.empty()) {
+    const int core_id = core_ids_[index % core_ids_.size()];
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core_id, &cpu_set);
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set) != 0) {
+      ABSL_LOG(ERROR) << "Error : " << strerror(errno) << std::endl
+                      << "Failed to pin worker " << index << " to processor "
+                      << core_id << ".";
+    }
+  }
+#endif  // __linux__
+  std::function<void()> task;
+  while (true) {
+    if (PopLocalTask(index, &task) || StealTask(index, &task)) {
+      task();
+      task = nullptr;
+    } else if (!WaitForTask()) {
+      break;
+    }
+  }
+  current_executor = nullptr;
+  current_worker_index = -1;
+}
+
+bool WorkStealingExecutor::PopLocalTask(int index,
+                                        std::function<void()>* task) {
+  Worker& worker = *workers_[index];
+  absl::MutexLock lock(&worker.mutex);
+  if (worker.tasks.empty()) {
+    return false;
+  }
+  *task = std::move(worker.tasks.back());
+  worker.tasks.pop_back();
+  num_pending_tasks_.fetch_sub(1);
+  return true;
+}
+
+bool WorkStealingExecutor::StealTask(int index, std::function<void()>* task) {
+  const int num_workers = workers_.size();
+  for (int i = 1; i < num_workers; ++i) {
+    Worker& victim = *workers_[(index + i) % num_workers];
+    absl::MutexLock lock(&victim.mutex);
+    if (victim.tasks.empty()) {
+      continue;
+    }
+    *task = std::move(victim.tasks.front());
+    victim.tasks.pop_front();
+    num_pending_tasks_.fetch_sub(1);
+    return true;
+  }
+  return false;
+}
+
+bool WorkStealingExecutor::WaitForTask() {
+  absl::MutexLock lock(&sleep_mutex_);
+  num_sleeping_workers_.fetch_add(1);
+  while (num_pending_tasks_.load() <= 0 && !stopped_) {
+    sleep_condition_.Wait(&sleep_mutex_);
+  }
+  num_sleeping_workers_.fetch_sub(1);
+  // Pending tasks are drained before the workers exit.
+  return num_pending_tasks_.load() > 0 || !stopped_;
+}
+
+REGISTER_EXECUTOR(WorkStealingExecutor);
+
+}  // namespace mediapipe
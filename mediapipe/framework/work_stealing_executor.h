@@ -0,0 +1,107 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_WORK_STEALING_EXECUTOR_H_
+#define MEDIAPIPE_FRAMEWORK_WORK_STEALING_EXECUTOR_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/deps/thread_options.h"
+#include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/port/statusor.h"
+#include "mediapipe/framework/port/threadpool.h"
+
+namespace mediapipe {
+
+// A multithreaded executor in which every worker thread owns a task deque.
+//
+// Tasks scheduled from one of the executor's own worker threads are pushed
+// onto that worker's deque, and tasks scheduled from any other thread are
+// distributed round-robin across the workers. A worker pops from the back of
+// its own deque and, when it runs dry, steals from the front of the other
+// workers' deques. Unlike ThreadPoolExecutor, there is no single lock shared
+// by every Schedule() call, which reduces contention when many graphs share
+// a machine with many cores.
+//
+// Tasks are not run in FIFO order, even with a single worker. MediaPipe's
+// scheduler does not depend on task order because every task it schedules
+// picks the highest priority ready node at the time it runs.
+class WorkStealingExecutor : public Executor {
+ public:
+  static absl::StatusOr<Executor*> Create(
+      const MediaPipeOptions& extendable_options);
+
+  explicit WorkStealingExecutor(int num_threads);
+  ~WorkStealingExecutor() override;
+  void Schedule(std::function<void()> task) override;
+
+  // For testing.
+  int num_threads() const { return workers_.size(); }
+
+ private:
+  // Per-worker task deque.
+  struct Worker {
+    absl::Mutex mutex;
+    std::deque<std::function<void()>> tasks ABSL_GUARDED_BY(mutex);
+  };
+
+  // If "core_ids" is non-empty, worker i is pinned to
+  // core_ids[i % core_ids.size()].
+  WorkStealingExecutor(const ThreadOptions& thread_options, int num_threads,
+                       std::vector<int> core_ids);
+
+  // Starts the worker threads.
+  void Start();
+
+  // The main loop of worker "index".
+  void RunWorker(int index);
+
+  // Pops a task from the back of the deque of worker "index".
+  bool PopLocalTask(int index, std::function<void()>* task);
+
+  // Steals a task from the front of the deque of a worker other than "index".
+  bool StealTask(int index, std::function<void()>* task);
+
+  // Blocks the calling worker until a task is scheduled or the executor is
+  // stopped. Returns false if the worker should exit.
+  bool WaitForTask();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<int> core_ids_;
+
+  // Number of tasks pushed onto the deques that have not been popped yet.
+  std::atomic<int> num_pending_tasks_{0};
+  // Number of workers blocked in WaitForTask().
+  std::atomic<int> num_sleeping_workers_{0};
+  // Round-robin cursor for tasks scheduled from outside the executor.
+  std::atomic<unsigned int> next_worker_{0};
+
+  absl::Mutex sleep_mutex_;
+  absl::CondVar sleep_condition_;
+  bool stopped_ ABSL_GUARDED_BY(sleep_mutex_) = false;
+
+  // Declared last so that the worker threads are joined before the deques
+  // are destroyed.
+  mediapipe::ThreadPool thread_pool_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_WORK_STEALING_EXECUTOR_H_
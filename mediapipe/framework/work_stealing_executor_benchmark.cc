@@ -0,0 +1,151 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Scaling benchmark comparing WorkStealingExecutor with ThreadPoolExecutor.
+//
+// BM_*_ScheduleFromWorkers mimics many graphs sharing one executor: every
+// task schedules a follow-up task from a worker thread, the pattern produced
+// by the MediaPipe scheduler when a node's output makes downstream nodes
+// ready. BM_*_ScheduleFromOutside schedules all tasks from the benchmark
+// thread. Both are run with 1 to 32 threads.
+#include <memory>
+#include <string>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+#include "mediapipe/framework/thread_pool_executor.pb.h"
+#include "mediapipe/framework/work_stealing_executor.h"
+#include "mediapipe/framework/work_stealing_executor.pb.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr int kNumChains = 256;
+constexpr int kChainLength = 64;
+
+// Runs a chain of "remaining" tasks, each of which schedules the next one.
+void RunChain(Executor* executor, int remaining, absl::BlockingCounter* done) {
+  benchmark::DoNotOptimize(remaining);
+  if (remaining == 0) {
+    done->DecrementCount();
+    return;
+  }
+  executor->Schedule(
+      [executor, remaining, done] { RunChain(executor, remaining - 1, done); });
+}
+
+template <typename ExecutorType>
+void BM_ScheduleFromWorkers(benchmark::State& state) {
+  ExecutorType executor(state.range(0));
+  for (auto _ : state) {
+    absl::BlockingCounter done(kNumChains);
+    for (int i = 0; i < kNumChains; ++i) {
+      executor.Schedule([&executor, &done] {
+        RunChain(&executor, kChainLength, &done);
+      });
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kNumChains * kChainLength);
+}
+
+template <typename ExecutorType>
+void BM_ScheduleFromOutside(benchmark::State& state) {
+  constexpr int kNumTasks = kNumChains * kChainLength;
+  ExecutorType executor(state.range(0));
+  for (auto _ : state) {
+    absl::BlockingCounter done(kNumTasks);
+    for (int i = 0; i < kNumTasks; ++i) {
+      executor.Schedule([&done] { done.DecrementCount(); });
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kNumTasks);
+}
+
+// Runs a 20-node pass-through chain graph on the given executor type.
+void BM_PassThroughGraph(benchmark::State& state,
+                         const std::string& executor_type) {
+  constexpr int kNumNodes = 20;
+  constexpr int kNumPackets = 200;
+  CalculatorGraphConfig config;
+  config.add_input_stream("in0");
+  auto* executor = config.add_executor();
+  executor->set_type(executor_type);
+  if (executor_type == "WorkStealingExecutor") {
+    executor->mutable_options()
+        ->MutableExtension(WorkStealingExecutorOptions::ext)
+        ->set_num_threads(state.range(0));
+  } else {
+    executor->mutable_options()
+        ->MutableExtension(ThreadPoolExecutorOptions::ext)
+        ->set_num_threads(state.range(0));
+  }
+  for (int i = 0; i < kNumNodes; ++i) {
+    auto* node = config.add_node();
+    node->set_calculator("PassThroughCalculator");
+    node->add_input_stream(absl::StrCat("in", i));
+    node->add_output_stream(absl::StrCat("in", i + 1));
+  }
+  for (auto _ : state) {
+    CalculatorGraph graph;
+    ABSL_CHECK_OK(graph.Initialize(config));
+    ABSL_CHECK_OK(graph.StartRun({}));
+    for (int i = 0; i < kNumPackets; ++i) {
+      ABSL_CHECK_OK(graph.AddPacketToInputStream(
+          "in0", MakePacket<int>(i).At(Timestamp(i))));
+    }
+    ABSL_CHECK_OK(graph.CloseAllInputStreams());
+    ABSL_CHECK_OK(graph.WaitUntilDone());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPackets * kNumNodes);
+}
+
+BENCHMARK_TEMPLATE(BM_ScheduleFromWorkers, ThreadPoolExecutor)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ScheduleFromWorkers, WorkStealingExecutor)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ScheduleFromOutside, ThreadPoolExecutor)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ScheduleFromOutside, WorkStealingExecutor)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PassThroughGraph, ThreadPoolExecutor,
+                  std::string("ThreadPoolExecutor"))
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PassThroughGraph, WorkStealingExecutor,
+                  std::string("WorkStealingExecutor"))
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
@@ -0,0 +1,137 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/work_stealing_executor.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/mediapipe_options.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/work_stealing_executor.pb.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(WorkStealingExecutorTest, RunsAllScheduledTasks) {
+  std::atomic<int> count(0);
+  {
+    WorkStealingExecutor executor(4);
+    ASSERT_EQ(executor.num_threads(), 4);
+    for (int i = 0; i < 1000; ++i) {
+      executor.Schedule([&count] { ++count; });
+    }
+  }
+  // Pending tasks are drained before the executor is destroyed.
+  EXPECT_EQ(count, 1000);
+}
+
+TEST(WorkStealingExecutorTest, RunsTasksScheduledFromWorkers) {
+  constexpr int kNumRoots = 8;
+  constexpr int kNumChildren = 100;
+  absl::BlockingCounter done(kNumRoots * kNumChildren);
+  WorkStealingExecutor executor(4);
+  for (int i = 0; i < kNumRoots; ++i) {
+    executor.Schedule([&executor, &done] {
+      // These tasks land on the scheduling worker's own deque and are
+      // stolen by idle workers.
+      for (int j = 0; j < kNumChildren; ++j) {
+        executor.Schedule([&done] { done.DecrementCount(); });
+      }
+    });
+  }
+  done.Wait();
+}
+
+TEST(WorkStealingExecutorTest, ZeroThreadsMeansOneThread) {
+  WorkStealingExecutor executor(0);
+  EXPECT_EQ(executor.num_threads(), 1);
+}
+
+TEST(WorkStealingExecutorTest, CreateRequiresPositiveNumThreads) {
+  MediaPipeOptions options;
+  EXPECT_EQ(WorkStealingExecutor::Create(options).status().code(),
+            absl::StatusCode::kInvalidArgument);
+  options.MutableExtension(WorkStealingExecutorOptions::ext)
+      ->set_num_threads(0);
+  EXPECT_EQ(WorkStealingExecutor::Create(options).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(WorkStealingExecutorTest, CreateWithPinnedThreads) {
+  MediaPipeOptions options;
+  auto* extension = options.MutableExtension(WorkStealingExecutorOptions::ext);
+  extension->set_num_threads(2);
+  extension->set_pin_threads_to_cores(true);
+  MP_ASSERT_OK_AND_ASSIGN(Executor * executor,
+                          WorkStealingExecutor::Create(options));
+  std::unique_ptr<Executor> owned_executor(executor);
+  absl::BlockingCounter done(2);
+  executor->Schedule([&done] { done.DecrementCount(); });
+  executor->Schedule([&done] { done.DecrementCount(); });
+  done.Wait();
+}
+
+TEST(WorkStealingExecutorTest, SelectedInGraphConfig) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: 'in'
+        output_stream: 'out'
+        executor {
+          type: 'WorkStealingExecutor'
+          options {
+            [mediapipe.WorkStealingExecutorOptions.ext] { num_threads: 4 }
+          }
+        }
+        node {
+          calculator: 'PassThroughCalculator'
+          input_stream: 'in'
+          output_stream: 'mid'
+        }
+        node {
+          calculator: 'PassThroughCalculator'
+          input_stream: 'mid'
+          output_stream: 'out'
+        }
+      )pb");
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  std::vector<Packet> output;
+  MP_ASSERT_OK(graph.ObserveOutputStream("out", [&output](const Packet& p) {
+    output.push_back(p);
+    return absl::OkStatus();
+  }));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 100; ++i) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "in", MakePacket<int>(i).At(Timestamp(i))));
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  ASSERT_EQ(output.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(output[i].Get<int>(), i);
+    EXPECT_EQ(output[i].Timestamp(), Timestamp(i));
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
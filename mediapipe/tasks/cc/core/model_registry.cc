@@ -0,0 +1,127 @@
+/* Copyright 2025 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/core/model_registry.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/tasks/cc/core/external_file_handler.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+
+/* static */
+ModelRegistry& ModelRegistry::GetInstance() {
+  static ModelRegistry* registry = new ModelRegistry();
+  return *registry;
+}
+
+absl::StatusOr<std::shared_ptr<const SharedModel>> ModelRegistry::GetOrCreate(
+    std::shared_ptr<const proto::ExternalFile> model_file,
+    BuildModelFn build_model) {
+  MP_ASSIGN_OR_RETURN(
+      std::unique_ptr<ExternalFileHandler> file_handler,
+      ExternalFileHandler::CreateFromExternalFile(model_file.get()));
+  const absl::string_view content = file_handler->GetFileContent();
+  // Hashing reads the whole buffer once, which is much cheaper than verifying
+  // and building the model again.
+  const size_t hash = absl::HashOf(content);
+  {
+    absl::MutexLock lock(&mutex_);
+    PruneExpiredModels();
+    if (auto model = Find(hash, content)) {
+      // Drops (e.g. unmaps) the duplicate buffer.
+      return model;
+    }
+  }
+
+  const bool is_owned = !model_file->file_content().empty() ||
+                        !model_file->has_file_pointer_meta();
+  auto shared_model = std::shared_ptr<SharedModel>(
+      new SharedModel(std::move(model_file), std::move(file_handler)));
+  // Builds the model outside of the lock, so that unrelated models can be
+  // loaded concurrently.
+  MP_ASSIGN_OR_RETURN(shared_model->model_,
+                      build_model(shared_model->GetContent()));
+  if (!is_owned) {
+    return shared_model;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  // Another thread may have registered the same model in the meantime, in
+  // which case the model that was just built is discarded.
+  if (auto model = Find(hash, shared_model->GetContent())) {
+    return model;
+  }
+  models_[hash].push_back(shared_model);
+  return shared_model;
+}
+
+int ModelRegistry::GetNumModels() const {
+  absl::MutexLock lock(&mutex_);
+  int num_models = 0;
+  for (const auto& [hash, models] : models_) {
+    for (const std::weak_ptr<const SharedModel>& model : models) {
+      if (!model.expired()) ++num_models;
+    }
+  }
+  return num_models;
+}
+
+void ModelRegistry::PruneExpiredModels() {
+  for (auto it = models_.begin(); it != models_.end();) {
+    std::vector<std::weak_ptr<const SharedModel>>& models = it->second;
+    models.erase(std::remove_if(models.begin(), models.end(),
+                                [](const std::weak_ptr<const SharedModel>& m) {
+                                  return m.expired();
+                                }),
+                 models.end());
+    if (models.empty()) {
+      models_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::shared_ptr<const SharedModel> ModelRegistry::Find(
+    size_t hash, absl::string_view content) {
+  auto it = models_.find(hash);
+  if (it == models_.end()) return nullptr;
+  for (const std::weak_ptr<const SharedModel>& weak_model : it->second) {
+    std::shared_ptr<const SharedModel> model = weak_model.lock();
+    // Compares the contents to rule out hash collisions.
+    if (model != nullptr && model->GetContent() == content) {
+      return model;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
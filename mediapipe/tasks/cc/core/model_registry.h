@@ -0,0 +1,127 @@
+/* Copyright 2025 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_CORE_MODEL_REGISTRY_H_
+#define MEDIAPIPE_TASKS_CC_CORE_MODEL_REGISTRY_H_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/tasks/cc/core/external_file_handler.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+
+// A read-only TFLite model shared by all the users of the same model content.
+// The model buffer (usually mmapped from the model file) and the flatbuffer
+// model are released when the last user drops its reference.
+class SharedModel {
+ public:
+  // SharedModel is neither copyable nor movable.
+  SharedModel(const SharedModel&) = delete;
+  SharedModel& operator=(const SharedModel&) = delete;
+
+  // Returns the model buffer, valid as long as the SharedModel is alive.
+  absl::string_view GetContent() const { return content_; }
+
+  // Returns the flatbuffer model built from the model buffer.
+  const tflite::FlatBufferModel& GetModel() const { return *model_; }
+
+ private:
+  friend class ModelRegistry;
+
+  SharedModel(std::shared_ptr<const proto::ExternalFile> model_file,
+              std::unique_ptr<ExternalFileHandler> file_handler)
+      : model_file_(std::move(model_file)),
+        file_handler_(std::move(file_handler)),
+        content_(file_handler_->GetFileContent()) {}
+
+  // The ExternalFile proto referenced by the file handler.
+  std::shared_ptr<const proto::ExternalFile> model_file_;
+  // The handler owning the mmapped (or copied) model buffer.
+  std::unique_ptr<ExternalFileHandler> file_handler_;
+  absl::string_view content_;
+  std::unique_ptr<tflite::FlatBufferModel> model_;
+};
+
+// A process-wide registry of TFLite models keyed by their content.
+//
+// Every ModelResources object goes through the registry, so that all the task
+// instances and graphs loading the same model, whether from the same path or
+// from different copies of the model, share one model buffer and one
+// tflite::FlatBufferModel. Because the buffer addresses are then identical,
+// the inference calculators can also share the XNNPACK packed weights of the
+// model (see mediapipe/calculators/tensor/xnnpack_weights_cache.h).
+//
+// Only weak references are stored, so the registry never extends the lifetime
+// of a model.
+class ModelRegistry {
+ public:
+  // Builds a verified flatbuffer model from the model buffer, or returns an
+  // error if the buffer is not a valid model.
+  using BuildModelFn = absl::AnyInvocable<
+      absl::StatusOr<std::unique_ptr<tflite::FlatBufferModel>>(
+          absl::string_view content)>;
+
+  // Returns the process-wide registry.
+  static ModelRegistry& GetInstance();
+
+  // Returns the registered model whose content is identical to the content of
+  // `model_file`, or builds a new model with `build_model` and registers it.
+  // On a registry hit, the model is neither rebuilt nor verified again.
+  //
+  // Models provided through `file_pointer_meta` are not registered, as their
+  // buffer is owned by the caller and may not outlive the other users.
+  absl::StatusOr<std::shared_ptr<const SharedModel>> GetOrCreate(
+      std::shared_ptr<const proto::ExternalFile> model_file,
+      BuildModelFn build_model);
+
+  // Returns the number of registered models that are still alive.
+  int GetNumModels() const;
+
+ private:
+  ModelRegistry() = default;
+
+  // Removes the entries of the models that were released.
+  void PruneExpiredModels() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns a registered model with the same content, or nullptr if none.
+  std::shared_ptr<const SharedModel> Find(size_t hash,
+                                          absl::string_view content)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  // Maps the content hash to the models with that hash. Expired entries are
+  // pruned on every lookup, so that the map only holds live models.
+  absl::flat_hash_map<size_t, std::vector<std::weak_ptr<const SharedModel>>>
+      models_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_TASKS_CC_CORE_MODEL_REGISTRY_H_
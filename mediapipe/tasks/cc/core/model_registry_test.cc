@@ -0,0 +1,166 @@
+/* Copyright 2025 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/core/model_registry.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+#include "mediapipe/tasks/cc/core/utils.h"
+#include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/test_util.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+namespace {
+
+constexpr char kTestModelPath[] =
+    "mediapipe/tasks/testdata/core/test_model_add_op.tflite";
+
+constexpr char kOtherTestModelPath[] =
+    "mediapipe/tasks/testdata/core/mobilenet_v1_0.25_224_quant.tflite";
+
+// Builds the model and counts the number of builds.
+ModelRegistry::BuildModelFn CountingBuildModel(int* num_builds) {
+  return [num_builds](absl::string_view content)
+             -> absl::StatusOr<std::unique_ptr<tflite::FlatBufferModel>> {
+    ++*num_builds;
+    auto model = tflite::FlatBufferModel::BuildFromBuffer(content.data(),
+                                                          content.size());
+    if (model == nullptr) {
+      return absl::InvalidArgumentError("Invalid model.");
+    }
+    return model;
+  };
+}
+
+std::shared_ptr<proto::ExternalFile> FileNamed(const char* file_name) {
+  auto model_file = std::make_shared<proto::ExternalFile>();
+  model_file->set_file_name(file_name);
+  return model_file;
+}
+
+}  // namespace
+
+class ModelRegistryTest : public tflite::testing::Test {};
+
+TEST_F(ModelRegistryTest, SharesModelsWithSameContent) {
+  ModelRegistry& registry = ModelRegistry::GetInstance();
+  int num_builds = 0;
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model, registry.GetOrCreate(FileNamed(kTestModelPath),
+                                       CountingBuildModel(&num_builds)));
+  EXPECT_EQ(registry.GetNumModels(), 1);
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto same_file_model,
+      registry.GetOrCreate(FileNamed(kTestModelPath),
+                           CountingBuildModel(&num_builds)));
+  auto model_file = std::make_shared<proto::ExternalFile>();
+  model_file->set_file_content(LoadBinaryContent(kTestModelPath));
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto same_content_model,
+      registry.GetOrCreate(model_file, CountingBuildModel(&num_builds)));
+
+  EXPECT_EQ(num_builds, 1);
+  EXPECT_EQ(model, same_file_model);
+  EXPECT_EQ(model, same_content_model);
+  EXPECT_EQ(&model->GetModel(), &same_content_model->GetModel());
+  EXPECT_EQ(registry.GetNumModels(), 1);
+}
+
+TEST_F(ModelRegistryTest, SeparatesModelsWithDifferentContent) {
+  ModelRegistry& registry = ModelRegistry::GetInstance();
+  int num_builds = 0;
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model, registry.GetOrCreate(FileNamed(kTestModelPath),
+                                       CountingBuildModel(&num_builds)));
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto other_model,
+      registry.GetOrCreate(FileNamed(kOtherTestModelPath),
+                           CountingBuildModel(&num_builds)));
+  EXPECT_EQ(num_builds, 2);
+  EXPECT_NE(model, other_model);
+  EXPECT_NE(model->GetContent(), other_model->GetContent());
+  EXPECT_EQ(registry.GetNumModels(), 2);
+}
+
+TEST_F(ModelRegistryTest, ReleasesUnusedModels) {
+  ModelRegistry& registry = ModelRegistry::GetInstance();
+  int num_builds = 0;
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model, registry.GetOrCreate(FileNamed(kTestModelPath),
+                                       CountingBuildModel(&num_builds)));
+  EXPECT_EQ(registry.GetNumModels(), 1);
+  model.reset();
+  EXPECT_EQ(registry.GetNumModels(), 0);
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      model, registry.GetOrCreate(FileNamed(kTestModelPath),
+                                  CountingBuildModel(&num_builds)));
+  EXPECT_EQ(num_builds, 2);
+  EXPECT_EQ(registry.GetNumModels(), 1);
+}
+
+TEST_F(ModelRegistryTest, DoesNotRegisterCallerOwnedBuffers) {
+  ModelRegistry& registry = ModelRegistry::GetInstance();
+  const std::string content = LoadBinaryContent(kTestModelPath);
+  auto model_file = std::make_shared<proto::ExternalFile>();
+  model_file->mutable_file_pointer_meta()->set_pointer(
+      reinterpret_cast<uint64_t>(content.data()));
+  model_file->mutable_file_pointer_meta()->set_length(content.size());
+  int num_builds = 0;
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model,
+      registry.GetOrCreate(model_file, CountingBuildModel(&num_builds)));
+  EXPECT_EQ(model->GetContent().data(), content.data());
+  EXPECT_EQ(registry.GetNumModels(), 0);
+
+  // A registered model is still reused for a caller-owned buffer.
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto registered_model,
+      registry.GetOrCreate(FileNamed(kTestModelPath),
+                           CountingBuildModel(&num_builds)));
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto shared_model,
+      registry.GetOrCreate(model_file, CountingBuildModel(&num_builds)));
+  EXPECT_EQ(num_builds, 2);
+  EXPECT_EQ(shared_model, registered_model);
+}
+
+TEST_F(ModelRegistryTest, ReturnsBuildErrors) {
+  auto model_file = std::make_shared<proto::ExternalFile>();
+  model_file->set_file_content("not a model");
+  int num_builds = 0;
+  auto status_or_model = ModelRegistry::GetInstance().GetOrCreate(
+      model_file, CountingBuildModel(&num_builds));
+  EXPECT_EQ(status_or_model.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(ModelRegistry::GetInstance().GetNumModels(), 0);
+}
+
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
@@ -29,7 +29,7 @@ limitations under the License.
 #include "mediapipe/framework/api2/packet.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
-#include "mediapipe/tasks/cc/core/external_file_handler.h"
+#include "mediapipe/tasks/cc/core/model_registry.h"
 #include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
 #include "mediapipe/tasks/cc/metadata/metadata_extractor.h"
 #include "mediapipe/util/resource_util.h"
@@ -94,7 +94,7 @@ const tflite::Model* ModelResources::GetTfLiteModel() const {
 #if !TFLITE_IN_GMSCORE
   return model_packet_.Get()->GetModel();
 #else
-  return tflite::GetModel(model_file_handler_->GetFileContent().data());
+  return tflite::GetModel(shared_model_->GetContent().data());
 #endif
 }
 
@@ -115,43 +115,50 @@ absl::Status ModelResources::BuildModelFromExternalFileProto() {
       model_file_->set_file_name(path_to_resource);
     }
   }
-  MP_ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(model_file_.get()));
-  const char* buffer_data = model_file_handler_->GetFileContent().data();
-  size_t buffer_size = model_file_handler_->GetFileContent().size();
   // Verifies that the supplied buffer refers to a valid flatbuffer model,
   // and that it uses only operators that are supported by the OpResolver
   // that was passed to the ModelResources constructor, and then builds
-  // the model from the buffer.
-  auto model = tflite::FlatBufferModel::VerifyAndBuildFromBuffer(
-      buffer_data, buffer_size, &verifier_, &error_reporter_);
-  if (model == nullptr) {
-    static constexpr char kInvalidFlatbufferMessage[] =
-        "The model is not a valid Flatbuffer";
-    // To be replaced with a proper switch-case when TFLite model builder
-    // returns a `MediaPipeTasksStatus` code capturing this type of error.
-    if (absl::StrContains(error_reporter_.message(),
-                          kInvalidFlatbufferMessage)) {
-      return CreateStatusWithPayload(
-          StatusCode::kInvalidArgument, error_reporter_.message(),
-          MediaPipeTasksStatus::kInvalidFlatBufferError);
-    } else if (absl::StrContains(error_reporter_.message(),
-                                 "Error loading model from buffer")) {
-      return CreateStatusWithPayload(
-          StatusCode::kInvalidArgument, kInvalidFlatbufferMessage,
-          MediaPipeTasksStatus::kInvalidFlatBufferError);
-    } else {
-      return CreateStatusWithPayload(
-          StatusCode::kUnknown,
-          absl::StrCat(
-              "Could not build model from the provided pre-loaded flatbuffer: ",
-              error_reporter_.message()));
+  // the model from the buffer. This is skipped if a model with the same content
+  // is already registered.
+  auto build_model = [this](absl::string_view content)
+      -> absl::StatusOr<std::unique_ptr<tflite::FlatBufferModel>> {
+    auto model = tflite::FlatBufferModel::VerifyAndBuildFromBuffer(
+        content.data(), content.size(), &verifier_, &error_reporter_);
+    if (model == nullptr) {
+      static constexpr char kInvalidFlatbufferMessage[] =
+          "The model is not a valid Flatbuffer";
+      // To be replaced with a proper switch-case when TFLite model builder
+      // returns a `MediaPipeTasksStatus` code capturing this type of error.
+      if (absl::StrContains(error_reporter_.message(),
+                            kInvalidFlatbufferMessage)) {
+        return CreateStatusWithPayload(
+            StatusCode::kInvalidArgument, error_reporter_.message(),
+            MediaPipeTasksStatus::kInvalidFlatBufferError);
+      } else if (absl::StrContains(error_reporter_.message(),
+                                   "Error loading model from buffer")) {
+        return CreateStatusWithPayload(
+            StatusCode::kInvalidArgument, kInvalidFlatbufferMessage,
+            MediaPipeTasksStatus::kInvalidFlatBufferError);
+      } else {
+        return CreateStatusWithPayload(
+            StatusCode::kUnknown,
+            absl::StrCat("Could not build model from the provided pre-loaded "
+                         "flatbuffer: ",
+                         error_reporter_.message()));
+      }
     }
-  }
-
+    return model;
+  };
+  MP_ASSIGN_OR_RETURN(shared_model_, ModelRegistry::GetInstance().GetOrCreate(
+                                         model_file_, std::move(build_model)));
+  const char* buffer_data = shared_model_->GetContent().data();
+  size_t buffer_size = shared_model_->GetContent().size();
+
+  // The model packet keeps the shared model alive. The model is never
+  // modified, the const_cast is only needed to fit the ModelPtr type.
   model_packet_ = MakePacket<ModelPtr>(
-      model.release(), [](tflite::FlatBufferModel* model) { delete model; });
+      const_cast<tflite::FlatBufferModel*>(&shared_model_->GetModel()),
+      [shared_model = shared_model_](tflite::FlatBufferModel*) {});
   MP_ASSIGN_OR_RETURN(auto model_metadata_extractor,
                       metadata::ModelMetadataExtractor::CreateFromModelBuffer(
                           buffer_data, buffer_size));
@@ -27,6 +27,7 @@ limitations under the License.
 #include "mediapipe/framework/api2/packet.h"
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/core/external_file_handler.h"
+#include "mediapipe/tasks/cc/core/model_registry.h"
 #include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
 #include "mediapipe/tasks/cc/metadata/metadata_extractor.h"
 #include "mediapipe/util/tflite/error_reporter.h"
@@ -47,6 +48,10 @@ namespace core {
 // resources, including flatbuffer model, op resolver, model metadata extractor,
 // and external file handler, are owned by the ModelResources object, callers
 // must keep ModelResources alive while using any of the resources.
+//
+// The model buffer and the flatbuffer model are obtained from the process-wide
+// ModelRegistry, so they are shared with any other ModelResources object
+// created from the same model content.
 class ModelResources {
  public:
   // Represents a TfLite model as a FlatBuffer.
@@ -124,13 +129,13 @@ class ModelResources {
 
   // The model resources tag.
   const std::string tag_;
-  // The model file.
-  std::unique_ptr<proto::ExternalFile> model_file_;
+  // The model file, shared with the registered model if it references it.
+  std::shared_ptr<proto::ExternalFile> model_file_;
   // The packet stores the TFLite op resolver.
   api2::Packet<tflite::OpResolver> op_resolver_packet_;
 
-  // The ExternalFileHandler for the model.
-  std::unique_ptr<ExternalFileHandler> model_file_handler_;
+  // The model buffer and flatbuffer model, shared through ModelRegistry.
+  std::shared_ptr<const SharedModel> shared_model_;
   // The packet stores the TFLite model for actual inference.
   api2::Packet<ModelPtr> model_packet_;
   // The packet stores the TFLite Metadata extractor built from the model.
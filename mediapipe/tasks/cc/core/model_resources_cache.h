@@ -88,6 +88,16 @@ class ModelResourcesCache {
   absl::StatusOr<api2::Packet<tflite::OpResolver>> GetGraphOpResolverPacket()
       const;
 
+  // Marks the cache as shared by several replicas of the same graph (see
+  // TaskRunnerPool). The model task graphs of a replica then reuse the model
+  // resources that the first replica added under the same tag, instead of
+  // failing to add them again, so that each model is only loaded once.
+  // The replicas must be initialized sequentially.
+  void SetSharedByGraphReplicas(bool shared_by_graph_replicas) {
+    shared_by_graph_replicas_ = shared_by_graph_replicas;
+  }
+  bool IsSharedByGraphReplicas() const { return shared_by_graph_replicas_; }
+
  private:
   // The packet stores all TFLite op resolvers for the models in the graph.
   api2::Packet<tflite::OpResolver> graph_op_resolver_packet_;
@@ -100,6 +110,8 @@ class ModelResourcesCache {
   // the graph.
   absl::flat_hash_map<std::string, std::unique_ptr<ModelAssetBundleResources>>
       model_asset_bundle_resources_collection_;
+
+  bool shared_by_graph_replicas_ = false;
 };
 
 // Global service for mediapipe task model resources cache.
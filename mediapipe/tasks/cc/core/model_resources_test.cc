@@ -295,6 +295,31 @@ TEST_F(ModelResourcesTest, CreateSuccessWithCustomOpsPacket) {
                                ->custom_name);
 }
 
+TEST_F(ModelResourcesTest, SharesModelWithSameContent) {
+  auto model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_name(kTestModelPath);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  auto other_model_file = std::make_unique<proto::ExternalFile>();
+  other_model_file->set_file_content(LoadBinaryContent(kTestModelPath));
+  MP_ASSERT_OK_AND_ASSIGN(auto other_model_resources,
+                          ModelResources::Create("other_model_resources",
+                                                 std::move(other_model_file)));
+  CheckModelResourcesPackets(other_model_resources.get());
+  EXPECT_EQ(model_resources->GetModelPacket().Get().get(),
+            other_model_resources->GetModelPacket().Get().get());
+  EXPECT_EQ(model_resources->GetTfLiteModel(),
+            other_model_resources->GetTfLiteModel());
+
+  // The model outlives the ModelResources it was created by, as long as it is
+  // used by other ModelResources.
+  const tflite::FlatBufferModel* model =
+      other_model_resources->GetModelPacket().Get().get();
+  model_resources.reset();
+  EXPECT_TRUE(model->initialized());
+}
+
 }  // namespace core
 }  // namespace tasks
 }  // namespace mediapipe
@@ -179,6 +179,11 @@ absl::StatusOr<const ModelResources*> ModelTaskGraph::CreateModelResources(
       model_resources_cache_service.GetObject().GetGraphOpResolverPacket());
   const std::string tag =
       absl::StrCat(CreateModelResourcesTag(sc->OriginalNode()), tag_suffix);
+  if (model_resources_cache_service.GetObject().IsSharedByGraphReplicas() &&
+      model_resources_cache_service.GetObject().Exists(tag)) {
+    // Another replica of the graph has already loaded the model.
+    return model_resources_cache_service.GetObject().GetModelResources(tag);
+  }
   MP_ASSIGN_OR_RETURN(auto model_resources,
                       ModelResources::Create(tag, std::move(external_file),
                                              op_resolver_packet));
@@ -228,6 +233,12 @@ ModelTaskGraph::CreateModelAssetBundleResources(
   }
   const std::string tag = absl::StrCat(
       CreateModelAssetBundleResourcesTag(sc->OriginalNode()), tag_suffix);
+  if (model_resources_cache_service.GetObject().IsSharedByGraphReplicas() &&
+      model_resources_cache_service.GetObject().ModelAssetBundleExists(tag)) {
+    // Another replica of the graph has already loaded the model asset bundle.
+    return model_resources_cache_service.GetObject()
+        .GetModelAssetBundleResources(tag);
+  }
   MP_ASSIGN_OR_RETURN(
       auto model_bundle_resources,
       ModelAssetBundleResources::Create(tag, std::move(external_file)));
@@ -102,7 +102,8 @@ absl::StatusOr<std::unique_ptr<TaskRunner>> TaskRunner::Create(
     std::shared_ptr<Executor> default_executor,
     std::optional<PacketMap> input_side_packets,
     std::shared_ptr<::mediapipe::GpuResources> resources,
-    std::optional<ErrorFn> error_fn, bool disable_default_service) {
+    std::optional<ErrorFn> error_fn, bool disable_default_service,
+    std::shared_ptr<ModelResourcesCache> model_resources_cache) {
 #else
 absl::StatusOr<std::unique_ptr<TaskRunner>> TaskRunner::Create(
     CalculatorGraphConfig config,
@@ -110,13 +111,14 @@ absl::StatusOr<std::unique_ptr<TaskRunner>> TaskRunner::Create(
     PacketsCallback packets_callback,
     std::shared_ptr<Executor> default_executor,
     std::optional<PacketMap> input_side_packets,
-    std::optional<ErrorFn> error_fn, bool disable_default_service) {
+    std::optional<ErrorFn> error_fn, bool disable_default_service,
+    std::shared_ptr<ModelResourcesCache> model_resources_cache) {
 #endif  // !MEDIAPIPE_DISABLE_GPU
   auto task_runner = absl::WrapUnique(new TaskRunner(packets_callback));
   MP_RETURN_IF_ERROR(task_runner->Initialize(
       std::move(config), std::move(op_resolver), std::move(default_executor),
       std::move(input_side_packets), std::move(error_fn),
-      disable_default_service));
+      disable_default_service, std::move(model_resources_cache)));
 
 #if !MEDIAPIPE_DISABLE_GPU
   if (resources) {
@@ -134,7 +136,8 @@ absl::Status TaskRunner::Initialize(
     std::unique_ptr<tflite::OpResolver> op_resolver,
     std::shared_ptr<Executor> default_executor,
     std::optional<PacketMap> input_side_packets,
-    std::optional<ErrorFn> error_fn, bool disable_default_service) {
+    std::optional<ErrorFn> error_fn, bool disable_default_service,
+    std::shared_ptr<ModelResourcesCache> model_resources_cache) {
   if (initialized_) {
     return CreateStatusWithPayload(
         absl::StatusCode::kInvalidArgument,
@@ -192,8 +195,15 @@ absl::Status TaskRunner::Initialize(
   if (disable_default_service) {
     MP_RETURN_IF_ERROR(graph_.DisallowServiceDefaultInitialization());
   }
-  auto model_resources_cache =
-      std::make_shared<ModelResourcesCache>(std::move(op_resolver));
+  if (model_resources_cache == nullptr) {
+    model_resources_cache =
+        std::make_shared<ModelResourcesCache>(std::move(op_resolver));
+  } else if (op_resolver != nullptr) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "The op resolver must be set in the provided ModelResourcesCache.",
+        MediaPipeTasksStatus::kRunnerInitializationError);
+  }
   MP_RETURN_IF_ERROR(
       AddPayload(graph_.SetServiceObject(kModelResourcesCacheService,
                                          model_resources_cache),
@@ -46,6 +46,8 @@ class GpuResources;
 namespace tasks {
 namespace core {
 
+class ModelResourcesCache;
+
 using ErrorFn = std::function<void(absl::Status)>;
 
 // Mapping from the MediaPipe calculator graph stream/side packet names to the
@@ -75,6 +77,10 @@ class TaskRunner {
   // asynchronous method, Send(), to provide the input packets. If the packets
   // callback is absent, clients must use the synchronous method, Process(), to
   // provide the input packets and receive the output packets.
+  // If a ModelResourcesCache is provided, the graph uses it instead of creating
+  // its own cache, which allows several task runners to share the loaded
+  // models. In that case, the op resolver must be set in the cache rather than
+  // passed to this method.
 #if !MEDIAPIPE_DISABLE_GPU
   static absl::StatusOr<std::unique_ptr<TaskRunner>> Create(
       CalculatorGraphConfig config,
@@ -84,7 +90,8 @@ class TaskRunner {
       std::optional<PacketMap> input_side_packets = std::nullopt,
       std::shared_ptr<::mediapipe::GpuResources> resources = nullptr,
       std::optional<ErrorFn> error_fn = std::nullopt,
-      bool disable_default_service = false);
+      bool disable_default_service = false,
+      std::shared_ptr<ModelResourcesCache> model_resources_cache = nullptr);
 #else
   static absl::StatusOr<std::unique_ptr<TaskRunner>> Create(
       CalculatorGraphConfig config,
@@ -93,7 +100,8 @@ class TaskRunner {
       std::shared_ptr<Executor> default_executor = nullptr,
       std::optional<PacketMap> input_side_packets = std::nullopt,
       std::optional<ErrorFn> error_fn = std::nullopt,
-      bool disable_default_service = false);
+      bool disable_default_service = false,
+      std::shared_ptr<ModelResourcesCache> model_resources_cache = nullptr);
 #endif  // !MEDIAPIPE_DISABLE_GPU
 
   // TaskRunner is neither copyable nor movable.
@@ -150,7 +158,8 @@ class TaskRunner {
       std::shared_ptr<Executor> default_executor = nullptr,
       std::optional<PacketMap> input_side_packets = std::nullopt,
       std::optional<ErrorFn> error_fn = std::nullopt,
-      bool disable_default_service = false);
+      bool disable_default_service = false,
+      std::shared_ptr<ModelResourcesCache> model_resources_cache = nullptr);
 
   // Starts the task runner. Returns an ok status to indicate that the
   // runner is ready to accept input data. Otherwise, returns an error status to
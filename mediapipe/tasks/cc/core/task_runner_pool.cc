@@ -0,0 +1,161 @@
+/* Copyright 2025 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/core/task_runner_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/timestamp.h"
+#include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/core/model_resources_cache.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+
+/* static */
+absl::StatusOr<std::unique_ptr<TaskRunnerPool>> TaskRunnerPool::Create(
+    CalculatorGraphConfig config, int num_replicas,
+    std::unique_ptr<tflite::OpResolver> op_resolver,
+    std::shared_ptr<Executor> default_executor,
+    std::optional<PacketMap> input_side_packets,
+    std::shared_ptr<ModelResourcesCache> model_resources_cache) {
+  if (num_replicas <= 0) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "The number of task runner replicas must be positive.",
+        MediaPipeTasksStatus::kRunnerInitializationError);
+  }
+  if (model_resources_cache == nullptr) {
+    model_resources_cache =
+        std::make_shared<ModelResourcesCache>(std::move(op_resolver));
+  } else if (op_resolver != nullptr) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "The op resolver must be set in the provided ModelResourcesCache.",
+        MediaPipeTasksStatus::kRunnerInitializationError);
+  }
+  model_resources_cache->SetSharedByGraphReplicas(true);
+
+  auto pool = absl::WrapUnique(new TaskRunnerPool());
+  pool->runners_.reserve(num_replicas);
+  // The replicas are created sequentially, as the graph initialization adds
+  // the model resources of the first replica to the shared cache.
+  for (int i = 0; i < num_replicas; ++i) {
+    MP_ASSIGN_OR_RETURN(
+        std::unique_ptr<TaskRunner> runner,
+        TaskRunner::Create(config, /*op_resolver=*/nullptr,
+                           /*packets_callback=*/nullptr, default_executor,
+                           input_side_packets,
+#if !MEDIAPIPE_DISABLE_GPU
+                           /*resources=*/nullptr,
+#endif  // !MEDIAPIPE_DISABLE_GPU
+                           /*error_fn=*/std::nullopt,
+                           /*disable_default_service=*/false,
+                           model_resources_cache));
+    pool->runners_.push_back(std::move(runner));
+  }
+  absl::MutexLock lock(&pool->mutex_);
+  for (const auto& runner : pool->runners_) {
+    pool->idle_runners_.push_back(runner.get());
+  }
+  return pool;
+}
+
+absl::StatusOr<PacketMap> TaskRunnerPool::Process(PacketMap inputs) {
+  for (const auto& [name, packet] : inputs) {
+    if (packet.Timestamp() != Timestamp::Unset()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "TaskRunnerPool::Process only accepts packets without timestamps.",
+          MediaPipeTasksStatus::kRunnerInvalidTimestampError);
+    }
+  }
+
+  const absl::Time enqueue_time = absl::Now();
+  TaskRunner* runner = nullptr;
+  {
+    absl::MutexLock lock(&mutex_);
+    ++stats_.num_waiting;
+    stats_.max_num_waiting =
+        std::max(stats_.max_num_waiting, stats_.num_waiting);
+    mutex_.Await(absl::Condition(this, &TaskRunnerPool::HasIdleRunner));
+    --stats_.num_waiting;
+    if (closed_) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument, "Task runner pool is closed.",
+          MediaPipeTasksStatus::kRunnerNotStartedError);
+    }
+    runner = idle_runners_.back();
+    idle_runners_.pop_back();
+    const absl::Duration queue_time = absl::Now() - enqueue_time;
+    stats_.total_queue_time += queue_time;
+    stats_.max_queue_time = std::max(stats_.max_queue_time, queue_time);
+  }
+
+  const absl::Time start_time = absl::Now();
+  absl::StatusOr<PacketMap> outputs = runner->Process(std::move(inputs));
+  const absl::Duration process_time = absl::Now() - start_time;
+
+  absl::MutexLock lock(&mutex_);
+  idle_runners_.push_back(runner);
+  ++stats_.num_processed;
+  stats_.total_process_time += process_time;
+  stats_.max_process_time = std::max(stats_.max_process_time, process_time);
+  return outputs;
+}
+
+absl::Status TaskRunnerPool::Close() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (closed_) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "Task runner pool is already closed.",
+          MediaPipeTasksStatus::kRunnerFailsToCloseError);
+    }
+    closed_ = true;
+    // Lets the in-flight Process calls complete.
+    mutex_.Await(absl::Condition(this, &TaskRunnerPool::AllRunnersIdle));
+  }
+  absl::Status status;
+  for (const auto& runner : runners_) {
+    status.Update(runner->Close());
+  }
+  return status;
+}
+
+TaskRunnerPool::Stats TaskRunnerPool::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
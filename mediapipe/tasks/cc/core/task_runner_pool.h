@@ -0,0 +1,135 @@
+/* Copyright 2025 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_CORE_TASK_RUNNER_POOL_H_
+#define MEDIAPIPE_TASKS_CC_CORE_TASK_RUNNER_POOL_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/executor.h"
+#include "mediapipe/tasks/cc/core/model_resources_cache.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+
+// A pool of synchronous TaskRunners running replicas of the same graph.
+//
+// TaskRunner::Process serializes the invocations on a single CalculatorGraph.
+// TaskRunnerPool instead dispatches each Process call to an idle replica, so
+// that up to N unrelated inputs (e.g. images in IMAGE mode) are processed
+// concurrently. All the replicas share one ModelResourcesCache, so each model
+// is loaded only once; each replica still creates its own interpreters.
+//
+// As inputs are dispatched to replicas in an arbitrary order, the input
+// packets must not have timestamps: each replica assigns synthetic timestamps,
+// which makes the pool unsuitable for stateful (video or live stream) graphs.
+//
+// Example usage:
+// ```
+//   MP_ASSIGN_OR_RETURN(auto pool, TaskRunnerPool::Create(
+//                                      std::move(config), /*num_replicas=*/8,
+//                                      std::move(op_resolver)));
+//   // Called concurrently from several threads.
+//   MP_ASSIGN_OR_RETURN(
+//       PacketMap outputs,
+//       pool->Process({{"image_in", MakePacket<Image>(image)}}));
+// ```
+class TaskRunnerPool {
+ public:
+  // Queueing and latency statistics of the processed requests.
+  struct Stats {
+    // The number of completed Process calls.
+    int64_t num_processed = 0;
+    // The number of Process calls currently waiting for an idle replica.
+    int num_waiting = 0;
+    // The maximum number of Process calls that waited at the same time.
+    int max_num_waiting = 0;
+    // The time that Process calls waited for an idle replica.
+    absl::Duration total_queue_time;
+    absl::Duration max_queue_time;
+    // The time that the replicas took to process the inputs.
+    absl::Duration total_process_time;
+    absl::Duration max_process_time;
+  };
+
+  // Creates `num_replicas` task runners from `config`. The op resolver, the
+  // default executor and the input side packets are shared by all replicas.
+  // If `model_resources_cache` is provided, the op resolver must be set in the
+  // cache rather than passed to this method.
+  static absl::StatusOr<std::unique_ptr<TaskRunnerPool>> Create(
+      CalculatorGraphConfig config, int num_replicas,
+      std::unique_ptr<tflite::OpResolver> op_resolver = nullptr,
+      std::shared_ptr<Executor> default_executor = nullptr,
+      std::optional<PacketMap> input_side_packets = std::nullopt,
+      std::shared_ptr<ModelResourcesCache> model_resources_cache = nullptr);
+
+  // TaskRunnerPool is neither copyable nor movable.
+  TaskRunnerPool(const TaskRunnerPool&) = delete;
+  TaskRunnerPool& operator=(const TaskRunnerPool&) = delete;
+
+  // Processes `inputs` on the first idle replica, blocking until one becomes
+  // available and until the results are returned. The input packets must not
+  // have timestamps. This method is thread-safe.
+  absl::StatusOr<PacketMap> Process(PacketMap inputs);
+
+  // Waits for the pending Process calls and shuts down all the replicas. Any
+  // subsequent Process call receives an error.
+  absl::Status Close();
+
+  int num_replicas() const { return static_cast<int>(runners_.size()); }
+
+  // Returns the statistics of the Process calls so far.
+  Stats GetStats() const;
+
+  // Returns the canonicalized CalculatorGraphConfig of the replicas.
+  const CalculatorGraphConfig& GetGraphConfig() {
+    return runners_.front()->GetGraphConfig();
+  }
+
+ private:
+  TaskRunnerPool() = default;
+
+  bool HasIdleRunner() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return closed_ || !idle_runners_.empty();
+  }
+  bool AllRunnersIdle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return idle_runners_.size() == runners_.size();
+  }
+
+  std::vector<std::unique_ptr<TaskRunner>> runners_;
+
+  mutable absl::Mutex mutex_;
+  std::vector<TaskRunner*> idle_runners_ ABSL_GUARDED_BY(mutex_);
+  bool closed_ ABSL_GUARDED_BY(mutex_) = false;
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_TASKS_CC_CORE_TASK_RUNNER_POOL_H_
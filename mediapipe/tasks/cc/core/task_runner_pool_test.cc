@@ -0,0 +1,253 @@
+/* Copyright 2025 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/core/task_runner_pool.h"
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/tasks/cc/core/model_resources.h"
+#include "mediapipe/tasks/cc/core/model_task_graph.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+#include "tensorflow/lite/test_util.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+namespace {
+
+constexpr int kNumReplicas = 4;
+
+constexpr char kTestModelPath[] =
+    "mediapipe/tasks/testdata/core/test_model_add_op.tflite";
+
+CalculatorGraphConfig GetPassThroughGraphConfig() {
+  return ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "out"
+        })pb");
+}
+
+ABSL_CONST_INIT absl::Mutex rendezvous_mutex(absl::kConstInit);
+int num_rendezvous_arrivals ABSL_GUARDED_BY(rendezvous_mutex) = 0;
+
+// Blocks each Process call until kNumReplicas calls have arrived, so that the
+// graph only makes progress if the replicas run concurrently.
+class RendezvousCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Index(0).SetAny();
+    cc->Outputs().Index(0).SetSameAs(&cc->Inputs().Index(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) final {
+    absl::MutexLock lock(&rendezvous_mutex);
+    ++num_rendezvous_arrivals;
+    const auto all_arrived = []() ABSL_SHARED_LOCKS_REQUIRED(
+                                 rendezvous_mutex) {
+      return num_rendezvous_arrivals >= kNumReplicas;
+    };
+    if (!rendezvous_mutex.AwaitWithTimeout(absl::Condition(&all_arrived),
+                                           absl::Seconds(10))) {
+      return absl::DeadlineExceededError("Replicas do not run concurrently.");
+    }
+    cc->Outputs().Index(0).AddPacket(cc->Inputs().Index(0).Value());
+    return absl::OkStatus();
+  }
+};
+REGISTER_CALCULATOR(RendezvousCalculator);
+
+// Loads the test model through the model resources cache, and outputs the
+// model packet at each tick.
+class ModelLoadingGraph : public ModelTaskGraph {
+ public:
+  absl::StatusOr<CalculatorGraphConfig> GetConfig(
+      SubgraphContext* sc) override {
+    auto external_file = std::make_unique<proto::ExternalFile>();
+    external_file->set_file_name(kTestModelPath);
+    MP_ASSIGN_OR_RETURN(const ModelResources* model_resources,
+                        CreateModelResources(sc, std::move(external_file)));
+    return ParseTextProtoOrDie<CalculatorGraphConfig>(absl::Substitute(
+        R"pb(
+          input_stream: "TICK:tick"
+          output_stream: "MODEL:model_out"
+          node {
+            calculator: "ModelResourcesCalculator"
+            output_side_packet: "MODEL:model"
+            options {
+              [mediapipe.tasks.core.proto.ModelResourcesCalculatorOptions
+                   .ext] { model_resources_tag: "$0" }
+            }
+          }
+          node {
+            calculator: "SidePacketToStreamCalculator"
+            input_stream: "TICK:tick"
+            input_side_packet: "model"
+            output_stream: "AT_TICK:model_out"
+          })pb",
+        model_resources->GetTag()));
+  }
+};
+REGISTER_MEDIAPIPE_GRAPH(::mediapipe::tasks::core::ModelLoadingGraph);
+
+}  // namespace
+
+class TaskRunnerPoolTest : public tflite::testing::Test {};
+
+TEST_F(TaskRunnerPoolTest, RequiresReplicas) {
+  auto status_or_pool = TaskRunnerPool::Create(GetPassThroughGraphConfig(),
+                                               /*num_replicas=*/0);
+  ASSERT_FALSE(status_or_pool.ok());
+  EXPECT_THAT(status_or_pool.status().message(),
+              testing::HasSubstr("must be positive"));
+}
+
+TEST_F(TaskRunnerPoolTest, MultiThreadProcessCalls) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto pool,
+      TaskRunnerPool::Create(GetPassThroughGraphConfig(), kNumReplicas));
+  EXPECT_EQ(pool->num_replicas(), kNumReplicas);
+
+  constexpr int kNumThreads = 10;
+  constexpr int kNumCallsPerThread = 30;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([i, &pool]() {
+      for (int j = 0; j < kNumCallsPerThread; ++j) {
+        auto status_or_result = pool->Process({{"in", MakePacket<int>(i * j)}});
+        ASSERT_TRUE(status_or_result.ok());
+        EXPECT_EQ(i * j, status_or_result.value()["out"].Get<int>());
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  const TaskRunnerPool::Stats stats = pool->GetStats();
+  EXPECT_EQ(stats.num_processed, kNumThreads * kNumCallsPerThread);
+  EXPECT_EQ(stats.num_waiting, 0);
+  EXPECT_GE(stats.max_num_waiting, 1);
+  EXPECT_GE(stats.max_process_time, absl::ZeroDuration());
+  EXPECT_LE(stats.max_process_time, stats.total_process_time);
+  MP_ASSERT_OK(pool->Close());
+}
+
+TEST_F(TaskRunnerPoolTest, ReplicasProcessConcurrently) {
+  auto config = ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_stream: "in"
+    output_stream: "out"
+    node {
+      calculator: "RendezvousCalculator"
+      input_stream: "in"
+      output_stream: "out"
+    })pb");
+  MP_ASSERT_OK_AND_ASSIGN(auto pool,
+                          TaskRunnerPool::Create(config, kNumReplicas));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumReplicas; ++i) {
+    threads.emplace_back([i, &pool]() {
+      auto status_or_result = pool->Process({{"in", MakePacket<int>(i)}});
+      MP_ASSERT_OK(status_or_result);
+      EXPECT_EQ(i, status_or_result.value()["out"].Get<int>());
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  MP_ASSERT_OK(pool->Close());
+}
+
+TEST_F(TaskRunnerPoolTest, ReplicasShareModelResources) {
+  auto config = ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_stream: "tick"
+    output_stream: "model_out"
+    node {
+      calculator: "mediapipe.tasks.core.ModelLoadingGraph"
+      input_stream: "TICK:tick"
+      output_stream: "MODEL:model_out"
+    })pb");
+  // Creating more than one replica fails if the model resources are not
+  // shared, as the replicas would add the same tag to the cache.
+  MP_ASSERT_OK_AND_ASSIGN(auto pool,
+                          TaskRunnerPool::Create(config, kNumReplicas));
+
+  absl::Mutex mutex;
+  absl::flat_hash_set<const void*> models;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumReplicas; ++i) {
+    threads.emplace_back([i, &pool, &mutex, &models]() {
+      auto status_or_result = pool->Process({{"tick", MakePacket<int>(i)}});
+      MP_ASSERT_OK(status_or_result);
+      const Packet& model_packet = status_or_result.value()["model_out"];
+      absl::MutexLock lock(&mutex);
+      models.insert(model_packet.Get<ModelResources::ModelPtr>().get());
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(models.size(), 1);
+  MP_ASSERT_OK(pool->Close());
+}
+
+TEST_F(TaskRunnerPoolTest, RejectsPacketsWithTimestamps) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto pool,
+      TaskRunnerPool::Create(GetPassThroughGraphConfig(), kNumReplicas));
+  auto status_or_result =
+      pool->Process({{"in", MakePacket<int>(0).At(Timestamp(0))}});
+  ASSERT_FALSE(status_or_result.ok());
+  EXPECT_THAT(status_or_result.status().message(),
+              testing::HasSubstr("without timestamps"));
+  MP_ASSERT_OK(pool->Close());
+}
+
+TEST_F(TaskRunnerPoolTest, ProcessFailsAfterClose) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto pool,
+      TaskRunnerPool::Create(GetPassThroughGraphConfig(), kNumReplicas));
+  MP_ASSERT_OK(pool->Close());
+  auto status_or_result = pool->Process({{"in", MakePacket<int>(0)}});
+  ASSERT_FALSE(status_or_result.ok());
+  EXPECT_THAT(status_or_result.status().message(),
+              testing::HasSubstr("closed"));
+  EXPECT_FALSE(pool->Close().ok());
+}
+
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
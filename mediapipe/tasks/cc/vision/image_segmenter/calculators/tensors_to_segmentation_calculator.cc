@@ -26,17 +26,22 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "mediapipe/calculators/image/image_tiling.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/api2/packet.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/image_multi_pool.h"
+#include "mediapipe/framework/formats/image_multi_pool_service.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/canonical_errors.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 #include "mediapipe/tasks/cc/vision/image_segmenter/calculators/tensors_to_segmentation_calculator.pb.h"
 #include "mediapipe/tasks/cc/vision/image_segmenter/proto/segmenter_options.pb.h"
 #include "mediapipe/tasks/cc/vision/utils/image_utils.h"
@@ -111,81 +116,104 @@ float GetTensorElement(const Shape& input_shape, const float* tensors_buffer,
                         x * input_shape.channels + c];
 }
 
+// Returns a mask frame from "pool", if not null, with the unpadded rows the
+// outputs of the calculator have always had.
+ImageFrameSharedPtr NewMaskFrame(ImageMultiPool* pool,
+                                 ImageFormat::Format format, int width,
+                                 int height) {
+  return NewImageFrame(pool, format, width, height, /*alignment_boundary=*/1);
+}
+
 Image ProcessForCategoryMaskCpu(const Shape& input_shape,
                                 const Shape& output_shape,
                                 const SegmenterOptions& options,
-                                const float* tensors_buffer) {
+                                const float* tensors_buffer,
+                                ImageMultiPool* pool,
+                                ThreadPoolExecutor* executor) {
   const float width_scale =
       (input_shape.width - 1) / static_cast<float>(output_shape.width - 1);
   const float height_scale =
       (input_shape.height - 1) / static_cast<float>(output_shape.height - 1);
 
   // Category mask Image.
-  ImageFrameSharedPtr image_frame_ptr = std::make_shared<ImageFrame>(
-      ImageFormat::GRAY8, output_shape.width, output_shape.height, 1);
+  ImageFrameSharedPtr image_frame_ptr = NewMaskFrame(
+      pool, ImageFormat::GRAY8, output_shape.width, output_shape.height);
   Image category_mask(image_frame_ptr);
 
+  // The interpolation columns and weights of each output column.
+  std::vector<int> columns0(output_shape.width);
+  std::vector<int> columns1(output_shape.width);
+  std::vector<float> column_weights(output_shape.width);
+  for (int x = 0; x < output_shape.width; ++x) {
+    columns0[x] =
+        static_cast<int>(std::max(std::floor(x * width_scale), 0.f));
+    columns1[x] = static_cast<int>(
+        std::min(std::ceil(x * width_scale), input_shape.width - 1.f));
+    column_weights[x] =
+        std::max(std::min(x * width_scale - columns0[x], 1.f), 0.f);
+  }
+
   // Fill in the maximum category in the category mask image.
-  cv::Mat category_mask_mat_view =
-      mediapipe::formats::MatView(image_frame_ptr.get());
   const int input_channels = input_shape.channels;
-  category_mask_mat_view.forEach<uint8_t>([&tensors_buffer, &input_shape,
-                                           &width_scale, &height_scale,
-                                           &input_channels,
-                                           &options](uint8_t& pixel,
-                                                     const int position[]) {
-    std::vector<float> confidence_scores(input_channels);
-    int y0 =
-        static_cast<int>(std::max(std::floor(position[0] * height_scale), 0.f));
-    int x0 =
-        static_cast<int>(std::max(std::floor(position[1] * width_scale), 0.f));
-    int y1 = static_cast<int>(std::min(std::ceil(position[0] * height_scale),
-                                       input_shape.height - 1.f));
-    int x1 = static_cast<int>(std ::min(std::ceil(position[1] * width_scale),
-                                        input_shape.width - 1.f));
-    float t0 = std::max(std::min(position[0] * height_scale - y0, 1.f), 0.f);
-    float t1 = std::max(std::min(position[1] * width_scale - x0, 1.f), 0.f);
-    for (int i = 0; i < input_channels; ++i) {
-      confidence_scores[i] = BilinearInterpolate(
-          GetTensorElement(input_shape, tensors_buffer, x0, y0, i),
-          GetTensorElement(input_shape, tensors_buffer, x0, y1, i),
-          GetTensorElement(input_shape, tensors_buffer, x1, y0, i),
-          GetTensorElement(input_shape, tensors_buffer, x1, y1, i), t0, t1);
-    }
-    absl::Span<float> confidence_scores_span(confidence_scores.data(),
-                                             confidence_scores.size());
-
-    // Only process the activation function if it is SIGMOID. If NONE,
-    // we do nothing for activation, If SOFTMAX, it is required
-    // to have input_channels > 1, and for input_channels > 1, we don't need
-    // activation to find the maximum value.
-    if (options.activation() == SegmenterOptions::SIGMOID) {
-      Sigmoid(confidence_scores_span, confidence_scores_span);
-    }
-    if (input_channels == 1) {
-      // if the input tensor is a single mask, it is assumed to be a binary
-      // foreground segmentation mask. For such a mask, instead of a true
-      // argmax, we simply use 0.5 as the cutoff, assigning 0 (foreground) or
-      // 255 (background) based on whether the confidence value reaches this
-      // cutoff or not, respectively.
-      pixel = confidence_scores[0] > 0.5f ? 0 : kUnLabeledPixelValue;
-    } else {
-      const int maximum_category_idx =
-          std::max_element(confidence_scores.begin(), confidence_scores.end()) -
-          confidence_scores.begin();
-      pixel = maximum_category_idx;
-    }
-  });
+  ForEachRowTileWithOpenCvFallback(
+      executor, output_shape.height, kDefaultMinTileRows,
+      [&](int row_begin, int row_end) {
+        std::vector<float> confidence_scores(input_channels);
+        absl::Span<float> confidence_scores_span(confidence_scores);
+        for (int y = row_begin; y < row_end; ++y) {
+          const int y0 =
+              static_cast<int>(std::max(std::floor(y * height_scale), 0.f));
+          const int y1 = static_cast<int>(
+              std::min(std::ceil(y * height_scale), input_shape.height - 1.f));
+          const float t0 = std::max(std::min(y * height_scale - y0, 1.f), 0.f);
+          uint8_t* pixels = image_frame_ptr->MutablePixelData() +
+                            y * image_frame_ptr->WidthStep();
+          for (int x = 0; x < output_shape.width; ++x) {
+            const int x0 = columns0[x];
+            const int x1 = columns1[x];
+            for (int i = 0; i < input_channels; ++i) {
+              confidence_scores[i] = BilinearInterpolate(
+                  GetTensorElement(input_shape, tensors_buffer, x0, y0, i),
+                  GetTensorElement(input_shape, tensors_buffer, x0, y1, i),
+                  GetTensorElement(input_shape, tensors_buffer, x1, y0, i),
+                  GetTensorElement(input_shape, tensors_buffer, x1, y1, i), t0,
+                  column_weights[x]);
+            }
+
+            // Only process the activation function if it is SIGMOID. If NONE,
+            // we do nothing for activation, If SOFTMAX, it is required
+            // to have input_channels > 1, and for input_channels > 1, we don't
+            // need activation to find the maximum value.
+            if (options.activation() == SegmenterOptions::SIGMOID) {
+              Sigmoid(confidence_scores_span, confidence_scores_span);
+            }
+            if (input_channels == 1) {
+              // if the input tensor is a single mask, it is assumed to be a
+              // binary foreground segmentation mask. For such a mask, instead
+              // of a true argmax, we simply use 0.5 as the cutoff, assigning 0
+              // (foreground) or 255 (background) based on whether the
+              // confidence value reaches this cutoff or not, respectively.
+              pixels[x] =
+                  confidence_scores[0] > 0.5f ? 0 : kUnLabeledPixelValue;
+            } else {
+              pixels[x] = std::max_element(confidence_scores.begin(),
+                                           confidence_scores.end()) -
+                          confidence_scores.begin();
+            }
+          }
+        }
+      });
   return category_mask;
 }
 
 std::vector<Image> ProcessForConfidenceMaskCpu(const Shape& input_shape,
                                                const Shape& output_shape,
                                                const SegmenterOptions& options,
-                                               const float* tensors_buffer) {
-  std::function<void(absl::Span<const float> values,
-                     absl::Span<float> activated_values)>
-      activation_fn;
+                                               const float* tensors_buffer,
+                                               ImageMultiPool* pool,
+                                               ThreadPoolExecutor* executor) {
+  void (*activation_fn)(absl::Span<const float> values,
+                        absl::Span<float> activated_values) = nullptr;
   switch (options.activation()) {
     case SegmenterOptions::SIGMOID:
       activation_fn = &Sigmoid;
@@ -202,50 +230,72 @@ std::vector<Image> ProcessForConfidenceMaskCpu(const Shape& input_shape,
       break;
   }
 
-  // TODO Use libyuv for resizing instead.
-  std::vector<Image> confidence_masks;
-  std::vector<cv::Mat> confidence_mask_mats;
-  confidence_masks.reserve(input_shape.channels);
-  confidence_mask_mats.reserve(input_shape.channels);
+  std::vector<ImageFrameSharedPtr> mask_frames;
+  mask_frames.reserve(input_shape.channels);
   for (int i = 0; i < input_shape.channels; ++i) {
-    confidence_masks.push_back(Image(std::make_shared<ImageFrame>(
-        ImageFormat::VEC32F1, input_shape.width, input_shape.height, 1)));
-    confidence_mask_mats.push_back(mediapipe::formats::MatView(
-        confidence_masks.back().GetImageFrameSharedPtr().get()));
+    mask_frames.push_back(NewMaskFrame(pool, ImageFormat::VEC32F1,
+                                       input_shape.width, input_shape.height));
   }
 
-  // Applies activation function.
-  const int tensor_size = input_shape.height * input_shape.width;
-  std::vector<float> activated_values(input_shape.channels);
-  absl::Span<float> activated_values_span(activated_values);
-  for (int i = 0; i < tensor_size; ++i) {
-    activation_fn(absl::MakeConstSpan(&tensors_buffer[i * input_shape.channels],
-                                      input_shape.channels),
-                  activated_values_span);
-    for (int j = 0; j < input_shape.channels; ++j) {
-      confidence_mask_mats[j].at<float>(
-          i / input_shape.width, i % input_shape.width) = activated_values[j];
+  // Applies the activation function, writing each channel to its own mask.
+  const int channels = input_shape.channels;
+  ForEachRowTileWithOpenCvFallback(
+      executor, input_shape.height, kDefaultMinTileRows,
+      [&](int row_begin, int row_end) {
+        std::vector<float> activated_values(channels);
+        std::vector<float*> mask_rows(channels);
+        for (int y = row_begin; y < row_end; ++y) {
+          for (int j = 0; j < channels; ++j) {
+            mask_rows[j] = reinterpret_cast<float*>(
+                mask_frames[j]->MutablePixelData() +
+                y * mask_frames[j]->WidthStep());
+          }
+          const float* values =
+              tensors_buffer + y * input_shape.width * channels;
+          for (int x = 0; x < input_shape.width; ++x) {
+            activation_fn(
+                absl::MakeConstSpan(values + x * channels, channels),
+                absl::MakeSpan(activated_values));
+            for (int j = 0; j < channels; ++j) {
+              mask_rows[j][x] = activated_values[j];
+            }
+          }
+        }
+      });
+
+  if (output_shape.height != input_shape.height ||
+      output_shape.width != input_shape.width) {
+    // TODO Use libyuv for resizing instead.
+    // Resizes segmented masks to required output size, in parallel.
+    std::vector<ImageFrameSharedPtr> resized_frames;
+    resized_frames.reserve(channels);
+    for (int i = 0; i < channels; ++i) {
+      resized_frames.push_back(NewMaskFrame(pool, ImageFormat::VEC32F1,
+                                            output_shape.width,
+                                            output_shape.height));
     }
+    ForEachRowTileWithOpenCvFallback(
+        executor, channels, /*min_tile_rows=*/1,
+        [&](int mask_begin, int mask_end) {
+          for (int i = mask_begin; i < mask_end; ++i) {
+            const cv::Mat mask_mat_view =
+                mediapipe::formats::MatView(mask_frames[i].get());
+            cv::Mat resized_mask_mat_view =
+                mediapipe::formats::MatView(resized_frames[i].get());
+            cv::resize(mask_mat_view, resized_mask_mat_view,
+                       resized_mask_mat_view.size(), 0, 0,
+                       cv::INTER_LINEAR);
+          }
+        });
+    mask_frames = std::move(resized_frames);
   }
-  if (output_shape.height == input_shape.height &&
-      output_shape.width == input_shape.width) {
-    return confidence_masks;
-  }
-  std::vector<Image> resized_confidence_masks;
-  resized_confidence_masks.reserve(confidence_mask_mats.size());
-  // Resizes segmented masks to required output size.
-  for (int i = 0; i < confidence_mask_mats.size(); i++) {
-    // Pre-allocates ImageFrame memory to avoid copying from cv::Mat
-    // afterward.
-    ImageFrameSharedPtr image_frame_ptr = std::make_shared<ImageFrame>(
-        ImageFormat::VEC32F1, output_shape.width, output_shape.height, 1);
-    cv::Mat resized_mask_mat_view =
-        mediapipe::formats::MatView(image_frame_ptr.get());
-    cv::resize(confidence_mask_mats[i], resized_mask_mat_view,
-               resized_mask_mat_view.size(), 0, 0, cv::INTER_LINEAR);
-    resized_confidence_masks.push_back(Image(image_frame_ptr));
+
+  std::vector<Image> confidence_masks;
+  confidence_masks.reserve(channels);
+  for (ImageFrameSharedPtr& mask_frame : mask_frames) {
+    confidence_masks.push_back(Image(std::move(mask_frame)));
   }
-  return resized_confidence_masks;
+  return confidence_masks;
 }
 
 }  // namespace
@@ -316,6 +366,11 @@ class TensorsToSegmentationCalculator : public Node {
                                               const Shape& output_shape,
                                               const float* tensors_buffer);
   TensorsToSegmentationCalculatorOptions options_;
+  // Pool for the CPU masks, if the graph provides one.
+  ImageMultiPool* image_pool_ = nullptr;
+  // Executor for the CPU row tiles if enable_cpu_tiling is set and the graph
+  // provides one.
+  ThreadPoolExecutor* tile_executor_ = nullptr;
 
 #ifdef TASK_SEGMENTATION_USE_GL_POSTPROCESSING
   SegmentationPostprocessorGl postprocessor_;
@@ -325,6 +380,8 @@ class TensorsToSegmentationCalculator : public Node {
 // static
 absl::Status TensorsToSegmentationCalculator::UpdateContract(
     CalculatorContract* cc) {
+  cc->UseService(kImageMultiPoolService).Optional();
+  cc->UseService(kImageTilingExecutorService).Optional();
 #ifdef TASK_SEGMENTATION_USE_GL_POSTPROCESSING
   return SegmentationPostprocessorGl::UpdateContract(cc);
 #else
@@ -335,6 +392,13 @@ absl::Status TensorsToSegmentationCalculator::UpdateContract(
 absl::Status TensorsToSegmentationCalculator::Open(
     mediapipe::CalculatorContext* cc) {
   options_ = cc->Options<TensorsToSegmentationCalculatorOptions>();
+  if (cc->Service(kImageMultiPoolService).IsAvailable()) {
+    image_pool_ = &cc->Service(kImageMultiPoolService).GetObject();
+  }
+  if (options_.enable_cpu_tiling() &&
+      cc->Service(kImageTilingExecutorService).IsAvailable()) {
+    tile_executor_ = &cc->Service(kImageTilingExecutorService).GetObject();
+  }
   // TODO: remove deprecated output type support.
   if (options_.segmenter_options().has_output_type()) {
     RET_CHECK_NE(options_.segmenter_options().output_type(),
@@ -465,7 +529,8 @@ absl::Status TensorsToSegmentationCalculator::Process(
         {/* height= */ output_height,
          /* width= */ output_width,
          /* channels= */ input_shape.channels},
-        options_.segmenter_options(), tensors_buffer);
+        options_.segmenter_options(), tensors_buffer, image_pool_,
+        tile_executor_);
     for (int i = 0; i < confidence_masks.size(); ++i) {
       kConfidenceMaskOut(cc)[i].Send(std::move(confidence_masks[i]));
     }
@@ -476,7 +541,8 @@ absl::Status TensorsToSegmentationCalculator::Process(
         {/* height= */ output_height,
          /* width= */ output_width,
          /* channels= */ 1},
-        options_.segmenter_options(), tensors_buffer));
+        options_.segmenter_options(), tensors_buffer, image_pool_,
+        tile_executor_));
   }
   return absl::OkStatus();
 }
@@ -486,13 +552,13 @@ std::vector<Image> TensorsToSegmentationCalculator::GetSegmentationResultCpu(
     const float* tensors_buffer) {
   if (options_.segmenter_options().output_type() ==
       SegmenterOptions::CATEGORY_MASK) {
-    return {ProcessForCategoryMaskCpu(input_shape, output_shape,
-                                      options_.segmenter_options(),
-                                      tensors_buffer)};
+    return {ProcessForCategoryMaskCpu(
+        input_shape, output_shape, options_.segmenter_options(),
+        tensors_buffer, image_pool_, tile_executor_)};
   } else {
-    return ProcessForConfidenceMaskCpu(input_shape, output_shape,
-                                       options_.segmenter_options(),
-                                       tensors_buffer);
+    return ProcessForConfidenceMaskCpu(
+        input_shape, output_shape, options_.segmenter_options(),
+        tensors_buffer, image_pool_, tile_executor_);
   }
 }
 
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -24,15 +25,18 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "mediapipe/calculators/image/image_tiling.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/calculator_runner.h"
 #include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/parse_text_proto.h"
 #include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 #include "mediapipe/tasks/cc/vision/image_segmenter/calculators/tensors_to_segmentation_calculator.pb.h"
 
 namespace mediapipe {
@@ -361,4 +365,107 @@ TEST(TensorsToSegmentationCalculatorTest, SucceedsCategoryMaskResize) {
                                             expected_index, buffer_indices)));
 }
 
+// Runs the calculator with softmax activation on a tensor of the given size
+// with 3 channels, and returns its 3 confidence masks and category mask.
+std::vector<Packet> RunSoftmaxSegmentation(int tensor_height, int tensor_width,
+                                           int output_height, int output_width,
+                                           bool enable_cpu_tiling) {
+  CalculatorGraphConfig graph_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrFormat(
+          R"pb(
+            input_stream: "tensors"
+            input_stream: "size"
+            node {
+              calculator: "mediapipe.tasks.TensorsToSegmentationCalculator"
+              input_stream: "TENSORS:tensors"
+              input_stream: "OUTPUT_SIZE:size"
+              output_stream: "CONFIDENCE_MASK:0:confidence_mask_0"
+              output_stream: "CONFIDENCE_MASK:1:confidence_mask_1"
+              output_stream: "CONFIDENCE_MASK:2:confidence_mask_2"
+              output_stream: "CATEGORY_MASK:category_mask"
+              options {
+                [mediapipe.tasks.TensorsToSegmentationCalculatorOptions.ext] {
+                  segmenter_options { activation: SOFTMAX }
+                  enable_cpu_tiling: %s
+                }
+              }
+            }
+          )pb",
+          enable_cpu_tiling ? "true" : "false"));
+  std::vector<Packet> output_packets;
+  for (const char* stream : {"confidence_mask_0", "confidence_mask_1",
+                             "confidence_mask_2", "category_mask"}) {
+    graph_config.add_output_stream(stream);
+  }
+
+  CalculatorGraph graph;
+  MP_EXPECT_OK(graph.Initialize(graph_config));
+  MP_EXPECT_OK(graph.SetServiceObject(
+      kImageTilingExecutorService,
+      std::make_shared<ThreadPoolExecutor>(/*num_threads=*/3)));
+  std::vector<std::unique_ptr<OutputStreamPoller>> pollers;
+  for (int i = 0; i < graph_config.output_stream_size(); ++i) {
+    auto poller = graph.AddOutputStreamPoller(graph_config.output_stream(i));
+    MP_EXPECT_OK(poller.status());
+    pollers.push_back(
+        std::make_unique<OutputStreamPoller>(std::move(poller).value()));
+  }
+  MP_EXPECT_OK(graph.StartRun({}));
+
+  std::vector<Tensor> tensors;
+  tensors.emplace_back(Tensor::ElementType::kFloat32,
+                       Tensor::Shape{1, tensor_height, tensor_width, 3});
+  {
+    auto view = tensors.back().GetCpuWriteView();
+    float* buffer = view.buffer<float>();
+    for (int i = 0; i < tensor_height * tensor_width * 3; ++i) {
+      buffer[i] = std::sin(i * 0.37f) * 4.0f;
+    }
+  }
+  MP_EXPECT_OK(graph.AddPacketToInputStream(
+      "tensors",
+      MakePacket<std::vector<Tensor>>(std::move(tensors)).At(Timestamp(0))));
+  MP_EXPECT_OK(graph.AddPacketToInputStream(
+      "size", MakePacket<std::pair<int, int>>(output_width, output_height)
+                  .At(Timestamp(0))));
+  MP_EXPECT_OK(graph.CloseAllInputStreams());
+  for (auto& poller : pollers) {
+    Packet packet;
+    EXPECT_TRUE(poller->Next(&packet));
+    output_packets.push_back(packet);
+  }
+  MP_EXPECT_OK(graph.WaitUntilDone());
+  return output_packets;
+}
+
+TEST(TensorsToSegmentationCalculatorTest, CpuTilingKeepsMasks) {
+  for (const auto& [output_height, output_width] :
+       std::vector<std::pair<int, int>>{{24, 40}, {101, 67}}) {
+    const std::vector<Packet> expected = RunSoftmaxSegmentation(
+        /*tensor_height=*/24, /*tensor_width=*/40, output_height, output_width,
+        /*enable_cpu_tiling=*/false);
+    const std::vector<Packet> packets = RunSoftmaxSegmentation(
+        /*tensor_height=*/24, /*tensor_width=*/40, output_height, output_width,
+        /*enable_cpu_tiling=*/true);
+    ASSERT_EQ(packets.size(), expected.size());
+    for (int i = 0; i < packets.size(); ++i) {
+      const ImageFrame& frame =
+          *packets[i].Get<Image>().GetImageFrameSharedPtr();
+      const ImageFrame& expected_frame =
+          *expected[i].Get<Image>().GetImageFrameSharedPtr();
+      ASSERT_EQ(frame.Width(), output_width);
+      ASSERT_EQ(frame.Height(), output_height);
+      ASSERT_EQ(frame.Format(), expected_frame.Format());
+      const int row_size = frame.Width() * frame.ByteDepth();
+      for (int y = 0; y < frame.Height(); ++y) {
+        EXPECT_TRUE(std::equal(
+            frame.PixelData() + y * frame.WidthStep(),
+            frame.PixelData() + y * frame.WidthStep() + row_size,
+            expected_frame.PixelData() + y * expected_frame.WidthStep()))
+            << "mask " << i << ", row " << y;
+      }
+    }
+  }
+}
+
 }  // namespace mediapipe
@@ -16,13 +16,17 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#include "Eigen/Core"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/str_cat.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/framework/formats/time_series_header.pb.h"
 
 namespace mediapipe {
@@ -132,5 +136,100 @@ double SamplesToSeconds(int64_t num_samples, double sample_rate) {
   return (num_samples / sample_rate);
 }
 
+void SampleBuffer::Reset(int num_channels) {
+  ABSL_CHECK_GE(num_channels, 0);
+  if (num_channels != storage_.rows()) {
+    storage_.resize(num_channels, 0);
+  }
+  begin_ = 0;
+  end_ = 0;
+}
+
+void SampleBuffer::Reserve(int num_samples) {
+  ABSL_CHECK_GE(num_samples, 0);
+  // Extend() only moves the buffered samples when they fill at most half of
+  // the storage.
+  if (storage_.cols() < 2 * num_samples) {
+    Reallocate(2 * num_samples);
+  }
+}
+
+void SampleBuffer::Push(const Eigen::Ref<const Matrix>& samples) {
+  ABSL_CHECK_EQ(samples.rows(), num_channels());
+  const int count = samples.cols();
+  float* dst = Extend(count);
+  if (samples.size() == 0) return;
+  if (samples.outerStride() == samples.rows()) {
+    std::memcpy(dst, samples.data(), samples.size() * sizeof(float));
+  } else {
+    Eigen::Map<Matrix>(dst, num_channels(), count) = samples;
+  }
+}
+
+void SampleBuffer::PushZeros(int count) {
+  ABSL_CHECK_GE(count, 0);
+  float* dst = Extend(count);
+  std::fill(dst, dst + static_cast<size_t>(count) * num_channels(), 0.0f);
+}
+
+SampleBuffer::View SampleBuffer::Samples(int offset, int count) const {
+  ABSL_CHECK_GE(offset, 0);
+  ABSL_CHECK_GE(count, 0);
+  ABSL_CHECK_LE(offset + count, num_samples());
+  return View(storage_.data() + static_cast<size_t>(begin_ + offset) *
+                                    num_channels(),
+              num_channels(), count);
+}
+
+int SampleBuffer::Drop(int count) {
+  const int num_dropped = std::min(std::max(count, 0), num_samples());
+  begin_ += num_dropped;
+  if (begin_ == end_) {
+    begin_ = 0;
+    end_ = 0;
+  }
+  return num_dropped;
+}
+
+float* SampleBuffer::Extend(int count) {
+  const int num_buffered = num_samples();
+  if (end_ + count > storage_.cols()) {
+    if (2 * (num_buffered + count) <= storage_.cols()) {
+      // Moves the buffered samples to the front, which copies at most half
+      // as many samples as the room it makes.
+      if (num_buffered > 0) {
+        std::memmove(storage_.data(),
+                     storage_.data() +
+                         static_cast<size_t>(begin_) * num_channels(),
+                     static_cast<size_t>(num_buffered) * num_channels() *
+                         sizeof(float));
+      }
+      begin_ = 0;
+      end_ = num_buffered;
+    } else {
+      Reallocate(2 * (num_buffered + count));
+    }
+  }
+  float* samples =
+      storage_.data() + static_cast<size_t>(end_) * num_channels();
+  end_ += count;
+  return samples;
+}
+
+void SampleBuffer::Reallocate(int capacity) {
+  const int num_buffered = num_samples();
+  ABSL_CHECK_GE(capacity, num_buffered);
+  Matrix storage(num_channels(), capacity);
+  if (num_buffered > 0) {
+    std::memcpy(storage.data(),
+                storage_.data() + static_cast<size_t>(begin_) * num_channels(),
+                static_cast<size_t>(num_buffered) * num_channels() *
+                    sizeof(float));
+  }
+  storage_.swap(storage);
+  begin_ = 0;
+  end_ = num_buffered;
+}
+
 }  // namespace time_series_util
 }  // namespace mediapipe
@@ -21,6 +21,7 @@
 #include <string>
 #include <typeinfo>
 
+#include "Eigen/Core"
 #include "absl/strings/str_cat.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
@@ -108,6 +109,61 @@ void SetExtensionInHeader(const TimeSeriesHeaderExtensionClass& extension,
       ->CopyFrom(extension);
 }
 
+// A buffer of multichannel samples, for calculators that frame time series.
+// The samples are stored interleaved by channel, as the columns of a Matrix.
+//
+// Samples are pushed at the back and dropped from the front. Unlike in a
+// circular buffer, the buffered samples stay contiguous, so that any range of
+// them can be read as a Matrix view without copies. When the back of the
+// storage is reached, the buffered samples are moved to its front, which costs
+// little as long as they only fill a fraction of the storage. The storage only
+// grows when it can't hold the buffered samples, so pushing samples doesn't
+// allocate once the buffer has reached its steady state.
+class SampleBuffer {
+ public:
+  using View = Eigen::Map<const Matrix>;
+
+  explicit SampleBuffer(int num_channels = 0) { Reset(num_channels); }
+
+  // Drops all the samples and sets the number of channels.
+  void Reset(int num_channels);
+  // Allocates the storage so that pushes never allocate while at most
+  // `num_samples` samples are buffered.
+  void Reserve(int num_samples);
+
+  int num_channels() const { return storage_.rows(); }
+  // Number of buffered samples.
+  int num_samples() const { return end_ - begin_; }
+
+  // Pushes the columns of `samples`, which must have num_channels() rows.
+  void Push(const Eigen::Ref<const Matrix>& samples);
+  // Pushes `count` zero samples.
+  void PushZeros(int count);
+
+  // Returns a view of `count` buffered samples, starting from the
+  // `offset`-th one. The view is invalidated by the next Push.
+  View Samples(int offset, int count) const;
+  // Returns a view of all the buffered samples.
+  View Samples() const { return Samples(0, num_samples()); }
+
+  // Drops up to `count` samples from the front of the buffer. Returns how many
+  // samples were dropped.
+  int Drop(int count);
+
+ private:
+  // Makes room for `count` samples at the back of the storage and returns
+  // where they should be written.
+  float* Extend(int count);
+  // Moves the buffered samples to the front of a new storage of `capacity`
+  // samples.
+  void Reallocate(int capacity);
+
+  // Each column is a sample. The buffered samples are in [begin_, end_).
+  Matrix storage_;
+  int begin_ = 0;
+  int end_ = 0;
+};
+
 // Converts from a time_in_seconds to an integer number of samples.
 int64_t SecondsToSamples(double time_in_seconds, double sample_rate);
 
@@ -192,6 +192,81 @@ TEST(TimeSeriesUtilTest, SamplesToSeconds) {
             SamplesToSeconds(num_samples, sample_rate));
 }
 
+TEST(SampleBufferTest, PushViewAndDrop) {
+  SampleBuffer buffer(/*num_channels=*/2);
+  Matrix samples(2, 3);
+  samples << 1, 2, 3,  //
+      4, 5, 6;
+  buffer.Push(samples);
+  ASSERT_EQ(buffer.num_samples(), 3);
+  EXPECT_EQ(Matrix(buffer.Samples()), samples);
+  EXPECT_EQ(Matrix(buffer.Samples(1, 2)), samples.rightCols(2));
+
+  EXPECT_EQ(buffer.Drop(2), 2);
+  ASSERT_EQ(buffer.num_samples(), 1);
+  EXPECT_EQ(Matrix(buffer.Samples()), samples.rightCols(1));
+  EXPECT_EQ(buffer.Drop(5), 1);
+  EXPECT_EQ(buffer.num_samples(), 0);
+}
+
+TEST(SampleBufferTest, KeepsSamplesThroughCompactionAndGrowth) {
+  SampleBuffer buffer(/*num_channels=*/3);
+  Matrix expected(3, 0);
+  for (int i = 0; i < 50; ++i) {
+    const Matrix samples = Matrix::Random(3, 1 + i % 7);
+    buffer.Push(samples);
+    Matrix appended(3, expected.cols() + samples.cols());
+    appended << expected, samples;
+    expected = appended;
+    const int dropped = buffer.Drop(i % 5);
+    expected = Matrix(expected.rightCols(expected.cols() - dropped));
+    ASSERT_EQ(Matrix(buffer.Samples()), expected) << "push " << i;
+  }
+}
+
+TEST(SampleBufferTest, PushZeros) {
+  SampleBuffer buffer(/*num_channels=*/2);
+  buffer.Push(Matrix::Ones(2, 2));
+  buffer.PushZeros(3);
+  Matrix expected(2, 5);
+  expected << Matrix::Ones(2, 2), Matrix::Zero(2, 3);
+  EXPECT_EQ(Matrix(buffer.Samples()), expected);
+}
+
+TEST(SampleBufferTest, PushesBlockOfLargerMatrix) {
+  const Matrix samples = Matrix::Random(4, 6);
+  SampleBuffer buffer(/*num_channels=*/2);
+  buffer.Push(samples.block(1, 2, 2, 3));
+  EXPECT_EQ(Matrix(buffer.Samples()), Matrix(samples.block(1, 2, 2, 3)));
+}
+
+TEST(SampleBufferTest, PushesWithoutReallocationAfterReserve) {
+  SampleBuffer buffer(/*num_channels=*/2);
+  buffer.Reserve(/*num_samples=*/8);
+  buffer.Push(Matrix::Ones(2, 1));
+  // The reserved storage holds 16 samples.
+  const float* storage_begin = buffer.Samples().data();
+  const float* storage_end = storage_begin + 2 * 16;
+  for (int i = 0; i < 20; ++i) {
+    const Matrix samples = Matrix::Random(2, 1 + i % 7);
+    buffer.Push(samples);
+    buffer.Drop(buffer.num_samples() - 1);
+    ASSERT_EQ(Matrix(buffer.Samples()), samples.rightCols(1));
+    EXPECT_GE(buffer.Samples().data(), storage_begin);
+    EXPECT_LE(buffer.Samples().data() + 2, storage_end);
+  }
+}
+
+TEST(SampleBufferTest, Reset) {
+  SampleBuffer buffer(/*num_channels=*/2);
+  buffer.Push(Matrix::Ones(2, 4));
+  buffer.Reset(/*num_channels=*/1);
+  EXPECT_EQ(buffer.num_channels(), 1);
+  EXPECT_EQ(buffer.num_samples(), 0);
+  buffer.Push(Matrix::Ones(1, 2));
+  EXPECT_EQ(Matrix(buffer.Samples()), Matrix::Ones(1, 2));
+}
+
 }  // namespace
 }  // namespace time_series_util
 }  // namespace mediapipe
@@ -16,17 +16,28 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <cstdint>
-#include <fstream>
 #include <limits>
-
+#include <map>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "absl/cleanup/cleanup.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "mediapipe/framework/port/file_helpers.h"
 #include "mediapipe/framework/port/logging.h"
+#include "mediapipe/util/tracking/indexed_tracking_data_chunk.h"
 #include "mediapipe/util/tracking/measure_time.h"
 #include "mediapipe/util/tracking/tracking.pb.h"
 
@@ -286,12 +297,61 @@ void BoxTracker::NewBoxTrack(const TimedBox& initial_pos, int id,
   ++track_status_[id][kInitCheckpoint].tracks_ongoing;
 
   auto operation = [this, initial_pos, id, min_msec, max_msec]() {
-    this->NewBoxTrackAsync(initial_pos, id, min_msec, max_msec);
+    this->NewBoxTrackAsync({initial_pos}, {id}, min_msec, max_msec);
   };
 
   tracking_workers_->Schedule(operation);
 }
 
+void BoxTracker::NewBoxTrackBatch(
+    const std::vector<TimedBox>& initial_positions, const std::vector<int>& ids,
+    int64_t min_msec, int64_t max_msec) {
+  ABSL_CHECK_EQ(initial_positions.size(), ids.size());
+  VLOG(1) << "New box track batch of " << ids.size() << " boxes from "
+          << min_msec << " to " << max_msec;
+
+  // Boxes tracked jointly, grouped by start time.
+  struct Batch {
+    std::vector<TimedBox> initial_positions;
+    std::vector<int> ids;
+  };
+  std::map<int64_t, Batch> batches;
+  std::set<std::pair<int64_t, int>> batch_ids;
+  for (int k = 0; k < ids.size(); ++k) {
+    const int64_t time_msec = initial_positions[k].time_msec;
+    if (!batch_ids.emplace(time_msec, ids[k]).second) {
+      ABSL_LOG(ERROR) << "Duplicate id " << ids[k] << " in batch. Ignoring "
+                      << initial_positions[k].ToString();
+      continue;
+    }
+    Batch& batch = batches[time_msec];
+    batch.initial_positions.push_back(initial_positions[k]);
+    batch.ids.push_back(ids[k]);
+  }
+
+  // Mark initialization with checkpoint -1.
+  absl::MutexLock lock(&status_mutex_);
+
+  if (canceling_) {
+    ABSL_LOG(WARNING) << "Box Tracker is in cancel state. Refusing request.";
+    return;
+  }
+
+  for (const auto& time_and_batch : batches) {
+    const Batch& batch = time_and_batch.second;
+    for (int id : batch.ids) {
+      ++track_status_[id][kInitCheckpoint].tracks_ongoing;
+    }
+
+    auto operation = [this, batch, min_msec, max_msec]() {
+      this->NewBoxTrackAsync(batch.initial_positions, batch.ids, min_msec,
+                             max_msec);
+    };
+
+    tracking_workers_->Schedule(operation);
+  }
+}
+
 std::pair<int64_t, int64_t> BoxTracker::TrackInterval(int id) {
   absl::MutexLock lock(&path_mutex_);
   const Path& path = paths_[id];
@@ -306,109 +366,159 @@ std::pair<int64_t, int64_t> BoxTracker::TrackInterval(int id) {
                         last_interval.back().time_msec);
 }
 
-void BoxTracker::NewBoxTrackAsync(const TimedBox& initial_pos, int id,
-                                  int64_t min_msec, int64_t max_msec) {
-  VLOG(1) << "Async track for id: " << id << " from " << min_msec << " to "
-          << max_msec;
+void BoxTracker::NewBoxTrackAsync(
+    const std::vector<TimedBox>& initial_positions, const std::vector<int>& ids,
+    int64_t min_msec, int64_t max_msec) {
+  ABSL_CHECK(!ids.empty());
+  const TimedBox& initial_pos = initial_positions[0];
+  VLOG(1) << "Async track for " << ids.size() << " ids, first id: " << ids[0]
+          << " from " << min_msec << " to " << max_msec;
+
+  // Ends initialization for all ids if the request can not be scheduled.
+  auto abort_request = [this, &ids]() {
+    absl::MutexLock lock(&status_mutex_);
+    for (int id : ids) {
+      --track_status_[id][kInitCheckpoint].tracks_ongoing;
+    }
+    status_condvar_.SignalAll();
+  };
 
   // Determine start position and track forward and backward.
   int chunk_idx = ChunkIdxFromTime(initial_pos.time_msec);
 
   VLOG(1) << "Starting at chunk " << chunk_idx;
 
-  AugmentedChunkPtr tracking_chunk(ReadChunk(id, kInitCheckpoint, chunk_idx));
+  // Indexed cache files are read in two steps: first only the timestamps, to
+  // determine the start frame, then the items each direction tracks through.
+  IndexedItemSelection timestamps_only;
+  timestamps_only.end_item = 0;
+  bool items_selected = false;
+  AugmentedChunkPtr tracking_chunk(ReadChunk(
+      ids, kInitCheckpoint, chunk_idx, timestamps_only, &items_selected));
 
   if (!tracking_chunk.first) {
-    absl::MutexLock lock(&status_mutex_);
-    --track_status_[id][kInitCheckpoint].tracks_ongoing;
+    abort_request();
     ABSL_LOG(ERROR) << "Could not read tracking chunk from file: " << chunk_idx
                     << " for start position: " << initial_pos.ToString();
     return;
   }
 
-  // Grab ownership here, to avoid any memory leaks due to early return.
-  std::unique_ptr<const TrackingDataChunk> chunk_owned;
-  if (tracking_chunk.second) {
-    chunk_owned.reset(tracking_chunk.first);
-  }
+  // Grab ownership here, to avoid any memory leaks due to early return. Both
+  // directions share the chunk, unless read partially below.
+  TrackingImplArgs forward_args(tracking_chunk, {}, {}, 0, chunk_idx,
+                                kInitCheckpoint, /*forward_=*/true, min_msec,
+                                max_msec);
 
   const int start_frame =
-      ClosestFrameIndex(initial_pos.time_msec, *tracking_chunk.first);
+      ClosestFrameIndex(initial_pos.time_msec, *forward_args.chunk_data);
 
   VLOG(1) << "Local start frame: " << start_frame;
 
   // Update starting position to coincide with a frame.
-  TimedBox start_pos = initial_pos;
-  start_pos.time_msec =
-      tracking_chunk.first->item(start_frame).timestamp_usec() / 1000;
+  const int checkpoint =
+      forward_args.chunk_data->item(start_frame).timestamp_usec() / 1000;
 
   VLOG(1) << "Request at " << initial_pos.time_msec << " revised to "
-          << start_pos.time_msec;
-
-  const int checkpoint = start_pos.time_msec;
+          << checkpoint;
+
+  forward_args.start_frame = start_frame;
+  forward_args.checkpoint = checkpoint;
+  TrackingImplArgs backward_args = forward_args;
+  backward_args.forward = false;
+
+  if (items_selected) {
+    // Forward tracking reads the items from the start frame on up to max_msec,
+    // backward tracking the items up to the start frame down to min_msec.
+    IndexedItemSelection forward_items;
+    forward_items.begin_item = start_frame;
+    forward_items.max_msec = max_msec;
+    IndexedItemSelection backward_items;
+    backward_items.end_item = start_frame + 1;
+    backward_items.min_msec = min_msec;
+    forward_args.SetChunk(
+        ReadChunk(ids, kInitCheckpoint, chunk_idx, forward_items));
+    backward_args.SetChunk(
+        ReadChunk(ids, kInitCheckpoint, chunk_idx, backward_items));
+    if (!forward_args.chunk_data || !backward_args.chunk_data) {
+      abort_request();
+      ABSL_LOG(ERROR) << "Could not read tracking chunk from file: "
+                      << chunk_idx
+                      << " for start position: " << initial_pos.ToString();
+      return;
+    }
+  }
 
   // TODO:
   // Compute min and max for tracking based on existing check points.
-  if (!WaitToScheduleId(id)) {
-    // Could not schedule, id already being canceled.
+  // Ids are scheduled in increasing order, so that requests sharing ids can
+  // not wait on each other.
+  std::vector<int> order(ids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&ids](int lhs, int rhs) { return ids[lhs] < ids[rhs]; });
+  std::vector<int> scheduled;
+  for (int k : order) {
+    // Skips ids that could not be scheduled, as already being canceled.
+    if (WaitToScheduleId(ids[k])) {
+      scheduled.push_back(k);
+    }
+  }
+  if (scheduled.empty()) {
     return;
   }
 
-  // If another checkpoint is close by, cancel that one.
-  VLOG(1) << "Removing close checkpoints";
   absl::MutexLock lock(&status_mutex_);
-  RemoveCloseCheckpoints(id, checkpoint);
-
-  VLOG(1) << "Cancel existing tracks";
-  CancelTracking(id, checkpoint);
-
-  // Remove checkpoint results (to be replaced with current one).
-  ClearCheckpoint(id, checkpoint);
-
-  MotionBoxState start_state;
-  MotionBoxStateFromTimedBox(start_pos, &start_state);
-
-  VLOG(1) << "Adding initial result";
-  AddBoxResult(start_pos, id, checkpoint, start_state);
-
-  // Perform forward and backward tracking and add to current PathSegment.
-  // Track forward.
-  track_status_[id][checkpoint].tracks_ongoing += 2;
+  for (int k : scheduled) {
+    const int id = ids[k];
+    // If another checkpoint is close by, cancel that one.
+    VLOG(1) << "Removing close checkpoints";
+    RemoveCloseCheckpoints(id, checkpoint);
+
+    VLOG(1) << "Cancel existing tracks";
+    CancelTracking(id, checkpoint);
+
+    // Remove checkpoint results (to be replaced with current one).
+    ClearCheckpoint(id, checkpoint);
+
+    TimedBox start_pos = initial_positions[k];
+    start_pos.time_msec = checkpoint;
+    MotionBoxState start_state;
+    MotionBoxStateFromTimedBox(start_pos, &start_state);
+
+    VLOG(1) << "Adding initial result";
+    AddBoxResult(start_pos, id, checkpoint, start_state);
+
+    // Perform forward and backward tracking and add to current PathSegment.
+    track_status_[id][checkpoint].tracks_ongoing += 2;
+    forward_args.ids.push_back(id);
+    forward_args.start_states.push_back(start_state);
+  }
+  backward_args.ids = forward_args.ids;
+  backward_args.start_states = forward_args.start_states;
 
   VLOG(1) << "Starting tracking workers ... ";
 
-  AugmentedChunkPtr forward_chunk = tracking_chunk;
-  AugmentedChunkPtr backward_chunk = tracking_chunk;
-
-  if (tracking_chunk.second) {  // We have ownership, need a copy here.
-    forward_chunk = std::make_pair(new TrackingDataChunk(*chunk_owned), true);
-    backward_chunk = std::make_pair(chunk_owned.release(), true);
-  }
-
-  auto forward_operation = [this, forward_chunk, start_state, start_frame,
-                            chunk_idx, id, checkpoint, min_msec, max_msec]() {
-    this->TrackingImpl(TrackingImplArgs(forward_chunk, start_state, start_frame,
-                                        chunk_idx, id, checkpoint, true, true,
-                                        min_msec, max_msec));
+  // Track forward.
+  auto forward_operation = [this, forward_args]() {
+    this->TrackingImpl(forward_args);
   };
 
   tracking_workers_->Schedule(forward_operation);
 
   // Track backward.
-  auto backward_operation = [this, backward_chunk, start_state, start_frame,
-                             chunk_idx, id, checkpoint, min_msec, max_msec]() {
-    this->TrackingImpl(TrackingImplArgs(backward_chunk, start_state,
-                                        start_frame, chunk_idx, id, checkpoint,
-                                        false, true, min_msec, max_msec));
+  auto backward_operation = [this, backward_args]() {
+    this->TrackingImpl(backward_args);
   };
 
   tracking_workers_->Schedule(backward_operation);
 
-  DoneSchedulingId(id);
+  for (int k : scheduled) {
+    DoneSchedulingId(ids[k]);
+  }
 
   // Tell a waiting request that we are done scheduling.
   status_condvar_.SignalAll();
-  VLOG(1) << "Scheduling done for " << id;
+  VLOG(1) << "Scheduling done for " << forward_args.ids.size() << " ids";
 }
 
 void BoxTracker::RemoveCloseCheckpoints(int id, int checkpoint) {
@@ -570,6 +680,16 @@ bool BoxTracker::IsTrackingOngoing() {
   return IsTrackingOngoingMutexHeld();
 }
 
+bool BoxTracker::IsCancelingId(int id) {
+  absl::MutexLock lock(&status_mutex_);
+  for (const auto& item : track_status_[id]) {
+    if (item.second.canceled) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool BoxTracker::IsTrackingOngoingMutexHeld() {
   for (const auto& id : track_status_) {
     for (const auto& item : id.second) {
@@ -581,9 +701,14 @@ bool BoxTracker::IsTrackingOngoingMutexHeld() {
   return false;
 }
 
-BoxTracker::AugmentedChunkPtr BoxTracker::ReadChunk(int id, int checkpoint,
-                                                    int chunk_idx) {
-  VLOG(1) << __FUNCTION__ << " id=" << id << " chunk_idx=" << chunk_idx;
+BoxTracker::AugmentedChunkPtr BoxTracker::ReadChunk(
+    const std::vector<int>& ids, int checkpoint, int chunk_idx,
+    const IndexedItemSelection& selection, bool* items_selected) {
+  VLOG(1) << __FUNCTION__ << " ids=" << ids.size() << " chunk_idx="
+          << chunk_idx;
+  if (items_selected) {
+    *items_selected = false;
+  }
   if (cache_dir_.empty() && !tracking_data_.empty()) {
     if (chunk_idx < tracking_data_.size()) {
       return std::make_pair(tracking_data_[chunk_idx], false);
@@ -592,15 +717,17 @@ BoxTracker::AugmentedChunkPtr BoxTracker::ReadChunk(int id, int checkpoint,
       return std::make_pair(nullptr, false);
     }
   } else {
-    std::unique_ptr<TrackingDataChunk> chunk_data(
-        ReadChunkFromCache(id, checkpoint, chunk_idx));
+    std::unique_ptr<TrackingDataChunk> chunk_data(ReadChunkFromCache(
+        ids, checkpoint, chunk_idx, selection, items_selected));
     return std::make_pair(chunk_data.release(), true);
   }
 }
 
 std::unique_ptr<TrackingDataChunk> BoxTracker::ReadChunkFromCache(
-    int id, int checkpoint, int chunk_idx) {
-  VLOG(1) << __FUNCTION__ << " id=" << id << " chunk_idx=" << chunk_idx;
+    const std::vector<int>& ids, int checkpoint, int chunk_idx,
+    const IndexedItemSelection& selection, bool* items_selected) {
+  VLOG(1) << __FUNCTION__ << " ids=" << ids.size() << " chunk_idx="
+          << chunk_idx;
 
   auto format_runtime =
       absl::ParsedFormat<'d'>::New(options_.cache_file_format());
@@ -618,33 +745,53 @@ std::unique_ptr<TrackingDataChunk> BoxTracker::ReadChunkFromCache(
 
   struct stat tmp;
   if (stat(chunk_file.c_str(), &tmp)) {
-    if (!WaitForChunkFile(id, checkpoint, chunk_file)) {
+    if (!WaitForChunkFile(ids, checkpoint, chunk_file)) {
       return nullptr;
     }
   }
 
   VLOG(1) << "File exists, reading ...";
 
-  std::ifstream in(chunk_file, std::ios::in | std::ios::binary);
-  if (!in) {
-    ABSL_LOG(ERROR) << "Could not read chunk file: " << chunk_file;
+  // Parses directly from the mapped file, which avoids copying it and, for
+  // indexed files, only pages in the selected items.
+  auto mapped_file = file::MMapFile(chunk_file);
+  if (!mapped_file.ok()) {
+    ABSL_LOG(ERROR) << "Could not read chunk file: " << chunk_file << " "
+                    << mapped_file.status();
+    return nullptr;
+  }
+  absl::Cleanup unmap_file = [&mapped_file, &chunk_file]() {
+    const absl::Status status = (*mapped_file)->Close();
+    if (!status.ok()) {
+      ABSL_LOG(WARNING) << "Could not close chunk file: " << chunk_file << " "
+                        << status;
+    }
+  };
+  const absl::string_view data(
+      static_cast<const char*>((*mapped_file)->BaseAddress()),
+      (*mapped_file)->Length());
+
+  if (IsIndexedTrackingDataChunk(data)) {
+    const absl::Status status =
+        ParseIndexedTrackingDataChunk(data, selection, chunk_data.get());
+    if (!status.ok()) {
+      ABSL_LOG(ERROR) << "Could not parse chunk file: " << chunk_file << " "
+                      << status;
+      return nullptr;
+    }
+    if (items_selected) {
+      *items_selected = true;
+    }
+  } else if (!chunk_data->ParseFromArray(data.data(), data.size())) {
+    ABSL_LOG(ERROR) << "Could not parse chunk file: " << chunk_file;
     return nullptr;
   }
-
-  std::string data;
-  in.seekg(0, std::ios::end);
-  data.resize(in.tellg());
-  in.seekg(0, std::ios::beg);
-  in.read(&data[0], data.size());
-  in.close();
-
-  chunk_data->ParseFromString(data);
 
   VLOG(1) << "Read success";
   return chunk_data;
 }
 
-bool BoxTracker::WaitForChunkFile(int id, int checkpoint,
+bool BoxTracker::WaitForChunkFile(const std::vector<int>& ids, int checkpoint,
                                   const std::string& chunk_file) {
   VLOG(1) << "Chunk no exists, waiting for file: " << chunk_file;
 
@@ -661,10 +808,15 @@ bool BoxTracker::WaitForChunkFile(int id, int checkpoint,
   bool file_exists = false;
 
   while (!file_exists && total_wait_msec < timeout_msec) {
-    // Check if we got canceled.
+    // Check if we got canceled. Boxes of a batch that got canceled are only
+    // dropped once tracking resumes, the others keep waiting.
     {
       absl::MutexLock lock(&status_mutex_);
-      if (track_status_[id][checkpoint].canceled) {
+      bool all_canceled = true;
+      for (int id : ids) {
+        all_canceled &= track_status_[id][checkpoint].canceled;
+      }
+      if (all_canceled) {
         return false;
       }
     }
@@ -746,166 +898,190 @@ void BoxTracker::ClearCheckpoint(int id, int checkpoint) {
   segment.clear();
 }
 
-void BoxTracker::TrackingImpl(const TrackingImplArgs& a) {
-  TrackStepOptions track_step_options = options_.track_step_options();
-  ChangeTrackingDegreesBasedOnStartPos(a.start_state, &track_step_options);
-  MotionBox motion_box(track_step_options);
-  const int chunk_data_size = a.chunk_data->item_size();
-
-  ABSL_CHECK_GE(a.start_frame, 0);
-  ABSL_CHECK_LT(a.start_frame, chunk_data_size);
+void BoxTracker::DoneTracking(int id, int checkpoint) {
+  // Signal we are done processing in this direction.
+  absl::MutexLock lock(&status_mutex_);
+  --track_status_[id][checkpoint].tracks_ongoing;
+  status_condvar_.SignalAll();
+}
 
-  VLOG(1) << " a.start_frame = " << a.start_frame << " @"
-          << a.chunk_data->item(a.start_frame).timestamp_usec() << " with "
-          << chunk_data_size << " items";
-  motion_box.ResetAtFrame(a.start_frame, a.start_state);
+void BoxTracker::TrackingImpl(const TrackingImplArgs& args) {
+  // Advanced chunk by chunk, with the boxes that are still being tracked.
+  TrackingImplArgs a = args;
+  std::vector<MotionBox> motion_boxes;
+
+  // Tracks all boxes by one frame with the motion in mvf and adds their
+  // results at result_msec. Ends the tracks of boxes that fail or got
+  // canceled.
+  auto track_step = [this, &a, &motion_boxes](int from_frame, int to_frame,
+                                              const MotionVectorFrame& mvf,
+                                              int64_t result_msec) {
+    const int num_boxes = a.ids.size();
+    std::vector<bool> tracked(num_boxes);
+    for (int k = 0; k < num_boxes; ++k) {
+      tracked[k] = motion_boxes[k].TrackStep(from_frame, mvf, a.forward);
+      if (!tracked[k]) {
+        VLOG(1) << "Failed " << (a.forward ? "forward" : "backward")
+                << " at frame: " << from_frame << " for id: " << a.ids[k];
+      }
+    }
 
-  auto cleanup_func = [&a, this]() -> void {
-    if (a.first_call) {
-      // Signal we are done processing in this direction.
+    // Test if current requests are canceled.
+    {
       absl::MutexLock lock(&status_mutex_);
-      --track_status_[a.id][a.checkpoint].tracks_ongoing;
-      status_condvar_.SignalAll();
+      for (int k = 0; k < num_boxes; ++k) {
+        if (tracked[k] && track_status_[a.ids[k]][a.checkpoint].canceled) {
+          tracked[k] = false;
+        }
+      }
     }
-  };
 
-  if (a.forward) {
-    // TrackingData at frame f, contains tracking information from
-    // frame f to f - 1. Get information at frame f + 1 and invert:
-    // Tracking from f to f + 1.
-    for (int f = a.start_frame; f + 1 < chunk_data_size; ++f) {
-      // Note: we use / 1000 instead of * 1000 to avoid overflow.
-      if (a.chunk_data->item(f + 1).timestamp_usec() / 1000 > a.max_msec) {
-        VLOG(2) << "Reached maximum tracking timestamp @" << a.max_msec;
-        break;
-      }
-      VLOG(1) << "Track forward from " << f;
-      MotionVectorFrame mvf;
-      MotionVectorFrameFromTrackingData(
-          a.chunk_data->item(f + 1).tracking_data(), &mvf);
-      const int track_duration_ms =
-          TrackingDataDurationMs(a.chunk_data->item(f + 1));
-      if (track_duration_ms > 0) {
-        mvf.duration_ms = track_duration_ms;
+    int num_tracked = 0;
+    for (int k = 0; k < num_boxes; ++k) {
+      if (!tracked[k]) {
+        DoneTracking(a.ids[k], a.checkpoint);
+        continue;
       }
+      TimedBox result;
+      const MotionBoxState& result_state =
+          motion_boxes[k].StateAtFrame(to_frame);
+      TimedBoxFromMotionBoxState(result_state, &result);
+      result.time_msec = result_msec;
+      AddBoxResult(result, a.ids[k], a.checkpoint, result_state);
+
+      a.ids[num_tracked] = a.ids[k];
+      motion_boxes[num_tracked] = std::move(motion_boxes[k]);
+      ++num_tracked;
+    }
+    a.ids.resize(num_tracked);
+    motion_boxes.resize(num_tracked);
+  };
 
-      // If this is the first frame in a chunk, there might be an unobserved
-      // chunk boundary at the first frame.
-      if (f == 0 && a.chunk_data->item(0).tracking_data().frame_flags() &
-                        TrackingData::FLAG_CHUNK_BOUNDARY) {
-        mvf.is_chunk_boundary = true;
-      }
+  while (!a.ids.empty()) {
+    const int chunk_data_size = a.chunk_data->item_size();
+
+    ABSL_CHECK_GE(a.start_frame, 0);
+    ABSL_CHECK_LT(a.start_frame, chunk_data_size);
 
-      MotionVectorFrame mvf_inverted;
-      InvertMotionVectorFrame(mvf, &mvf_inverted);
-
-      const bool forward_tracking = true;
-      if (!motion_box.TrackStep(f, mvf_inverted, forward_tracking)) {
-        VLOG(1) << "Failed forward at frame: " << f;
-        break;
-      } else {
-        // Test if current request is canceled.
-        {
-          absl::MutexLock lock(&status_mutex_);
-          if (track_status_[a.id][a.checkpoint].canceled) {
-            --track_status_[a.id][a.checkpoint].tracks_ongoing;
-            status_condvar_.SignalAll();
-            return;
-          }
+    VLOG(1) << " a.start_frame = " << a.start_frame << " @"
+            << a.chunk_data->item(a.start_frame).timestamp_usec() << " with "
+            << chunk_data_size << " items and " << a.ids.size() << " boxes";
+
+    motion_boxes.clear();
+    for (const MotionBoxState& start_state : a.start_states) {
+      TrackStepOptions track_step_options = options_.track_step_options();
+      ChangeTrackingDegreesBasedOnStartPos(start_state, &track_step_options);
+      motion_boxes.emplace_back(track_step_options);
+      motion_boxes.back().ResetAtFrame(a.start_frame, start_state);
+    }
+
+    // Frame at which tracking continues in the next (or previous) chunk, if
+    // the boxes reach the end of this one.
+    std::optional<int> continue_frame;
+    if (a.forward) {
+      // TrackingData at frame f, contains tracking information from
+      // frame f to f - 1. Get information at frame f + 1 and invert:
+      // Tracking from f to f + 1.
+      for (int f = a.start_frame; f + 1 < chunk_data_size && !a.ids.empty();
+           ++f) {
+        // Note: we use / 1000 instead of * 1000 to avoid overflow.
+        if (a.chunk_data->item(f + 1).timestamp_usec() / 1000 > a.max_msec) {
+          VLOG(2) << "Reached maximum tracking timestamp @" << a.max_msec;
+          break;
+        }
+        VLOG(1) << "Track forward from " << f;
+        // Decoded once for all boxes.
+        MotionVectorFrame mvf;
+        MotionVectorFrameFromTrackingData(
+            a.chunk_data->item(f + 1).tracking_data(), &mvf);
+        const int track_duration_ms =
+            TrackingDataDurationMs(a.chunk_data->item(f + 1));
+        if (track_duration_ms > 0) {
+          mvf.duration_ms = track_duration_ms;
         }
 
-        TimedBox result;
-        const MotionBoxState& result_state = motion_box.StateAtFrame(f + 1);
-        TimedBoxFromMotionBoxState(result_state, &result);
-        result.time_msec = a.chunk_data->item(f + 1).timestamp_usec() / 1000;
-        AddBoxResult(result, a.id, a.checkpoint, result_state);
-      }
+        // If this is the first frame in a chunk, there might be an unobserved
+        // chunk boundary at the first frame.
+        if (f == 0 && a.chunk_data->item(0).tracking_data().frame_flags() &
+                          TrackingData::FLAG_CHUNK_BOUNDARY) {
+          mvf.is_chunk_boundary = true;
+        }
 
-      if (f + 2 == chunk_data_size && !a.chunk_data->last_chunk()) {
-        // Last frame, successful track, continue;
-        AugmentedChunkPtr next_chunk(
-            ReadChunk(a.id, a.checkpoint, a.chunk_idx + 1));
+        MotionVectorFrame mvf_inverted;
+        InvertMotionVectorFrame(mvf, &mvf_inverted);
 
-        if (next_chunk.first != nullptr) {
-          TrackingImplArgs next_args(next_chunk, motion_box.StateAtFrame(f + 1),
-                                     0, a.chunk_idx + 1, a.id, a.checkpoint,
-                                     a.forward, false, a.min_msec, a.max_msec);
+        track_step(f, f + 1, mvf_inverted,
+                   a.chunk_data->item(f + 1).timestamp_usec() / 1000);
 
-          TrackingImpl(next_args);
-        } else {
-          cleanup_func();
-          ABSL_LOG(ERROR) << "Can't read expected chunk file!";
+        if (f + 2 == chunk_data_size && !a.chunk_data->last_chunk()) {
+          // Last frame, successful track, continue;
+          continue_frame = f + 1;
         }
       }
-    }
-  } else {
-    // Backward tracking.
-    // Don't attempt to track from the very first frame backwards.
-    const int first_frame = a.chunk_data->first_chunk() ? 1 : 0;
-
-    for (int f = a.start_frame; f >= first_frame; --f) {
-      if (a.chunk_data->item(f).timestamp_usec() / 1000 < a.min_msec) {
-        VLOG(2) << "Reached minimum tracking timestamp @" << a.min_msec;
-        break;
-      }
-      VLOG(1) << "Track backward from " << f;
-      MotionVectorFrame mvf;
-      MotionVectorFrameFromTrackingData(a.chunk_data->item(f).tracking_data(),
-                                        &mvf);
-      const int64_t track_duration_ms =
-          TrackingDataDurationMs(a.chunk_data->item(f));
-      if (track_duration_ms > 0) {
-        mvf.duration_ms = track_duration_ms;
-      }
-      const bool forward_tracking = false;
-      if (!motion_box.TrackStep(f, mvf, forward_tracking)) {
-        VLOG(1) << "Failed backward at frame: " << f;
-        break;
-      } else {
-        // Test if current request is canceled.
-        {
-          absl::MutexLock lock(&status_mutex_);
-          if (track_status_[a.id][a.checkpoint].canceled) {
-            --track_status_[a.id][a.checkpoint].tracks_ongoing;
-            status_condvar_.SignalAll();
-            return;
-          }
+    } else {
+      // Backward tracking.
+      // Don't attempt to track from the very first frame backwards.
+      const int first_frame = a.chunk_data->first_chunk() ? 1 : 0;
+
+      for (int f = a.start_frame; f >= first_frame && !a.ids.empty(); --f) {
+        if (a.chunk_data->item(f).timestamp_usec() / 1000 < a.min_msec) {
+          VLOG(2) << "Reached minimum tracking timestamp @" << a.min_msec;
+          break;
+        }
+        VLOG(1) << "Track backward from " << f;
+        // Decoded once for all boxes.
+        MotionVectorFrame mvf;
+        MotionVectorFrameFromTrackingData(a.chunk_data->item(f).tracking_data(),
+                                          &mvf);
+        const int64_t track_duration_ms =
+            TrackingDataDurationMs(a.chunk_data->item(f));
+        if (track_duration_ms > 0) {
+          mvf.duration_ms = track_duration_ms;
         }
 
-        TimedBox result;
-        const MotionBoxState& result_state = motion_box.StateAtFrame(f - 1);
-        TimedBoxFromMotionBoxState(result_state, &result);
-        result.time_msec = a.chunk_data->item(f).prev_timestamp_usec() / 1000;
-        AddBoxResult(result, a.id, a.checkpoint, result_state);
-      }
+        track_step(f, f - 1, mvf,
+                   a.chunk_data->item(f).prev_timestamp_usec() / 1000);
 
-      if (f == first_frame && !a.chunk_data->first_chunk()) {
-        VLOG(1) << "Read next chunk: " << f << "==" << first_frame << " in "
-                << a.chunk_idx;
-        // First frame, successful track, continue.
-        AugmentedChunkPtr prev_chunk(
-            ReadChunk(a.id, a.checkpoint, a.chunk_idx - 1));
-        if (prev_chunk.first != nullptr) {
-          const int last_frame = prev_chunk.first->item_size() - 1;
-          TrackingImplArgs prev_args(prev_chunk, motion_box.StateAtFrame(f - 1),
-                                     last_frame, a.chunk_idx - 1, a.id,
-                                     a.checkpoint, a.forward, false, a.min_msec,
-                                     a.max_msec);
-
-          TrackingImpl(prev_args);
-        } else {
-          cleanup_func();
-          ABSL_LOG(ERROR) << "Can't read expected chunk file! "
-                          << a.chunk_idx - 1 << " while tracking @"
-                          << a.chunk_data->item(f).timestamp_usec() / 1000
-                          << " with cutoff " << a.min_msec;
-          return;
+        if (f == first_frame && !a.chunk_data->first_chunk()) {
+          // First frame, successful track, continue.
+          continue_frame = f - 1;
         }
       }
     }
+
+    if (!continue_frame.has_value() || a.ids.empty()) {
+      break;
+    }
+
+    const int next_chunk_idx = a.chunk_idx + (a.forward ? 1 : -1);
+    VLOG(1) << "Read next chunk: " << next_chunk_idx;
+    IndexedItemSelection next_items;
+    if (a.forward) {
+      next_items.max_msec = a.max_msec;
+    } else {
+      next_items.min_msec = a.min_msec;
+    }
+    AugmentedChunkPtr next_chunk(
+        ReadChunk(a.ids, a.checkpoint, next_chunk_idx, next_items));
+    if (next_chunk.first == nullptr) {
+      ABSL_LOG(ERROR) << "Can't read expected chunk file! " << next_chunk_idx
+                      << " while tracking with cutoff "
+                      << (a.forward ? a.max_msec : a.min_msec);
+      break;
+    }
+
+    a.start_states.resize(a.ids.size());
+    for (int k = 0; k < a.ids.size(); ++k) {
+      a.start_states[k] = motion_boxes[k].StateAtFrame(*continue_frame);
+    }
+    a.SetChunk(next_chunk);
+    a.start_frame = a.forward ? 0 : a.chunk_data->item_size() - 1;
+    a.chunk_idx = next_chunk_idx;
   }
 
-  cleanup_func();
+  for (int id : a.ids) {
+    DoneTracking(id, a.checkpoint);
+  }
 }
 
 bool TimedBoxAtTime(const PathSegment& segment, int64_t time_msec,
@@ -1038,7 +1214,8 @@ bool BoxTracker::GetTrackingData(int id, int64_t request_time_msec,
 
   int chunk_idx = ChunkIdxFromTime(request_time_msec);
 
-  AugmentedChunkPtr tracking_chunk(ReadChunk(id, kInitCheckpoint, chunk_idx));
+  AugmentedChunkPtr tracking_chunk(
+      ReadChunk({id}, kInitCheckpoint, chunk_idx));
   if (!tracking_chunk.first) {
     absl::MutexLock lock(&status_mutex_);
     --track_status_[id][kInitCheckpoint].tracks_ongoing;
@@ -18,7 +18,9 @@
 #include <inttypes.h>
 
 #include <map>
+#include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/str_format.h"
@@ -26,6 +28,7 @@
 #include "mediapipe/framework/port/threadpool.h"
 #include "mediapipe/util/tracking/box_tracker.pb.h"
 #include "mediapipe/util/tracking/flow_packager.pb.h"
+#include "mediapipe/util/tracking/indexed_tracking_data_chunk.h"
 #include "mediapipe/util/tracking/tracking.h"
 #include "mediapipe/util/tracking/tracking.pb.h"
 
@@ -172,6 +175,17 @@ class BoxTracker {
   void NewBoxTrack(const TimedBox& initial_pos, int id, int64_t min_msec = 0,
                    int64_t max_msec = std::numeric_limits<int64_t>::max());
 
+  // Starts new tracks for a batch of boxes, ids[i] being the id of
+  // initial_positions[i], with the same semantics as a NewBoxTrack call per
+  // box. Boxes with equal time_msec are tracked jointly: the TrackingData of
+  // each frame is decoded once and advances all of these boxes, instead of
+  // being decoded per box. Ids must be unique among boxes with equal
+  // time_msec.
+  void NewBoxTrackBatch(
+      const std::vector<TimedBox>& initial_positions,
+      const std::vector<int>& ids, int64_t min_msec = 0,
+      int64_t max_msec = std::numeric_limits<int64_t>::max());
+
   // Returns interval for which the state of the specified box is known.
   // (Returns -1, -1 if id is missing or no tracking has been done).
   std::pair<int64_t, int64_t> TrackInterval(int id);
@@ -198,6 +212,10 @@ class BoxTracker {
   // Returns true if any tracking is ongoing.
   bool IsTrackingOngoing() ABSL_LOCKS_EXCLUDED(status_mutex_);
 
+  // Returns true if tracks of the specified id are being canceled, e.g. by a
+  // new request for the id that waits for them to end.
+  bool IsCancelingId(int id) ABSL_LOCKS_EXCLUDED(status_mutex_);
+
   // Cancels all ongoing tracks. To avoid race conditions all NewBoxTrack's in
   // flight will also be canceled. Future NewBoxTrack's will be canceled.
   // NOTE: To resume execution, you have to call ResumeTracking() before
@@ -226,27 +244,38 @@ class BoxTracker {
 
  private:
   // Asynchronous implementation function for box tracking. Schedules forward
-  // and backward tracking.
-  void NewBoxTrackAsync(const TimedBox& initial_pos, int id, int64_t min_msec,
+  // and backward tracking of the boxes initial_positions, which share their
+  // time_msec, with ids[i] the id of initial_positions[i].
+  void NewBoxTrackAsync(const std::vector<TimedBox>& initial_positions,
+                        const std::vector<int>& ids, int64_t min_msec,
                         int64_t max_msec);
 
   typedef std::pair<const TrackingDataChunk*, bool> AugmentedChunkPtr;
-  // Attempts to read chunk at chunk_idx if it exists. Reads from cache
-  // directory or from in memory cache.
+  // Attempts to read chunk at chunk_idx if it exists for the boxes with the
+  // passed ids. Reads from cache directory or from in memory cache.
   // Important: 2nd part of return value indicates if returned tracking data
   // will be owned by the caller (if true). In that case caller is responsible
   // for releasing the returned chunk.
-  AugmentedChunkPtr ReadChunk(int id, int checkpoint, int chunk_idx);
+  // Cache files in the indexed format (see indexed_tracking_data_chunk.h) are
+  // read partially, with only the items in selection parsed; in that case
+  // items_selected is set to true if not null. Other chunks are read whole.
+  AugmentedChunkPtr ReadChunk(
+      const std::vector<int>& ids, int checkpoint, int chunk_idx,
+      const IndexedItemSelection& selection = IndexedItemSelection(),
+      bool* items_selected = nullptr);
 
   // Attempts to read specified chunk from caching directory. Blocks and waits
-  // until chunk is available or internal time out is reached.
+  // until chunk is available or internal time out is reached. The file is
+  // memory mapped and, if indexed, only the items in selection are parsed.
   // Returns nullptr if data could not be read.
-  std::unique_ptr<TrackingDataChunk> ReadChunkFromCache(int id, int checkpoint,
-                                                        int chunk_idx);
+  std::unique_ptr<TrackingDataChunk> ReadChunkFromCache(
+      const std::vector<int>& ids, int checkpoint, int chunk_idx,
+      const IndexedItemSelection& selection, bool* items_selected);
 
   // Waits with timeout for chunkfile to become available. Returns true on
-  // success, false if waited till timeout or when canceled.
-  bool WaitForChunkFile(int id, int checkpoint, const std::string& chunk_file)
+  // success, false if waited till timeout or when all ids got canceled.
+  bool WaitForChunkFile(const std::vector<int>& ids, int checkpoint,
+                        const std::string& chunk_file)
       ABSL_LOCKS_EXCLUDED(status_mutex_);
 
   // Determines closest index in passed TrackingDataChunk
@@ -257,21 +286,29 @@ class BoxTracker {
                     const MotionBoxState& state);
 
   // Callback can only handle 5 args max.
-  // Set own_data to true for args to assume ownership.
+  // Describes a batch of boxes tracked jointly in one direction from the same
+  // start frame, as a structure of arrays with one entry per box.
   struct TrackingImplArgs {
-    TrackingImplArgs(AugmentedChunkPtr chunk_ptr,
-                     const MotionBoxState& start_state_, int start_frame_,
-                     int chunk_idx_, int id_, int checkpoint_, bool forward_,
-                     bool first_call_, int64_t min_msec_, int64_t max_msec_)
-        : start_state(start_state_),
+    TrackingImplArgs(AugmentedChunkPtr chunk_ptr, std::vector<int> ids_,
+                     std::vector<MotionBoxState> start_states_,
+                     int start_frame_, int chunk_idx_, int checkpoint_,
+                     bool forward_, int64_t min_msec_, int64_t max_msec_)
+        : ids(std::move(ids_)),
+          start_states(std::move(start_states_)),
           start_frame(start_frame_),
           chunk_idx(chunk_idx_),
-          id(id_),
           checkpoint(checkpoint_),
           forward(forward_),
-          first_call(first_call_),
           min_msec(min_msec_),
           max_msec(max_msec_) {
+      SetChunk(chunk_ptr);
+    }
+
+    TrackingImplArgs(const TrackingImplArgs&) = default;
+
+    // Sets the tracking data, assuming ownership if chunk_ptr.second is true.
+    void SetChunk(AugmentedChunkPtr chunk_ptr) {
+      chunk_data_buffer.reset();
       if (chunk_ptr.second) {
         chunk_data_buffer.reset(chunk_ptr.first);
       }
@@ -279,8 +316,6 @@ class BoxTracker {
       chunk_data = chunk_ptr.first;
     }
 
-    TrackingImplArgs(const TrackingImplArgs&) = default;
-
     // Storage for tracking data.
     std::shared_ptr<const TrackingDataChunk> chunk_data_buffer;
 
@@ -288,20 +323,25 @@ class BoxTracker {
     // but can also point to external data for performance reasons.
     const TrackingDataChunk* chunk_data;
 
-    MotionBoxState start_state;
+    // Id and state at start_frame of each box.
+    std::vector<int> ids;
+    std::vector<MotionBoxState> start_states;
     int start_frame;
     int chunk_idx;
-    int id;
     int checkpoint;
     bool forward = true;
-    bool first_call = true;
     int64_t min_msec;  // minimum timestamp to track to
     int64_t max_msec;  // maximum timestamp to track to
   };
 
-  // Actual tracking algorithm.
+  // Actual tracking algorithm. Tracks all boxes of args frame by frame,
+  // continuing into the next (or previous) chunks, until each box fails, gets
+  // canceled or reaches args.max_msec (or args.min_msec).
   void TrackingImpl(const TrackingImplArgs& args);
 
+  // Signals that tracking of id from checkpoint in one direction is done.
+  void DoneTracking(int id, int checkpoint) ABSL_LOCKS_EXCLUDED(status_mutex_);
+
   // Ids are scheduled exclusively, run this method to acquire lock.
   // Returns false if id could not be scheduled (e.g. id got canceled during
   // waiting).
@@ -14,8 +14,27 @@
 
 #include "mediapipe/util/tracking/box_tracker.h"
 
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/deps/file_path.h"
+#include "mediapipe/framework/port/benchmark.h"
+#include "mediapipe/framework/port/file_helpers.h"
 #include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/util/tracking/flow_packager.pb.h"
+#include "mediapipe/util/tracking/indexed_tracking_data_chunk.h"
 
 namespace mediapipe {
 namespace {
@@ -23,10 +42,62 @@ namespace {
 constexpr double kWidth = 1280.0;
 constexpr double kHeight = 720.0;
 
+constexpr char kTestDataDir[] = "/mediapipe/util/tracking/testdata/box_tracker";
+// Number of chunks in the test data, each of the default chunk size except
+// for the shorter last one.
+constexpr int kNumTestChunks = 7;
+constexpr int kChunkSizeMsec = 2500;
+
+// Writes a clip of num_chunks chunks to dir, in the indexed encoding if
+// indexed is set. Starts with the test data chunks and continues by repeating
+// the full length chunks after the first one, with shifted timestamps.
+absl::Status WriteClipChunks(const std::string& dir, int num_chunks,
+                             bool indexed) {
+  std::vector<TrackingDataChunk> test_chunks(kNumTestChunks);
+  for (int k = 0; k < kNumTestChunks; ++k) {
+    std::string data;
+    MP_RETURN_IF_ERROR(file::GetContents(
+        file::JoinPath("./", kTestDataDir, absl::StrFormat("chunk_%04d", k)),
+        &data));
+    RET_CHECK(test_chunks[k].ParseFromString(data));
+  }
+
+  MP_RETURN_IF_ERROR(file::RecursivelyCreateDir(dir));
+  for (int c = 0; c < num_chunks; ++c) {
+    const int source = c < kNumTestChunks - 1
+                           ? c
+                           : 1 + (c - 1) % (kNumTestChunks - 2);
+    const int64_t shift_usec =
+        static_cast<int64_t>(c - source) * kChunkSizeMsec * 1000;
+    TrackingDataChunk chunk = test_chunks[source];
+    for (auto& item : *chunk.mutable_item()) {
+      item.set_timestamp_usec(item.timestamp_usec() + shift_usec);
+      if (item.has_prev_timestamp_usec()) {
+        item.set_prev_timestamp_usec(item.prev_timestamp_usec() + shift_usec);
+      }
+    }
+    chunk.set_last_chunk(c + 1 == num_chunks);
+    MP_RETURN_IF_ERROR(file::SetContents(
+        file::JoinPath(dir, absl::StrFormat("chunk_%04d", c)),
+        indexed ? SerializeIndexedTrackingDataChunk(chunk)
+                : chunk.SerializeAsString()));
+  }
+  return absl::OkStatus();
+}
+
+TimedBox CenteredBox(int64_t time_msec) {
+  TimedBox box;
+  box.left = 0.4f;
+  box.top = 0.4f;
+  box.right = 0.6f;
+  box.bottom = 0.6f;
+  box.time_msec = time_msec;
+  return box;
+}
+
 // Ground truth test; testing tracking accuracy and multi-thread load testing.
 TEST(BoxTrackerTest, MovingBoxTest) {
-  const std::string cache_dir =
-      file::JoinPath("./", "/mediapipe/util/tracking/testdata/box_tracker");
+  const std::string cache_dir = file::JoinPath("./", kTestDataDir);
   BoxTracker box_tracker(cache_dir, BoxTrackerOptions());
 
   // Ground truth positions of the overlay (linear in between).
@@ -112,6 +183,207 @@ TEST(BoxTrackerTest, MovingBoxTest) {
   }
 }
 
+// Tracking on indexed cache files, which BoxTracker reads partially, yields
+// the same boxes as on legacy cache files.
+TEST(BoxTrackerTest, IndexedCacheMatchesLegacyCache) {
+  constexpr int kNumChunks = 2 * kNumTestChunks;
+  const std::string legacy_dir =
+      file::JoinPath(::testing::TempDir(), "legacy_chunks");
+  const std::string indexed_dir =
+      file::JoinPath(::testing::TempDir(), "indexed_chunks");
+  MP_ASSERT_OK(WriteClipChunks(legacy_dir, kNumChunks, /*indexed=*/false));
+  MP_ASSERT_OK(WriteClipChunks(indexed_dir, kNumChunks, /*indexed=*/true));
+
+  BoxTracker legacy_tracker(legacy_dir, BoxTrackerOptions());
+  BoxTracker indexed_tracker(indexed_dir, BoxTrackerOptions());
+  // Start within a chunk and limit the range to end within others.
+  const TimedBox initial_pos = CenteredBox(9100);
+  constexpr int64_t kMinMsec = 4200;
+  constexpr int64_t kMaxMsec = 21300;
+  legacy_tracker.NewBoxTrack(initial_pos, 0, kMinMsec, kMaxMsec);
+  indexed_tracker.NewBoxTrack(initial_pos, 0, kMinMsec, kMaxMsec);
+  legacy_tracker.WaitForAllOngoingTracks();
+  indexed_tracker.WaitForAllOngoingTracks();
+
+  EXPECT_EQ(indexed_tracker.TrackInterval(0), legacy_tracker.TrackInterval(0));
+  for (int k = kMinMsec; k <= kMaxMsec; k += 33) {
+    TimedBox legacy_box;
+    TimedBox indexed_box;
+    ASSERT_EQ(legacy_tracker.GetTimedPosition(0, k, &legacy_box),
+              indexed_tracker.GetTimedPosition(0, k, &indexed_box));
+    EXPECT_EQ(indexed_box.time_msec, legacy_box.time_msec);
+    EXPECT_EQ(indexed_box.left, legacy_box.left) << "at " << k;
+    EXPECT_EQ(indexed_box.top, legacy_box.top) << "at " << k;
+    EXPECT_EQ(indexed_box.right, legacy_box.right) << "at " << k;
+    EXPECT_EQ(indexed_box.bottom, legacy_box.bottom) << "at " << k;
+  }
+}
+
+// Boxes tracked jointly via NewBoxTrackBatch yield the same boxes as boxes
+// tracked one by one.
+TEST(BoxTrackerTest, BatchMatchesSeparateTracks) {
+  const std::string cache_dir = file::JoinPath("./", kTestDataDir);
+  // Three boxes starting at the same time and one starting later.
+  std::vector<TimedBox> positions;
+  for (float offset : {0.0f, -0.2f, 0.2f}) {
+    TimedBox box = CenteredBox(5000);
+    box.left += offset;
+    box.right += offset;
+    positions.push_back(box);
+  }
+  positions.push_back(CenteredBox(8000));
+  const std::vector<int> ids = {0, 1, 2, 3};
+  constexpr int64_t kMinMsec = 2000;
+  constexpr int64_t kMaxMsec = 12000;
+
+  BoxTracker batch_tracker(cache_dir, BoxTrackerOptions());
+  BoxTracker separate_tracker(cache_dir, BoxTrackerOptions());
+  batch_tracker.NewBoxTrackBatch(positions, ids, kMinMsec, kMaxMsec);
+  for (int j = 0; j < ids.size(); ++j) {
+    separate_tracker.NewBoxTrack(positions[j], ids[j], kMinMsec, kMaxMsec);
+  }
+  batch_tracker.WaitForAllOngoingTracks();
+  separate_tracker.WaitForAllOngoingTracks();
+
+  for (int id : ids) {
+    EXPECT_EQ(batch_tracker.TrackInterval(id),
+              separate_tracker.TrackInterval(id));
+    for (int k = kMinMsec; k <= kMaxMsec; k += 33) {
+      TimedBox batch_box;
+      TimedBox separate_box;
+      ASSERT_EQ(batch_tracker.GetTimedPosition(id, k, &batch_box),
+                separate_tracker.GetTimedPosition(id, k, &separate_box));
+      EXPECT_EQ(batch_box.left, separate_box.left) << id << " at " << k;
+      EXPECT_EQ(batch_box.top, separate_box.top) << id << " at " << k;
+      EXPECT_EQ(batch_box.right, separate_box.right) << id << " at " << k;
+      EXPECT_EQ(batch_box.bottom, separate_box.bottom) << id << " at " << k;
+    }
+  }
+}
+
+// Canceling the first box of a batch, while the batch waits for the next
+// chunk file, ends only that box's track.
+TEST(BoxTrackerTest, CancelingFirstBoxKeepsBatchTracking) {
+  constexpr int kNumChunks = 3;
+  const std::string clip_dir =
+      file::JoinPath(::testing::TempDir(), "batch_cancel_clip");
+  const std::string cache_dir =
+      file::JoinPath(::testing::TempDir(), "batch_cancel_chunks");
+  MP_ASSERT_OK(WriteClipChunks(clip_dir, kNumChunks, /*indexed=*/false));
+  MP_ASSERT_OK(file::RecursivelyCreateDir(cache_dir));
+  // Moves a chunk file into the cache directory at once, so that the tracker
+  // never reads it partially written.
+  auto publish_chunk = [&](int chunk_idx) -> absl::Status {
+    const std::string name = absl::StrFormat("chunk_%04d", chunk_idx);
+    std::string data;
+    MP_RETURN_IF_ERROR(
+        file::GetContents(file::JoinPath(clip_dir, name), &data));
+    const std::string tmp_path = file::JoinPath(cache_dir, name + ".tmp");
+    MP_RETURN_IF_ERROR(file::SetContents(tmp_path, data));
+    RET_CHECK_EQ(
+        std::rename(tmp_path.c_str(), file::JoinPath(cache_dir, name).c_str()),
+        0);
+    return absl::OkStatus();
+  };
+  MP_ASSERT_OK(publish_chunk(0));
+
+  std::vector<TimedBox> positions;
+  for (float offset : {-0.2f, 0.2f}) {
+    TimedBox box = CenteredBox(1000);
+    box.left += offset;
+    box.right += offset;
+    positions.push_back(box);
+  }
+  const std::vector<int> ids = {0, 1};
+  constexpr int64_t kMaxMsec = kNumChunks * kChunkSizeMsec;
+
+  BoxTracker box_tracker(cache_dir, BoxTrackerOptions());
+  box_tracker.NewBoxTrackBatch(positions, ids, 0, kMaxMsec);
+  // The batch has scheduled its tracks once it added the start box of its last
+  // id. Its forward track can not end before the second chunk is published.
+  while (box_tracker.TrackInterval(ids[1]).first < 0) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  // A new request for id 0 at the same time cancels its batched track, and
+  // waits for the batch to drop the box.
+  box_tracker.NewBoxTrack(positions[0], ids[0], 0, kChunkSizeMsec);
+  while (!box_tracker.IsCancelingId(ids[0])) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  for (int c = kNumChunks - 1; c > 0; --c) {
+    MP_ASSERT_OK(publish_chunk(c));
+  }
+  box_tracker.WaitForAllOngoingTracks();
+
+  EXPECT_GT(box_tracker.TrackInterval(ids[1]).second, kChunkSizeMsec);
+  TimedBox box;
+  EXPECT_TRUE(box_tracker.GetTimedPosition(ids[0], 1000, &box));
+}
+
+// Measures tracking 64 boxes starting at the same time for two seconds in
+// each direction, one by one (state.range(0) == 0) and jointly.
+void BM_TrackBoxes(benchmark::State& state) {
+  constexpr int kNumBoxes = 64;
+  constexpr int64_t kStartMsec = 8000;
+  constexpr int64_t kTrackMsec = 2000;
+  const std::string cache_dir = file::JoinPath("./", kTestDataDir);
+  std::mt19937 rng(/*seed=*/13);
+  std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+  std::vector<TimedBox> positions;
+  for (int j = 0; j < kNumBoxes; ++j) {
+    TimedBox box = CenteredBox(kStartMsec);
+    const float dx = offset(rng);
+    const float dy = offset(rng);
+    box.left += dx;
+    box.right += dx;
+    box.top += dy;
+    box.bottom += dy;
+    positions.push_back(box);
+  }
+  std::vector<int> ids(kNumBoxes);
+  std::iota(ids.begin(), ids.end(), 0);
+  for (auto _ : state) {
+    BoxTracker box_tracker(cache_dir, BoxTrackerOptions());
+    if (state.range(0)) {
+      box_tracker.NewBoxTrackBatch(positions, ids, kStartMsec - kTrackMsec,
+                                   kStartMsec + kTrackMsec);
+    } else {
+      for (int j = 0; j < kNumBoxes; ++j) {
+        box_tracker.NewBoxTrack(positions[j], ids[j], kStartMsec - kTrackMsec,
+                                kStartMsec + kTrackMsec);
+      }
+    }
+    box_tracker.WaitForAllOngoingTracks();
+  }
+  state.SetItemsProcessed(state.iterations() * kNumBoxes);
+}
+BENCHMARK(BM_TrackBoxes)->Arg(0)->Arg(1);
+
+// Measures the latency of seeking to a random position of a 10 minute clip
+// and tracking one second in each direction, on legacy cache files
+// (state.range(0) == 0) and on indexed cache files.
+void BM_SeekAndTrack(benchmark::State& state) {
+  constexpr int kNumChunks = 10 * 60 * 1000 / kChunkSizeMsec;
+  constexpr int64_t kTrackMsec = 1000;
+  const bool indexed = state.range(0);
+  const std::string cache_dir = file::JoinPath(
+      ::testing::TempDir(), indexed ? "indexed_clip" : "legacy_clip");
+  ABSL_CHECK_OK(WriteClipChunks(cache_dir, kNumChunks, indexed));
+
+  BoxTracker box_tracker(cache_dir, BoxTrackerOptions());
+  std::mt19937 rng(/*seed=*/11);
+  std::uniform_int_distribution<int64_t> seek_msec(
+      kTrackMsec, kNumChunks * kChunkSizeMsec - kTrackMsec);
+  int id = 0;
+  for (auto _ : state) {
+    const int64_t time_msec = seek_msec(rng);
+    box_tracker.NewBoxTrack(CenteredBox(time_msec), id++,
+                            time_msec - kTrackMsec, time_msec + kTrackMsec);
+    box_tracker.WaitForAllOngoingTracks();
+  }
+}
+BENCHMARK(BM_SeekAndTrack)->Arg(0)->Arg(1);
+
 }  // namespace
 
 }  // namespace mediapipe
@@ -0,0 +1,150 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/tracking/indexed_tracking_data_chunk.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/util/tracking/flow_packager.pb.h"
+
+namespace mediapipe {
+
+namespace {
+
+constexpr char kMagic[] = "MPTDCHI1";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+
+constexpr uint32_t kFirstChunkFlag = 1 << 0;
+constexpr uint32_t kLastChunkFlag = 1 << 1;
+
+struct Header {
+  uint32_t num_items;
+  uint32_t flags;
+};
+
+struct IndexEntry {
+  int64_t timestamp_usec;
+  uint64_t offset;
+  uint64_t size;
+};
+
+constexpr size_t kHeaderSize = kMagicSize + sizeof(Header);
+
+template <typename T>
+void Append(const T& value, std::string* data) {
+  data->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Reads a T at offset, which the caller checked to be within data.
+template <typename T>
+T Read(absl::string_view data, size_t offset) {
+  T value;
+  memcpy(&value, data.data() + offset, sizeof(T));
+  return value;
+}
+
+}  // namespace
+
+bool IsIndexedTrackingDataChunk(absl::string_view data) {
+  return data.size() >= kHeaderSize &&
+         data.substr(0, kMagicSize) == absl::string_view(kMagic, kMagicSize);
+}
+
+std::string SerializeIndexedTrackingDataChunk(const TrackingDataChunk& chunk) {
+  const int num_items = chunk.item_size();
+  const size_t index_size = num_items * sizeof(IndexEntry);
+
+  std::string items;
+  std::string index;
+  index.reserve(index_size);
+  for (const auto& item : chunk.item()) {
+    const size_t item_offset = items.size();
+    item.AppendToString(&items);
+    Append(IndexEntry{item.timestamp_usec(),
+                      kHeaderSize + index_size + item_offset,
+                      items.size() - item_offset},
+           &index);
+  }
+
+  Header header;
+  header.num_items = num_items;
+  header.flags = (chunk.first_chunk() ? kFirstChunkFlag : 0) |
+                 (chunk.last_chunk() ? kLastChunkFlag : 0);
+
+  std::string data;
+  data.reserve(kHeaderSize + index_size + items.size());
+  data.append(kMagic, kMagicSize);
+  Append(header, &data);
+  data.append(index);
+  data.append(items);
+  return data;
+}
+
+absl::Status ParseIndexedTrackingDataChunk(
+    absl::string_view data, const IndexedItemSelection& selection,
+    TrackingDataChunk* chunk) {
+  if (!IsIndexedTrackingDataChunk(data)) {
+    return absl::InvalidArgumentError("Not an indexed tracking data chunk.");
+  }
+  const Header header = Read<Header>(data, kMagicSize);
+  if (header.num_items > (data.size() - kHeaderSize) / sizeof(IndexEntry)) {
+    return absl::DataLossError(
+        absl::StrCat("Index of ", header.num_items, " items is truncated."));
+  }
+
+  const int num_items = header.num_items;
+  const int end_item = selection.end_item < 0
+                           ? num_items
+                           : std::min(selection.end_item, num_items);
+
+  chunk->Clear();
+  if (header.flags & kFirstChunkFlag) {
+    chunk->set_first_chunk(true);
+  }
+  if (header.flags & kLastChunkFlag) {
+    chunk->set_last_chunk(true);
+  }
+  chunk->mutable_item()->Reserve(num_items);
+  for (int i = 0; i < num_items; ++i) {
+    const IndexEntry entry =
+        Read<IndexEntry>(data, kHeaderSize + i * sizeof(IndexEntry));
+    TrackingDataChunk::Item* item = chunk->add_item();
+    const int64_t item_msec = entry.timestamp_usec / 1000;
+    if (i < selection.begin_item || i >= end_item ||
+        item_msec < selection.min_msec || item_msec > selection.max_msec) {
+      item->set_timestamp_usec(entry.timestamp_usec);
+      continue;
+    }
+    if (entry.offset > data.size() || entry.size > data.size() - entry.offset) {
+      return absl::DataLossError(absl::StrCat("Item ", i, " is truncated."));
+    }
+    if (!item->ParseFromArray(data.data() + entry.offset, entry.size)) {
+      return absl::DataLossError(absl::StrCat("Could not parse item ", i));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ParseIndexedTrackingDataChunk(absl::string_view data,
+                                           TrackingDataChunk* chunk) {
+  return ParseIndexedTrackingDataChunk(data, IndexedItemSelection(), chunk);
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,69 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Indexed encoding of TrackingDataChunks for cache files. It is written by
+// FlowPackagerCalculator if index_cache_files is set, and is read by
+// BoxTracker. The encoding consists of, in host byte order:
+//   - a header: the 8 byte magic "MPTDCHI1", the number of items (uint32) and
+//     the chunk flags (uint32, bit 0 for first_chunk, bit 1 for last_chunk),
+//   - an index: per item, in chunk order, its timestamp_usec (int64) and the
+//     offset and size (uint64 each) of the serialized item,
+//   - the serialized TrackingDataChunk::Items.
+// Readers look up items by timestamp in the index and parse only the items
+// they need, directly from the memory mapped cache file.
+
+#ifndef MEDIAPIPE_UTIL_TRACKING_INDEXED_TRACKING_DATA_CHUNK_H_
+#define MEDIAPIPE_UTIL_TRACKING_INDEXED_TRACKING_DATA_CHUNK_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/util/tracking/flow_packager.pb.h"
+
+namespace mediapipe {
+
+// Returns true if data starts with the header of an indexed chunk.
+bool IsIndexedTrackingDataChunk(absl::string_view data);
+
+// Returns the indexed encoding of chunk.
+std::string SerializeIndexedTrackingDataChunk(const TrackingDataChunk& chunk);
+
+// Selects the items of an indexed chunk to parse.
+struct IndexedItemSelection {
+  // Range [begin_item, end_item) of item indices. An end_item below zero
+  // extends the range to the last item.
+  int begin_item = 0;
+  int end_item = -1;
+  // Range of item timestamps, compared to timestamp_usec / 1000.
+  int64_t min_msec = std::numeric_limits<int64_t>::min();
+  int64_t max_msec = std::numeric_limits<int64_t>::max();
+};
+
+// Decodes the indexed chunk in data into chunk, parsing only the items within
+// both ranges of selection. The other items are left empty except for their
+// timestamp_usec, which keeps item indices and timestamp lookups valid.
+absl::Status ParseIndexedTrackingDataChunk(
+    absl::string_view data, const IndexedItemSelection& selection,
+    TrackingDataChunk* chunk);
+
+// Decodes all items of the indexed chunk in data into chunk.
+absl::Status ParseIndexedTrackingDataChunk(absl::string_view data,
+                                           TrackingDataChunk* chunk);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_TRACKING_INDEXED_TRACKING_DATA_CHUNK_H_
@@ -0,0 +1,158 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/tracking/indexed_tracking_data_chunk.h"
+
+#include <string>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "mediapipe/framework/deps/file_path.h"
+#include "mediapipe/framework/port/benchmark.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/util/tracking/flow_packager.pb.h"
+
+namespace mediapipe {
+namespace {
+
+TrackingDataChunk ReadTestChunk(int chunk_idx) {
+  const std::string path = file::JoinPath(
+      "./", "/mediapipe/util/tracking/testdata/box_tracker/",
+      absl::StrFormat("chunk_%04d", chunk_idx));
+  std::string data;
+  MP_EXPECT_OK(file::GetContents(path, &data));
+  TrackingDataChunk chunk;
+  EXPECT_TRUE(chunk.ParseFromString(data));
+  return chunk;
+}
+
+TEST(IndexedTrackingDataChunkTest, DetectsFormat) {
+  const TrackingDataChunk chunk = ReadTestChunk(1);
+  EXPECT_FALSE(IsIndexedTrackingDataChunk(chunk.SerializeAsString()));
+  EXPECT_TRUE(
+      IsIndexedTrackingDataChunk(SerializeIndexedTrackingDataChunk(chunk)));
+  EXPECT_FALSE(IsIndexedTrackingDataChunk(""));
+}
+
+TEST(IndexedTrackingDataChunkTest, RoundTripsChunks) {
+  for (int chunk_idx : {0, 1, 6}) {
+    const TrackingDataChunk chunk = ReadTestChunk(chunk_idx);
+    TrackingDataChunk parsed;
+    MP_ASSERT_OK(ParseIndexedTrackingDataChunk(
+        SerializeIndexedTrackingDataChunk(chunk), &parsed));
+    EXPECT_EQ(parsed.SerializeAsString(), chunk.SerializeAsString())
+        << "chunk " << chunk_idx;
+  }
+}
+
+TEST(IndexedTrackingDataChunkTest, RoundTripsEmptyChunk) {
+  TrackingDataChunk chunk;
+  chunk.set_first_chunk(true);
+  chunk.set_last_chunk(true);
+  TrackingDataChunk parsed;
+  MP_ASSERT_OK(ParseIndexedTrackingDataChunk(
+      SerializeIndexedTrackingDataChunk(chunk), &parsed));
+  EXPECT_EQ(parsed.item_size(), 0);
+  EXPECT_TRUE(parsed.first_chunk());
+  EXPECT_TRUE(parsed.last_chunk());
+}
+
+TEST(IndexedTrackingDataChunkTest, ParsesSelectedItemsOnly) {
+  const TrackingDataChunk chunk = ReadTestChunk(2);
+  ASSERT_GT(chunk.item_size(), 20);
+  IndexedItemSelection selection;
+  selection.begin_item = 5;
+  selection.end_item = 20;
+  selection.min_msec = chunk.item(8).timestamp_usec() / 1000;
+  selection.max_msec = chunk.item(30).timestamp_usec() / 1000;
+
+  TrackingDataChunk parsed;
+  MP_ASSERT_OK(ParseIndexedTrackingDataChunk(
+      SerializeIndexedTrackingDataChunk(chunk), selection, &parsed));
+  ASSERT_EQ(parsed.item_size(), chunk.item_size());
+  EXPECT_EQ(parsed.first_chunk(), chunk.first_chunk());
+  EXPECT_EQ(parsed.last_chunk(), chunk.last_chunk());
+  for (int i = 0; i < chunk.item_size(); ++i) {
+    if (i >= 8 && i < 20) {
+      EXPECT_EQ(parsed.item(i).SerializeAsString(),
+                chunk.item(i).SerializeAsString())
+          << "item " << i;
+    } else {
+      EXPECT_FALSE(parsed.item(i).has_tracking_data()) << "item " << i;
+      EXPECT_EQ(parsed.item(i).timestamp_usec(), chunk.item(i).timestamp_usec())
+          << "item " << i;
+    }
+  }
+}
+
+TEST(IndexedTrackingDataChunkTest, ParsesTimestampsOnly) {
+  const TrackingDataChunk chunk = ReadTestChunk(0);
+  IndexedItemSelection selection;
+  selection.end_item = 0;
+  TrackingDataChunk parsed;
+  MP_ASSERT_OK(ParseIndexedTrackingDataChunk(
+      SerializeIndexedTrackingDataChunk(chunk), selection, &parsed));
+  ASSERT_EQ(parsed.item_size(), chunk.item_size());
+  EXPECT_EQ(parsed.first_chunk(), chunk.first_chunk());
+  for (int i = 0; i < chunk.item_size(); ++i) {
+    EXPECT_FALSE(parsed.item(i).has_tracking_data());
+    EXPECT_EQ(parsed.item(i).timestamp_usec(), chunk.item(i).timestamp_usec());
+  }
+}
+
+TEST(IndexedTrackingDataChunkTest, RejectsInvalidData) {
+  const TrackingDataChunk chunk = ReadTestChunk(6);
+  const std::string data = SerializeIndexedTrackingDataChunk(chunk);
+  TrackingDataChunk parsed;
+  EXPECT_EQ(
+      ParseIndexedTrackingDataChunk(chunk.SerializeAsString(), &parsed).code(),
+      absl::StatusCode::kInvalidArgument);
+  // Truncated within the items.
+  EXPECT_EQ(
+      ParseIndexedTrackingDataChunk(data.substr(0, data.size() - 1), &parsed)
+          .code(),
+      absl::StatusCode::kDataLoss);
+  // Truncated within the index.
+  EXPECT_EQ(ParseIndexedTrackingDataChunk(data.substr(0, 40), &parsed).code(),
+            absl::StatusCode::kDataLoss);
+}
+
+// Compares reading the items of a one second window from an indexed chunk
+// (state.range(0) == 1) to parsing the whole chunk, as needed for the legacy
+// encoding.
+void BM_ParseChunkWindow(benchmark::State& state) {
+  const TrackingDataChunk chunk = ReadTestChunk(3);
+  const std::string legacy_data = chunk.SerializeAsString();
+  const std::string indexed_data = SerializeIndexedTrackingDataChunk(chunk);
+  IndexedItemSelection selection;
+  selection.min_msec = chunk.item(0).timestamp_usec() / 1000 + 1000;
+  selection.max_msec = selection.min_msec + 1000;
+  for (auto _ : state) {
+    TrackingDataChunk parsed;
+    if (state.range(0)) {
+      ABSL_CHECK_OK(
+          ParseIndexedTrackingDataChunk(indexed_data, selection, &parsed));
+    } else {
+      ABSL_CHECK(parsed.ParseFromString(legacy_data));
+    }
+    benchmark::DoNotOptimize(parsed);
+  }
+}
+BENCHMARK(BM_ParseChunkWindow)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace mediapipe
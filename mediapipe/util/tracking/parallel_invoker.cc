@@ -21,6 +21,42 @@ int flags_parallel_invoker_max_threads = 4;
 
 namespace mediapipe {
 
+namespace {
+
+// The executor of the innermost ParallelInvokerExecutorScope of each thread.
+struct ExecutorScopeState {
+  Executor* executor = nullptr;
+  int num_threads = 0;
+};
+
+thread_local ExecutorScopeState executor_scope_state;
+
+}  // namespace
+
+ParallelInvokerExecutorScope::ParallelInvokerExecutorScope(Executor* executor,
+                                                           int num_threads)
+    : previous_executor_(executor_scope_state.executor),
+      previous_num_threads_(executor_scope_state.num_threads) {
+  ABSL_CHECK(executor != nullptr);
+  executor_scope_state.executor = executor;
+  executor_scope_state.num_threads = num_threads;
+}
+
+ParallelInvokerExecutorScope::~ParallelInvokerExecutorScope() {
+  executor_scope_state.executor = previous_executor_;
+  executor_scope_state.num_threads = previous_num_threads_;
+}
+
+/* static */
+Executor* ParallelInvokerExecutorScope::CurrentExecutor() {
+  return executor_scope_state.executor;
+}
+
+/* static */
+int ParallelInvokerExecutorScope::CurrentNumThreads() {
+  return executor_scope_state.num_threads;
+}
+
 #if defined(PARALLEL_INVOKER_ACTIVE)
 ThreadPool* ParallelInvokerThreadPool() {
   static ThreadPool* pool = []() -> ThreadPool* {
@@ -69,11 +69,16 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <optional>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/executor.h"
 
 #ifdef PARALLEL_INVOKER_ACTIVE
 #include "mediapipe/framework/port/threadpool.h"
@@ -136,6 +141,121 @@ class BlockedRange2D {
   BlockedRange cols_;
 };
 
+// Dispatches the ParallelFor and ParallelFor2D calls of the current thread onto
+// `executor` while in scope, regardless of flags_parallel_invoker_mode. This
+// lets the tracking calculators share the threads of a graph executor, instead
+// of oversubscribing the cores with the parallel invoker thread pool.
+// `num_threads` is the number of threads of `executor`, which sizes the chunks
+// the loops are split into. The calling thread runs chunks too, so the loops
+// complete even if all the threads of `executor` are busy.
+//
+// Scopes can be nested, and the loops running on `executor` dispatch their
+// own nested loops onto it. Has no effect unless PARALLEL_INVOKER_ACTIVE is
+// defined.
+class ParallelInvokerExecutorScope {
+ public:
+  // `executor` must outlive the scope.
+  ParallelInvokerExecutorScope(Executor* executor, int num_threads);
+  ~ParallelInvokerExecutorScope();
+
+  // ParallelInvokerExecutorScope is neither copyable nor movable.
+  ParallelInvokerExecutorScope(const ParallelInvokerExecutorScope&) = delete;
+  ParallelInvokerExecutorScope& operator=(const ParallelInvokerExecutorScope&) =
+      delete;
+
+  // Returns the executor of the innermost scope of the current thread, or
+  // nullptr outside of any scope.
+  static Executor* CurrentExecutor();
+  // Returns the number of threads of CurrentExecutor().
+  static int CurrentNumThreads();
+
+ private:
+  Executor* const previous_executor_;
+  const int previous_num_threads_;
+};
+
+namespace parallel_invoker_internal {
+
+// Number of chunks per executor thread that the loops are split into, so that
+// threads that are busy with other tasks of the executor don't delay the loop.
+inline constexpr int kChunksPerThread = 4;
+
+// Returns the number of grains per chunk when splitting `num_grains` grains
+// for `num_threads` threads.
+inline int GrainsPerChunk(int num_grains, int num_threads) {
+  const int num_chunks = std::max(1, kChunksPerThread * num_threads);
+  return std::max(1, (num_grains + num_chunks - 1) / num_chunks);
+}
+
+// The chunks of a loop running on an executor.
+class ExecutorLoop {
+ public:
+  explicit ExecutorLoop(int num_chunks)
+      : num_chunks_(num_chunks), unfinished_chunks_(num_chunks) {}
+
+  // Claims the next chunk to run. Returns false if all chunks were claimed.
+  bool ClaimChunk(int* chunk) {
+    *chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+    return *chunk < num_chunks_;
+  }
+
+  // Marks a claimed chunk as finished.
+  void FinishChunk() {
+    absl::MutexLock lock(&mutex_);
+    --unfinished_chunks_;
+  }
+
+  // Waits for all the chunks to be finished.
+  void WaitForChunks() {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(
+        +[](int* unfinished_chunks) { return *unfinished_chunks == 0; },
+        &unfinished_chunks_));
+  }
+
+ private:
+  const int num_chunks_;
+  std::atomic<int> next_chunk_{0};
+  absl::Mutex mutex_;
+  int unfinished_chunks_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Calls `run_chunk(chunk)` for every chunk in [0, num_chunks), on the calling
+// thread and on the executor of the current ParallelInvokerExecutorScope. Each
+// executor task runs its chunks with its own copy of `run_chunk`.
+template <class ChunkInvoker>
+void RunChunksOnExecutor(int num_chunks, const ChunkInvoker& run_chunk) {
+  Executor* executor = ParallelInvokerExecutorScope::CurrentExecutor();
+  const int num_threads = ParallelInvokerExecutorScope::CurrentNumThreads();
+  auto loop = std::make_shared<ExecutorLoop>(num_chunks);
+  const int num_tasks = std::min(num_threads, num_chunks - 1);
+  for (int i = 0; i < num_tasks; ++i) {
+    // Tasks that start once all the chunks were claimed only access `loop`,
+    // as `run_chunk` is only valid until the caller returns.
+    executor->Schedule([loop, &run_chunk, executor, num_threads]() {
+      ParallelInvokerExecutorScope scope(executor, num_threads);
+      std::optional<ChunkInvoker> local_run_chunk;
+      int chunk;
+      bool claimed = loop->ClaimChunk(&chunk);
+      while (claimed) {
+        if (!local_run_chunk.has_value()) local_run_chunk.emplace(run_chunk);
+        (*local_run_chunk)(chunk);
+        claimed = loop->ClaimChunk(&chunk);
+        // The local copy must be released before the last chunk is finished.
+        if (!claimed) local_run_chunk.reset();
+        loop->FinishChunk();
+      }
+    });
+  }
+  for (int chunk; loop->ClaimChunk(&chunk);) {
+    run_chunk(chunk);
+    loop->FinishChunk();
+  }
+  loop->WaitForChunks();
+}
+
+}  // namespace parallel_invoker_internal
+
 #ifdef PARALLEL_INVOKER_ACTIVE
 
 // Singleton ThreadPool for parallel invoker.
@@ -300,6 +420,26 @@ template <class Invoker>
 void ParallelFor(size_t start, size_t end, size_t grain_size,
                  const Invoker& invoker) {
 #ifdef PARALLEL_INVOKER_ACTIVE
+  if (ParallelInvokerExecutorScope::CurrentExecutor() != nullptr) {
+    const int num_grains = (end - start + grain_size - 1) / grain_size;
+    const int num_threads = ParallelInvokerExecutorScope::CurrentNumThreads();
+    if (num_grains <= 1 || num_threads <= 1) {
+      SerialFor(start, end, grain_size, invoker);
+      return;
+    }
+    const int chunk_size =
+        grain_size *
+        parallel_invoker_internal::GrainsPerChunk(num_grains, num_threads);
+    const int num_chunks = (end - start + chunk_size - 1) / chunk_size;
+    parallel_invoker_internal::RunChunksOnExecutor(
+        num_chunks, [invoker, start, end, chunk_size](int chunk) {
+          const int chunk_start = start + chunk * chunk_size;
+          invoker(BlockedRange(chunk_start,
+                               std::min<int>(end, chunk_start + chunk_size),
+                               1));
+        });
+    return;
+  }
   CheckAndSetInvokerOptions();
   switch (flags_parallel_invoker_mode) {
 #if defined(__APPLE__)
@@ -411,6 +551,29 @@ template <class Invoker>
 void ParallelFor2D(size_t start_row, size_t end_row, size_t start_col,
                    size_t end_col, size_t grain_size, const Invoker& invoker) {
 #ifdef PARALLEL_INVOKER_ACTIVE
+  if (ParallelInvokerExecutorScope::CurrentExecutor() != nullptr) {
+    // Only the rows are split, like in the other modes.
+    const int num_grains = (end_row - start_row + grain_size - 1) / grain_size;
+    const int num_threads = ParallelInvokerExecutorScope::CurrentNumThreads();
+    if (num_grains <= 1 || num_threads <= 1) {
+      SerialFor2D(start_row, end_row, start_col, end_col, grain_size, invoker);
+      return;
+    }
+    const int chunk_size =
+        grain_size *
+        parallel_invoker_internal::GrainsPerChunk(num_grains, num_threads);
+    const int num_chunks = (end_row - start_row + chunk_size - 1) / chunk_size;
+    parallel_invoker_internal::RunChunksOnExecutor(
+        num_chunks, [invoker, start_row, end_row, start_col, end_col,
+                     chunk_size](int chunk) {
+          const int chunk_start = start_row + chunk * chunk_size;
+          invoker(BlockedRange2D(
+              BlockedRange(chunk_start,
+                           std::min<int>(end_row, chunk_start + chunk_size), 1),
+              BlockedRange(start_col, end_col, 1)));
+        });
+    return;
+  }
   CheckAndSetInvokerOptions();
   switch (flags_parallel_invoker_mode) {
 #if defined(__APPLE__)
@@ -0,0 +1,39 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_TRACKING_PARALLEL_INVOKER_SERVICE_H_
+#define MEDIAPIPE_UTIL_TRACKING_PARALLEL_INVOKER_SERVICE_H_
+
+#include "mediapipe/framework/graph_service.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+
+namespace mediapipe {
+
+// Graph service providing the executor that the ParallelFor loops of the
+// tracking calculators run on, through a ParallelInvokerExecutorScope.
+// Typically the graph's default executor, so that the calculators share its
+// threads:
+//
+//   auto executor = std::make_shared<ThreadPoolExecutor>(num_threads);
+//   MP_RETURN_IF_ERROR(graph.SetExecutor("", executor));
+//   MP_RETURN_IF_ERROR(
+//       graph.SetServiceObject(kParallelInvokerExecutorService, executor));
+inline constexpr GraphService<ThreadPoolExecutor>
+    kParallelInvokerExecutorService(
+        "ParallelInvokerExecutorService",
+        GraphServiceBase::kDisallowDefaultInitialization);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_TRACKING_PARALLEL_INVOKER_SERVICE_H_
@@ -15,10 +15,14 @@
 #include "mediapipe/util/tracking/parallel_invoker.h"
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 
 namespace mediapipe {
 namespace {
@@ -56,5 +60,82 @@ TEST(ParallelInvokerTest, ThreadPoolTest) {
   RunParallelTest();
 }
 
+TEST(ParallelInvokerTest, ExecutorTest) {
+  ThreadPoolExecutor executor(/*num_threads=*/4);
+  ParallelInvokerExecutorScope scope(&executor, executor.num_threads());
+
+  RunParallelTest();
+}
+
+TEST(ParallelInvokerTest, Executor2DTest) {
+  ThreadPoolExecutor executor(/*num_threads=*/4);
+  ParallelInvokerExecutorScope scope(&executor, executor.num_threads());
+  const int kNumRows = 37;
+  const int kNumCols = 11;
+  std::vector<std::atomic<int>> visits(kNumRows * kNumCols);
+
+  ParallelFor2D(0, kNumRows, 0, kNumCols, 2,
+                [&visits](const BlockedRange2D& b) {
+                  for (int y = b.rows().begin(); y < b.rows().end(); ++y) {
+                    for (int x = b.cols().begin(); x < b.cols().end(); ++x) {
+                      ++visits[y * kNumCols + x];
+                    }
+                  }
+                });
+
+  for (const std::atomic<int>& count : visits) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(ParallelInvokerTest, ExecutorNestedTest) {
+  ThreadPoolExecutor executor(/*num_threads=*/2);
+  ParallelInvokerExecutorScope scope(&executor, executor.num_threads());
+  std::atomic<int> sum{0};
+
+  // Nested loops run on the executor too, and complete even though the outer
+  // loop occupies its threads.
+  ParallelFor(0, 8, 1, [&sum](const BlockedRange& outer) {
+    for (int i = outer.begin(); i < outer.end(); ++i) {
+      ParallelFor(0, 100, 1, [&sum](const BlockedRange& inner) {
+        sum += inner.end() - inner.begin();
+      });
+    }
+  });
+
+  EXPECT_EQ(sum.load(), 800);
+}
+
+TEST(ParallelInvokerTest, ExecutorWithBusyThreadsTest) {
+  absl::Notification release_executor;
+  ThreadPoolExecutor executor(/*num_threads=*/1);
+  executor.Schedule([&release_executor] {
+    release_executor.WaitForNotification();
+  });
+  ParallelInvokerExecutorScope scope(&executor, /*num_threads=*/4);
+
+  // The calling thread runs all the chunks while the executor is busy.
+  RunParallelTest();
+
+  release_executor.Notify();
+}
+
+TEST(ParallelInvokerTest, ExecutorScopeRestoresPreviousExecutor) {
+  ThreadPoolExecutor outer_executor(/*num_threads=*/1);
+  ThreadPoolExecutor inner_executor(/*num_threads=*/1);
+  EXPECT_EQ(ParallelInvokerExecutorScope::CurrentExecutor(), nullptr);
+  {
+    ParallelInvokerExecutorScope outer_scope(&outer_executor, 1);
+    {
+      ParallelInvokerExecutorScope inner_scope(&inner_executor, 1);
+      EXPECT_EQ(ParallelInvokerExecutorScope::CurrentExecutor(),
+                &inner_executor);
+    }
+    EXPECT_EQ(ParallelInvokerExecutorScope::CurrentExecutor(),
+              &outer_executor);
+  }
+  EXPECT_EQ(ParallelInvokerExecutorScope::CurrentExecutor(), nullptr);
+}
+
 }  // namespace
 }  // namespace mediapipe
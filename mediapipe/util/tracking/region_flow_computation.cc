@@ -45,6 +45,7 @@
 #include "mediapipe/util/tracking/motion_models.h"
 #include "mediapipe/util/tracking/parallel_invoker.h"
 #include "mediapipe/util/tracking/region_flow.h"
+#include "mediapipe/util/tracking/region_flow_kernels.h"
 #include "mediapipe/util/tracking/tone_estimation.h"
 #include "mediapipe/util/tracking/tone_estimation.pb.h"
 #include "mediapipe/util/tracking/tone_models.h"
@@ -185,14 +186,30 @@ void GetPatchDescriptorAtPoint(const cv::Mat& rgb_frame, const Vector2_i& pt,
   }
 }
 
+// Same as GetPatchDescriptorAtPoint, but accumulates all moments in a single
+// pass over the window.
+void ComputePatchDescriptorAtPoint(const cv::Mat& rgb_frame,
+                                   const Vector2_i& pt, const int radius,
+                                   PatchDescriptor* descriptor) {
+  ABSL_CHECK(descriptor);
+  float data[kPatchDescriptorSize];
+  ComputePatchDescriptor(
+      rgb_frame.ptr<uint8_t>(pt.y() - radius, pt.x() - radius),
+      static_cast<int>(rgb_frame.step[0]), radius, data);
+  descriptor->clear_data();
+  descriptor->mutable_data()->Add(data, data + kPatchDescriptorSize);
+}
+
 class PatchDescriptorInvoker {
  public:
   PatchDescriptorInvoker(const cv::Mat& rgb_frame,
                          const cv::Mat* prev_rgb_frame, int radius,
+                         bool use_vectorized_kernels,
                          RegionFlowFeatureList* features)
       : rgb_frame_(rgb_frame),
         prev_rgb_frame_(prev_rgb_frame),
         radius_(radius),
+        use_vectorized_kernels_(use_vectorized_kernels),
         features_(features) {}
 
   void operator()(const BlockedRange& range) const {
@@ -205,8 +222,8 @@ class PatchDescriptorInvoker {
       ABSL_DCHECK_GE(pt.y(), radius_);
       ABSL_DCHECK_LT(pt.x(), rgb_frame_.cols - radius_);
       ABSL_DCHECK_LT(pt.y(), rgb_frame_.rows - radius_);
-      GetPatchDescriptorAtPoint(rgb_frame_, pt, radius_, &lab_window,
-                                feature->mutable_feature_descriptor());
+      GetDescriptor(rgb_frame_, pt, &lab_window,
+                    feature->mutable_feature_descriptor());
 
       if (prev_rgb_frame_) {
         Vector2_i pt_match(FeatureMatchIntLocation(*feature));
@@ -214,17 +231,27 @@ class PatchDescriptorInvoker {
         ABSL_DCHECK_GE(pt_match.y(), radius_);
         ABSL_DCHECK_LT(pt_match.x(), rgb_frame_.cols - radius_);
         ABSL_DCHECK_LT(pt_match.y(), rgb_frame_.rows - radius_);
-        GetPatchDescriptorAtPoint(*prev_rgb_frame_, pt_match, radius_,
-                                  &lab_window,
-                                  feature->mutable_feature_match_descriptor());
+        GetDescriptor(*prev_rgb_frame_, pt_match, &lab_window,
+                      feature->mutable_feature_match_descriptor());
       }
     }
   }
 
  private:
+  void GetDescriptor(const cv::Mat& rgb_frame, const Vector2_i& pt,
+                     cv::Mat* lab_window, PatchDescriptor* descriptor) const {
+    if (use_vectorized_kernels_) {
+      ComputePatchDescriptorAtPoint(rgb_frame, pt, radius_, descriptor);
+    } else {
+      GetPatchDescriptorAtPoint(rgb_frame, pt, radius_, lab_window,
+                                descriptor);
+    }
+  }
+
   const cv::Mat& rgb_frame_;
   const cv::Mat* prev_rgb_frame_;
   int radius_;
+  bool use_vectorized_kernels_;
   RegionFlowFeatureList* features_;
 };
 
@@ -236,9 +263,12 @@ class PatchDescriptorInvoker {
 // feature_match_descriptor.
 // IMPORTANT: Ensure that patch_descriptor_rad <= distance_from_border in
 // GetRegionFlowFeatureList. Checked by function.
+// If use_vectorized_kernels is set, computes descriptors in a single pass over
+// each patch.
 void ComputeRegionFlowFeatureDescriptors(
     const cv::Mat& rgb_frame, const cv::Mat* prev_rgb_frame,
-    int patch_descriptor_radius, RegionFlowFeatureList* flow_feature_list) {
+    int patch_descriptor_radius, bool use_vectorized_kernels,
+    RegionFlowFeatureList* flow_feature_list) {
   const int rows = rgb_frame.rows;
   const int cols = rgb_frame.cols;
   ABSL_CHECK_EQ(rgb_frame.depth(), CV_8U);
@@ -257,7 +287,7 @@ void ComputeRegionFlowFeatureDescriptors(
   ParallelFor(
       0, flow_feature_list->feature_size(), 1,
       PatchDescriptorInvoker(rgb_frame, prev_rgb_frame, patch_descriptor_radius,
-                             flow_feature_list));
+                             use_vectorized_kernels, flow_feature_list));
 }
 
 // Stores 2D location's of feature points and their corresponding descriptors,
@@ -859,7 +889,8 @@ RegionFlowComputation::RetrieveRegionFlowFeatureListImpl(
     ComputeRegionFlowFeatureDescriptors(
         *curr_color_image,
         compute_match_descriptor ? prev_color_image : nullptr,
-        options_.patch_descriptor_radius(), feature_list.get());
+        options_.patch_descriptor_radius(), options_.use_vectorized_kernels(),
+        feature_list.get());
   } else {
     ABSL_CHECK(!compute_match_descriptor)
         << "Set compute_feature_descriptor also "
@@ -3122,6 +3153,10 @@ void RegionFlowComputation::DetermineRegionFlowInliers(
   // Save ptr to each inlier feature.
   TrackedFeatureView inlier_set;
   TrackedFeatureView best_inlier_set;
+  // Flow of the features in contiguous arrays, if vectorized kernels are used.
+  const bool use_vectorized_kernels = options_.use_vectorized_kernels();
+  std::vector<float> flow_x;
+  std::vector<float> flow_y;
   unsigned int seed = 900913;  // = Google in leet :)
   std::default_random_engine rand_gen(seed);
 
@@ -3156,6 +3191,20 @@ void RegionFlowComputation::DetermineRegionFlowInliers(
       best_inlier_set.clear();
       std::uniform_int_distribution<> distribution(0, all_features->size() - 1);
 
+      if (use_vectorized_kernels) {
+        flow_x.clear();
+        flow_y.clear();
+        for (auto feature_ptr : *all_features) {
+          flow_x.push_back(feature_ptr->flow.x());
+          flow_y.push_back(feature_ptr->flow.y());
+        }
+      }
+      // Vector and threshold of the largest inlier set, if only inliers are
+      // counted in each round.
+      int best_num_inliers = 0;
+      Vector2_f best_vec;
+      float best_err_threshold = 0;
+
       for (int i = 0; i < max_iterations; ++i) {
         // Pick a random vector.
         const int rand_idx = distribution(rand_gen);
@@ -3167,6 +3216,18 @@ void RegionFlowComputation::DetermineRegionFlowInliers(
         const float err_threshold =
             std::max(relative_err_threshold, absolute_err_threshold);
 
+        if (use_vectorized_kernels) {
+          const int num_inliers =
+              CountFlowInliers(flow_x.data(), flow_y.data(), flow_x.size(),
+                               vec.x(), vec.y(), err_threshold);
+          if (num_inliers >= best_num_inliers) {
+            best_num_inliers = num_inliers;
+            best_vec = vec;
+            best_err_threshold = err_threshold;
+          }
+          continue;
+        }
+
         // Determine inlier vectors.
         inlier_set.clear();
 
@@ -3181,6 +3242,15 @@ void RegionFlowComputation::DetermineRegionFlowInliers(
         }
       }
 
+      if (use_vectorized_kernels) {
+        // Collects the inliers of the best round only.
+        for (auto feature_ptr : *all_features) {
+          if ((feature_ptr->flow - best_vec).Norm2() < best_err_threshold) {
+            best_inlier_set.push_back(feature_ptr);
+          }
+        }
+      }
+
       if (best_inlier_set.size() >=
           max(options_.min_feature_inliers(), last_inlier_set_size / 2)) {
         last_inlier_set_size = best_inlier_set.size();
@@ -20,12 +20,14 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/time/clock.h"
 #include "mediapipe/framework/deps/file_path.h"
+#include "mediapipe/framework/port/benchmark.h"
 #include "mediapipe/framework/port/file_helpers.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
@@ -45,6 +47,17 @@ namespace {
 
 using RandomEngine = std::mt19937_64;
 
+constexpr char kTestDataDir[] = "/mediapipe/util/tracking/testdata/";
+
+// Loads the bee image.
+cv::Mat LoadTestFrame() {
+  std::string png_data;
+  MEDIAPIPE_CHECK_OK(file::GetContents(
+      file::JoinPath("./", kTestDataDir, "stabilize_test.png"), &png_data));
+  std::vector<char> buffer(png_data.begin(), png_data.end());
+  return cv::imdecode(cv::Mat(buffer), 1);
+}
+
 struct FlowDirectionParam {
   TrackingOptions::FlowDirection internal_direction;
   TrackingOptions::FlowDirection output_direction;
@@ -60,14 +73,7 @@ class RegionFlowComputationTest
     tracking_options->set_internal_tracking_direction(param.internal_direction);
     tracking_options->set_output_flow_direction(param.output_direction);
 
-    // Load bee image.
-    data_dir_ = file::JoinPath("./", "/mediapipe/util/tracking/testdata/");
-
-    std::string png_data;
-    MEDIAPIPE_CHECK_OK(
-        file::GetContents(data_dir_ + "stabilize_test.png", &png_data));
-    std::vector<char> buffer(png_data.begin(), png_data.end());
-    original_frame_ = cv::imdecode(cv::Mat(buffer), 1);
+    original_frame_ = LoadTestFrame();
     ASSERT_FALSE(original_frame_.empty());
     ASSERT_EQ(original_frame_.type(), CV_8UC3);
   }
@@ -88,7 +94,6 @@ class RegionFlowComputationTest
   RegionFlowComputationOptions base_options_;
 
  private:
-  std::string data_dir_;
   cv::Mat original_frame_;
 };
 
@@ -301,5 +306,78 @@ TEST_P(RegionFlowComputationTest, ResolutionTests) {
   }
 }
 
+TEST_P(RegionFlowComputationTest, VectorizedKernelsMatchDefaultLoops) {
+  std::vector<cv::Mat> movie;
+  std::vector<Vector2_f> positions;
+  const int num_frames = 10;
+  MakeMovie(num_frames, RegionFlowComputationOptions::FORMAT_RGB, &movie,
+            &positions);
+
+  const int frame_width = movie[0].cols;
+  const int frame_height = movie[0].rows;
+
+  RegionFlowComputationOptions vectorized_options = base_options_;
+  vectorized_options.set_use_vectorized_kernels(true);
+  RegionFlowComputation flow_computation(base_options_, frame_width,
+                                         frame_height);
+  RegionFlowComputation vectorized_flow_computation(
+      vectorized_options, frame_width, frame_height);
+
+  for (int i = 0; i < num_frames; ++i) {
+    flow_computation.AddImage(movie[i], 0);
+    vectorized_flow_computation.AddImage(movie[i], 0);
+
+    if (i > 0) {
+      std::unique_ptr<RegionFlowFeatureList> feature_list(
+          flow_computation.RetrieveRegionFlowFeatureList(
+              true, true, &movie[i], &movie[i - 1]));
+      std::unique_ptr<RegionFlowFeatureList> vectorized_feature_list(
+          vectorized_flow_computation.RetrieveRegionFlowFeatureList(
+              true, true, &movie[i], &movie[i - 1]));
+      ASSERT_GT(feature_list->feature_size(), 0);
+      EXPECT_EQ(vectorized_feature_list->SerializeAsString(),
+                feature_list->SerializeAsString())
+          << "frame " << i;
+    }
+  }
+}
+
+// Computes region flow with feature descriptors over a movie panning across
+// the test frame, with the default loops (state.range(0) == 0) or the
+// vectorized kernels (state.range(0) == 1).
+void BM_RegionFlowComputation(benchmark::State& state) {
+  constexpr int kNumFrames = 20;
+  constexpr int kBorder = 40;
+  const cv::Mat original_frame = LoadTestFrame();
+  ABSL_CHECK(!original_frame.empty());
+  const int frame_width = original_frame.cols - 2 * kBorder;
+  const int frame_height = original_frame.rows - 2 * kBorder;
+  std::vector<cv::Mat> movie(kNumFrames);
+  for (int f = 0; f < kNumFrames; ++f) {
+    const int x = (3 * f) % (2 * kBorder);
+    const int y = (2 * f) % (2 * kBorder);
+    original_frame(cv::Rect(x, y, frame_width, frame_height))
+        .copyTo(movie[f]);
+  }
+
+  RegionFlowComputationOptions options;
+  options.set_use_vectorized_kernels(state.range(0) == 1);
+  for (auto _ : state) {
+    RegionFlowComputation flow_computation(options, frame_width,
+                                           frame_height);
+    for (int f = 0; f < kNumFrames; ++f) {
+      flow_computation.AddImage(movie[f], 0);
+      if (f > 0) {
+        std::unique_ptr<RegionFlowFeatureList> feature_list(
+            flow_computation.RetrieveRegionFlowFeatureList(
+                true, true, &movie[f], &movie[f - 1]));
+        benchmark::DoNotOptimize(feature_list.get());
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumFrames);
+}
+BENCHMARK(BM_RegionFlowComputation)->Arg(0)->Arg(1);
+
 }  // namespace
 }  // namespace mediapipe
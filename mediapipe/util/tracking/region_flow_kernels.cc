@@ -0,0 +1,93 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/tracking/region_flow_kernels.h"
+
+#include <cstdint>
+
+namespace mediapipe {
+
+void ComputePatchDescriptor(const uint8_t* window, int row_step, int radius,
+                            float* descriptor) {
+  const int diameter = 2 * radius + 1;
+  // Channel sums and the upper triangular channel cross products, kept in
+  // independent accumulators.
+  int sum_r = 0, sum_g = 0, sum_b = 0;
+  int sum_rr = 0, sum_rg = 0, sum_rb = 0, sum_gg = 0, sum_gb = 0, sum_bb = 0;
+  for (int y = 0; y < diameter; ++y) {
+    const uint8_t* data = window + y * row_step;
+    for (int x = 0; x < diameter; ++x, data += 3) {
+      const int r = data[0];
+      const int g = data[1];
+      const int b = data[2];
+      sum_r += r;
+      sum_g += g;
+      sum_b += b;
+      sum_rr += r * r;
+      sum_rg += r * g;
+      sum_rb += r * b;
+      sum_gg += g * g;
+      sum_gb += g * b;
+      sum_bb += b * b;
+    }
+  }
+
+  const int sum[3] = {sum_r, sum_g, sum_b};
+  const int cross_sum[3][3] = {{sum_rr, sum_rg, sum_rb},
+                               {0, sum_gg, sum_gb},
+                               {0, 0, sum_bb}};
+  // Same arithmetic as the multi-pass GetPatchDescriptorAtPoint, including
+  // the truncation of the centering term, so that descriptors are identical.
+  const float scale = 1.f / (diameter * diameter);
+  for (int c = 0; c < 3; ++c) {
+    descriptor[c] = sum[c] * scale;
+  }
+  int idx = 3;
+  for (int c = 0; c < 3; ++c) {
+    for (int d = c; d < 3; ++d) {
+      const int product =
+          static_cast<int>(-sum[c] * sum[d] * scale) + cross_sum[c][d];
+      descriptor[idx++] = product * scale;
+    }
+  }
+}
+
+int CountFlowInliers(const float* flow_x, const float* flow_y, int num_flows,
+                     float x, float y, float sq_threshold) {
+  // Counts per lane over blocks of kLanes flows. The fixed size inner loop
+  // has no dependency between lanes, which compilers vectorize at -O2, unlike
+  // a single counter over all flows.
+  constexpr int kLanes = 8;
+  int lane_counts[kLanes] = {};
+  int i = 0;
+  for (; i + kLanes <= num_flows; i += kLanes) {
+    for (int k = 0; k < kLanes; ++k) {
+      const float dx = flow_x[i + k] - x;
+      const float dy = flow_y[i + k] - y;
+      lane_counts[k] += dx * dx + dy * dy < sq_threshold;
+    }
+  }
+  int count = 0;
+  for (; i < num_flows; ++i) {
+    const float dx = flow_x[i] - x;
+    const float dy = flow_y[i] - y;
+    count += dx * dx + dy * dy < sq_threshold;
+  }
+  for (int k = 0; k < kLanes; ++k) {
+    count += lane_counts[k];
+  }
+  return count;
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,49 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Kernels for the inner loops of RegionFlowComputation, selected by
+// RegionFlowComputationOptions::use_vectorized_kernels. They read contiguous
+// data in a single pass so that compilers keep the accumulators in registers
+// and vectorize the loops. Each kernel computes the same result as the loop
+// it replaces.
+
+#ifndef MEDIAPIPE_UTIL_TRACKING_REGION_FLOW_KERNELS_H_
+#define MEDIAPIPE_UTIL_TRACKING_REGION_FLOW_KERNELS_H_
+
+#include <cstdint>
+
+namespace mediapipe {
+
+// Number of values in a patch descriptor: 3 channel means followed by the
+// upper triangular part of the 3x3 channel covariance matrix.
+inline constexpr int kPatchDescriptorSize = 3 + 6;
+
+// Computes the patch descriptor of the square window of diameter
+// 2 * radius + 1 of interleaved 8-bit RGB pixels whose top left pixel is at
+// `window`, with rows `row_step` bytes apart. Outputs kPatchDescriptorSize
+// values to `descriptor`: the channel means followed by the upper triangular
+// part of the channel covariance, row by row. Accumulates all moments in a
+// single pass over the window.
+void ComputePatchDescriptor(const uint8_t* window, int row_step, int radius,
+                            float* descriptor);
+
+// Returns the number of flow vectors (flow_x[i], flow_y[i]), i < num_flows,
+// whose squared distance to (x, y) is below sq_threshold. Expects the flow
+// components in separate contiguous arrays, so that the loop vectorizes.
+int CountFlowInliers(const float* flow_x, const float* flow_y, int num_flows,
+                     float x, float y, float sq_threshold);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_TRACKING_REGION_FLOW_KERNELS_H_
@@ -0,0 +1,241 @@
+// Copyright 2025 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/tracking/region_flow_kernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mediapipe/framework/port/benchmark.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAreArray;
+
+constexpr int kWidth = 64;
+constexpr int kHeight = 48;
+// Row padding, as in frames with aligned rows.
+constexpr int kRowStep = 3 * kWidth + 8;
+
+std::vector<uint8_t> RandomImage(int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<uint8_t> image(kRowStep * kHeight);
+  for (uint8_t& value : image) value = distribution(rng);
+  return image;
+}
+
+// The multi-pass loops of GetPatchDescriptorAtPoint.
+void ComputePatchDescriptorScalar(const uint8_t* window, int row_step,
+                                  int radius, float* descriptor) {
+  const int diameter = 2 * radius + 1;
+  int sum[3] = {0, 0, 0};
+  for (int y = 0; y < diameter; ++y) {
+    const uint8_t* data = window + y * row_step;
+    for (int x = 0; x < diameter; ++x, data += 3) {
+      for (int c = 0; c < 3; ++c) {
+        sum[c] += data[c];
+      }
+    }
+  }
+  const float scale = 1.f / (diameter * diameter);
+  for (int c = 0; c < 3; ++c) {
+    *descriptor++ = sum[c] * scale;
+  }
+  const float denom = 1.0f / (diameter * diameter);
+  for (int c = 0; c < 3; ++c) {
+    for (int d = c; d < 3; ++d) {
+      int product = -sum[c] * sum[d] * denom;
+      for (int y = 0; y < diameter; ++y) {
+        const uint8_t* data = window + y * row_step;
+        for (int x = 0; x < diameter; ++x, data += 3) {
+          product += static_cast<int>(data[c]) * data[d];
+        }
+      }
+      *descriptor++ = product * scale;
+    }
+  }
+}
+
+int CountFlowInliersScalar(const float* flow_x, const float* flow_y,
+                           int num_flows, float x, float y,
+                           float sq_threshold) {
+  int count = 0;
+  for (int i = 0; i < num_flows; ++i) {
+    const float dx = flow_x[i] - x;
+    const float dy = flow_y[i] - y;
+    if (dx * dx + dy * dy < sq_threshold) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+TEST(RegionFlowKernelsTest, PatchDescriptorMatchesScalar) {
+  const std::vector<uint8_t> image = RandomImage(/*seed=*/17);
+  for (int radius : {0, 1, 3, 7}) {
+    const int diameter = 2 * radius + 1;
+    for (int y = 0; y + diameter <= kHeight; y += 5) {
+      for (int x = 0; x + diameter <= kWidth; x += 3) {
+        const uint8_t* window = image.data() + y * kRowStep + 3 * x;
+        float expected[kPatchDescriptorSize];
+        ComputePatchDescriptorScalar(window, kRowStep, radius, expected);
+        float descriptor[kPatchDescriptorSize];
+        ComputePatchDescriptor(window, kRowStep, radius, descriptor);
+        EXPECT_THAT(descriptor, ElementsAreArray(expected))
+            << "radius " << radius << " at " << x << ", " << y;
+      }
+    }
+  }
+}
+
+TEST(RegionFlowKernelsTest, PatchDescriptorOfConstantPatch) {
+  std::vector<uint8_t> image(kRowStep * kHeight);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      uint8_t* pixel = image.data() + y * kRowStep + 3 * x;
+      pixel[0] = 10;
+      pixel[1] = 20;
+      pixel[2] = 255;
+    }
+  }
+  float descriptor[kPatchDescriptorSize];
+  ComputePatchDescriptor(image.data(), kRowStep, /*radius=*/3, descriptor);
+  EXPECT_THAT(descriptor, ElementsAreArray({10.f, 20.f, 255.f, 0.f, 0.f, 0.f,
+                                            0.f, 0.f, 0.f}));
+}
+
+TEST(RegionFlowKernelsTest, CountFlowInliersMatchesScalar) {
+  std::mt19937 rng(/*seed=*/5);
+  std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+  for (int num_flows : {0, 1, 7, 100, 1013}) {
+    std::vector<float> flow_x(num_flows);
+    std::vector<float> flow_y(num_flows);
+    for (int i = 0; i < num_flows; ++i) {
+      flow_x[i] = distribution(rng);
+      flow_y[i] = distribution(rng);
+    }
+    for (float sq_threshold : {0.0f, 0.5f, 4.0f, 100.0f}) {
+      const float x = distribution(rng);
+      const float y = distribution(rng);
+      EXPECT_EQ(CountFlowInliers(flow_x.data(), flow_y.data(), num_flows, x, y,
+                                 sq_threshold),
+                CountFlowInliersScalar(flow_x.data(), flow_y.data(),
+                                       num_flows, x, y, sq_threshold));
+    }
+  }
+}
+
+TEST(RegionFlowKernelsTest, CountFlowInliersExcludesThreshold) {
+  const std::vector<float> flow_x = {0.0f, 1.0f, 2.0f};
+  const std::vector<float> flow_y = {0.0f, 0.0f, 0.0f};
+  EXPECT_EQ(CountFlowInliers(flow_x.data(), flow_y.data(), 3, 0.0f, 0.0f,
+                             /*sq_threshold=*/1.0f),
+            1);
+}
+
+// Compares ComputePatchDescriptor (state.range(0) == 1) to the multi-pass
+// loops on the default descriptor radius.
+void BM_PatchDescriptor(benchmark::State& state) {
+  constexpr int kRadius = 3;
+  const std::vector<uint8_t> image = RandomImage(/*seed=*/3);
+  float descriptor[kPatchDescriptorSize];
+  int num_windows = 0;
+  for (auto _ : state) {
+    for (int y = 0; y + 2 * kRadius + 1 <= kHeight; y += 4) {
+      for (int x = 0; x + 2 * kRadius + 1 <= kWidth; x += 4) {
+        const uint8_t* window = image.data() + y * kRowStep + 3 * x;
+        if (state.range(0)) {
+          ComputePatchDescriptor(window, kRowStep, kRadius, descriptor);
+        } else {
+          ComputePatchDescriptorScalar(window, kRowStep, kRadius, descriptor);
+        }
+        benchmark::DoNotOptimize(descriptor);
+        ++num_windows;
+      }
+    }
+  }
+  state.SetItemsProcessed(num_windows);
+}
+BENCHMARK(BM_PatchDescriptor)->Arg(0)->Arg(1);
+
+// A feature as laid out by RegionFlowComputation, which keeps the flow next
+// to other per feature data.
+struct Feature {
+  float point[2];
+  float flow[2];
+  float other_data[28];
+};
+
+// Compares the RANSAC rounds of a grid bin with CountFlowInliers
+// (state.range(0) == 1), including the gathering of the flow into contiguous
+// arrays, to the loop over pointers to features it replaces.
+void BM_CountFlowInliers(benchmark::State& state) {
+  constexpr int kNumFeatures = 256;
+  constexpr int kRansacRounds = 15;
+  constexpr float kSqThreshold = 4.0f;
+  std::mt19937 rng(/*seed=*/9);
+  std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+  std::vector<Feature> features(kNumFeatures);
+  std::vector<const Feature*> feature_view;
+  for (Feature& feature : features) {
+    feature.flow[0] = distribution(rng);
+    feature.flow[1] = distribution(rng);
+    feature_view.push_back(&feature);
+  }
+  std::shuffle(feature_view.begin(), feature_view.end(), rng);
+  std::vector<float> flow_x;
+  std::vector<float> flow_y;
+  for (auto _ : state) {
+    int best_count = 0;
+    if (state.range(0)) {
+      flow_x.clear();
+      flow_y.clear();
+      for (const Feature* feature : feature_view) {
+        flow_x.push_back(feature->flow[0]);
+        flow_y.push_back(feature->flow[1]);
+      }
+      for (int k = 0; k < kRansacRounds; ++k) {
+        best_count = std::max(
+            best_count, CountFlowInliers(flow_x.data(), flow_y.data(),
+                                         kNumFeatures, flow_x[k], flow_y[k],
+                                         kSqThreshold));
+      }
+    } else {
+      for (int k = 0; k < kRansacRounds; ++k) {
+        const float* vec = feature_view[k]->flow;
+        int count = 0;
+        for (const Feature* feature : feature_view) {
+          const float dx = feature->flow[0] - vec[0];
+          const float dy = feature->flow[1] - vec[1];
+          if (dx * dx + dy * dy < kSqThreshold) {
+            ++count;
+          }
+        }
+        best_count = std::max(best_count, count);
+      }
+    }
+    benchmark::DoNotOptimize(best_count);
+  }
+  state.SetItemsProcessed(state.iterations() * kRansacRounds * kNumFeatures);
+}
+BENCHMARK(BM_CountFlowInliers)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace mediapipe